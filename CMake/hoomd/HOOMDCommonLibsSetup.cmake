@@ -25,7 +25,20 @@ if (TBB_USE_GLIBCXX_VERSION)
    add_definitions(-DTBB_USE_GLIBCXX_VERSION=${TBB_USE_GLIBCXX_VERSION})
 endif()
 
-set(HOOMD_COMMON_LIBS ${ADDITIONAL_LIBS})
+# GSDDumpWriter runs a background I/O thread
+find_package(Threads REQUIRED)
+
+# zlib is optional, GSDDumpWriter uses it to compress chunks
+find_package(ZLIB)
+if (ZLIB_FOUND)
+    include_directories(${ZLIB_INCLUDE_DIRS})
+endif()
+
+set(HOOMD_COMMON_LIBS ${ADDITIONAL_LIBS} ${CMAKE_THREAD_LIBS_INIT})
+
+if (ZLIB_FOUND)
+    list(APPEND HOOMD_COMMON_LIBS ${ZLIB_LIBRARIES})
+endif()
 
 if (ENABLE_TBB)
     list(APPEND HOOMD_COMMON_LIBS ${TBB_LIBRARY})
@@ -44,3 +44,8 @@ endif()
 if (ENABLE_TBB)
     add_definitions(-DENABLE_TBB)
 endif()
+
+# export zlib availability (compressed GSD chunks)
+if (ZLIB_FOUND)
+    add_definitions(-DENABLE_ZLIB)
+endif()
@@ -77,6 +77,10 @@ struct PYBIND11_EXPORT AABBNode
                an update will only increase the volume of nodes. The tree should be rebuilt periodically instead of
                continually updated.
     - buildTree : build an efficiently arranged tree given a complete set of AABBs, one for each particle.
+    - refit : Recompute the AABBs of all nodes for a new set of AABBs of the same particles. Particles that have left
+              the volume their leaf had when the tree was built are moved to a leaf that covers them and has room.
+              The tree topology is left unchanged. Runs in O(N) time, and returns false when the leaves have grown
+              too much, so that the caller can rebuild the tree.
 
     **Implementation details**
 
@@ -86,6 +90,10 @@ struct PYBIND11_EXPORT AABBNode
     are allocated as needed with allocate(). With multiple particles per leaf node, the total number of internal nodes
     needed is not known (but can be estimated) until build time.
 
+    The stackless query relies on the nodes being stored in the order of a depth first traversal. refit() keeps this
+    order: it does not rotate subtrees, but moves particles between existing leaf nodes, which have a fixed capacity.
+    The AABBs of all nodes after the last build are kept as a reference to measure how much the tree has degraded.
+
     For performance, no recursive calls are used. Instead, each function is either turned into a loop if it uses
     tail recursion, or it uses a local stack to traverse the tree. The stack is cached between calls to limit
     the amount of dynamic memory allocation.
@@ -95,7 +103,7 @@ class PYBIND11_EXPORT AABBTree
     public:
         //! Construct an AABBTree
         AABBTree()
-            : m_nodes(0), m_num_nodes(0), m_node_capacity(0), m_root(0)
+            : m_nodes(0), m_num_nodes(0), m_node_capacity(0), m_root(0), m_ref_size(0.0)
             {
             }
 
@@ -113,6 +121,8 @@ class PYBIND11_EXPORT AABBTree
             m_node_capacity = from.m_node_capacity;
             m_root = from.m_root;
             m_mapping = from.m_mapping;
+            m_ref_aabbs = from.m_ref_aabbs;
+            m_ref_size = from.m_ref_size;
 
             m_nodes = NULL;
 
@@ -137,6 +147,8 @@ class PYBIND11_EXPORT AABBTree
             m_node_capacity = from.m_node_capacity;
             m_root = from.m_root;
             m_mapping = from.m_mapping;
+            m_ref_aabbs = from.m_ref_aabbs;
+            m_ref_size = from.m_ref_size;
 
             if (m_nodes)
                 free(m_nodes);
@@ -167,6 +179,12 @@ class PYBIND11_EXPORT AABBTree
         //! Update the AABB of a particle
         inline void update(unsigned int idx, const AABB& aabb);
 
+        //! Refit the tree to new AABBs of the same particles
+        inline bool refit(const AABB *aabbs, unsigned int N, Scalar max_growth);
+
+        //! Get the total size of the leaf nodes relative to the size after the last build
+        inline Scalar getGrowth() const;
+
         //! Get the height of a given particle's leaf node
         inline unsigned int height(unsigned int idx);
 
@@ -246,6 +264,8 @@ class PYBIND11_EXPORT AABBTree
         unsigned int m_node_capacity;       //!< Capacity of the nodes array
         unsigned int m_root;                //!< Index to the root node of the tree
         std::vector<unsigned int> m_mapping;//!< Reverse mapping to find node given a particle index
+        std::vector<AABB> m_ref_aabbs;      //!< AABBs of the nodes after the last build
+        Scalar m_ref_size;                  //!< Total size of the leaf nodes after the last build
 
         //! Initialize the tree to hold N particles
         inline void init(unsigned int N);
@@ -258,6 +278,22 @@ class PYBIND11_EXPORT AABBTree
 
         //! Update the skip value for a node
         inline unsigned int updateSkip(unsigned int idx);
+
+        //! Find a leaf node that covered a point after the last build and has room for another particle
+        inline unsigned int findLeaf(const vec3<Scalar>& pos, unsigned int exclude) const;
+
+        //! Get the total size of the leaf nodes
+        inline Scalar getLeafSize() const;
+
+        //! Get the size of an AABB
+        /*! The sum of the side lengths is used as the size, which is proportional to the surface area of the box for
+            similar shapes, and works for flat boxes in 2D.
+        */
+        static Scalar getSize(const AABB& aabb)
+            {
+            vec3<Scalar> l = aabb.getUpper() - aabb.getLower();
+            return l.x + l.y + l.z;
+            }
     };
 
 
@@ -394,6 +430,131 @@ inline void AABBTree::buildTree(AABB *aabbs, unsigned int N)
 
     m_root = buildNode(aabbs, idx, 0, N, INVALID_NODE);
     updateSkip(m_root);
+
+    // keep the node volumes as the reference for refit()
+    m_ref_aabbs.resize(m_num_nodes);
+    for (unsigned int i = 0; i < m_num_nodes; i++)
+        m_ref_aabbs[i] = m_nodes[i].aabb;
+    m_ref_size = getLeafSize();
+    }
+
+/*! \param aabbs List of AABBs for each particle
+    \param N Number of AABBs in the list
+    \param max_growth Maximum ratio of the total size of the leaf nodes to their size after the last build
+    \returns true if the tree was refit, false if it needs to be rebuilt
+
+    The AABBs must belong to the same particles, with the same indices, as in the last call to buildTree(). Particles
+    whose center has left the reference volume of their leaf node are moved to another leaf node that covers it and has
+    room, if there is one. Then the AABBs of all nodes are recomputed, leaf nodes from their particles and internal
+    nodes from their children. Children are stored after their parent, so one pass in reverse order suffices.
+
+    When the total size of the leaf nodes has grown by more than a factor of  max_growth, queries become expensive
+    and false is returned. The tree is left in a valid state either way.
+*/
+inline bool AABBTree::refit(const AABB *aabbs, unsigned int N, Scalar max_growth)
+    {
+    if (m_num_nodes == 0 || m_mapping.size() != N)
+        return false;
+
+    // move particles that left the volume of their leaf
+    for (unsigned int i = 0; i < N; i++)
+        {
+        unsigned int leaf = m_mapping[i];
+        vec3<Scalar> pos = aabbs[i].getPosition();
+
+        // leaves are never emptied, their AABB would be undefined
+        if (m_nodes[leaf].num_particles == 1 || contains(m_ref_aabbs[leaf], AABB(pos, pos)))
+            continue;
+
+        unsigned int new_leaf = findLeaf(pos, leaf);
+        if (new_leaf == INVALID_NODE)
+            continue;
+
+        // remove the particle from its leaf, and fill the hole with the last particle of the leaf
+        AABBNode& node = m_nodes[leaf];
+        unsigned int k = 0;
+        while (node.particles[k] != i)
+            k++;
+        node.num_particles--;
+        node.particles[k] = node.particles[node.num_particles];
+        node.particle_tags[k] = node.particle_tags[node.num_particles];
+
+        // add it to the new leaf
+        AABBNode& new_node = m_nodes[new_leaf];
+        new_node.particles[new_node.num_particles] = i;
+        new_node.particle_tags[new_node.num_particles] = aabbs[i].tag;
+        new_node.num_particles++;
+        m_mapping[i] = new_leaf;
+        }
+
+    // recompute the node AABBs bottom up
+    for (unsigned int node_idx = m_num_nodes; node_idx-- > 0; )
+        {
+        AABBNode& node = m_nodes[node_idx];
+        if (node.left == INVALID_NODE)
+            {
+            AABB aabb = aabbs[node.particles[0]];
+            for (unsigned int k = 1; k < node.num_particles; k++)
+                aabb = merge(aabb, aabbs[node.particles[k]]);
+            node.aabb = aabb;
+            }
+        else
+            {
+            node.aabb = merge(m_nodes[node.left].aabb, m_nodes[node.right].aabb);
+            }
+        }
+
+    return getGrowth() <= max_growth;
+    }
+
+/*! \returns The total size of the leaf nodes, relative to the size after the last build
+*/
+inline Scalar AABBTree::getGrowth() const
+    {
+    if (m_ref_size <= Scalar(0.0))
+        return Scalar(1.0);
+    return getLeafSize() / m_ref_size;
+    }
+
+/*! \returns The sum of the sizes of the leaf nodes
+*/
+inline Scalar AABBTree::getLeafSize() const
+    {
+    Scalar size = 0.0;
+    for (unsigned int i = 0; i < m_num_nodes; i++)
+        {
+        if (m_nodes[i].left == INVALID_NODE)
+            size += getSize(m_nodes[i].aabb);
+        }
+    return size;
+    }
+
+/*! \param pos Point to search for
+    \param exclude Leaf node to ignore
+    \returns The index of the first leaf node whose reference AABB contains \a pos and which has fewer than
+             NODE_CAPACITY particles, or INVALID_NODE if there is none
+
+    The search is stackless like query(), and descends only into nodes whose reference AABB contains the point.
+*/
+inline unsigned int AABBTree::findLeaf(const vec3<Scalar>& pos, unsigned int exclude) const
+    {
+    AABB point(pos, pos);
+    for (unsigned int node_idx = 0; node_idx < m_num_nodes; node_idx++)
+        {
+        const AABBNode& node = m_nodes[node_idx];
+        if (contains(m_ref_aabbs[node_idx], point))
+            {
+            if (node.left == INVALID_NODE && node_idx != exclude && node.num_particles < NODE_CAPACITY)
+                return node_idx;
+            }
+        else
+            {
+            // skip ahead
+            node_idx += node.skip;
+            }
+        }
+
+    return INVALID_NODE;
     }
 
 /*! \param aabbs List of AABBs
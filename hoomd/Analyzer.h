@@ -92,6 +92,13 @@ class PYBIND11_EXPORT Analyzer
         */
         virtual void resetStats(){}
 
+        //! Finish pending output
+        /*! Derived classes that buffer their output or write it in the background should override flush() and
+            return only once all data has been written. System calls flush() on all Analyzers at the end of a run,
+            also when the run is interrupted with Ctrl-C.
+        */
+        virtual void flush(){}
+
         //! Get needed pdata flags
         /*! Not all fields in ParticleData are computed by default. When derived classes need one of these optional
             fields, they must return the requested fields in getRequestedPDataFlags().
@@ -13,6 +13,10 @@
 
 #include <algorithm>
 
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
 using namespace std;
 namespace py = pybind11;
 
@@ -134,6 +138,19 @@ void CellList::compute(unsigned int timestep)
         force = true;
         }
 
+#ifdef ENABLE_MPI
+    // the communicator may have widened the ghost layer (e.g. by a ghost skin)
+    if (m_comm)
+        {
+        Scalar ghost_width = m_comm->getGhostLayerMaxWidth();
+        const BoxDim& box = m_pdata->getBox();
+        if ((!box.getPeriodic().x && ghost_width != m_ghost_width.x)
+            || (!box.getPeriodic().y && ghost_width != m_ghost_width.y)
+            || (m_sysdef->getNDimensions() == 3 && !box.getPeriodic().z && ghost_width != m_ghost_width.z))
+            m_box_changed = true;
+        }
+#endif
+
     if (m_box_changed)
         {
         uint3 new_dim = computeDimensions();
@@ -471,16 +488,24 @@ void CellList::computeCellList()
     // for each particle
     unsigned n_tot_particles = m_pdata->getN() + m_pdata->getNGhosts();
 
-    for (unsigned int n = 0; n < n_tot_particles; n++)
+    // the cell list is filled in three passes: the bins of all particles are determined in parallel, then the
+    // offsets into the cells are assigned serially (so that the ordering within a cell is deterministic) and finally
+    // the particle data is scattered into the cell list in parallel
+    const unsigned int bin_nan = 0xffffffff;
+    const unsigned int bin_out_of_box = 0xfffffffe;
+    m_particle_bin.resize(n_tot_particles);
+    m_particle_offset.resize(n_tot_particles);
+
+    // determine the bin of particle n
+    auto find_bin = [&](unsigned int n)
         {
         Scalar3 p = make_scalar3(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z);
         if (std::isnan(p.x) || std::isnan(p.y) || std::isnan(p.z))
             {
-            conditions.y = n+1;
-            continue;
+            m_particle_bin[n] = bin_nan;
+            return;
             }
 
-
         // find the bin each particle belongs in
         Scalar3 f = box.makeFraction(p,ghost_width);
         int ib = (int)(f.x * m_dim.x);
@@ -492,10 +517,8 @@ void CellList::computeCellList()
             (f.y < Scalar(-0.00001) || f.y >= Scalar(1.00001)) ||
             (f.z < Scalar(-0.00001) || f.z >= Scalar(1.00001)) )
             {
-            // if a ghost particle is out of bounds, silently ignore it
-            if (n < m_pdata->getN())
-                conditions.z = n+1;
-            continue;
+            m_particle_bin[n] = bin_out_of_box;
+            return;
             }
 
         // need to handle the case where the particle is exactly at the box hi
@@ -509,20 +532,77 @@ void CellList::computeCellList()
         // sanity check
         assert((ib < (int)(m_dim.x) && jb < (int)(m_dim.y) && kb < (int)(m_dim.z)) || n>=m_pdata->getN());
 
-        // record its bin
-        unsigned int bin = ci(ib, jb, kb);
-
         // all particles should be in a valid cell
         if (ib < 0 || ib >= (int)m_dim.x ||
             jb < 0 || jb >= (int)m_dim.y ||
             kb < 0 || kb >= (int)m_dim.z)
             {
-            // but ghost particles that are out of range should not produce an error
+            m_particle_bin[n] = bin_out_of_box;
+            return;
+            }
+
+        // record its bin
+        m_particle_bin[n] = ci(ib, jb, kb);
+        };
+
+    #ifdef ENABLE_TBB
+    if (m_exec_conf->getNumThreads() > 1)
+        {
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_tot_particles),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int n = r.begin(); n != r.end(); ++n)
+                find_bin(n);
+            });
+        }
+    else
+    #endif
+        {
+        for (unsigned int n = 0; n < n_tot_particles; n++)
+            find_bin(n);
+        }
+
+    // assign the offsets in particle order
+    for (unsigned int n = 0; n < n_tot_particles; n++)
+        {
+        unsigned int bin = m_particle_bin[n];
+        if (bin == bin_nan)
+            {
+            conditions.y = n+1;
+            continue;
+            }
+        if (bin == bin_out_of_box)
+            {
+            // if a ghost particle is out of bounds, silently ignore it
             if (n < m_pdata->getN())
                 conditions.z = n+1;
             continue;
             }
 
+        // store the bin entries
+        unsigned int offset = h_cell_size.data[bin];
+        m_particle_offset[n] = offset;
+
+        if (offset >= m_Nmax)
+            {
+            conditions.x = max(conditions.x, offset+1);
+            }
+
+        // increment the cell occupancy counter
+        h_cell_size.data[bin]++;
+        }
+
+    // copy the data of particle n into its cell
+    auto scatter = [&](unsigned int n)
+        {
+        unsigned int bin = m_particle_bin[n];
+        if (bin == bin_nan || bin == bin_out_of_box)
+            return;
+
+        unsigned int offset = m_particle_offset[n];
+        if (offset >= m_Nmax)
+            return;
+
         // setup the flag value to store
         Scalar flag;
         if (m_flag_charge)
@@ -532,41 +612,45 @@ void CellList::computeCellList()
         else
             flag = __int_as_scalar(n);
 
-        // store the bin entries
-        unsigned int offset = h_cell_size.data[bin];
-
-        if (offset < m_Nmax)
+        if (m_compute_xyzf)
             {
-            if (m_compute_xyzf)
-                {
-                h_xyzf.data[cli(offset, bin)] = make_scalar4(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z, flag);
-                }
-
-            if (m_compute_tdb)
-                {
-                h_tdb.data[cli(offset, bin)] = make_scalar4(h_pos.data[n].w,
-                                                            h_diameter.data[n],
-                                                            __int_as_scalar(h_body.data[n]),
-                                                            Scalar(0.0));
-                }
+            h_xyzf.data[cli(offset, bin)] = make_scalar4(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z, flag);
+            }
 
-            if (m_compute_orientation)
-                {
-                h_cell_orientation.data[cli(offset, bin)] = h_orientation.data[n];
-                }
+        if (m_compute_tdb)
+            {
+            h_tdb.data[cli(offset, bin)] = make_scalar4(h_pos.data[n].w,
+                                                        h_diameter.data[n],
+                                                        __int_as_scalar(h_body.data[n]),
+                                                        Scalar(0.0));
+            }
 
-            if (m_compute_idx)
-                {
-                h_cell_idx.data[cli(offset, bin)] = n;
-                }
+        if (m_compute_orientation)
+            {
+            h_cell_orientation.data[cli(offset, bin)] = h_orientation.data[n];
             }
-        else
+
+        if (m_compute_idx)
             {
-            conditions.x = max(conditions.x, offset+1);
+            h_cell_idx.data[cli(offset, bin)] = n;
             }
+        };
 
-        // increment the cell occupancy counter
-        h_cell_size.data[bin]++;
+    #ifdef ENABLE_TBB
+    if (m_exec_conf->getNumThreads() > 1)
+        {
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_tot_particles),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int n = r.begin(); n != r.end(); ++n)
+                scatter(n);
+            });
+        }
+    else
+    #endif
+        {
+        for (unsigned int n = 0; n < n_tot_particles; n++)
+            scatter(n);
         }
 
         {
@@ -11,6 +11,7 @@
 #include "Compute.h"
 
 #include <memory>
+#include <vector>
 #include <hoomd/extern/nano-signal-slot/nano_signal_slot.hpp>
 
 /*! \file CellList.h
@@ -387,6 +388,9 @@ class PYBIND11_EXPORT CellList : public Compute
         GlobalArray<unsigned int> m_idx;        //!< Cell list with index
         GlobalArray<uint3> m_conditions;        //!< Condition flags set during the computeCellList() call
 
+        std::vector<unsigned int> m_particle_bin;    //!< Temporary cell index of every particle (computeCellList())
+        std::vector<unsigned int> m_particle_offset; //!< Temporary offset of every particle in its cell
+
         bool m_sort_cell_list;               //!< If true, sort cell list
         bool m_compute_adj_list;            //!< If true, compute the cell adjacency lists
 
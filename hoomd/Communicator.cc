@@ -22,6 +22,30 @@ using namespace std;
 namespace py = pybind11;
 
 #include <vector>
+#include <limits.h>
+
+//! Scale of the fixed point ghost positions
+/*! Fractional coordinates in [-0.5, 1.5) map to the range of a 32 bit int. Ghost particles are less than half a
+    box length outside of the global box.
+*/
+static const double ghost_fixed_point_scale = 2147483648.0;
+
+//! Convert a fractional coordinate to fixed point
+inline int encodeGhostFraction(Scalar f)
+    {
+    double q = floor((double(f) - 0.5)*ghost_fixed_point_scale + 0.5);
+    if (q < double(INT_MIN))
+        q = double(INT_MIN);
+    if (q > double(INT_MAX))
+        q = double(INT_MAX);
+    return int(q);
+    }
+
+//! Convert a fixed point coordinate back to a fraction
+inline Scalar decodeGhostFraction(int q)
+    {
+    return Scalar(double(q)/ghost_fixed_point_scale + 0.5);
+    }
 
 template<class group_data>
 Communicator::GroupCommunicator<group_data>::GroupCommunicator(Communicator& comm, std::shared_ptr<group_data> gdata)
@@ -32,328 +56,250 @@ Communicator::GroupCommunicator<group_data>::GroupCommunicator(Communicator& com
     }
 
 template<class group_data>
-void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete, bool local_multiple)
+template<class T>
+void Communicator::GroupCommunicator<group_data>::initExchange(group_buffer_t& buf,
+    const std::multimap<unsigned int, T>& send_map, std::vector<T>& sendbuf)
     {
-    if (m_gdata->getNGlobal())
-        {
-        if (m_comm.m_prof) m_comm.m_prof->push(m_exec_conf, m_gdata->getName());
+    ArrayHandle<unsigned int> h_unique_neighbors(m_comm.m_unique_neighbors, access_location::host, access_mode::read);
 
-            {
-            // wipe out reverse-lookup tag -> idx for old ghost groups
-            ArrayHandle<unsigned int> h_group_tag(m_gdata->getTags(), access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_group_rtag(m_gdata->getRTags(), access_location::host, access_mode::readwrite);
-            for (unsigned int i = 0; i < m_gdata->getNGhosts(); i++)
-                {
-                unsigned int idx = m_gdata->getN() + i;
-                h_group_rtag.data[h_group_tag.data[idx]] = GROUP_NOT_LOCAL;
-                }
-            }
+    sendbuf.clear();
+    buf.n_send.resize(m_comm.m_n_unique_neigh);
 
+    // output send data sorted by neighbor
+    for (unsigned int ineigh = 0; ineigh < m_comm.m_n_unique_neigh; ++ineigh)
+        {
+        auto range = send_map.equal_range(h_unique_neighbors.data[ineigh]);
+        for (auto it = range.first; it != range.second; ++it)
+            sendbuf.push_back(it->second);
 
-        // remove ghost groups
-        m_gdata->removeAllGhostGroups();
+        buf.n_send[ineigh] = std::distance(range.first, range.second);
+        }
 
-        // send map for rank updates
-        typedef std::multimap<unsigned int, rank_element_t> map_t;
-        map_t send_map;
+    buf.send = sendbuf.empty() ? NULL : (const char *) &sendbuf.front();
+    buf.element_size = sizeof(T);
+    }
 
-            {
-            ArrayHandle<unsigned int> h_comm_flags(m_comm.m_pdata->getCommFlags(), access_location::host, access_mode::read);
-            ArrayHandle<typename group_data::members_t> h_members(m_gdata->getMembersArray(), access_location::host, access_mode::read);
-            ArrayHandle<typename group_data::ranks_t> h_group_ranks(m_gdata->getRanksArray(), access_location::host, access_mode::readwrite);
-            ArrayHandle<unsigned int> h_group_tag(m_gdata->getTags(), access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_comm.m_pdata->getRTags(), access_location::host, access_mode::read);
+template<class group_data>
+void Communicator::GroupCommunicator<group_data>::prepareRankUpdate(bool incomplete, bool migrate,
+    std::vector<group_buffer_t *>& buffers)
+    {
+    if (! m_gdata->getNGlobal())
+        return;
 
-            ArrayHandle<unsigned int> h_unique_neighbors(m_comm.m_unique_neighbors, access_location:: host, access_mode::read);
+    if (m_comm.m_prof) m_comm.m_prof->push(m_exec_conf, m_gdata->getName());
 
-            ArrayHandle<unsigned int> h_cart_ranks(m_comm.m_pdata->getDomainDecomposition()->getCartRanks(), access_location::host, access_mode::read);
+        {
+        // wipe out reverse-lookup tag -> idx for old ghost groups
+        ArrayHandle<unsigned int> h_group_tag(m_gdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_group_rtag(m_gdata->getRTags(), access_location::host, access_mode::readwrite);
+        for (unsigned int i = 0; i < m_gdata->getNGhosts(); i++)
+            {
+            unsigned int idx = m_gdata->getN() + i;
+            h_group_rtag.data[h_group_tag.data[idx]] = GROUP_NOT_LOCAL;
+            }
+        }
 
-            Index3D di = m_comm.m_pdata->getDomainDecomposition()->getDomainIndexer();
-            uint3 my_pos = m_comm.m_pdata->getDomainDecomposition()->getGridPos();
-            unsigned int my_rank = m_exec_conf->getRank();
+    // remove ghost groups
+    m_gdata->removeAllGhostGroups();
 
-            // mark groups whose member ranks need to be updated
-            unsigned int n_groups = m_gdata->getN();
-            for (unsigned int group_idx = 0; group_idx < n_groups; group_idx++)
-                {
-                typename group_data::members_t g = h_members.data[group_idx];
-                typename group_data::ranks_t r = h_group_ranks.data[group_idx];
+    // send map for rank updates
+    typedef std::multimap<unsigned int, rank_element_t> map_t;
+    map_t send_map;
 
-                // initialize bit field
-                unsigned int mask = 0;
+    // without migrating particles, no group member changes its rank
+    if (incomplete || migrate)
+        {
+        ArrayHandle<unsigned int> h_comm_flags(m_comm.m_pdata->getCommFlags(), access_location::host, access_mode::read);
+        ArrayHandle<typename group_data::members_t> h_members(m_gdata->getMembersArray(), access_location::host, access_mode::read);
+        ArrayHandle<typename group_data::ranks_t> h_group_ranks(m_gdata->getRanksArray(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_group_tag(m_gdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_rtag(m_comm.m_pdata->getRTags(), access_location::host, access_mode::read);
 
-                bool update = false;
+        ArrayHandle<unsigned int> h_unique_neighbors(m_comm.m_unique_neighbors, access_location:: host, access_mode::read);
 
-                // iterate over group members
-                for (unsigned int i = 0; i < group_data::size; i++)
-                    {
-                    unsigned int tag = g.tag[i];
-                    unsigned int pidx = h_rtag.data[tag];
+        ArrayHandle<unsigned int> h_cart_ranks(m_comm.m_pdata->getDomainDecomposition()->getCartRanks(), access_location::host, access_mode::read);
 
-                    if (pidx == NOT_LOCAL)
-                        {
-                        // if any ptl is non-local, send
-                        update = true;
-                        }
-                    else
-                        {
-                        if (incomplete)
-                            {
-                            // initially, update rank information
-                            r.idx[i] = my_rank;
-                            mask |= (1 << i);
-                            }
+        Index3D di = m_comm.m_pdata->getDomainDecomposition()->getDomainIndexer();
+        uint3 my_pos = m_comm.m_pdata->getDomainDecomposition()->getGridPos();
+        unsigned int my_rank = m_exec_conf->getRank();
 
-                        unsigned int flags = h_comm_flags.data[pidx];
+        // mark groups whose member ranks need to be updated
+        unsigned int n_groups = m_gdata->getN();
+        for (unsigned int group_idx = 0; group_idx < n_groups; group_idx++)
+            {
+            typename group_data::members_t g = h_members.data[group_idx];
+            typename group_data::ranks_t r = h_group_ranks.data[group_idx];
 
-                        if (flags)
-                            {
-                            // particle is sent to a different domain
-                            mask |= (1 << i);
-
-                            int ix, iy, iz;
-                            ix = iy = iz = 0;
-
-                            if (flags & send_east)
-                                ix = 1;
-                            else if (flags & send_west)
-                                ix = -1;
-
-                            if (flags & send_north)
-                                iy = 1;
-                            else if (flags & send_south)
-                                iy = -1;
-
-                            if (flags & send_up)
-                                iz = 1;
-                            else if (flags & send_down)
-                                iz = -1;
-
-                            int ni = my_pos.x;
-                            int nj = my_pos.y;
-                            int nk = my_pos.z;
-
-                            ni += ix;
-                            if (ni == (int)di.getW())
-                                ni = 0;
-                            else if (ni < 0)
-                                ni += di.getW();
-
-                            nj += iy;
-                            if (nj == (int) di.getH())
-                                nj = 0;
-                            else if (nj < 0)
-                                nj += di.getH();
-
-                            nk += iz;
-                            if (nk == (int) di.getD())
-                                nk = 0;
-                            else if (nk < 0)
-                                nk += di.getD();
-
-                            // update ranks
-                            r.idx[i] = h_cart_ranks.data[di(ni,nj,nk)];
-
-                            update = true;
-                            }
-                        }
-                    } // end loop over group members
+            // initialize bit field
+            unsigned int mask = 0;
 
-                h_group_ranks.data[group_idx] = r;
+            bool update = false;
 
-                // a group that is purely local is not sent
-                if (!update) mask = 0;
+            // iterate over group members
+            for (unsigned int i = 0; i < group_data::size; i++)
+                {
+                unsigned int tag = g.tag[i];
+                unsigned int pidx = h_rtag.data[tag];
 
-                if (mask)
+                if (pidx == NOT_LOCAL)
                     {
-                    // add to sorted output buffer
-                    rank_element_t el;
-                    el.ranks = r;
-                    el.mask = mask;
-                    el.tag = h_group_tag.data[group_idx];
-                    if (incomplete)
-                        // in initialization, send to all neighbors
-                        for(unsigned int ineigh = 0; ineigh < m_comm.m_n_unique_neigh; ineigh++)
-                            send_map.insert(std::make_pair(h_unique_neighbors.data[ineigh], el));
-                    else
-                        // send to other ranks owning the bonded group
-                        for (unsigned int j = 0; j < group_data::size; ++j)
-                            {
-                            unsigned int rank = r.idx[j];
-                            bool rank_updated = mask & (1 << j);
-                            // send out to ranks different from ours
-                            if (rank != my_rank && !rank_updated)
-                                send_map.insert(std::make_pair(rank, el));
-                            }
+                    // if any ptl is non-local, send
+                    update = true;
                     }
-                } // end loop over groups
-            } // end ArrayHandle scope
-
-        // clear send buffer
-        m_ranks_sendbuf.clear();
-
-            {
-            // output send data sorted by rank
-            for (typename map_t::iterator it = send_map.begin(); it != send_map.end(); ++it)
-                {
-                m_ranks_sendbuf.push_back(it->second);
-                }
-
-            ArrayHandle<unsigned int> h_unique_neighbors(m_comm.m_unique_neighbors, access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_begin(m_comm.m_begin, access_location::host, access_mode::overwrite);
-            ArrayHandle<unsigned int> h_end(m_comm.m_end, access_location::host, access_mode::overwrite);
-
-            // Find start and end indices
-            for (unsigned int i = 0; i < m_comm.m_n_unique_neigh; ++i)
-                {
-                typename map_t::iterator lower = send_map.lower_bound(h_unique_neighbors.data[i]);
-                typename map_t::iterator upper = send_map.upper_bound(h_unique_neighbors.data[i]);
-                h_begin.data[i] = std::distance(send_map.begin(),lower);
-                h_end.data[i] = std::distance(send_map.begin(),upper);
-                }
-            }
-
-        /*
-         * communicate rank information (phase 1)
-         */
-        unsigned int n_send_groups[m_comm.m_n_unique_neigh];
-        unsigned int n_recv_groups[m_comm.m_n_unique_neigh];
-        unsigned int offs[m_comm.m_n_unique_neigh];
-        unsigned int n_recv_tot = 0;
-
-            {
-            ArrayHandle<unsigned int> h_begin(m_comm.m_begin, access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_end(m_comm.m_end, access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_unique_neighbors(m_comm.m_unique_neighbors, access_location::host, access_mode::read);
-
-            unsigned int send_bytes = 0;
-            unsigned int recv_bytes = 0;
-            if (m_comm.m_prof) m_comm.m_prof->push("MPI send/recv");
+                else
+                    {
+                    if (incomplete)
+                        {
+                        // initially, update rank information
+                        r.idx[i] = my_rank;
+                        mask |= (1 << i);
+                        }
 
-            // compute send counts
-            for (unsigned int ineigh = 0; ineigh < m_comm.m_n_unique_neigh; ineigh++)
-                n_send_groups[ineigh] = h_end.data[ineigh] - h_begin.data[ineigh];
+                    unsigned int flags = h_comm_flags.data[pidx];
 
-            MPI_Request req[2*m_comm.m_n_unique_neigh];
-            MPI_Status stat[2*m_comm.m_n_unique_neigh];
+                    if (flags)
+                        {
+                        // particle is sent to a different domain
+                        mask |= (1 << i);
 
-            unsigned int nreq = 0;
+                        int ix, iy, iz;
+                        ix = iy = iz = 0;
+
+                        if (flags & send_east)
+                            ix = 1;
+                        else if (flags & send_west)
+                            ix = -1;
+
+                        if (flags & send_north)
+                            iy = 1;
+                        else if (flags & send_south)
+                            iy = -1;
+
+                        if (flags & send_up)
+                            iz = 1;
+                        else if (flags & send_down)
+                            iz = -1;
+
+                        int ni = my_pos.x;
+                        int nj = my_pos.y;
+                        int nk = my_pos.z;
+
+                        ni += ix;
+                        if (ni == (int)di.getW())
+                            ni = 0;
+                        else if (ni < 0)
+                            ni += di.getW();
+
+                        nj += iy;
+                        if (nj == (int) di.getH())
+                            nj = 0;
+                        else if (nj < 0)
+                            nj += di.getH();
+
+                        nk += iz;
+                        if (nk == (int) di.getD())
+                            nk = 0;
+                        else if (nk < 0)
+                            nk += di.getD();
+
+                        // update ranks
+                        r.idx[i] = h_cart_ranks.data[di(ni,nj,nk)];
 
-            // loop over neighbors
-            for (unsigned int ineigh = 0; ineigh < m_comm.m_n_unique_neigh; ineigh++)
-                {
-                // rank of neighbor processor
-                unsigned int neighbor = h_unique_neighbors.data[ineigh];
+                        update = true;
+                        }
+                    }
+                } // end loop over group members
 
-                MPI_Isend(&n_send_groups[ineigh], 1, MPI_UNSIGNED, neighbor, 0, m_comm.m_mpi_comm, & req[nreq++]);
-                MPI_Irecv(&n_recv_groups[ineigh], 1, MPI_UNSIGNED, neighbor, 0, m_comm.m_mpi_comm, & req[nreq++]);
-                send_bytes += sizeof(unsigned int);
-                recv_bytes += sizeof(unsigned int);
-                } // end neighbor loop
+            h_group_ranks.data[group_idx] = r;
 
-            MPI_Waitall(nreq, req, stat);
+            // a group that is purely local is not sent
+            if (!update) mask = 0;
 
-            // sum up receive counts
-            for (unsigned int ineigh = 0; ineigh < m_comm.m_n_unique_neigh; ineigh++)
+            if (mask)
                 {
-                if (ineigh == 0)
-                    offs[ineigh] = 0;
+                // add to sorted output buffer
+                rank_element_t el;
+                el.ranks = r;
+                el.mask = mask;
+                el.tag = h_group_tag.data[group_idx];
+                if (incomplete)
+                    // in initialization, send to all neighbors
+                    for(unsigned int ineigh = 0; ineigh < m_comm.m_n_unique_neigh; ineigh++)
+                        send_map.insert(std::make_pair(h_unique_neighbors.data[ineigh], el));
                 else
-                    offs[ineigh] = offs[ineigh-1] + n_recv_groups[ineigh-1];
-
-                n_recv_tot += n_recv_groups[ineigh];
+                    // send to other ranks owning the bonded group
+                    for (unsigned int j = 0; j < group_data::size; ++j)
+                        {
+                        unsigned int rank = r.idx[j];
+                        bool rank_updated = mask & (1 << j);
+                        // send out to ranks different from ours
+                        if (rank != my_rank && !rank_updated)
+                            send_map.insert(std::make_pair(rank, el));
+                        }
                 }
+            } // end loop over groups
+        } // end ArrayHandle scope
 
-            if (m_comm.m_prof) m_comm.m_prof->pop(0,send_bytes+recv_bytes);
-            }
-
-        // Resize receive buffer
-        m_ranks_recvbuf.resize(n_recv_tot);
-
-            {
-            ArrayHandle<unsigned int> h_begin(m_comm.m_begin, access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_end(m_comm.m_end, access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_unique_neighbors(m_comm.m_unique_neighbors, access_location::host, access_mode::read);
-
-            if (m_comm.m_prof) m_comm.m_prof->push("MPI send/recv");
-
-            std::vector<MPI_Request> reqs;
-            MPI_Request req;
+    initExchange(m_rank_exchange, send_map, m_ranks_sendbuf);
+    buffers.push_back(&m_rank_exchange);
 
-            unsigned int send_bytes = 0;
-            unsigned int recv_bytes = 0;
+    if (m_comm.m_prof) m_comm.m_prof->pop();
+    }
 
-            // loop over neighbors
-            for (unsigned int ineigh = 0; ineigh < m_comm.m_n_unique_neigh; ineigh++)
-                {
-                // rank of neighbor processor
-                unsigned int neighbor = h_unique_neighbors.data[ineigh];
+template<class group_data>
+void Communicator::GroupCommunicator<group_data>::applyRankUpdate()
+    {
+    if (! m_gdata->getNGlobal())
+        return;
 
-                // exchange particle data
-                if (n_send_groups[ineigh])
-                    {
-                    MPI_Isend(&m_ranks_sendbuf.front()+h_begin.data[ineigh],
-                        n_send_groups[ineigh]*sizeof(rank_element_t),
-                        MPI_BYTE,
-                        neighbor,
-                        1,
-                        m_comm.m_mpi_comm,
-                        &req);
-                    reqs.push_back(req);
-                    }
-                send_bytes+= n_send_groups[ineigh]*sizeof(rank_element_t);
+    unsigned int n_recv = m_rank_exchange.getNRecv();
+    if (! n_recv)
+        return;
 
-                if (n_recv_groups[ineigh])
-                    {
-                    MPI_Irecv(&m_ranks_recvbuf.front()+offs[ineigh],
-                        n_recv_groups[ineigh]*sizeof(rank_element_t),
-                        MPI_BYTE,
-                        neighbor,
-                        1,
-                        m_comm.m_mpi_comm,
-                        &req);
-                    reqs.push_back(req);
-                    }
-                recv_bytes += n_recv_groups[ineigh]*sizeof(rank_element_t);
-                }
+    const rank_element_t *ranks_recvbuf = (const rank_element_t *) &m_rank_exchange.recv.front();
 
-            std::vector<MPI_Status> stats(reqs.size());
-            MPI_Waitall(reqs.size(), &reqs.front(), &stats.front());
+    // access receive buffers
+    ArrayHandle<typename group_data::ranks_t> h_group_ranks(m_gdata->getRanksArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_group_rtag(m_gdata->getRTags(), access_location::host, access_mode::read);
 
-            if (m_comm.m_prof) m_comm.m_prof->pop(0,send_bytes+recv_bytes);
-            }
+    for (unsigned int recv_idx = 0; recv_idx < n_recv; ++recv_idx)
+        {
+        rank_element_t el = ranks_recvbuf[recv_idx];
+        unsigned int tag = el.tag;
+        unsigned int gidx = h_group_rtag.data[tag];
 
+        if (gidx != GROUP_NOT_LOCAL)
             {
-            // access receive buffers
-            ArrayHandle<typename group_data::ranks_t> h_group_ranks(m_gdata->getRanksArray(), access_location::host, access_mode::readwrite);
-            ArrayHandle<unsigned int> h_group_rtag(m_gdata->getRTags(), access_location::host, access_mode::read);
+            typename group_data::ranks_t new_ranks = el.ranks;
+            unsigned int mask = el.mask;
 
-            for (unsigned int recv_idx = 0; recv_idx < n_recv_tot; ++recv_idx)
+            for (unsigned int i = 0; i < group_data::size; ++i)
                 {
-                rank_element_t el = m_ranks_recvbuf[recv_idx];
-                unsigned int tag = el.tag;
-                unsigned int gidx = h_group_rtag.data[tag];
-
-                if (gidx != GROUP_NOT_LOCAL)
-                    {
-                    typename group_data::ranks_t new_ranks = el.ranks;
-                    unsigned int mask = el.mask;
-
-                    for (unsigned int i = 0; i < group_data::size; ++i)
-                        {
-                        bool update = mask & (1 << i);
+                bool update = mask & (1 << i);
 
-                        if (update)
-                            h_group_ranks.data[gidx].idx[i] = new_ranks.idx[i];
-                        }
-                    }
+                if (update)
+                    h_group_ranks.data[gidx].idx[i] = new_ranks.idx[i];
                 }
             }
+        }
+    }
+
+template<class group_data>
+void Communicator::GroupCommunicator<group_data>::prepareGroupMigration(bool local_multiple, bool migrate,
+    std::vector<group_buffer_t *>& buffers)
+    {
+    if (! m_gdata->getNGlobal())
+        return;
+
+    if (m_comm.m_prof) m_comm.m_prof->push(m_exec_conf, m_gdata->getName());
 
-        // send map for groups
-        typedef std::multimap<unsigned int, group_element_t> group_map_t;
-        group_map_t group_send_map;
+    // send map for groups
+    typedef std::multimap<unsigned int, group_element_t> group_map_t;
+    group_map_t group_send_map;
 
+    // only groups with migrating members are sent or removed
+    if (migrate)
+        {
             {
             ArrayHandle<typename group_data::members_t> h_groups(m_gdata->getMembersArray(), access_location::host, access_mode::read);
             ArrayHandle<typeval_t> h_group_typeval(m_gdata->getTypeValArray(), access_location::host, access_mode::read);
@@ -474,222 +420,111 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
         m_gdata->removeGroups(m_gdata->getN() - new_ngroups);
 
         assert(m_gdata->getN() == new_ngroups);
+        }
 
-        // reset send buf
-        m_groups_sendbuf.clear();
-
-        // output groups to send buffer in rank-sorted order
-        for (typename group_map_t::iterator it = group_send_map.begin(); it != group_send_map.end(); ++it)
-            {
-            m_groups_sendbuf.push_back(it->second);
-            }
-
-            {
-            ArrayHandle<unsigned int> h_unique_neighbors(m_comm.m_unique_neighbors, access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_begin(m_comm.m_begin, access_location::host, access_mode::overwrite);
-            ArrayHandle<unsigned int> h_end(m_comm.m_end, access_location::host, access_mode::overwrite);
-
-            // Find start and end indices
-            for (unsigned int i = 0; i < m_comm.m_n_unique_neigh; ++i)
-                {
-                typename group_map_t::iterator lower = group_send_map.lower_bound(h_unique_neighbors.data[i]);
-                typename group_map_t::iterator upper = group_send_map.upper_bound(h_unique_neighbors.data[i]);
-                h_begin.data[i] = std::distance(group_send_map.begin(),lower);
-                h_end.data[i] = std::distance(group_send_map.begin(),upper);
-                }
-            }
+    initExchange(m_group_exchange, group_send_map, m_groups_sendbuf);
+    buffers.push_back(&m_group_exchange);
 
-        /*
-         * communicate groups (phase 2)
-         */
+    if (m_comm.m_prof) m_comm.m_prof->pop();
+    }
 
-       n_recv_tot = 0;
-            {
-            ArrayHandle<unsigned int> h_begin(m_comm.m_begin, access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_end(m_comm.m_end, access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_unique_neighbors(m_comm.m_unique_neighbors, access_location::host, access_mode::read);
+template<class group_data>
+void Communicator::GroupCommunicator<group_data>::addMigratedGroups(bool local_multiple)
+    {
+    if (! m_gdata->getNGlobal())
+        return;
 
-            unsigned int send_bytes = 0;
-            unsigned int recv_bytes = 0;
-            if (m_comm.m_prof) m_comm.m_prof->push("MPI send/recv");
+    unsigned int n_recv_tot = m_group_exchange.getNRecv();
+    if (! n_recv_tot)
+        return;
 
-            // compute send counts
-            for (unsigned int ineigh = 0; ineigh < m_comm.m_n_unique_neigh; ineigh++)
-                n_send_groups[ineigh] = h_end.data[ineigh] - h_begin.data[ineigh];
+    if (m_comm.m_prof) m_comm.m_prof->push(m_exec_conf, m_gdata->getName());
 
-            MPI_Request req[2*m_comm.m_n_unique_neigh];
-            MPI_Status stat[2*m_comm.m_n_unique_neigh];
+    const group_element_t *groups_recvbuf = (const group_element_t *) &m_group_exchange.recv.front();
 
-            unsigned int nreq = 0;
+    // use a std::map, i.e. single-key, to filter out duplicate groups in input buffer
+    typedef std::map<unsigned int, group_element_t> recv_map_t;
+    recv_map_t recv_map;
 
-            // loop over neighbors
-            for (unsigned int ineigh = 0; ineigh < m_comm.m_n_unique_neigh; ineigh++)
-                {
-                // rank of neighbor processor
-                unsigned int neighbor = h_unique_neighbors.data[ineigh];
+    for (unsigned int recv_idx = 0; recv_idx < n_recv_tot; recv_idx++)
+        {
+        group_element_t el = groups_recvbuf[recv_idx];
+        unsigned int tag= el.group_tag;
+        recv_map.insert(std::make_pair(tag, el));
+        }
 
-                MPI_Isend(&n_send_groups[ineigh], 1, MPI_UNSIGNED, neighbor, 0, m_comm.m_mpi_comm, & req[nreq++]);
-                MPI_Irecv(&n_recv_groups[ineigh], 1, MPI_UNSIGNED, neighbor, 0, m_comm.m_mpi_comm, & req[nreq++]);
-                send_bytes += sizeof(unsigned int);
-                recv_bytes += sizeof(unsigned int);
-                } // end neighbor loop
+    unsigned int n_recv_unique = recv_map.size();
 
-            MPI_Waitall(nreq, req, stat);
+    unsigned int old_ngroups = m_gdata->getN();
 
-            // sum up receive counts
-            for (unsigned int ineigh = 0; ineigh < m_comm.m_n_unique_neigh; ineigh++)
-                {
-                if (ineigh == 0)
-                    offs[ineigh] = 0;
-                else
-                    offs[ineigh] = offs[ineigh-1] + n_recv_groups[ineigh-1];
+    // resize group arrays to accommodate additional groups (there can still be duplicates with local groups)
+    m_gdata->addGroups(n_recv_unique);
 
-                n_recv_tot += n_recv_groups[ineigh];
-                }
+    auto& groups_array = m_gdata->getMembersArray();
+    auto& group_typeval_array = m_gdata->getTypeValArray();
+    auto& group_tag_array = m_gdata->getTags();
+    auto& group_ranks_array = m_gdata->getRanksArray();
 
-            if (m_comm.m_prof) m_comm.m_prof->pop(0,send_bytes+recv_bytes);
-            }
+    unsigned int nremove = 0;
 
-        // Resize receive buffer
-        m_groups_recvbuf.resize(n_recv_tot);
+    unsigned int myrank = m_exec_conf->getRank();
 
+        {
+        ArrayHandle<unsigned int> h_group_rtag(m_gdata->getRTags(), access_location::host, access_mode::readwrite);
+        ArrayHandle<typename group_data::members_t> h_groups(groups_array, access_location::host, access_mode::readwrite);
+        ArrayHandle<typeval_t> h_group_typeval(group_typeval_array, access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_group_tag(group_tag_array, access_location::host, access_mode::readwrite);
+        ArrayHandle<typename group_data::ranks_t> h_group_ranks(group_ranks_array, access_location::host, access_mode::readwrite);
+
+        // add non-duplicate groups to group data
+        unsigned int add_idx = old_ngroups;
+        for (typename recv_map_t::iterator it = recv_map.begin(); it != recv_map.end(); ++it)
             {
-            ArrayHandle<unsigned int> h_begin(m_comm.m_begin, access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_end(m_comm.m_end, access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_unique_neighbors(m_comm.m_unique_neighbors, access_location::host, access_mode::read);
-
-            if (m_comm.m_prof) m_comm.m_prof->push("MPI send/recv");
+            typename group_data::packed_t el = it->second;
 
-            std::vector<MPI_Request> reqs;
-            MPI_Request req;
-
-            unsigned int send_bytes = 0;
-            unsigned int recv_bytes = 0;
+            unsigned int tag = el.group_tag;
+            unsigned int group_rtag = h_group_rtag.data[tag];
 
-            // loop over neighbors
-            for (unsigned int ineigh = 0; ineigh < m_comm.m_n_unique_neigh; ineigh++)
+            bool remove = false;
+            if (! local_multiple)
                 {
-                // rank of neighbor processor
-                unsigned int neighbor = h_unique_neighbors.data[ineigh];
-
-                // exchange particle data
-                if (n_send_groups[ineigh])
-                    {
-                    MPI_Isend(&m_groups_sendbuf.front()+h_begin.data[ineigh],
-                        n_send_groups[ineigh]*sizeof(group_element_t),
-                        MPI_BYTE,
-                        neighbor,
-                        1,
-                        m_comm.m_mpi_comm,
-                        &req);
-                    reqs.push_back(req);
-                    }
-                send_bytes+= n_send_groups[ineigh]*sizeof(group_element_t);
-
-                if (n_recv_groups[ineigh])
+                // only add if we own the first particle
+                assert(group_data::size);
+                if (el.ranks.idx[0] != myrank)
                     {
-                    MPI_Irecv(&m_groups_recvbuf.front()+offs[ineigh],
-                        n_recv_groups[ineigh]*sizeof(group_element_t),
-                        MPI_BYTE,
-                        neighbor,
-                        1,
-                        m_comm.m_mpi_comm,
-                        &req);
-                    reqs.push_back(req);
+                    remove = true;
                     }
-                recv_bytes += n_recv_groups[ineigh]*sizeof(group_element_t);
                 }
 
-            std::vector<MPI_Status> stats(reqs.size());
-            MPI_Waitall(reqs.size(), &reqs.front(), &stats.front());
-
-            if (m_comm.m_prof) m_comm.m_prof->pop(0,send_bytes+recv_bytes);
-            }
-
-        // use a std::map, i.e. single-key, to filter out duplicate groups in input buffer
-        typedef std::map<unsigned int, group_element_t> recv_map_t;
-        recv_map_t recv_map;
-
-        for (unsigned int recv_idx = 0; recv_idx < n_recv_tot; recv_idx++)
-            {
-            group_element_t el = m_groups_recvbuf[recv_idx];
-            unsigned int tag= el.group_tag;
-            recv_map.insert(std::make_pair(tag, el));
-            }
-
-        unsigned int n_recv_unique = recv_map.size();
-
-        unsigned int old_ngroups = m_gdata->getN();
-
-        // resize group arrays to accommodate additional groups (there can still be duplicates with local groups)
-        m_gdata->addGroups(n_recv_unique);
-
-        auto& groups_array = m_gdata->getMembersArray();
-        auto& group_typeval_array = m_gdata->getTypeValArray();
-        auto& group_tag_array = m_gdata->getTags();
-        auto& group_ranks_array = m_gdata->getRanksArray();
-
-        unsigned int nremove = 0;
-
-        unsigned int myrank = m_exec_conf->getRank();
-
-            {
-            ArrayHandle<unsigned int> h_group_rtag(m_gdata->getRTags(), access_location::host, access_mode::readwrite);
-            ArrayHandle<typename group_data::members_t> h_groups(groups_array, access_location::host, access_mode::readwrite);
-            ArrayHandle<typeval_t> h_group_typeval(group_typeval_array, access_location::host, access_mode::readwrite);
-            ArrayHandle<unsigned int> h_group_tag(group_tag_array, access_location::host, access_mode::readwrite);
-            ArrayHandle<typename group_data::ranks_t> h_group_ranks(group_ranks_array, access_location::host, access_mode::readwrite);
-
-            // add non-duplicate groups to group data
-            unsigned int add_idx = old_ngroups;
-            for (typename recv_map_t::iterator it = recv_map.begin(); it != recv_map.end(); ++it)
+            if (!remove)
                 {
-                typename group_data::packed_t el = it->second;
-
-                unsigned int tag = el.group_tag;
-                unsigned int group_rtag = h_group_rtag.data[tag];
-
-                bool remove = false;
-                if (! local_multiple)
-                    {
-                    // only add if we own the first particle
-                    assert(group_data::size);
-                    if (el.ranks.idx[0] != myrank)
-                        {
-                        remove = true;
-                        }
-                    }
-
-                if (!remove)
+                if (group_rtag == GROUP_NOT_LOCAL)
                     {
-                    if (group_rtag == GROUP_NOT_LOCAL)
-                        {
-                        h_groups.data[add_idx] = el.tags;
-                        h_group_typeval.data[add_idx] = el.typeval;
-                        h_group_tag.data[add_idx] = tag;
-                        h_group_ranks.data[add_idx] = el.ranks;
+                    h_groups.data[add_idx] = el.tags;
+                    h_group_typeval.data[add_idx] = el.typeval;
+                    h_group_tag.data[add_idx] = tag;
+                    h_group_ranks.data[add_idx] = el.ranks;
 
-                        // update reverse-lookup table
-                        h_group_rtag.data[tag] = add_idx++;
-                        }
-                    else
-                        {
-                        remove = true;
-                        }
+                    // update reverse-lookup table
+                    h_group_rtag.data[tag] = add_idx++;
                     }
-
-                if (remove)
+                else
                     {
-                    nremove++;
+                    remove = true;
                     }
                 }
+
+            if (remove)
+                {
+                nremove++;
+                }
             }
+        }
 
-        // resize arrays to final size
-        m_gdata->removeGroups(nremove);
+    // resize arrays to final size
+    m_gdata->removeGroups(nremove);
 
-        if (m_comm.m_prof) m_comm.m_prof->pop();
-        }
+    if (m_comm.m_prof) m_comm.m_prof->pop();
     }
 
 //! Mark ghost particles
@@ -1088,8 +923,34 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
             m_r_extra_ghost_max(Scalar(0.0)),
             m_ghosts_added(0),
             m_has_ghost_particles(false),
+            m_ghost_skin(0.0),
+            m_ghost_ref_pos(m_exec_conf),
+            m_n_skipped_exchanges(0),
             m_last_flags(0),
             m_comm_pending(false),
+            m_ghost_overlap(false),
+            m_ghost_update_pending(false),
+            m_ghost_update_stage(3),
+            m_num_tot_recv_ghosts(0),
+            m_pos_recvbuf(m_exec_conf),
+            m_velocity_recvbuf(m_exec_conf),
+            m_orientation_recvbuf(m_exec_conf),
+            m_ghost_update_bytes(0),
+            m_persistent_reqs(false),
+            m_ghost_reqs_valid(false),
+            m_ghost_reqs_flags(0),
+            m_ghost_compression(false),
+            m_ghost_compression_tol(0.0),
+            m_pos_compressed_copybuf(m_exec_conf),
+            m_pos_compressed_recvbuf(m_exec_conf),
+            m_velocity_compressed_copybuf(m_exec_conf),
+            m_velocity_compressed_recvbuf(m_exec_conf),
+            m_shm_ghosts(false),
+            m_shm_valid(false),
+            m_shm_comm(m_exec_conf->getMPIConfig()->getNodeCommunicator()),
+            m_shm_rank(0),
+            m_shm_win(MPI_WIN_NULL),
+            m_shm_capacity(0),
             m_bond_comm(*this, m_sysdef->getBondData()),
             m_angle_comm(*this, m_sysdef->getAngleData()),
             m_dihedral_comm(*this, m_sysdef->getDihedralData()),
@@ -1106,7 +967,33 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
     for (unsigned int dir = 0; dir < 6; dir ++)
         {
         m_is_at_boundary[dir] = m_decomposition->isAtBoundary(dir) ? 1 : 0;
+        m_neighbor_distance[dir] = m_decomposition->getTopologyDistance(m_decomposition->getNeighborRank(dir));
+        }
+    resetGhostTraffic();
+
+    // find the neighbors that share this node
+    MPI_Comm_rank(m_shm_comm, &m_shm_rank);
+
+    MPI_Group group, shm_group;
+    MPI_Comm_group(m_mpi_comm, &group);
+    MPI_Comm_group(m_shm_comm, &shm_group);
+    for (unsigned int dir = 0; dir < 6; dir ++)
+        {
+        // we receive from the direction opposite to the one we send to
+        int ranks[2];
+        ranks[0] = m_decomposition->getNeighborRank(dir);
+        ranks[1] = m_decomposition->getNeighborRank(dir % 2 == 0 ? dir+1 : dir-1);
+
+        int shm_ranks[2];
+        MPI_Group_translate_ranks(group, 2, ranks, shm_group, shm_ranks);
+        m_shm_send_rank[dir] = (shm_ranks[0] == MPI_UNDEFINED) ? -1 : shm_ranks[0];
+        m_shm_recv_rank[dir] = (shm_ranks[1] == MPI_UNDEFINED) ? -1 : shm_ranks[1];
+        m_shm_send_seq[dir] = 0;
+        m_shm_recv_seq[dir] = 0;
+        m_shm_recv_pending[dir] = false;
         }
+    MPI_Group_free(&group);
+    MPI_Group_free(&shm_group);
 
     for (unsigned int dir = 0; dir < 6; dir ++)
         {
@@ -1114,6 +1001,8 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
         m_copy_ghosts[dir].swap(copy_ghosts);
         m_num_copy_ghosts[dir] = 0;
         m_num_recv_ghosts[dir] = 0;
+        m_ghost_send_offset[dir] = 0;
+        m_ghost_recv_offset[dir] = 0;
         }
 
     // All buffers corresponding to sending ghosts in reverse
@@ -1235,6 +1124,9 @@ Communicator::~Communicator()
     m_sysdef->getConstraintData()->getGroupNumChangeSignal().disconnect<Communicator, &Communicator::setConstraintsChanged>(this);
     m_sysdef->getPairData()->getGroupNumChangeSignal().disconnect<Communicator, &Communicator::setPairsChanged>(this);
 
+    freePersistentRequests();
+    freeSharedGhostWindow();
+
     MPI_Type_free(&m_mpi_pdata_element);
     }
 
@@ -1331,11 +1223,15 @@ void Communicator::initializeNeighborArrays()
     }
 
 //! Interface to the communication methods.
-void Communicator::communicate(unsigned int timestep)
+void Communicator::communicate(unsigned int timestep, bool defer_ghosts)
     {
     // Guard to prevent recursive triggering of migration
     m_is_communicating = true;
 
+    // complete a deferred ghost update that nobody waited for
+    if (isGhostUpdatePending())
+        finishUpdateGhosts(timestep);
+
     // update ghost communication flags
     m_flags = CommFlags(0);
     m_requested_flags.emit_accumulate( [&](CommFlags f)
@@ -1371,12 +1267,21 @@ void Communicator::communicate(unsigned int timestep)
 
     bool migrate = migrate_request || m_force_migrate || !m_has_ghost_particles;
 
+    // with a ghost skin, the current ghosts may still contain all particles the neighbor list needs
+    if (migrate && m_ghost_skin > Scalar(0.0) && checkGhostSkin())
+        {
+        m_n_skipped_exchanges++;
+        migrate = false;
+        }
+
     // Update ghosts if we are not migrating
     if (!migrate && m_compute_callbacks.empty())
         {
         beginUpdateGhosts(timestep);
 
-        finishUpdateGhosts(timestep);
+        // with overlap enabled, the caller completes the update after computing the interior forces
+        if (! (defer_ghosts && m_ghost_overlap))
+            finishUpdateGhosts(timestep);
         }
 
     // Check if migration of particles is requested
@@ -1394,50 +1299,525 @@ void Communicator::communicate(unsigned int timestep)
         m_compute_callbacks.emit(timestep);
 
         m_has_ghost_particles = true;
+
+        if (m_ghost_skin > Scalar(0.0))
+            setGhostReferencePositions();
         }
 
     m_is_communicating = false;
     }
 
-//! Transfer particles between neighboring domains
-void Communicator::migrateParticles()
+/*! \param skin Width added to the ghost layer of every type (in distance units)
+*/
+void Communicator::setGhostSkin(Scalar skin)
     {
-    m_exec_conf->msg->notice(7) << "Communicator: migrate particles" << std::endl;
+    if (skin < Scalar(0.0))
+        {
+        m_exec_conf->msg->error() << "comm.ghost_skin: the skin must not be negative" << std::endl;
+        throw std::runtime_error("Error setting ghost skin");
+        }
 
-    updateGhostWidth();
+    if (skin > Scalar(0.0) && m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "comm.ghost_skin() is not supported on the GPU" << std::endl;
+        throw std::runtime_error("Error setting ghost skin");
+        }
 
-    // check if simulation box is sufficiently large for domain decomposition
-    checkBoxSize();
+    m_ghost_skin = skin;
 
-    if (m_prof)
-        m_prof->push("comm_migrate");
+    // select the ghosts with the new width, this also sets new reference positions
+    forceMigrate();
+    }
 
-    // remove ghost particles from system
-    m_pdata->removeAllGhostParticles();
+void Communicator::setGhostReferencePositions()
+    {
+    m_ghost_ref_pos.resize(m_pdata->getN());
 
-    // get box dimensions
-    const BoxDim& box = m_pdata->getBox();
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_ghost_ref_pos(m_ghost_ref_pos, access_location::host, access_mode::overwrite);
 
-    // determine local particles that are to be sent to neighboring processors and fill send buffer
-    for (unsigned int dir=0; dir < 6; dir++)
-        {
-        if (! isCommunicating(dir) ) continue;
+    for (unsigned int i = 0; i < m_pdata->getN(); ++i)
+        h_ghost_ref_pos.data[i] = h_pos.data[i];
 
-            {
-            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_comm_flag(m_pdata->getCommFlags(), access_location::host, access_mode::readwrite);
+    m_ghost_ref_box = m_pdata->getGlobalBox();
+    }
 
-            // mark all particles which have left the box for sending (rtag=NOT_LOCAL)
-            unsigned int N = m_pdata->getN();
+/*! A particle that was not sent as a ghost was more than the ghost width plus the skin away from the domain. Both
+    it and the local particles it may interact with move at most by the largest displacement since then, and local
+    particles are allowed to leave the domain until the next migration. The ghosts are therefore complete as long as
+    no particle has moved more than half the skin. Changes of the box or of the local particles (e.g. by sorting)
+    always require a new exchange.
 
-            for (unsigned int idx = 0; idx < N; ++idx)
-                {
-                const Scalar4& postype = h_pos.data[idx];
-                Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
-                Scalar3 f = box.makeFraction(pos);
+    This is a collective call. It returns the same result on all ranks.
+*/
+bool Communicator::checkGhostSkin()
+    {
+    if (m_prof) m_prof->push("comm_skin_check");
 
-                // return true if the particle stays leaves the box
-                unsigned int flags = 0;
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+    Scalar3 L = global_box.getL();
+    Scalar3 L_ref = m_ghost_ref_box.getL();
+
+    bool valid = ! m_force_migrate && m_has_ghost_particles
+        && m_ghost_ref_pos.size() == m_pdata->getN()
+        && L.x == L_ref.x && L.y == L_ref.y && L.z == L_ref.z
+        && global_box.getTiltFactorXY() == m_ghost_ref_box.getTiltFactorXY()
+        && global_box.getTiltFactorXZ() == m_ghost_ref_box.getTiltFactorXZ()
+        && global_box.getTiltFactorYZ() == m_ghost_ref_box.getTiltFactorYZ();
+
+    if (valid)
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_ghost_ref_pos(m_ghost_ref_pos, access_location::host, access_mode::read);
+
+        Scalar max_disp_sq = m_ghost_skin*m_ghost_skin/Scalar(4.0);
+        for (unsigned int i = 0; i < m_pdata->getN(); ++i)
+            {
+            Scalar3 dx = make_scalar3(h_pos.data[i].x - h_ghost_ref_pos.data[i].x,
+                                      h_pos.data[i].y - h_ghost_ref_pos.data[i].y,
+                                      h_pos.data[i].z - h_ghost_ref_pos.data[i].z);
+            dx = global_box.minImage(dx);
+
+            if (dot(dx, dx) > max_disp_sq)
+                {
+                valid = false;
+                break;
+                }
+            }
+        }
+
+    // the ghosts are only kept if they are valid on every rank
+    int local_valid = valid ? 1 : 0;
+    int global_valid = 0;
+    MPI_Allreduce(&local_valid, &global_valid, 1, MPI_INT, MPI_MIN, m_mpi_comm);
+
+    if (m_prof) m_prof->pop();
+
+    return global_valid > 0;
+    }
+
+/*! \param enable True if ghost updates should overlap with the computation of forces
+*/
+void Communicator::setGhostOverlap(bool enable)
+    {
+    if (enable && m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "comm.overlap_ghosts() is not supported on the GPU" << std::endl;
+        throw std::runtime_error("Error enabling ghost overlap");
+        }
+
+    m_ghost_overlap = enable;
+    }
+
+/*! \param enable True if ghost updates should use persistent requests
+*/
+void Communicator::setPersistentRequests(bool enable)
+    {
+    if (enable && m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "comm.persistent_requests() is not supported on the GPU" << std::endl;
+        throw std::runtime_error("Error enabling persistent requests");
+        }
+
+    if (isGhostUpdatePending())
+        finishUpdateGhosts(0);
+
+    if (! enable)
+        freePersistentRequests();
+
+    m_persistent_reqs = enable;
+    }
+
+/*! \param enable True if ghost updates to ranks on the same node should use shared memory
+*/
+void Communicator::setSharedMemoryGhosts(bool enable)
+    {
+    if (enable && m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "comm.shared_memory_ghosts() is not supported on the GPU" << std::endl;
+        throw std::runtime_error("Error enabling shared memory ghosts");
+        }
+
+    if (isGhostUpdatePending())
+        finishUpdateGhosts(0);
+
+    // the persistent requests only cover the messages to other nodes
+    m_ghost_reqs_valid = false;
+
+    m_shm_ghosts = enable;
+    if (enable)
+        allocateSharedGhostWindow();
+    else
+        freeSharedGhostWindow();
+    }
+
+/*! \param enable True if the ghost updates should be compressed
+    \param tolerance Maximum error of the ghost positions (in distance units)
+*/
+void Communicator::setGhostCompression(bool enable, Scalar tolerance)
+    {
+    if (enable && m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "comm.compress_ghosts() is not supported on the GPU" << std::endl;
+        throw std::runtime_error("Error enabling ghost compression");
+        }
+
+    if (isGhostUpdatePending())
+        finishUpdateGhosts(0);
+
+    // the persistent requests point to the buffers of the other precision
+    m_ghost_reqs_valid = false;
+
+    // keep the previous settings if the tolerance cannot be met
+    bool prev_enable = m_ghost_compression;
+    Scalar prev_tolerance = m_ghost_compression_tol;
+    m_ghost_compression = enable;
+    m_ghost_compression_tol = tolerance;
+
+    try
+        {
+        checkGhostCompression();
+        }
+    catch (...)
+        {
+        m_ghost_compression = prev_enable;
+        m_ghost_compression_tol = prev_tolerance;
+        throw;
+        }
+    }
+
+/*! Every fractional coordinate is rounded to the nearest fixed point value. The tilt factors add the errors of the
+    coordinates along the other box vectors.
+*/
+Scalar Communicator::getGhostCompressionError() const
+    {
+    const BoxDim& box = m_pdata->getGlobalBox();
+    Scalar3 L = box.getL();
+    Scalar xy = box.getTiltFactorXY();
+    Scalar xz = box.getTiltFactorXZ();
+    Scalar yz = box.getTiltFactorYZ();
+
+    Scalar h = Scalar(0.5/ghost_fixed_point_scale);
+    Scalar err_x = h*(L.x + fabs(xy)*L.y + fabs(xz)*L.z);
+    Scalar err_y = h*(L.y + fabs(yz)*L.z);
+    Scalar err_z = h*L.z;
+
+    return sqrt(err_x*err_x + err_y*err_y + err_z*err_z);
+    }
+
+void Communicator::checkGhostCompression()
+    {
+    if (! m_ghost_compression)
+        return;
+
+    Scalar err = getGhostCompressionError();
+    if (err > m_ghost_compression_tol)
+        {
+        m_exec_conf->msg->error() << "comm.compress_ghosts: the error of the ghost positions (" << err
+                                  << ") exceeds the tolerance (" << m_ghost_compression_tol << ") in this box"
+                                  << std::endl;
+        throw std::runtime_error("Error compressing ghost positions");
+        }
+    }
+
+/*! Every rank on the node owns one segment of the window, with the flags followed by its ghost send buffers. All
+    segments have the same layout, so that the neighbors can find the ghosts of a direction. The window only grows,
+    and is reallocated when a new ghost plan does not fit. This is a collective call on the ranks of the node.
+*/
+void Communicator::allocateSharedGhostWindow()
+    {
+    unsigned long n_ghosts = 0;
+    for (unsigned int dir = 0; dir < 6; dir++)
+        if (isCommunicating(dir))
+            n_ghosts = std::max(n_ghosts, (unsigned long) m_num_copy_ghosts[dir]);
+
+    unsigned long max_n_ghosts;
+    MPI_Allreduce(&n_ghosts, &max_n_ghosts, 1, MPI_UNSIGNED_LONG, MPI_MAX, m_shm_comm);
+
+    // all ranks on the node have completed their last ghost update, the window can be reallocated
+    if (m_shm_win != MPI_WIN_NULL && max_n_ghosts <= m_shm_capacity)
+        {
+        m_shm_valid = true;
+        return;
+        }
+
+    freeSharedGhostWindow();
+
+    m_exec_conf->msg->notice(7) << "Communicator: allocate shared memory window" << std::endl;
+
+    // leave room for the number of ghosts to grow, three fields per direction
+    m_shm_capacity = max_n_ghosts + max_n_ghosts/4 + 1;
+    MPI_Aint size = shm_header_size + 6*3*m_shm_capacity*sizeof(Scalar4);
+
+    char *base;
+    MPI_Win_allocate_shared(size, 1, MPI_INFO_NULL, m_shm_comm, &base, &m_shm_win);
+
+    // the flags are polled without RMA calls, which requires the unified memory model
+    int *model;
+    int flag;
+    MPI_Win_get_attr(m_shm_win, MPI_WIN_MODEL, &model, &flag);
+    if (! flag || *model != MPI_WIN_UNIFIED)
+        {
+        MPI_Win_free(&m_shm_win);
+        m_exec_conf->msg->error() << "comm.shared_memory_ghosts: the MPI library does not support the unified "
+                                  << "memory model for shared memory windows" << std::endl;
+        throw std::runtime_error("Error allocating shared memory window");
+        }
+
+    int n_shm_ranks;
+    MPI_Comm_size(m_shm_comm, &n_shm_ranks);
+    m_shm_base.resize(n_shm_ranks);
+    for (int i = 0; i < n_shm_ranks; i++)
+        {
+        MPI_Aint segment_size;
+        int disp_unit;
+        MPI_Win_shared_query(m_shm_win, i, &segment_size, &disp_unit, &m_shm_base[i]);
+        }
+
+    // a new window starts counting the updates from zero
+    volatile uint64_t *flags = getSharedGhostFlags(m_shm_rank);
+    for (unsigned int i = 0; i < shm_header_size/sizeof(uint64_t); i++)
+        flags[i] = 0;
+
+    for (unsigned int dir = 0; dir < 6; dir++)
+        {
+        m_shm_send_seq[dir] = 0;
+        m_shm_recv_seq[dir] = 0;
+        }
+
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, m_shm_win);
+    MPI_Win_sync(m_shm_win);
+
+    // no neighbor may read the flags before they are cleared
+    MPI_Barrier(m_shm_comm);
+
+    m_shm_valid = true;
+    }
+
+void Communicator::freeSharedGhostWindow()
+    {
+    if (m_shm_win != MPI_WIN_NULL)
+        {
+        MPI_Win_unlock_all(m_shm_win);
+        MPI_Win_free(&m_shm_win);
+        }
+
+    m_shm_base.clear();
+    m_shm_capacity = 0;
+    m_shm_valid = false;
+    }
+
+/*! The groups of all types are migrated together, with one message per neighbor and phase.
+*/
+void Communicator::migrateGroups(bool migrate)
+    {
+    // update the member ranks on the other ranks that own members of the groups (phase 1)
+    std::vector<group_buffer_t *> buffers;
+    m_bond_comm.prepareRankUpdate(m_bonds_changed, migrate, buffers);
+    m_pair_comm.prepareRankUpdate(m_pairs_changed, migrate, buffers);
+    m_angle_comm.prepareRankUpdate(m_angles_changed, migrate, buffers);
+    m_dihedral_comm.prepareRankUpdate(m_dihedrals_changed, migrate, buffers);
+    m_improper_comm.prepareRankUpdate(m_impropers_changed, migrate, buffers);
+    m_constraint_comm.prepareRankUpdate(m_constraints_changed, migrate, buffers);
+
+    exchangeGroupBuffers(buffers);
+
+    m_bond_comm.applyRankUpdate();
+    m_pair_comm.applyRankUpdate();
+    m_angle_comm.applyRankUpdate();
+    m_dihedral_comm.applyRankUpdate();
+    m_improper_comm.applyRankUpdate();
+    m_constraint_comm.applyRankUpdate();
+
+    // send the groups along with their migrating members (phase 2)
+    buffers.clear();
+    m_bond_comm.prepareGroupMigration(true, migrate, buffers);
+    m_pair_comm.prepareGroupMigration(true, migrate, buffers);
+    m_angle_comm.prepareGroupMigration(true, migrate, buffers);
+    m_dihedral_comm.prepareGroupMigration(true, migrate, buffers);
+    m_improper_comm.prepareGroupMigration(true, migrate, buffers);
+    m_constraint_comm.prepareGroupMigration(true, migrate, buffers);
+
+    exchangeGroupBuffers(buffers);
+
+    m_bond_comm.addMigratedGroups(true);
+    m_pair_comm.addMigratedGroups(true);
+    m_angle_comm.addMigratedGroups(true);
+    m_dihedral_comm.addMigratedGroups(true);
+    m_improper_comm.addMigratedGroups(true);
+    m_constraint_comm.addMigratedGroups(true);
+
+    m_bonds_changed = false;
+    m_pairs_changed = false;
+    m_angles_changed = false;
+    m_dihedrals_changed = false;
+    m_impropers_changed = false;
+    m_constraints_changed = false;
+    }
+
+/*! \param buffers The send buffers of the group types (input), and their receive buffers (output)
+*/
+void Communicator::exchangeGroupBuffers(const std::vector<group_buffer_t *>& buffers)
+    {
+    unsigned int n_types = buffers.size();
+    unsigned int n_neigh = m_n_unique_neigh;
+
+    if (! n_types)
+        return;
+
+    if (m_prof) m_prof->push("MPI send/recv");
+
+    ArrayHandle<unsigned int> h_unique_neighbors(m_unique_neighbors, access_location::host, access_mode::read);
+
+    // exchange the number of elements of all types with every neighbor
+    std::vector<unsigned int> n_send(n_neigh*n_types);
+    std::vector<unsigned int> n_recv(n_neigh*n_types);
+    for (unsigned int ineigh = 0; ineigh < n_neigh; ineigh++)
+        for (unsigned int t = 0; t < n_types; t++)
+            n_send[ineigh*n_types + t] = buffers[t]->n_send[ineigh];
+
+    std::vector<MPI_Request> reqs;
+    MPI_Request req;
+
+    for (unsigned int ineigh = 0; ineigh < n_neigh; ineigh++)
+        {
+        unsigned int neighbor = h_unique_neighbors.data[ineigh];
+
+        MPI_Isend(&n_send[ineigh*n_types], n_types, MPI_UNSIGNED, neighbor, 0, m_mpi_comm, &req);
+        reqs.push_back(req);
+        MPI_Irecv(&n_recv[ineigh*n_types], n_types, MPI_UNSIGNED, neighbor, 0, m_mpi_comm, &req);
+        reqs.push_back(req);
+        }
+
+    std::vector<MPI_Status> stats(reqs.size());
+    if (reqs.size())
+        MPI_Waitall(reqs.size(), &reqs.front(), &stats.front());
+
+    // the message for every neighbor holds the elements of all types, one type after the other
+    std::vector<size_t> send_offs(n_neigh+1, 0);
+    std::vector<size_t> recv_offs(n_neigh+1, 0);
+    std::vector<unsigned int> n_recv_tot(n_types, 0);
+    for (unsigned int ineigh = 0; ineigh < n_neigh; ineigh++)
+        {
+        size_t send_bytes = 0;
+        size_t recv_bytes = 0;
+        for (unsigned int t = 0; t < n_types; t++)
+            {
+            send_bytes += n_send[ineigh*n_types + t]*buffers[t]->element_size;
+            recv_bytes += n_recv[ineigh*n_types + t]*buffers[t]->element_size;
+            n_recv_tot[t] += n_recv[ineigh*n_types + t];
+            }
+        send_offs[ineigh+1] = send_offs[ineigh] + send_bytes;
+        recv_offs[ineigh+1] = recv_offs[ineigh] + recv_bytes;
+        }
+
+    m_group_sendbuf.resize(send_offs[n_neigh]);
+    m_group_recvbuf.resize(recv_offs[n_neigh]);
+
+    // pack the send buffers of all types
+    std::vector<size_t> type_offs(n_types, 0);
+    size_t offs = 0;
+    for (unsigned int ineigh = 0; ineigh < n_neigh; ineigh++)
+        for (unsigned int t = 0; t < n_types; t++)
+            {
+            size_t bytes = n_send[ineigh*n_types + t]*buffers[t]->element_size;
+            if (! bytes) continue;
+
+            const char *src = buffers[t]->send + type_offs[t];
+            std::copy(src, src + bytes, &m_group_sendbuf[offs]);
+            type_offs[t] += bytes;
+            offs += bytes;
+            }
+
+    // only exchange messages with neighbors that send or receive any elements
+    reqs.clear();
+    for (unsigned int ineigh = 0; ineigh < n_neigh; ineigh++)
+        {
+        unsigned int neighbor = h_unique_neighbors.data[ineigh];
+
+        size_t send_bytes = send_offs[ineigh+1] - send_offs[ineigh];
+        if (send_bytes)
+            {
+            MPI_Isend(&m_group_sendbuf[send_offs[ineigh]], send_bytes, MPI_BYTE, neighbor, 1, m_mpi_comm, &req);
+            reqs.push_back(req);
+            }
+
+        size_t recv_bytes = recv_offs[ineigh+1] - recv_offs[ineigh];
+        if (recv_bytes)
+            {
+            MPI_Irecv(&m_group_recvbuf[recv_offs[ineigh]], recv_bytes, MPI_BYTE, neighbor, 1, m_mpi_comm, &req);
+            reqs.push_back(req);
+            }
+        }
+
+    stats.resize(reqs.size());
+    if (reqs.size())
+        MPI_Waitall(reqs.size(), &reqs.front(), &stats.front());
+
+    // unpack into the receive buffers of all types, sorted by neighbor
+    for (unsigned int t = 0; t < n_types; t++)
+        {
+        buffers[t]->recv.resize(n_recv_tot[t]*buffers[t]->element_size);
+        type_offs[t] = 0;
+        }
+
+    offs = 0;
+    for (unsigned int ineigh = 0; ineigh < n_neigh; ineigh++)
+        for (unsigned int t = 0; t < n_types; t++)
+            {
+            size_t bytes = n_recv[ineigh*n_types + t]*buffers[t]->element_size;
+            if (! bytes) continue;
+
+            const char *src = &m_group_recvbuf[offs];
+            std::copy(src, src + bytes, &buffers[t]->recv[type_offs[t]]);
+            type_offs[t] += bytes;
+            offs += bytes;
+            }
+
+    if (m_prof) m_prof->pop(0, send_offs[n_neigh] + recv_offs[n_neigh] + 2*n_send.size()*sizeof(unsigned int));
+    }
+
+//! Transfer particles between neighboring domains
+void Communicator::migrateParticles()
+    {
+    m_exec_conf->msg->notice(7) << "Communicator: migrate particles" << std::endl;
+
+    updateGhostWidth();
+
+    // check if simulation box is sufficiently large for domain decomposition
+    checkBoxSize();
+
+    if (m_prof)
+        m_prof->push("comm_migrate");
+
+    // remove ghost particles from system
+    m_pdata->removeAllGhostParticles();
+
+    // get box dimensions
+    const BoxDim& box = m_pdata->getBox();
+
+    // determine local particles that are to be sent to neighboring processors and fill send buffer
+    for (unsigned int dir=0; dir < 6; dir++)
+        {
+        if (! isCommunicating(dir) ) continue;
+
+        unsigned int n_migrate = 0;
+
+            {
+            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_comm_flag(m_pdata->getCommFlags(), access_location::host, access_mode::readwrite);
+
+            // mark all particles which have left the box for sending (rtag=NOT_LOCAL)
+            unsigned int N = m_pdata->getN();
+
+            for (unsigned int idx = 0; idx < N; ++idx)
+                {
+                const Scalar4& postype = h_pos.data[idx];
+                Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
+                Scalar3 f = box.makeFraction(pos);
+
+                // return true if the particle stays leaves the box
+                unsigned int flags = 0;
                 if (dir == 0 && f.x >= Scalar(1.0)) flags |= send_east;
                 else if (dir == 1 && f.x < Scalar(0.0)) flags |= send_west;
                 else if (dir == 2 && f.y >= Scalar(1.0)) flags |= send_north;
@@ -1446,35 +1826,15 @@ void Communicator::migrateParticles()
                 else if (dir == 5 && f.z < Scalar(0.0)) flags |= send_down;
 
                 h_comm_flag.data[idx] = flags;
+                if (flags)
+                    n_migrate++;
                 }
             }
 
         /*
          * Bonded group communication, determine groups to be sent
          */
-        // Bonds
-        m_bond_comm.migrateGroups(m_bonds_changed, true);
-        m_bonds_changed = false;
-
-        // Special pairs
-        m_pair_comm.migrateGroups(m_pairs_changed, true);
-        m_pairs_changed = false;
-
-        // Angles
-        m_angle_comm.migrateGroups(m_angles_changed, true);
-        m_angles_changed = false;
-
-        // Dihedrals
-        m_dihedral_comm.migrateGroups(m_dihedrals_changed, true);
-        m_dihedrals_changed = false;
-
-        // Dihedrals
-        m_improper_comm.migrateGroups(m_impropers_changed, true);
-        m_impropers_changed = false;
-
-        // Constraints
-        m_constraint_comm.migrateGroups(m_constraints_changed, true);
-        m_constraints_changed = false;
+        migrateGroups(n_migrate > 0);
 
         // fill send buffer
         std::vector<unsigned int> comm_flag_out; // not currently used
@@ -1564,6 +1924,11 @@ void Communicator::updateGhostWidth()
                                                             if (r > r_ghost_i) r_ghost_i = r;
                                                             }
                                                             ,cur_type);
+
+            // widen the layer of the types that are communicated
+            if (r_ghost_i > Scalar(0.0))
+                r_ghost_i += m_ghost_skin;
+
             h_r_ghost.data[cur_type] = r_ghost_i;
             if (r_ghost_i > r_ghost_max) r_ghost_max = r_ghost_i;
             }
@@ -1602,6 +1967,12 @@ void Communicator::exchangeGhosts()
 
     m_exec_conf->msg->notice(7) << "Communicator: exchange ghosts" << std::endl;
 
+    // the ghost plan changes
+    m_ghost_reqs_valid = false;
+
+    // the box may have grown since the last check
+    checkGhostCompression();
+
     const BoxDim& box = m_pdata->getBox();
 
     // Sending ghosts proceeds in two stages:
@@ -2324,11 +2695,24 @@ void Communicator::exchangeGhosts()
         } // end dir loop
     }
 
+    // make room for the new ghost plan in shared memory
+    if (m_shm_ghosts)
+        allocateSharedGhostWindow();
+
     if (m_prof)
         m_prof->pop();
     }
 
 //! update positions of ghost particles
+/*! The update is carried out one dimension at a time, since ghosts received in one dimension may be forwarded in
+    the next one. The two directions of a dimension are sent together. They never forward each other's ghosts,
+    because a domain is at least twice as wide as the ghost layer.
+
+    This method packs the ghosts of the local particles for all directions and posts the messages of the first
+    dimension. The ghosts are received into communicator buffers, so progressUpdateGhosts() can forward them and start
+    the following dimensions without accessing the particle data. finishUpdateGhosts() copies them into the particle
+    data.
+*/
 void Communicator::beginUpdateGhosts(unsigned int timestep)
     {
     // we have a current m_copy_ghosts liss which contain the indices of particles
@@ -2338,168 +2722,706 @@ void Communicator::beginUpdateGhosts(unsigned int timestep)
 
     m_exec_conf->msg->notice(7) << "Communicator: update ghosts" << std::endl;
 
-    // update data in these arrays
+    m_comm_pending = true;
+    m_ghost_update_pending = true;
+    m_ghost_update_bytes = 0;
 
-    unsigned int num_tot_recv_ghosts = 0; // total number of ghosts received
+    CommFlags flags = getFlags();
 
-    for (unsigned int dir = 0; dir < 6; dir ++)
+    // every direction has its own range in the send and receive buffers
+    unsigned int n_tot_copy_ghosts = 0;
+    m_num_tot_recv_ghosts = 0;
+    for (unsigned int dir = 0; dir < 6; dir++)
         {
-        if (! isCommunicating(dir) ) continue;
+        m_ghost_send_offset[dir] = n_tot_copy_ghosts;
+        m_ghost_recv_offset[dir] = m_num_tot_recv_ghosts;
+        if (! isCommunicating(dir)) continue;
 
-        CommFlags flags = getFlags();
+        n_tot_copy_ghosts += m_num_copy_ghosts[dir];
+        m_num_tot_recv_ghosts += m_num_recv_ghosts[dir];
+        }
 
-        if (flags[comm_flag::position])
-            {
-            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
-            ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::overwrite);
-            ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    if (flags[comm_flag::position])
+        {
+        m_pos_copybuf.resize(n_tot_copy_ghosts);
+        m_pos_recvbuf.resize(m_num_tot_recv_ghosts);
+        }
+    if (flags[comm_flag::velocity])
+        {
+        m_velocity_copybuf.resize(n_tot_copy_ghosts);
+        m_velocity_recvbuf.resize(m_num_tot_recv_ghosts);
+        }
+    if (flags[comm_flag::orientation])
+        {
+        m_orientation_copybuf.resize(n_tot_copy_ghosts);
+        m_orientation_recvbuf.resize(m_num_tot_recv_ghosts);
+        }
 
-            // copy positions of ghost particles
-            for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
-                {
-                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+    unsigned int N = m_pdata->getN();
 
-                assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
+    if (m_ghost_compression)
+        {
+        // size the buffers for the reduced precision fields
+        m_pos_compressed_copybuf.resize(n_tot_copy_ghosts);
+        m_velocity_compressed_copybuf.resize(n_tot_copy_ghosts);
+        m_pos_compressed_recvbuf.resize(m_num_tot_recv_ghosts);
+        m_velocity_compressed_recvbuf.resize(m_num_tot_recv_ghosts);
 
-                // copy position into send buffer
-                h_pos_copybuf.data[ghost_idx] = h_pos.data[idx];
-                }
+        // the types and masses are not sent in reduced precision, start from the current ones
+        if (flags[comm_flag::position])
+            {
+            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_pos_recvbuf(m_pos_recvbuf, access_location::host, access_mode::overwrite);
+            std::copy(h_pos.data + N, h_pos.data + N + m_num_tot_recv_ghosts, h_pos_recvbuf.data);
             }
-
         if (flags[comm_flag::velocity])
             {
             ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
-            ArrayHandle<Scalar4> h_velocity_copybuf(m_velocity_copybuf, access_location::host, access_mode::overwrite);
-            ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
-
-            // copy velocity of ghost particles
-            for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
-                {
-                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
-
-                assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
-
-                // copy velocity into send buffer
-                h_velocity_copybuf.data[ghost_idx] = h_vel.data[idx];
-                }
+            ArrayHandle<Scalar4> h_velocity_recvbuf(m_velocity_recvbuf, access_location::host, access_mode::overwrite);
+            std::copy(h_vel.data + N, h_vel.data + N + m_num_tot_recv_ghosts, h_velocity_recvbuf.data);
             }
+        }
 
-        if (flags[comm_flag::orientation])
+        {
+        // sort the ghosts to send into local particles, packed now, and ghosts forwarded from the receive buffers
+        ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+
+        for (unsigned int dir = 0; dir < 6; dir++)
             {
-            ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
-            ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::overwrite);
-            ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+            m_ghost_local[dir].clear();
+            m_ghost_forward[dir].clear();
+            if (! isCommunicating(dir)) continue;
 
-            // copy orientation of ghost particles
+            ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
             for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
                 {
                 unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
 
-                assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
+                assert(idx < N + m_pdata->getNGhosts());
 
-                // copy orientation into send buffer
-                h_orientation_copybuf.data[ghost_idx] = h_orientation.data[idx];
+                if (idx < N)
+                    {
+                    m_ghost_local[dir].push_back(make_uint2(ghost_idx, idx));
+                    }
+                else
+                    {
+                    // only ghosts received in a previous dimension are forwarded
+                    assert(idx - N < m_ghost_recv_offset[dir - dir % 2]);
+                    m_ghost_forward[dir].push_back(make_uint2(ghost_idx, idx - N));
+                    }
                 }
             }
+        }
 
+    // ghosts for a neighbor on the same node are packed directly into shared memory, once it has read the last ones
+    for (unsigned int dir = 0; dir < 6; dir++)
+        {
+        if (! isCommunicating(dir) || ! isSharedGhostSend(dir)) continue;
 
-        unsigned int send_neighbor = m_decomposition->getNeighborRank(dir);
-
-        // we receive from the direction opposite to the one we send to
-        unsigned int recv_neighbor;
-        if (dir % 2 == 0)
-            recv_neighbor = m_decomposition->getNeighborRank(dir+1);
-        else
-            recv_neighbor = m_decomposition->getNeighborRank(dir-1);
+        volatile uint64_t *neighbor_flags = getSharedGhostFlags(m_shm_send_rank[dir]);
+        do
+            {
+            MPI_Win_sync(m_shm_win);
+            } while (neighbor_flags[6+dir] < m_shm_send_seq[dir]);
+        }
 
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
 
-        unsigned int start_idx;
+        for (unsigned int dir = 0; dir < 6; dir++)
+            {
+            if (! isCommunicating(dir)) continue;
+            packGhostUpdate(dir, m_ghost_local[dir], h_pos.data, h_vel.data, h_orientation.data);
+            }
+        }
 
-        if (m_prof)
-            m_prof->push("MPI send/recv");
+    if (m_persistent_reqs)
+        updatePersistentRequests();
 
-        start_idx = m_pdata->getN() + num_tot_recv_ghosts;
+    startGhostUpdateStage(0);
 
-        num_tot_recv_ghosts += m_num_recv_ghosts[dir];
+    if (m_prof)
+        m_prof->pop();
+    }
+
+/*! \param dir Direction of the ghost update
+    \param ghosts Index in the send buffer of direction \a dir and index in \a pos, \a vel and \a orientation of every
+           ghost to pack
+    \param pos Positions to pack from
+    \param vel Velocities to pack from
+    \param orientation Orientations to pack from
+*/
+void Communicator::packGhostUpdate(unsigned int dir, const std::vector<uint2>& ghosts, const Scalar4 *pos,
+    const Scalar4 *vel, const Scalar4 *orientation)
+    {
+    CommFlags flags = getFlags();
+
+    bool shm_send = isSharedGhostSend(dir);
+    bool compress_send = isCompressedGhostSend(dir);
+    unsigned int offset = m_ghost_send_offset[dir];
+
+    if (flags[comm_flag::position] && compress_send)
+        {
+        ArrayHandle<int3> h_pos_copybuf(m_pos_compressed_copybuf, access_location::host, access_mode::readwrite);
+
+        const BoxDim& box = m_pdata->getGlobalBox();
+
+        // convert positions of ghost particles to fixed point fractions of the global box, the type is not sent
+        for (unsigned int i = 0; i < ghosts.size(); i++)
+            {
+            const Scalar4& postype = pos[ghosts[i].y];
+            Scalar3 f = box.makeFraction(make_scalar3(postype.x, postype.y, postype.z));
+            h_pos_copybuf.data[offset + ghosts[i].x] = make_int3(encodeGhostFraction(f.x),
+                                                                 encodeGhostFraction(f.y),
+                                                                 encodeGhostFraction(f.z));
+            }
+        }
+    else if (flags[comm_flag::position])
+        {
+        ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::readwrite);
+        Scalar4 *pos_buf = shm_send ? getSharedGhostBuffer(m_shm_rank, dir, 0) : h_pos_copybuf.data + offset;
+
+        // copy positions of ghost particles
+        for (unsigned int i = 0; i < ghosts.size(); i++)
+            pos_buf[ghosts[i].x] = pos[ghosts[i].y];
+        }
+
+    if (flags[comm_flag::velocity] && compress_send)
+        {
+        ArrayHandle<float3> h_velocity_copybuf(m_velocity_compressed_copybuf, access_location::host, access_mode::readwrite);
+
+        // convert velocities of ghost particles to single precision, the mass is not sent
+        for (unsigned int i = 0; i < ghosts.size(); i++)
+            {
+            const Scalar4& v = vel[ghosts[i].y];
+            h_velocity_copybuf.data[offset + ghosts[i].x] = make_float3(float(v.x), float(v.y), float(v.z));
+            }
+        }
+    else if (flags[comm_flag::velocity])
+        {
+        ArrayHandle<Scalar4> h_velocity_copybuf(m_velocity_copybuf, access_location::host, access_mode::readwrite);
+        Scalar4 *velocity_buf = shm_send ? getSharedGhostBuffer(m_shm_rank, dir, 1) : h_velocity_copybuf.data + offset;
+
+        // copy velocity of ghost particles
+        for (unsigned int i = 0; i < ghosts.size(); i++)
+            velocity_buf[ghosts[i].x] = vel[ghosts[i].y];
+        }
+
+    if (flags[comm_flag::orientation])
+        {
+        ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::readwrite);
+        Scalar4 *orientation_buf = shm_send ? getSharedGhostBuffer(m_shm_rank, dir, 2)
+                                            : h_orientation_copybuf.data + offset;
+
+        // copy orientation of ghost particles
+        for (unsigned int i = 0; i < ghosts.size(); i++)
+            orientation_buf[ghosts[i].x] = orientation[ghosts[i].y];
+        }
+    }
+
+/*! \param stage First dimension to consider
+
+    Copies the ghosts forwarded in both directions of the first communicating dimension >= \a stage from the receive
+    buffers into the send buffers, and posts the non-blocking sends and receives, or starts the persistent requests.
+    If no dimension is left, all messages of the update have completed. Only communicator buffers are accessed.
+*/
+void Communicator::startGhostUpdateStage(unsigned int stage)
+    {
+    while (stage < 3 && ! isCommunicating(2*stage) && ! isCommunicating(2*stage+1))
+        stage++;
+
+    m_ghost_update_stage = stage;
+
+    if (stage == 3)
+        return;
+
+    CommFlags flags = getFlags();
+
+    for (unsigned int dir = 2*stage; dir < 2*stage+2; dir++)
+        {
+        m_shm_recv_pending[dir] = false;
+        if (! isCommunicating(dir)) continue;
+
+        if (m_ghost_forward[dir].size())
+            {
+            ArrayHandle<Scalar4> h_pos_recvbuf(m_pos_recvbuf, access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_velocity_recvbuf(m_velocity_recvbuf, access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_orientation_recvbuf(m_orientation_recvbuf, access_location::host, access_mode::read);
+            packGhostUpdate(dir, m_ghost_forward[dir], h_pos_recvbuf.data, h_velocity_recvbuf.data,
+                h_orientation_recvbuf.data);
+            }
+
+        if (isSharedGhostSend(dir))
+            {
+            // publish the ghosts to the neighbor
+            MPI_Win_sync(m_shm_win);
+            getSharedGhostFlags(m_shm_rank)[dir] = ++m_shm_send_seq[dir];
+            }
+        m_shm_recv_pending[dir] = isSharedGhostRecv(dir);
+
+        if (m_persistent_reqs)
+            {
+            std::vector<MPI_Request>& reqs = m_ghost_reqs[dir];
+            if (reqs.size())
+                MPI_Startall(reqs.size(), &reqs.front());
+            }
+        else
+            {
+            initGhostUpdateRequests(dir, false, m_ghost_update_reqs[dir]);
+            }
 
-        size_t sz = 0;
         // only non-permanent fields (position, velocity, orientation) need to be considered here
         // charge, body, image and diameter are not updated between neighbor list builds
+        bool compress_send = isCompressedGhostSend(dir);
+        bool compress_recv = isCompressedGhostRecv(dir);
+        size_t send_sz = 0;
+        size_t recv_sz = 0;
         if (flags[comm_flag::position])
             {
-            m_reqs.resize(2);
-            m_stats.resize(2);
+            send_sz += compress_send ? sizeof(int3) : sizeof(Scalar4);
+            recv_sz += compress_recv ? sizeof(int3) : sizeof(Scalar4);
+            }
+        if (flags[comm_flag::velocity])
+            {
+            send_sz += compress_send ? sizeof(float3) : sizeof(Scalar4);
+            recv_sz += compress_recv ? sizeof(float3) : sizeof(Scalar4);
+            }
+        if (flags[comm_flag::orientation])
+            {
+            send_sz += sizeof(Scalar4);
+            recv_sz += sizeof(Scalar4);
+            }
 
-            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
-            ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::read);
+        m_ghost_update_bytes += m_num_recv_ghosts[dir]*recv_sz + m_num_copy_ghosts[dir]*send_sz;
+        m_ghost_traffic[m_neighbor_distance[dir]] += m_num_copy_ghosts[dir]*send_sz;
+        }
+    }
 
-            // exchange particle data, write directly to the particle data arrays
-            MPI_Isend(h_pos_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 1, m_mpi_comm, &m_reqs[0]);
-            MPI_Irecv(h_pos.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 1, m_mpi_comm, &m_reqs[1]);
-            MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
+/*! \param wait If true, block until the messages have completed
+    \returns true if all messages of the dimension in flight have completed
+*/
+bool Communicator::testGhostUpdateStage(bool wait)
+    {
+    bool done = true;
+    unsigned int stage = m_ghost_update_stage;
+    assert(stage < 3);
 
-            sz += sizeof(Scalar4);
-            }
+    for (unsigned int dir = 2*stage; dir < 2*stage+2; dir++)
+        {
+        if (! isCommunicating(dir)) continue;
 
-        if (flags[comm_flag::velocity])
+        std::vector<MPI_Request>& reqs = getGhostUpdateRequests(dir);
+        if (reqs.size())
             {
-            m_reqs.resize(2);
-            m_stats.resize(2);
+            m_stats.resize(reqs.size());
+            if (wait)
+                {
+                MPI_Waitall(reqs.size(), &reqs.front(), &m_stats.front());
+                }
+            else
+                {
+                int flag;
+                MPI_Testall(reqs.size(), &reqs.front(), &flag, &m_stats.front());
+                done = done && flag;
+                }
+            }
+        }
 
-            ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
-            ArrayHandle<Scalar4> h_vel_copybuf(m_velocity_copybuf, access_location::host, access_mode::read);
+    for (unsigned int dir = 2*stage; dir < 2*stage+2; dir++)
+        {
+        if (! receiveSharedGhosts(dir, wait))
+            done = false;
+        }
 
-            // exchange particle data, write directly to the particle data arrays
-            MPI_Isend(h_vel_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 2, m_mpi_comm, &m_reqs[0]);
-            MPI_Irecv(h_vel.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 2, m_mpi_comm, &m_reqs[1]);
-            MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
+    return done;
+    }
 
-            sz += sizeof(Scalar4);
+/*! \param dir Direction of the ghost update
+    \param wait If true, wait until the receive neighbor has published the ghosts
+    \returns true if the ghosts of direction \a dir have been received
+
+    Copies the ghosts from the window segment of the receive neighbor into the receive buffers, and signals the
+    neighbor that its send buffer may be reused.
+*/
+bool Communicator::receiveSharedGhosts(unsigned int dir, bool wait)
+    {
+    if (! m_shm_recv_pending[dir])
+        return true;
+
+    int neighbor = m_shm_recv_rank[dir];
+    uint64_t seq = m_shm_recv_seq[dir] + 1;
+
+    volatile uint64_t *neighbor_flags = getSharedGhostFlags(neighbor);
+    while (true)
+        {
+        MPI_Win_sync(m_shm_win);
+        if (neighbor_flags[dir] >= seq)
+            break;
+        if (! wait)
+            return false;
+        }
+
+    CommFlags flags = getFlags();
+    unsigned int offset = m_ghost_recv_offset[dir];
+    unsigned int n = m_num_recv_ghosts[dir];
+
+    if (flags[comm_flag::position])
+        {
+        ArrayHandle<Scalar4> h_pos_recvbuf(m_pos_recvbuf, access_location::host, access_mode::readwrite);
+        const Scalar4 *buf = getSharedGhostBuffer(neighbor, dir, 0);
+        std::copy(buf, buf + n, h_pos_recvbuf.data + offset);
+        }
+
+    if (flags[comm_flag::velocity])
+        {
+        ArrayHandle<Scalar4> h_velocity_recvbuf(m_velocity_recvbuf, access_location::host, access_mode::readwrite);
+        const Scalar4 *buf = getSharedGhostBuffer(neighbor, dir, 1);
+        std::copy(buf, buf + n, h_velocity_recvbuf.data + offset);
+        }
+
+    if (flags[comm_flag::orientation])
+        {
+        ArrayHandle<Scalar4> h_orientation_recvbuf(m_orientation_recvbuf, access_location::host, access_mode::readwrite);
+        const Scalar4 *buf = getSharedGhostBuffer(neighbor, dir, 2);
+        std::copy(buf, buf + n, h_orientation_recvbuf.data + offset);
+        }
+
+    // the neighbor may overwrite its buffer after this
+    MPI_Win_sync(m_shm_win);
+    getSharedGhostFlags(m_shm_rank)[6+dir] = seq;
+    m_shm_recv_seq[dir] = seq;
+    m_shm_recv_pending[dir] = false;
+
+    return true;
+    }
+
+std::vector<double> Communicator::getGhostTraffic()
+    {
+    std::vector<double> local(DomainDecomposition::n_topology_distances);
+    for (unsigned int d = 0; d < local.size(); ++d)
+        local[d] = double(m_ghost_traffic[d]);
+
+    std::vector<double> total(local.size());
+    MPI_Allreduce(&local[0], &total[0], local.size(), MPI_DOUBLE, MPI_SUM, m_mpi_comm);
+    return total;
+    }
+
+/*! \param dir Direction of the ghost update
+    \param persistent If true, set up persistent requests that are started later, otherwise start the messages
+    \param reqs The requests (output)
+*/
+void Communicator::initGhostUpdateRequests(unsigned int dir, bool persistent, std::vector<MPI_Request>& reqs)
+    {
+    CommFlags flags = getFlags();
+
+    unsigned int send_neighbor = m_decomposition->getNeighborRank(dir);
+
+    // we receive from the direction opposite to the one we send to
+    unsigned int recv_neighbor;
+    if (dir % 2 == 0)
+        recv_neighbor = m_decomposition->getNeighborRank(dir+1);
+    else
+        recv_neighbor = m_decomposition->getNeighborRank(dir-1);
+
+    reqs.clear();
+
+    // neighbors on the same node exchange the ghosts through shared memory instead
+    bool shm_send = isSharedGhostSend(dir);
+    bool shm_recv = isSharedGhostRecv(dir);
+
+    bool compress_send = isCompressedGhostSend(dir);
+    bool compress_recv = isCompressedGhostRecv(dir);
+
+    // both directions of a dimension are in flight at the same time, and may have the same neighbor
+    int tag_offset = (dir % 2 == 0) ? 0 : 3;
+
+    // post one message to the send neighbor and one from the receive neighbor
+    auto post = [&](void *send_buf, size_t send_size, void *recv_buf, size_t recv_size, int tag)
+        {
+        MPI_Request req;
+        if (! shm_send)
+            {
+            if (persistent)
+                MPI_Send_init(send_buf, m_num_copy_ghosts[dir]*send_size, MPI_BYTE, send_neighbor, tag, m_mpi_comm, &req);
+            else
+                MPI_Isend(send_buf, m_num_copy_ghosts[dir]*send_size, MPI_BYTE, send_neighbor, tag, m_mpi_comm, &req);
+            reqs.push_back(req);
             }
 
-        if (flags[comm_flag::orientation])
+        if (! shm_recv)
             {
-            m_reqs.resize(2);
-            m_stats.resize(2);
+            if (persistent)
+                MPI_Recv_init(recv_buf, m_num_recv_ghosts[dir]*recv_size, MPI_BYTE, recv_neighbor, tag, m_mpi_comm, &req);
+            else
+                MPI_Irecv(recv_buf, m_num_recv_ghosts[dir]*recv_size, MPI_BYTE, recv_neighbor, tag, m_mpi_comm, &req);
+            reqs.push_back(req);
+            }
+        };
 
-            ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
-            ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::read);
+    // exchange particle data between the communicator buffers, finishUpdateGhosts() copies it into the particle data
+    // the host pointers stay valid while the requests are in use, because the buffers are not resized in between
+    // compressed ghosts are received into separate buffers, and converted by finishGhostUpdateStage()
+    unsigned int send_offset = m_ghost_send_offset[dir];
+    unsigned int recv_offset = m_ghost_recv_offset[dir];
 
-            // exchange particle data, write directly to the particle data arrays
-            MPI_Isend(h_orientation_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 3, m_mpi_comm, &m_reqs[0]);
-            MPI_Irecv(h_orientation.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 3, m_mpi_comm, &m_reqs[1]);
-            MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
+    if (flags[comm_flag::position])
+        {
+        ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_pos_recvbuf(m_pos_recvbuf, access_location::host, access_mode::readwrite);
+        ArrayHandle<int3> h_pos_compressed_copybuf(m_pos_compressed_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<int3> h_pos_compressed_recvbuf(m_pos_compressed_recvbuf, access_location::host, access_mode::readwrite);
+        post(compress_send ? (void *) (h_pos_compressed_copybuf.data + send_offset)
+                           : (void *) (h_pos_copybuf.data + send_offset),
+             compress_send ? sizeof(int3) : sizeof(Scalar4),
+             compress_recv ? (void *) (h_pos_compressed_recvbuf.data + recv_offset)
+                           : (void *) (h_pos_recvbuf.data + recv_offset),
+             compress_recv ? sizeof(int3) : sizeof(Scalar4),
+             1 + tag_offset);
+        }
 
-            sz += sizeof(Scalar4);
-            }
+    if (flags[comm_flag::velocity])
+        {
+        ArrayHandle<Scalar4> h_vel_copybuf(m_velocity_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_vel_recvbuf(m_velocity_recvbuf, access_location::host, access_mode::readwrite);
+        ArrayHandle<float3> h_vel_compressed_copybuf(m_velocity_compressed_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<float3> h_vel_compressed_recvbuf(m_velocity_compressed_recvbuf, access_location::host, access_mode::readwrite);
+        post(compress_send ? (void *) (h_vel_compressed_copybuf.data + send_offset)
+                           : (void *) (h_vel_copybuf.data + send_offset),
+             compress_send ? sizeof(float3) : sizeof(Scalar4),
+             compress_recv ? (void *) (h_vel_compressed_recvbuf.data + recv_offset)
+                           : (void *) (h_vel_recvbuf.data + recv_offset),
+             compress_recv ? sizeof(float3) : sizeof(Scalar4),
+             2 + tag_offset);
+        }
 
-        if (m_prof)
-            m_prof->pop(0, (m_num_recv_ghosts[dir]+m_num_copy_ghosts[dir])*sz);
+    if (flags[comm_flag::orientation])
+        {
+        ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation_recvbuf(m_orientation_recvbuf, access_location::host, access_mode::readwrite);
+        post(h_orientation_copybuf.data + send_offset, sizeof(Scalar4),
+             h_orientation_recvbuf.data + recv_offset, sizeof(Scalar4),
+             3 + tag_offset);
+        }
+    }
+
+/*! The persistent requests encode the buffer addresses, so they are also set up again when a buffer has been
+    reallocated since.
+*/
+std::vector<const void *> Communicator::getGhostUpdateBuffers()
+    {
+    std::vector<const void *> buffers;
+        {
+        ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_pos_recvbuf(m_pos_recvbuf, access_location::host, access_mode::read);
+        buffers.push_back(h_pos_copybuf.data);
+        buffers.push_back(h_pos_recvbuf.data);
+        }
+        {
+        ArrayHandle<Scalar4> h_vel_copybuf(m_velocity_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_vel_recvbuf(m_velocity_recvbuf, access_location::host, access_mode::read);
+        buffers.push_back(h_vel_copybuf.data);
+        buffers.push_back(h_vel_recvbuf.data);
+        }
+        {
+        ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation_recvbuf(m_orientation_recvbuf, access_location::host, access_mode::read);
+        buffers.push_back(h_orientation_copybuf.data);
+        buffers.push_back(h_orientation_recvbuf.data);
+        }
+        {
+        ArrayHandle<int3> h_pos_compressed_copybuf(m_pos_compressed_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<int3> h_pos_compressed_recvbuf(m_pos_compressed_recvbuf, access_location::host, access_mode::read);
+        ArrayHandle<float3> h_vel_compressed_copybuf(m_velocity_compressed_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<float3> h_vel_compressed_recvbuf(m_velocity_compressed_recvbuf, access_location::host, access_mode::read);
+        buffers.push_back(h_pos_compressed_copybuf.data);
+        buffers.push_back(h_pos_compressed_recvbuf.data);
+        buffers.push_back(h_vel_compressed_copybuf.data);
+        buffers.push_back(h_vel_compressed_recvbuf.data);
+        }
+    return buffers;
+    }
+
+void Communicator::updatePersistentRequests()
+    {
+    CommFlags flags = getFlags();
+    std::vector<const void *> buffers = getGhostUpdateBuffers();
 
+    if (m_ghost_reqs_valid && flags == m_ghost_reqs_flags && buffers == m_ghost_reqs_buffers)
+        return;
+
+    m_exec_conf->msg->notice(7) << "Communicator: set up persistent requests" << std::endl;
+
+    freePersistentRequests();
+
+    for (unsigned int dir = 0; dir < 6; dir++)
+        {
+        if (! isCommunicating(dir)) continue;
+
+        initGhostUpdateRequests(dir, true, m_ghost_reqs[dir]);
+        }
+
+    m_ghost_reqs_flags = flags;
+    m_ghost_reqs_buffers = buffers;
+    m_ghost_reqs_valid = true;
+    }
 
-        // wrap particle positions (only if copying positions)
+void Communicator::freePersistentRequests()
+    {
+    for (unsigned int dir = 0; dir < 6; dir++)
+        {
+        for (unsigned int i = 0; i < m_ghost_reqs[dir].size(); i++)
+            MPI_Request_free(&m_ghost_reqs[dir][i]);
+        m_ghost_reqs[dir].clear();
+        }
+
+    m_ghost_reqs_valid = false;
+    }
+
+/*! Called when all messages of the current dimension have completed. Converts the compressed ghosts and wraps the
+    positions in the receive buffers, then starts the next dimension.
+*/
+void Communicator::finishGhostUpdateStage()
+    {
+    unsigned int stage = m_ghost_update_stage;
+    assert(stage < 3);
+
+    CommFlags flags = getFlags();
+
+    for (unsigned int dir = 2*stage; dir < 2*stage+2; dir++)
+        {
+        if (! isCommunicating(dir)) continue;
+
+        unsigned int offset = m_ghost_recv_offset[dir];
+        unsigned int n = m_num_recv_ghosts[dir];
+
+        if (isCompressedGhostRecv(dir))
+            {
+            if (flags[comm_flag::position])
+                {
+                ArrayHandle<Scalar4> h_pos_recvbuf(m_pos_recvbuf, access_location::host, access_mode::readwrite);
+                ArrayHandle<int3> h_pos_compressed_recvbuf(m_pos_compressed_recvbuf, access_location::host, access_mode::read);
+
+                // reconstruct the positions from the fixed point fractions, keeping the types
+                const BoxDim& box = m_pdata->getGlobalBox();
+                for (unsigned int i = offset; i < offset + n; i++)
+                    {
+                    int3 q = h_pos_compressed_recvbuf.data[i];
+                    Scalar3 pos = box.makeCoordinates(make_scalar3(decodeGhostFraction(q.x),
+                                                                   decodeGhostFraction(q.y),
+                                                                   decodeGhostFraction(q.z)));
+                    Scalar4& postype = h_pos_recvbuf.data[i];
+                    postype.x = pos.x;
+                    postype.y = pos.y;
+                    postype.z = pos.z;
+                    }
+                }
+
+            if (flags[comm_flag::velocity])
+                {
+                ArrayHandle<Scalar4> h_vel_recvbuf(m_velocity_recvbuf, access_location::host, access_mode::readwrite);
+                ArrayHandle<float3> h_vel_compressed_recvbuf(m_velocity_compressed_recvbuf, access_location::host, access_mode::read);
+
+                // keep the masses
+                for (unsigned int i = offset; i < offset + n; i++)
+                    {
+                    float3 v = h_vel_compressed_recvbuf.data[i];
+                    Scalar4& vel = h_vel_recvbuf.data[i];
+                    vel.x = v.x;
+                    vel.y = v.y;
+                    vel.z = v.z;
+                    }
+                }
+            }
+
+        // wrap particle positions (only if copying positions), before they are forwarded
         if (flags[comm_flag::position])
             {
-            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+            ArrayHandle<Scalar4> h_pos_recvbuf(m_pos_recvbuf, access_location::host, access_mode::readwrite);
 
             const BoxDim shifted_box = getShiftedBox();
-            for (unsigned int idx = start_idx; idx < start_idx + m_num_recv_ghosts[dir]; idx++)
+            for (unsigned int i = offset; i < offset + n; i++)
                 {
-                Scalar4& pos = h_pos.data[idx];
-
                 // wrap particles received across a global boundary
                 int3 img = make_int3(0,0,0);
-                shifted_box.wrap(pos, img);
+                shifted_box.wrap(h_pos_recvbuf.data[i], img);
                 }
             }
+        }
 
-        } // end dir loop
+    startGhostUpdateStage(stage+1);
+    }
 
-        if (m_prof)
-            m_prof->pop();
+/*! Tests the messages of the dimension in flight, which lets the MPI library progress the transfer. Once they have
+    completed, the ghosts of the next dimension are packed and sent right away. Only communicator buffers are accessed,
+    so the caller may hold ArrayHandles to the particle data while it computes.
+*/
+bool Communicator::progressUpdateGhosts()
+    {
+    while (m_ghost_update_stage < 3)
+        {
+        if (! testGhostUpdateStage(false))
+            return false;
+
+        finishGhostUpdateStage();
+        }
+
+    return true;
+    }
+
+/*! Waits for the remaining dimensions of the ghost update started by beginUpdateGhosts(), and copies the received
+    ghosts into the particle data.
+*/
+void Communicator::finishUpdateGhosts(unsigned int timestep)
+    {
+    if (! m_ghost_update_pending)
+        return;
+
+    if (m_prof)
+        m_prof->push("comm_ghost_update");
+
+    if (m_prof)
+        m_prof->push("MPI send/recv");
+
+    while (m_ghost_update_stage < 3)
+        {
+        testGhostUpdateStage(true);
+        finishGhostUpdateStage();
+        }
+
+    if (m_prof)
+        m_prof->pop(0, m_ghost_update_bytes);
+
+    CommFlags flags = getFlags();
+    unsigned int N = m_pdata->getN();
+
+    if (flags[comm_flag::position])
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_pos_recvbuf(m_pos_recvbuf, access_location::host, access_mode::read);
+        std::copy(h_pos_recvbuf.data, h_pos_recvbuf.data + m_num_tot_recv_ghosts, h_pos.data + N);
+        }
+
+    if (flags[comm_flag::velocity])
+        {
+        ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_vel_recvbuf(m_velocity_recvbuf, access_location::host, access_mode::read);
+        std::copy(h_vel_recvbuf.data, h_vel_recvbuf.data + m_num_tot_recv_ghosts, h_vel.data + N);
+        }
+
+    if (flags[comm_flag::orientation])
+        {
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_orientation_recvbuf(m_orientation_recvbuf, access_location::host, access_mode::read);
+        std::copy(h_orientation_recvbuf.data, h_orientation_recvbuf.data + m_num_tot_recv_ghosts, h_orientation.data + N);
+        }
+
+    m_ghost_update_pending = false;
+    m_comm_pending = false;
+
+    if (m_prof)
+        m_prof->pop();
     }
 
 void Communicator::updateNetForce(unsigned int timestep)
@@ -2925,6 +3847,20 @@ const BoxDim Communicator::getShiftedBox() const
 void export_Communicator(py::module& m)
     {
     py::class_<Communicator, std::shared_ptr<Communicator> >(m,"Communicator")
-    .def(py::init<std::shared_ptr<SystemDefinition>, std::shared_ptr<DomainDecomposition> >());
+    .def(py::init<std::shared_ptr<SystemDefinition>, std::shared_ptr<DomainDecomposition> >())
+    .def("setGhostOverlap", &Communicator::setGhostOverlap)
+    .def("getGhostOverlap", &Communicator::getGhostOverlap)
+    .def("setPersistentRequests", &Communicator::setPersistentRequests)
+    .def("getPersistentRequests", &Communicator::getPersistentRequests)
+    .def("setSharedMemoryGhosts", &Communicator::setSharedMemoryGhosts)
+    .def("getSharedMemoryGhosts", &Communicator::getSharedMemoryGhosts)
+    .def("setGhostCompression", &Communicator::setGhostCompression)
+    .def("getGhostCompression", &Communicator::getGhostCompression)
+    .def("getGhostCompressionError", &Communicator::getGhostCompressionError)
+    .def("setGhostSkin", &Communicator::setGhostSkin)
+    .def("getGhostSkin", &Communicator::getGhostSkin)
+    .def("getNumSkippedGhostExchanges", &Communicator::getNumSkippedGhostExchanges)
+    .def("getGhostTraffic", &Communicator::getGhostTraffic)
+    .def("resetGhostTraffic", &Communicator::resetGhostTraffic);
     }
 #endif // ENABLE_MPI
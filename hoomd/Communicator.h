@@ -24,6 +24,7 @@
 #include "BondedGroupData.h"
 #include "DomainDecomposition.h"
 
+#include <map>
 #include <memory>
 #include <hoomd/extern/nano-signal-slot/nano_signal_slot.hpp>
 
@@ -278,8 +279,110 @@ class PYBIND11_EXPORT Communicator
         /*! Interface to the communication methods.
          * This method is supposed to be called every time step and automatically performs all necessary
          * communication steps.
+         *
+         * \param timestep The time step
+         * \param defer_ghosts If true and ghost overlap is enabled, a ghost position update is only started. The
+         *        caller must call finishUpdateGhosts() before it uses any ghost data.
+         */
+        void communicate(unsigned int timestep, bool defer_ghosts=false);
+
+        //! Enable or disable overlapping the ghost update with the computation of forces
+        /*! When enabled, integrators compute the forces that do not depend on ghost particles while the ghost
+         *  positions are being exchanged (see ForceCompute::computeInterior()). Only supported on the CPU.
+         */
+        void setGhostOverlap(bool enable);
+
+        //! Returns true if ghost updates overlap with the computation of forces
+        bool getGhostOverlap() const
+            {
+            return m_ghost_overlap;
+            }
+
+        //! Enable or disable persistent MPI requests for ghost updates
+        /*! When enabled, the sends and receives of the ghost update are set up once with MPI_Send_init() and
+         *  MPI_Recv_init() after every ghost exchange, and only started on each time step. Only supported on the CPU.
+         */
+        void setPersistentRequests(bool enable);
+
+        //! Returns true if ghost updates use persistent MPI requests
+        bool getPersistentRequests() const
+            {
+            return m_persistent_reqs;
+            }
+
+        //! Enable or disable the shared memory path of the ghost update
+        /*! When enabled, the ghosts sent to neighbors on the same node are packed into a shared memory window
+         *  (MPI_Win_allocate_shared()), from which the neighbor copies them directly into its particle data. Messages
+         *  to other nodes are unchanged. This is a collective call on all ranks. Only supported on the CPU.
+         */
+        void setSharedMemoryGhosts(bool enable);
+
+        //! Returns true if ghost updates to ranks on the same node use shared memory
+        bool getSharedMemoryGhosts() const
+            {
+            return m_shm_ghosts;
+            }
+
+        //! Enable or disable sending ghost positions and velocities in reduced precision
+        /*! \param enable True if the ghost updates should be compressed
+         *  \param tolerance Maximum error of the ghost positions (in distance units)
+         *
+         *  When enabled, the ghost update sends positions as 32 bit fixed point fractions of the global box and
+         *  velocities in single precision. Only the fields that change between ghost exchanges are sent, the types
+         *  and masses of the ghosts are kept. The receiver reconstructs positions in full precision. Ghosts
+         *  exchanged through shared memory are not compressed. Only supported on the CPU.
+         */
+        void setGhostCompression(bool enable, Scalar tolerance);
+
+        //! Returns true if ghost updates are sent in reduced precision
+        bool getGhostCompression() const
+            {
+            return m_ghost_compression;
+            }
+
+        //! Get the maximum error of the compressed ghost positions in the current box
+        Scalar getGhostCompressionError() const;
+
+        //! Set the extra width of the ghost layer
+        /*! \param skin Width added to the ghost layer of every type (in distance units)
+         *
+         *  With a nonzero skin, particles are not migrated and ghosts are not selected again when a neighbor list
+         *  rebuild is requested, as long as no particle on any rank has moved more than half of the skin since the
+         *  last ghost exchange. Only the ghost positions are updated in this case. Only supported on the CPU.
          */
-        void communicate(unsigned int timestep);
+        void setGhostSkin(Scalar skin);
+
+        //! Get the extra width of the ghost layer
+        Scalar getGhostSkin() const
+            {
+            return m_ghost_skin;
+            }
+
+        //! Get the number of ghost exchanges that were skipped because of the ghost skin
+        unsigned int getNumSkippedGhostExchanges() const
+            {
+            return m_n_skipped_exchanges;
+            }
+
+        //! Get the bytes of ghost updates sent by all ranks, by the topological distance of the receiver
+        /*! \returns Bytes sent within NUMA domains, sockets, nodes, and between nodes
+         *           (see DomainDecomposition::getTopologyDistance())
+         *  \note This is a collective call. Only ghost updates on the CPU are counted.
+         */
+        std::vector<double> getGhostTraffic();
+
+        //! Reset the ghost traffic counters
+        void resetGhostTraffic()
+            {
+            for (unsigned int d = 0; d < DomainDecomposition::n_topology_distances; ++d)
+                m_ghost_traffic[d] = 0;
+            }
+
+        //! Returns true if a ghost update was started and has not been finished yet
+        bool isGhostUpdatePending() const
+            {
+            return m_ghost_update_pending;
+            }
 
         //@}
 
@@ -296,8 +399,9 @@ class PYBIND11_EXPORT Communicator
          * neighboring processors.
          *
          * This routine uses non-blocking MPI communication, to make it possible to overlap
-         * additional computation or communication during the update substep. To complete
-         * the communication, call finishUpdateGhosts()
+         * additional computation or communication during the update substep. The ghosts of all directions are
+         * packed into the send buffers here, the messages are exchanged in progressUpdateGhosts() and
+         * finishUpdateGhosts(). To complete the communication, call finishUpdateGhosts()
          *
          * \param timestep The time step
          *
@@ -306,15 +410,23 @@ class PYBIND11_EXPORT Communicator
          */
         virtual void beginUpdateGhosts(unsigned int timestep);
 
+        /*! Make progress on a ghost update without blocking
+         *
+         * Call this method regularly while computing between beginUpdateGhosts() and finishUpdateGhosts(). Many
+         * MPI libraries only transfer data inside MPI calls. Whenever the messages of one dimension have completed,
+         * the ghosts to forward are packed and the next dimension is sent. This method does not access the particle
+         * data, so it may be called while the caller holds ArrayHandles to it. The received ghosts are kept in
+         * communicator buffers and only unpacked into the particle data in finishUpdateGhosts().
+         *
+         * \returns true if all messages of the ghost update have completed
+         */
+        virtual bool progressUpdateGhosts();
+
         /*! Finish ghost update
          *
          * \param timestep The time step
          */
-        virtual void finishUpdateGhosts(unsigned int timestep)
-            {
-            // the base class implementation is currently empty
-            m_comm_pending = false;
-            }
+        virtual void finishUpdateGhosts(unsigned int timestep);
 
         /*! Communicate the net particle force
          * \parm timestep The time step
@@ -383,6 +495,29 @@ class PYBIND11_EXPORT Communicator
             { }
 
     protected:
+        //! Elements of one group type in a combined exchange with all neighbors
+        /*! The send buffer is sorted by unique neighbor. The elements received from all neighbors are stored in the
+         *  same order in \a recv.
+         */
+        struct group_buffer_t
+            {
+            const char *send;                       //!< Elements to send
+            std::vector<unsigned int> n_send;       //!< Number of elements sent to every unique neighbor
+            std::vector<char> recv;                 //!< Received elements
+            size_t element_size;                    //!< Size of an element in bytes
+
+            //! Default constructor
+            group_buffer_t()
+                : send(NULL), element_size(1)
+                { }
+
+            //! Number of elements received
+            unsigned int getNRecv() const
+                {
+                return recv.size() / element_size;
+                }
+            };
+
         //! Helper class to perform the communication tasks related to bonded groups
         template<class group_data>
         class GroupCommunicator
@@ -394,15 +529,35 @@ class PYBIND11_EXPORT Communicator
                 //! Constructor
                 GroupCommunicator(Communicator& comm, std::shared_ptr<group_data> gdata);
 
-                //! Migrate groups
+                //! Determine the rank updates of the group members (first phase of the migration)
                 /*! \param incomplete If true, mark all groups that have non-local members and update local
                  *         member rank information. Otherwise, mark only groups flagged for communication
                  *         in particle data
-                 *  \param local_multiple If true, a group may be split across several ranks
-                 * A group is marked for sending by setting its rtag to GROUP_NOT_LOCAL, and by updating
-                 * the rank information with the destination ranks (or the local ranks if incomplete=true)
+                 *  \param migrate True if any local particle leaves the domain
+                 *  \param buffers The buffer of this group type is appended for the exchange with the neighbors
+                 *
+                 * Only the groups with members that leave the domain (or all groups with non-local members if
+                 * incomplete=true) are packed. Without migrating particles, the groups are not scanned at all.
                  */
-                void migrateGroups(bool incomplete, bool local_multiple);
+                void prepareRankUpdate(bool incomplete, bool migrate, std::vector<group_buffer_t *>& buffers);
+
+                //! Apply the rank updates received from the neighbors
+                void applyRankUpdate();
+
+                //! Determine the groups sent along with the migrating particles (second phase of the migration)
+                /*! \param local_multiple If true, a group may be split across several ranks
+                 *  \param migrate True if any local particle leaves the domain
+                 *  \param buffers The buffer of this group type is appended for the exchange with the neighbors
+                 *
+                 * A group is sent to the destination ranks of its migrating members, and removed if none of its
+                 * members remain local.
+                 */
+                void prepareGroupMigration(bool local_multiple, bool migrate, std::vector<group_buffer_t *>& buffers);
+
+                //! Add the groups received from the neighbors
+                /*! \param local_multiple If true, a group may be split across several ranks
+                 */
+                void addMigratedGroups(bool local_multiple);
 
                 //! Mark ghost particles
                 /* All particles that need to be sent as ghosts because they are members
@@ -427,7 +582,14 @@ class PYBIND11_EXPORT Communicator
                 std::shared_ptr<group_data> m_gdata;           //!< The group data
 
                 std::vector<rank_element_t> m_ranks_sendbuf;     //!< Send buffer for rank elements
-                std::vector<rank_element_t> m_ranks_recvbuf;     //!< Receive buffer for rank elements
+
+                group_buffer_t m_rank_exchange;                  //!< Rank elements in the combined exchange
+                group_buffer_t m_group_exchange;                 //!< Group elements in the combined exchange
+
+                //! Set up the exchange of a send buffer sorted by destination rank
+                template<class T>
+                void initExchange(group_buffer_t& buf, const std::multimap<unsigned int, T>& send_map,
+                    std::vector<T>& sendbuf);
 
                 std::vector<typename group_data::packed_t> m_groups_sendbuf;     //!< Send buffer for group elements
                 std::vector<typename group_data::packed_t> m_groups_recvbuf;     //!< Receive buffer for group elements
@@ -522,6 +684,17 @@ class PYBIND11_EXPORT Communicator
         unsigned int m_ghosts_added;             //!< Number of ghosts added
         bool m_has_ghost_particles;              //!< True if we have a current copy of ghost particles
 
+        Scalar m_ghost_skin;                     //!< Extra width of the ghost layer
+        GlobalVector<Scalar4> m_ghost_ref_pos;   //!< Positions of the local particles at the last ghost exchange
+        BoxDim m_ghost_ref_box;                  //!< Global box at the last ghost exchange
+        unsigned int m_n_skipped_exchanges;      //!< Number of ghost exchanges skipped because of the skin
+
+        //! Store the positions of the local particles after a ghost exchange
+        void setGhostReferencePositions();
+
+        //! Returns true if the current ghosts are still valid for a neighbor list rebuild
+        bool checkGhostSkin();
+
         MPI_Datatype m_mpi_pdata_element;        //!< A datatype for the (non-packed) pdata_element struct
 
         //! Update the ghost width array
@@ -552,6 +725,133 @@ class PYBIND11_EXPORT Communicator
         std::vector<MPI_Request> m_reqs; //!< Container for all MPI communication requests
         std::vector<MPI_Status> m_stats; //!< Container for all MPI communication statuses
 
+        bool m_ghost_overlap;                    //!< True if ghost updates may overlap with force computation
+        bool m_ghost_update_pending;             //!< True between beginUpdateGhosts() and finishUpdateGhosts()
+        unsigned int m_ghost_update_stage;       //!< Dimension of the ghost update in flight (3 if none)
+        unsigned int m_num_tot_recv_ghosts;      //!< Number of ghosts received in a ghost update
+        unsigned int m_ghost_send_offset[6];     //!< Index of the first ghost of every direction in the send buffers
+        unsigned int m_ghost_recv_offset[6];     //!< Index of the first ghost of every direction in the receive buffers
+        std::vector<uint2> m_ghost_local[6];     //!< Send buffer index and particle index of the local ghosts sent
+        std::vector<uint2> m_ghost_forward[6];   //!< Send buffer index and receive buffer index of forwarded ghosts
+        std::vector<MPI_Request> m_ghost_update_reqs[6]; //!< Non-persistent requests of the ghost update, per direction
+        GlobalVector<Scalar4> m_pos_recvbuf;         //!< Receive buffer for ghost positions
+        GlobalVector<Scalar4> m_velocity_recvbuf;    //!< Receive buffer for ghost velocities
+        GlobalVector<Scalar4> m_orientation_recvbuf; //!< Receive buffer for ghost orientations
+        size_t m_ghost_update_bytes;             //!< Bytes sent and received in the ghost update
+        unsigned int m_neighbor_distance[6];     //!< Topological distance to the neighbor in every direction
+        uint64_t m_ghost_traffic[DomainDecomposition::n_topology_distances]; //!< Ghost update bytes sent, by distance
+
+        bool m_persistent_reqs;                  //!< True if ghost updates use persistent requests
+        bool m_ghost_reqs_valid;                 //!< True if the persistent requests match the ghost plan
+        std::vector<MPI_Request> m_ghost_reqs[6];  //!< Persistent requests of the ghost update, per direction
+        CommFlags m_ghost_reqs_flags;            //!< Flags the persistent requests were set up for
+        std::vector<const void *> m_ghost_reqs_buffers; //!< Buffers the persistent requests were set up for
+
+        bool m_ghost_compression;                //!< True if ghost updates are sent in reduced precision
+        Scalar m_ghost_compression_tol;          //!< Maximum error of the compressed ghost positions
+        GlobalVector<int3> m_pos_compressed_copybuf;      //!< Send buffer for fixed point ghost positions
+        GlobalVector<int3> m_pos_compressed_recvbuf;      //!< Receive buffer for fixed point ghost positions
+        GlobalVector<float3> m_velocity_compressed_copybuf; //!< Send buffer for single precision ghost velocities
+        GlobalVector<float3> m_velocity_compressed_recvbuf; //!< Receive buffer for single precision ghost velocities
+
+        //! Check that the compressed ghost positions are accurate enough in the current box
+        void checkGhostCompression();
+
+        //! Returns true if the ghosts in direction \a dir are sent in reduced precision
+        bool isCompressedGhostSend(unsigned int dir) const
+            {
+            return m_ghost_compression && ! isSharedGhostSend(dir);
+            }
+
+        //! Returns true if the ghosts in direction \a dir are received in reduced precision
+        bool isCompressedGhostRecv(unsigned int dir) const
+            {
+            return m_ghost_compression && ! isSharedGhostRecv(dir);
+            }
+
+        bool m_shm_ghosts;                       //!< True if ghost updates to ranks on the same node use shared memory
+        bool m_shm_valid;                        //!< True if the shared memory window fits the current ghost plan
+        MPI_Comm m_shm_comm;                     //!< Ranks of this partition on the same node
+        int m_shm_rank;                          //!< Rank of this processor in m_shm_comm
+        MPI_Win m_shm_win;                       //!< Window with the ghost send buffers of all ranks on the node
+        std::vector<char *> m_shm_base;          //!< Base address of the window segment of every rank on the node
+        size_t m_shm_capacity;                   //!< Number of ghosts per direction and field in a window segment
+        int m_shm_send_rank[6];                  //!< Rank in m_shm_comm of the send neighbor, -1 if on another node
+        int m_shm_recv_rank[6];                  //!< Rank in m_shm_comm of the receive neighbor, -1 if on another node
+        uint64_t m_shm_send_seq[6];              //!< Number of ghost updates sent through shared memory, per direction
+        uint64_t m_shm_recv_seq[6];              //!< Number of ghost updates received through shared memory, per direction
+        bool m_shm_recv_pending[6];              //!< True if a direction in flight waits for ghosts in shared memory
+
+        //! Size of the flags at the beginning of every window segment (in bytes)
+        /*! The first six flags hold the number of updates sent per direction, the next six the number of updates
+         *  received per direction. The ghost data follows, aligned to a cache line.
+         */
+        static const size_t shm_header_size = 128;
+
+        //! Get the flags in the window segment of rank \a shm_rank
+        volatile uint64_t *getSharedGhostFlags(int shm_rank)
+            {
+            return (volatile uint64_t *) m_shm_base[shm_rank];
+            }
+
+        //! Get the send buffer of rank \a shm_rank for a direction and field (0: position, 1: velocity, 2: orientation)
+        Scalar4 *getSharedGhostBuffer(int shm_rank, unsigned int dir, unsigned int field)
+            {
+            return (Scalar4 *)(m_shm_base[shm_rank] + shm_header_size) + (dir*3 + field)*m_shm_capacity;
+            }
+
+        //! Returns true if the ghosts in direction \a dir are sent through shared memory
+        bool isSharedGhostSend(unsigned int dir) const
+            {
+            return m_shm_valid && m_shm_send_rank[dir] >= 0;
+            }
+
+        //! Returns true if the ghosts in direction \a dir are received through shared memory
+        bool isSharedGhostRecv(unsigned int dir) const
+            {
+            return m_shm_valid && m_shm_recv_rank[dir] >= 0;
+            }
+
+        //! Make sure the shared memory window is large enough for the current ghost plan
+        void allocateSharedGhostWindow();
+
+        //! Free the shared memory window
+        void freeSharedGhostWindow();
+
+        //! Copy the ghosts of direction \a dir from the window segment of the receive neighbor
+        bool receiveSharedGhosts(unsigned int dir, bool wait);
+
+        //! Copy ghosts of direction \a dir into the send buffers
+        void packGhostUpdate(unsigned int dir, const std::vector<uint2>& ghosts, const Scalar4 *pos,
+            const Scalar4 *vel, const Scalar4 *orientation);
+
+        //! Post the ghost update of the first dimension starting at \a stage that has communicating directions
+        void startGhostUpdateStage(unsigned int stage);
+
+        //! Returns true if all messages of the dimension in flight have completed
+        bool testGhostUpdateStage(bool wait);
+
+        //! Set up the sends and receives of the ghost update in direction \a dir
+        void initGhostUpdateRequests(unsigned int dir, bool persistent, std::vector<MPI_Request>& reqs);
+
+        //! Get the buffers the messages of the ghost update read from and write to
+        std::vector<const void *> getGhostUpdateBuffers();
+
+        //! Set up the persistent requests of all directions, if the ghost plan or the buffers have changed
+        void updatePersistentRequests();
+
+        //! Free the persistent requests
+        void freePersistentRequests();
+
+        //! Get the requests of direction \a dir
+        std::vector<MPI_Request>& getGhostUpdateRequests(unsigned int dir)
+            {
+            return m_persistent_reqs ? m_ghost_reqs[dir] : m_ghost_update_reqs[dir];
+            }
+
+        //! Wrap the ghosts received in the current dimension and start the next one
+        void finishGhostUpdateStage();
+
         /* Bonds communication */
         bool m_bonds_changed;                          //!< True if bond information needs to be refreshed
         void setBondsChanged()
@@ -637,6 +937,20 @@ class PYBIND11_EXPORT Communicator
         GroupCommunicator<PairData> m_pair_comm;    //!< Communication helper for special pairs
         friend class GroupCommunicator<PairData>;
 
+        //! Migrate the bonded groups of all types along with the particles leaving in the current direction
+        /*! \param migrate True if any local particle leaves the domain
+         */
+        void migrateGroups(bool migrate);
+
+        //! Exchange the elements of several group types with all neighbors
+        /*! The number of elements of all types is exchanged in one message per neighbor, followed by one message
+         *  with the elements of all types for every neighbor that sends or receives any.
+         */
+        void exchangeGroupBuffers(const std::vector<group_buffer_t *>& buffers);
+
+        std::vector<char> m_group_sendbuf;             //!< Send buffer of the combined group exchange
+        std::vector<char> m_group_recvbuf;             //!< Receive buffer of the combined group exchange
+
         //! Reallocate the ghost layer width arrays when number of types change
         void slotNumTypesChanged()
             {
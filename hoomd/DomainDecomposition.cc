@@ -20,10 +20,90 @@
 #include <algorithm>
 #include <cmath>
 #include <numeric>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#include <dirent.h>
+#endif
 
 using namespace std;
 namespace py = pybind11;
 
+//! Determine the socket and NUMA domain of the CPUs this process is bound to
+/*! \param socket Physical package id (output, -1 if unknown)
+    \param numa NUMA node (output, -1 if unknown)
+
+    The ids are read from /sys/devices/system/cpu for every CPU in the affinity mask of the process. If the process is
+    not bound (it may run on all CPUs), or if its CPUs span several sockets or NUMA domains, the respective id is -1.
+*/
+static void getCPUTopology(int& socket, int& numa)
+    {
+    socket = -1;
+    numa = -1;
+
+    #ifdef __linux__
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) != 0)
+        return;
+
+    // an unbound process can be moved anywhere
+    long n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n_cpus <= 0 || CPU_COUNT(&mask) >= n_cpus)
+        return;
+
+    bool first = true;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+        if (!CPU_ISSET(cpu, &mask))
+            continue;
+
+        std::ostringstream path;
+        path << "/sys/devices/system/cpu/cpu" << cpu;
+
+        int cpu_socket = -1;
+        std::ifstream f((path.str() + "/topology/physical_package_id").c_str());
+        if (!(f >> cpu_socket))
+            cpu_socket = -1;
+
+        // the NUMA node is given by a nodeN link in the cpu directory
+        int cpu_numa = -1;
+        DIR *dir = opendir(path.str().c_str());
+        if (dir)
+            {
+            struct dirent *entry;
+            while ((entry = readdir(dir)) != NULL)
+                {
+                if (strncmp(entry->d_name, "node", 4) == 0 && isdigit(entry->d_name[4]))
+                    cpu_numa = atoi(entry->d_name + 4);
+                }
+            closedir(dir);
+            }
+
+        if (first)
+            {
+            socket = cpu_socket;
+            numa = cpu_numa;
+            first = false;
+            }
+        else
+            {
+            if (cpu_socket != socket)
+                socket = -1;
+            if (cpu_numa != numa)
+                numa = -1;
+            }
+        }
+    #endif
+    }
+
 //! Constructor
 /*! The constructor performs a spatial domain decomposition of the simulation box of processor with rank \b exec_conf->getMPIroot().
  * The domain dimensions are distributed on the other processors.
@@ -133,27 +213,26 @@ void DomainDecomposition::initializeDomainGrid(Scalar3 L,
         initializeTwoLevel();
         }
 
-    unsigned int nx_node =0, ny_node = 0, nz_node = 0;
-    unsigned int nx_intra = 0, ny_intra = 0, nz_intra = 0;
-
     if (nx || ny || nz) m_twolevel = false;
 
+    // dimensions of the blocks of the grid on every level of the topology, and the rank of every grid position
+    unsigned int n_levels = 0;
+    std::vector<unsigned int> blocks;
+    std::vector<unsigned int> rank_map;
+
     if (rank == 0)
         {
         if (m_twolevel)
             {
-            // every node has the same number of ranks, so nranks == num_nodes * num_ranks_per_node
-            unsigned int n_nodes = m_nodes.size();
-
             // subdivide the global grid
             findDecomposition(nranks, L, nx, ny, nz);
 
-            // subdivide the local grid
-            subdivide(nranks/n_nodes, L, nx, ny, nz, nx_intra, ny_intra, nz_intra);
+            // place the blocks of the grid on the nodes, sockets and NUMA domains
+            n_levels = mapDomainsToTopology(m_rank_node, m_rank_socket, m_rank_numa, L, nx, ny, nz, rank_map, blocks);
 
-            nx_node = nx/nx_intra;
-            ny_node = ny/ny_intra;
-            nz_node = nz/nz_intra;
+            // fall back to the one-level decomposition if the grid cannot be divided among nodes
+            if (n_levels == 0)
+                m_twolevel = false;
             }
         else
             {
@@ -190,73 +269,22 @@ void DomainDecomposition::initializeDomainGrid(Scalar3 L,
     ArrayHandle<unsigned int> h_cart_ranks(m_cart_ranks, access_location::host, access_mode::overwrite);
     ArrayHandle<unsigned int> h_cart_ranks_inv(m_cart_ranks_inv, access_location::host, access_mode::overwrite);
 
+    bcast(m_twolevel, 0, m_mpi_comm);
+
     if (m_twolevel)
         {
-        bcast(nx_intra, 0, m_mpi_comm);
-        bcast(ny_intra, 0, m_mpi_comm);
-        bcast(nz_intra, 0, m_mpi_comm);
-
-        bcast(nx_node, 0, m_mpi_comm);
-        bcast(ny_node, 0, m_mpi_comm);
-        bcast(nz_node, 0, m_mpi_comm);
-
-        m_node_grid = Index3D(nx_node, ny_node, nz_node);
-        m_intra_node_grid = Index3D(nx_intra, ny_intra, nz_intra);
-
-        std::vector<unsigned int> node_ranks(m_max_n_node);
-        std::set<std::string>::iterator node_it = m_nodes.begin();
+        bcast(n_levels, 0, m_mpi_comm);
+        blocks.resize(3*(n_levels+1));
+        MPI_Bcast(&blocks[0], blocks.size(), MPI_UNSIGNED, 0, m_mpi_comm);
+        rank_map.resize(nranks);
+        MPI_Bcast(&rank_map[0], nranks, MPI_UNSIGNED, 0, m_mpi_comm);
 
-        std::set<unsigned int> node_rank_set;
-
-        // iterate over node grid
-        for (unsigned int ix_node = 0; ix_node < m_node_grid.getW(); ix_node++)
-            for (unsigned int iy_node = 0; iy_node < m_node_grid.getH(); iy_node++)
-                for (unsigned int iz_node = 0; iz_node < m_node_grid.getD(); iz_node++)
-                    {
-                    // get ranks for this node
-                    typedef std::multimap<std::string, unsigned int> map_t;
-                    std::string node = *(node_it++);
-                    std::pair<map_t::iterator, map_t::iterator> p = m_node_map.equal_range(node);
-
-                    // Insert ranks per node into an ordered set (multimap doesn't guarantee order
-                    // and thus order can be different on different ranks, especially after deserialization)
-                    node_rank_set.clear();
-                    for (map_t::iterator it = p.first; it != p.second; ++it)
-                        {
-                        node_rank_set.insert(it->second);
-                        }
-
-                    std::set<unsigned int>::iterator set_it;
-
-                    std::ostringstream oss;
-                    oss << "Node " << node << ": ranks";
-                    unsigned int i = 0;
-                    for (set_it= node_rank_set.begin(); set_it != node_rank_set.end(); ++set_it)
-                        {
-                        unsigned int r = *set_it;
-                        oss << " " << r;
-                        node_ranks[i++] = r;
-                        }
-                    m_exec_conf->msg->notice(5) << oss.str() << std::endl;
-
-                    // iterate over local ranks
-                    for (unsigned int ix_intra = 0; ix_intra < m_intra_node_grid.getW(); ix_intra++)
-                        for (unsigned int iy_intra = 0; iy_intra < m_intra_node_grid.getH(); iy_intra++)
-                            for (unsigned int iz_intra = 0; iz_intra < m_intra_node_grid.getD(); iz_intra++)
-                                {
-                                unsigned int ilocal = m_intra_node_grid(ix_intra, iy_intra, iz_intra);
-
-                                unsigned int ix = ix_node * nx_intra + ix_intra;
-                                unsigned int iy = iy_node * ny_intra + iy_intra;
-                                unsigned int iz = iz_node * nz_intra + iz_intra;
-
-                                unsigned int iglob = m_index(ix, iy, iz);
-
-                                // add rank to table
-                                h_cart_ranks.data[iglob] = node_ranks[ilocal];
-                                h_cart_ranks_inv.data[node_ranks[ilocal]] = iglob;
-                                }
-                    }
+        for (unsigned int iglob = 0; iglob < nranks; ++iglob)
+            {
+            // add rank to table
+            h_cart_ranks.data[iglob] = rank_map[iglob];
+            h_cart_ranks_inv.data[rank_map[iglob]] = iglob;
+            }
         } // twolevel
     else
         {
@@ -273,11 +301,22 @@ void DomainDecomposition::initializeDomainGrid(Scalar3 L,
         << m_nx << " n_y = " << m_ny << " n_z = " << m_nz << "." << std::endl;
 
     if (m_twolevel)
-        m_exec_conf->msg->notice(1) << nx_intra << " x " << ny_intra << " x " << nz_intra
+        {
+        m_exec_conf->msg->notice(1) << blocks[3] << " x " << blocks[4] << " x " << blocks[5]
             << " local grid on " << m_nodes.size() << " nodes" << std::endl;
 
+        for (unsigned int level = 1; level < n_levels; ++level)
+            {
+            m_exec_conf->msg->notice(2) << blocks[3*(level+1)] << " x " << blocks[3*(level+1)+1] << " x "
+                << blocks[3*(level+1)+2] << " grid per " << m_level_name[level] << std::endl;
+            }
+        }
+
     // compute position of this box in the domain grid by reverse look-up
     m_grid_pos = m_index.getTriple(h_cart_ranks_inv.data[rank]);
+
+    if (rank == 0)
+        reportTopologyTraffic(L, h_cart_ranks.data);
     }
 
 /*!
@@ -641,25 +680,292 @@ void DomainDecomposition::findCommonNodes()
     // broadcast to other ranks
     bcast(m_nodes, 0, m_exec_conf->getMPICommunicator());
     bcast(m_node_map, 0, m_exec_conf->getMPICommunicator());
+
+    unsigned int nranks = m_exec_conf->getNRanks();
+    m_rank_node.resize(nranks);
+    typedef std::multimap<std::string, unsigned int> map_t;
+    for (map_t::iterator it = m_node_map.begin(); it != m_node_map.end(); ++it)
+        {
+        m_rank_node[it->second] = std::distance(m_nodes.begin(), m_nodes.find(it->first));
+        }
+
+    // collect the socket and NUMA domain of every rank
+    int topology[2];
+    getCPUTopology(topology[0], topology[1]);
+
+    std::vector<int> all_topology(2*nranks);
+    MPI_Allgather(topology, 2, MPI_INT, &all_topology[0], 2, MPI_INT, m_exec_conf->getMPICommunicator());
+
+    m_rank_socket.resize(nranks);
+    m_rank_numa.resize(nranks);
+    for (unsigned int r = 0; r < nranks; r++)
+        {
+        m_rank_socket[r] = all_topology[2*r];
+        m_rank_numa[r] = all_topology[2*r+1];
+        }
     }
 
 void DomainDecomposition::initializeTwoLevel()
     {
     typedef std::multimap<std::string, unsigned int> map_t;
-    m_twolevel = true;
     m_max_n_node = 0;
     for (std::set<std::string>::iterator it = m_nodes.begin(); it != m_nodes.end(); ++it)
         {
         std::pair<map_t::iterator, map_t::iterator> p = m_node_map.equal_range(*it);
         unsigned int n_node = std::distance(p.first, p.second);
 
-        // if we have a non-uniform number of ranks per node use one-level decomposition
-        if (m_max_n_node != 0 && n_node != m_max_n_node)
-            m_twolevel = false;
-
         if (n_node > m_max_n_node)
             m_max_n_node = n_node;
         }
+
+    // if we have a non-uniform number of ranks per node use one-level decomposition
+    std::vector<unsigned int> ordered_ranks;
+    std::vector<unsigned int> level_size;
+    m_twolevel = findTopologyLevels(m_rank_node, m_rank_socket, m_rank_numa, ordered_ranks, level_size, m_level_name);
+    }
+
+/*! \param rank_node Index of the node of every rank (0 to number of nodes - 1)
+    \param rank_socket Socket of every rank (-1 if unknown)
+    \param rank_numa NUMA domain of every rank (-1 if unknown)
+    \param ordered_ranks (output) Ranks sorted by node, socket, NUMA domain and rank
+    \param level_size (output) Number of groups per parent group on every topology level, starting with the nodes
+    \param level_name (output) Name of the groups on every topology level
+    \returns false if the nodes have different numbers of ranks
+
+    The socket and NUMA levels are only added when all ranks are bound and every group on the level has the same
+    number of ranks.
+*/
+bool DomainDecomposition::findTopologyLevels(const std::vector<unsigned int>& rank_node,
+                                             const std::vector<int>& rank_socket,
+                                             const std::vector<int>& rank_numa,
+                                             std::vector<unsigned int>& ordered_ranks,
+                                             std::vector<unsigned int>& level_size,
+                                             std::vector<std::string>& level_name)
+    {
+    unsigned int nranks = rank_node.size();
+    assert(rank_socket.size() == nranks);
+    assert(rank_numa.size() == nranks);
+
+    // count the ranks on every node
+    unsigned int n_nodes = *std::max_element(rank_node.begin(), rank_node.end()) + 1;
+    std::vector<unsigned int> node_size(n_nodes, 0);
+    for (unsigned int r = 0; r < nranks; ++r)
+        node_size[rank_node[r]]++;
+
+    if (std::count(node_size.begin(), node_size.end(), node_size[0]) != (int)n_nodes)
+        return false;
+
+    // order the ranks by node, socket, NUMA domain and rank, so that every group is a contiguous range
+    ordered_ranks.resize(nranks);
+    std::iota(ordered_ranks.begin(), ordered_ranks.end(), 0);
+    std::sort(ordered_ranks.begin(), ordered_ranks.end(), [&](unsigned int a, unsigned int b)
+        {
+        if (rank_node[a] != rank_node[b]) return rank_node[a] < rank_node[b];
+        if (rank_socket[a] != rank_socket[b]) return rank_socket[a] < rank_socket[b];
+        if (rank_numa[a] != rank_numa[b]) return rank_numa[a] < rank_numa[b];
+        return a < b;
+        });
+
+    level_size.assign(1, n_nodes);
+    level_name.assign(1, "node");
+    unsigned int group_size = node_size[0];
+
+    // add the socket and NUMA levels when all ranks are bound and every group has the same number of ranks
+    for (unsigned int level = 0; level < 2; ++level)
+        {
+        const std::vector<int>& ids = (level == 0) ? rank_socket : rank_numa;
+
+        std::vector<unsigned int> sizes;
+        bool valid = true;
+        for (unsigned int i = 0; i < nranks; ++i)
+            {
+            unsigned int r = ordered_ranks[i];
+            if (ids[r] < 0)
+                {
+                valid = false;
+                break;
+                }
+
+            unsigned int prev = ordered_ranks[i > 0 ? i-1 : 0];
+            bool new_group = (i == 0) || rank_node[r] != rank_node[prev] || rank_socket[r] != rank_socket[prev]
+                || (level == 1 && rank_numa[r] != rank_numa[prev]);
+            if (new_group)
+                sizes.push_back(0);
+            sizes.back()++;
+            }
+
+        if (!valid || std::count(sizes.begin(), sizes.end(), sizes[0]) != (int)sizes.size())
+            break;
+
+        // skip levels with a single group, e.g. single socket nodes
+        unsigned int n_groups = group_size / sizes[0];
+        if (n_groups > 1)
+            {
+            level_size.push_back(n_groups);
+            level_name.push_back(level == 0 ? "socket" : "NUMA domain");
+            group_size = sizes[0];
+            }
+        }
+
+    return true;
+    }
+
+/*! \param rank_node Index of the node of every rank (0 to number of nodes - 1)
+    \param rank_socket Socket of every rank (-1 if unknown)
+    \param rank_numa NUMA domain of every rank (-1 if unknown)
+    \param L Box lengths of the global box
+    \param nx Number of domains along the x direction
+    \param ny Number of domains along the y direction
+    \param nz Number of domains along the z direction
+    \param cart_ranks (output) Rank of every linear grid index
+    \param blocks (output) Dimensions of the blocks on every level, starting with the whole grid
+    \returns Number of topology levels used, 0 if the grid is mapped linearly onto the ranks
+
+    Every block of the grid is divided into one block per group on the next level (nodes, sockets, NUMA domains), so
+    that the ranks of every group own a contiguous sub-block of the grid. The deepest level that can be divided
+    evenly is used.
+*/
+unsigned int DomainDecomposition::mapDomainsToTopology(const std::vector<unsigned int>& rank_node,
+                                                       const std::vector<int>& rank_socket,
+                                                       const std::vector<int>& rank_numa,
+                                                       Scalar3 L,
+                                                       unsigned int nx,
+                                                       unsigned int ny,
+                                                       unsigned int nz,
+                                                       std::vector<unsigned int>& cart_ranks,
+                                                       std::vector<unsigned int>& blocks)
+    {
+    unsigned int nranks = rank_node.size();
+    assert(nx*ny*nz == nranks);
+
+    // fall back to the linear mapping
+    cart_ranks.resize(nranks);
+    std::iota(cart_ranks.begin(), cart_ranks.end(), 0);
+    blocks.clear();
+    blocks.push_back(nx); blocks.push_back(ny); blocks.push_back(nz);
+
+    std::vector<unsigned int> ordered_ranks;
+    std::vector<unsigned int> level_size;
+    std::vector<std::string> level_name;
+    if (!findTopologyLevels(rank_node, rank_socket, rank_numa, ordered_ranks, level_size, level_name))
+        return 0;
+
+    // subdivide every block into one block per group on the next level
+    unsigned int n_levels = 0;
+    unsigned int n_block_ranks = nranks;
+    for (unsigned int level = 0; level < level_size.size(); ++level)
+        {
+        // every group on a level has the same number of ranks
+        n_block_ranks /= level_size[level];
+
+        unsigned int px = blocks[3*level], py = blocks[3*level+1], pz = blocks[3*level+2];
+        unsigned int cx = 0, cy = 0, cz = 0;
+        subdivide(n_block_ranks, L, px, py, pz, cx, cy, cz);
+        if (cx*cy*cz != n_block_ranks || px % cx || py % cy || pz % cz)
+            break;
+
+        blocks.push_back(cx); blocks.push_back(cy); blocks.push_back(cz);
+        n_levels++;
+        }
+
+    if (n_levels == 0)
+        return 0;
+
+    // number of ranks in the blocks of the finest level
+    unsigned int n_leaf = nranks;
+    for (unsigned int level = 0; level < n_levels; ++level)
+        n_leaf /= level_size[level];
+
+    Index3D index(nx, ny, nz);
+    for (unsigned int iglob = 0; iglob < nranks; ++iglob)
+        {
+        // descend the levels, the position of a block among its siblings selects the group
+        uint3 c = index.getTriple(iglob);
+        unsigned int group = 0;
+        for (unsigned int level = 0; level < n_levels; ++level)
+            {
+            uint3 child = make_uint3(blocks[3*(level+1)], blocks[3*(level+1)+1], blocks[3*(level+1)+2]);
+            Index3D sibling_grid(blocks[3*level]/child.x, blocks[3*level+1]/child.y, blocks[3*level+2]/child.z);
+            assert(sibling_grid.getNumElements() == level_size[level]);
+
+            group = group*level_size[level] + sibling_grid(c.x/child.x, c.y/child.y, c.z/child.z);
+            c = make_uint3(c.x % child.x, c.y % child.y, c.z % child.z);
+            }
+
+        Index3D leaf_grid(blocks[3*n_levels], blocks[3*n_levels+1], blocks[3*n_levels+2]);
+        cart_ranks[iglob] = ordered_ranks[group*n_leaf + leaf_grid(c.x, c.y, c.z)];
+        }
+
+    return n_levels;
+    }
+
+/*! \param rank_a First rank
+    \param rank_b Second rank
+    \returns 0 if both ranks are bound to the same NUMA domain, 1 to the same socket, 2 if they are on the same node,
+              and 3 otherwise
+*/
+unsigned int DomainDecomposition::getTopologyDistance(unsigned int rank_a, unsigned int rank_b) const
+    {
+    if (m_rank_node[rank_a] != m_rank_node[rank_b])
+        return 3;
+    if (m_rank_socket[rank_a] < 0 || m_rank_socket[rank_a] != m_rank_socket[rank_b])
+        return 2;
+    if (m_rank_numa[rank_a] < 0 || m_rank_numa[rank_a] != m_rank_numa[rank_b])
+        return 1;
+    return 0;
+    }
+
+/*! \param rank The other rank
+    \returns The topological distance between this rank and \a rank (see getTopologyDistance(rank_a, rank_b))
+*/
+unsigned int DomainDecomposition::getTopologyDistance(unsigned int rank) const
+    {
+    return getTopologyDistance(m_exec_conf->getRank(), rank);
+    }
+
+/*! \param L Box lengths of the global box
+    \param cart_ranks The cartesian ranks lookup table
+
+    With a uniform particle density, the number of ghost particles exchanged through a face between two domains is
+    proportional to its area. Print the share of the total face area between ranks on the same NUMA domain, socket,
+    node, and between nodes.
+*/
+void DomainDecomposition::reportTopologyTraffic(Scalar3 L, const unsigned int *cart_ranks)
+    {
+    double area[n_topology_distances] = {0.0, 0.0, 0.0, 0.0};
+    const unsigned int n[3] = {m_nx, m_ny, m_nz};
+    const double face_area[3] = {double(L.y)*L.z/(m_ny*m_nz), double(L.x)*L.z/(m_nx*m_nz), double(L.x)*L.y/(m_nx*m_ny)};
+
+    for (unsigned int iglob = 0; iglob < m_index.getNumElements(); ++iglob)
+        {
+        uint3 c = m_index.getTriple(iglob);
+        for (unsigned int dim = 0; dim < 3; ++dim)
+            {
+            // count every face once, through the domain below it
+            if (n[dim] == 1)
+                continue;
+
+            uint3 neigh = c;
+            if (dim == 0) neigh.x = (c.x + 1) % m_nx;
+            else if (dim == 1) neigh.y = (c.y + 1) % m_ny;
+            else neigh.z = (c.z + 1) % m_nz;
+
+            unsigned int d = getTopologyDistance(cart_ranks[iglob], cart_ranks[m_index(neigh.x, neigh.y, neigh.z)]);
+            area[d] += face_area[dim];
+            }
+        }
+
+    double total = area[0] + area[1] + area[2] + area[3];
+    if (total == 0.0)
+        return;
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1) << "Domain faces: "
+        << 100.0*area[0]/total << "% within NUMA domains, "
+        << 100.0*area[1]/total << "% within sockets, "
+        << 100.0*area[2]/total << "% within nodes, "
+        << 100.0*area[3]/total << "% between nodes";
+    m_exec_conf->msg->notice(2) << oss.str() << std::endl;
     }
 
 //! Export DomainDecomposition class to python
@@ -678,6 +984,8 @@ void export_DomainDecomposition(py::module& m)
               const std::vector<Scalar>&,
               const std::vector<Scalar>&>())
     .def("getCumulativeFractions", &DomainDecomposition::getCumulativeFractions)
+    .def("getTopologyDistance", (unsigned int (DomainDecomposition::*)(unsigned int) const)
+        &DomainDecomposition::getTopologyDistance)
     ;
     }
 #endif // ENABLE_MPI
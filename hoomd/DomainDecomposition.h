@@ -44,6 +44,12 @@
  *  ranks does not match the number that is available, behavior is reverted to the normal default with
  *  uniform cuts along each dimension.
  *
+ *  With the default decomposition, the grid is mapped onto the ranks hierarchically (multi-level decomposition). The
+ *  grid is divided into equal blocks, one per node, so that most neighbor domains are on the same node. If the ranks
+ *  are bound to cores, every node block is further divided into one block per socket and every socket block into one
+ *  block per NUMA domain, as read from the Linux /sys topology of the CPUs a rank is bound to. Levels are only used
+ *  if every group at that level contains the same number of ranks and the grid divides evenly.
+ *
  *  The initialization of the domain decomposition scheme is performed in the constructor.
  */
 class PYBIND11_EXPORT DomainDecomposition
@@ -102,6 +108,12 @@ class PYBIND11_EXPORT DomainDecomposition
         //! Determines whether the local box shares a boundary with the global box
         bool isAtBoundary(unsigned int dir) const;
 
+        //! Get the topological distance between this rank and another one
+        unsigned int getTopologyDistance(unsigned int rank) const;
+
+        //! Number of topological distances returned by getTopologyDistance()
+        static const unsigned int n_topology_distances = 4;
+
         //! Get the cumulative box fraction at a specific rank index
         /*!
          * \param dir Direction (0=x, 1=y, 2=z) to get fraction
@@ -160,6 +172,25 @@ class PYBIND11_EXPORT DomainDecomposition
 
         //! Get the number of grid cells in each dimension.
         uint3 getGridSize(void)const{return make_uint3(m_nx,m_ny,m_nz);}
+
+        //! Order the ranks by node, socket and NUMA domain and find the topology levels with uniform groups
+        static bool findTopologyLevels(const std::vector<unsigned int>& rank_node,
+                                       const std::vector<int>& rank_socket,
+                                       const std::vector<int>& rank_numa,
+                                       std::vector<unsigned int>& ordered_ranks,
+                                       std::vector<unsigned int>& level_size,
+                                       std::vector<std::string>& level_name);
+
+        //! Map the domain grid onto the ranks so that every node, socket and NUMA domain owns a sub-block
+        static unsigned int mapDomainsToTopology(const std::vector<unsigned int>& rank_node,
+                                                 const std::vector<int>& rank_socket,
+                                                 const std::vector<int>& rank_numa,
+                                                 Scalar3 L,
+                                                 unsigned int nx,
+                                                 unsigned int ny,
+                                                 unsigned int nz,
+                                                 std::vector<unsigned int>& cart_ranks,
+                                                 std::vector<unsigned int>& blocks);
     private:
         unsigned int m_nx;           //!< Number of processors along the x-axis
         unsigned int m_ny;           //!< Number of processors along the y-axis
@@ -167,14 +198,17 @@ class PYBIND11_EXPORT DomainDecomposition
 
         uint3 m_grid_pos;            //!< Position of this domain in the grid
         Index3D m_index;             //!< Index to the 3D processor grid
-        Index3D m_node_grid;         //!< Indexer of the grid of nodes
-        Index3D m_intra_node_grid;   //!< The grid in every node
 
         std::set<std::string> m_nodes; //!< List of nodes
         std::multimap<std::string, unsigned int> m_node_map; //!< Map of ranks per node
         unsigned int m_max_n_node;   //!< Maximum number of ranks on a node
         bool m_twolevel;             //!< Whether we use a two-level decomposition
 
+        std::vector<unsigned int> m_rank_node;      //!< Index of the node of every rank
+        std::vector<int> m_rank_socket;             //!< Socket of every rank (-1 if unknown)
+        std::vector<int> m_rank_numa;               //!< NUMA domain of every rank (-1 if unknown)
+        std::vector<std::string> m_level_name;      //!< Name of the groups on every topology level
+
         GlobalArray<unsigned int> m_cart_ranks; //!< A lookup-table to map the cartesian grid index onto ranks
         GlobalArray<unsigned int> m_cart_ranks_inv; //!< Inverse permutation of grid index lookup table
 
@@ -183,7 +217,7 @@ class PYBIND11_EXPORT DomainDecomposition
             unsigned int& nx, unsigned int& ny, unsigned int& nz);
 
         //! Find a two-level decomposition of the global grid
-        void subdivide(unsigned int n_node_ranks, Scalar3 L,
+        static void subdivide(unsigned int n_node_ranks, Scalar3 L,
             unsigned int nx, unsigned int ny, unsigned int nz,
             unsigned int& nx_intra, unsigned int &ny_intra, unsigned int& nz_intra);
 
@@ -193,6 +227,12 @@ class PYBIND11_EXPORT DomainDecomposition
         //! Helper method to initialize the two-level decomposition
         void initializeTwoLevel();
 
+        //! Helper method to report the share of the domain faces on every topology level
+        void reportTopologyTraffic(Scalar3 L, const unsigned int *cart_ranks);
+
+        //! Helper method to compute the topological distance between two ranks
+        unsigned int getTopologyDistance(unsigned int rank_a, unsigned int rank_b) const;
+
         //! Helper method to perform common grid initialization tasks in constructors
         void initializeDomainGrid(Scalar3 L,
                                   unsigned int nx,
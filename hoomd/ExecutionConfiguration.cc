@@ -20,6 +20,7 @@ namespace py = pybind11;
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <thread>
 
 using namespace std;
 
@@ -245,6 +246,40 @@ ExecutionConfiguration::ExecutionConfiguration(executionMode mode,
     #endif
     }
 
+#ifdef ENABLE_TBB
+/*! \param num_threads Number of threads in the pool shared by all CPU computes
+*/
+void ExecutionConfiguration::setNumThreads(unsigned int num_threads)
+    {
+    #ifdef ENABLE_MPI
+    // the worker threads do not call MPI, but the MPI library still needs to support threads
+    int provided;
+    MPI_Query_thread(&provided);
+    if (num_threads > 1 && provided < MPI_THREAD_FUNNELED)
+        {
+        msg->warning() << "The MPI library does not support threads, running with " << num_threads
+                       << " threads per rank may fail." << std::endl;
+        }
+    #endif
+
+    m_task_scheduler.reset(new tbb::task_scheduler_init(num_threads));
+    m_num_threads = num_threads;
+    }
+
+/*! When this rank is bound to a subset of the cores (for example, to a NUMA domain by the MPI launcher), all of
+    these cores are used. Otherwise, the hardware threads of this node are divided evenly among the ranks on it.
+*/
+unsigned int ExecutionConfiguration::getNumThreadsPerRank() const
+    {
+    unsigned int n_hardware = std::thread::hardware_concurrency();
+    unsigned int n_available = tbb::task_scheduler_init::default_num_threads();
+    if (n_hardware == 0 || n_available < n_hardware)
+        return n_available;
+
+    return std::max(1u, n_hardware / m_mpi_config->getNRanksNode());
+    }
+#endif
+
 ExecutionConfiguration::~ExecutionConfiguration()
     {
     msg->notice(5) << "Destroying ExecutionConfiguration" << endl;
@@ -846,6 +881,7 @@ void export_ExecutionConfiguration(py::module& m)
         .def("getRank", &ExecutionConfiguration::getRank)
 #ifdef ENABLE_TBB
         .def("setNumThreads", &ExecutionConfiguration::setNumThreads)
+        .def("getNumThreadsPerRank", &ExecutionConfiguration::getNumThreadsPerRank)
 #endif
         .def("getNumThreads", &ExecutionConfiguration::getNumThreads)
         .def("setMemoryTracing", &ExecutionConfiguration::setMemoryTracing)
@@ -261,11 +261,10 @@ struct PYBIND11_EXPORT ExecutionConfiguration
 
     #ifdef ENABLE_TBB
     //! set number of TBB threads
-    void setNumThreads(unsigned int num_threads)
-        {
-        m_task_scheduler.reset(new tbb::task_scheduler_init(num_threads));
-        m_num_threads = num_threads;
-        }
+    void setNumThreads(unsigned int num_threads);
+
+    //! Get the number of threads that uses the cores of this node without oversubscribing them
+    unsigned int getNumThreadsPerRank() const;
     #endif
 
     //! Return the number of active threads
@@ -29,7 +29,7 @@ namespace py = pybind11;
     \post All forces are initialized to 0
 */
 ForceCompute::ForceCompute(std::shared_ptr<SystemDefinition> sysdef)
-     : Compute(sysdef), m_particles_sorted(false)
+     : Compute(sysdef), m_particles_sorted(false), m_interior_computed(false)
     {
     assert(m_pdata);
     assert(m_pdata->getMaxN() > 0);
@@ -281,8 +281,23 @@ void ForceCompute::compute(unsigned int timestep)
 
     computeForces(timestep);
     m_particles_sorted = false;
+    m_interior_computed = false;
     }
 
+#ifdef ENABLE_MPI
+/*! \param timestep Current time step
+
+    Does nothing if compute() would not compute the forces at this step.
+*/
+void ForceCompute::computeInterior(unsigned int timestep)
+    {
+    if (!m_particles_sorted && !peekCompute(timestep))
+        return;
+
+    m_interior_computed = computeForcesInterior(timestep);
+    }
+#endif
+
 /*! \param num_iters Number of iterations to average for the benchmark
     \returns Milliseconds of execution time per calculation
 
@@ -69,6 +69,12 @@ class PYBIND11_EXPORT ForceCompute : public Compute
          * and can be used to overlap computation with communication
          */
         virtual void preCompute(unsigned int timestep){}
+
+        //! Compute the forces that do not depend on ghost particles
+        /*! This method is called while the ghost positions are being updated, see Communicator::setGhostOverlap().
+         * The following call to compute() with the same timestep completes the forces.
+         */
+        void computeInterior(unsigned int timestep);
         #endif
 
         //! Computes the forces
@@ -153,6 +159,7 @@ class PYBIND11_EXPORT ForceCompute : public Compute
 
     protected:
         bool m_particles_sorted;    //!< Flag set to true when particles are resorted in memory
+        bool m_interior_computed;   //!< True if computeForcesInterior() computed part of the forces of this step
 
         //! Helper function called when particles are sorted
         /*! setParticlesSorted() is passed as a slot to the particle sort signal.
@@ -195,6 +202,20 @@ class PYBIND11_EXPORT ForceCompute : public Compute
             \param timestep Current time step
         */
         virtual void computeForces(unsigned int timestep){}
+
+        #ifdef ENABLE_MPI
+        //! Compute the part of the forces that does not depend on ghost particles
+        /*! Sub-classes that support overlapping the ghost update with computation override this method. They must not
+            access ghost particle data, and should call Communicator::progressUpdateGhosts() regularly. The following
+            call to computeForces() must then only add the remaining contributions.
+            \param timestep Current time step
+            \returns true if the interior forces were computed
+        */
+        virtual bool computeForcesInterior(unsigned int timestep)
+            {
+            return false;
+            }
+        #endif
     };
 
 //! Exports the ForceCompute class to python
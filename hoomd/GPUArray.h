@@ -170,6 +170,43 @@ class host_deleter
         bool m_use_device;     //!< Whether to use hostMallocManaged
         unsigned int m_N;      //!< Number of elements in array
     };
+
+//! Zero host memory
+/*! \param ptr Memory to clear
+    \param bytes Number of bytes to clear
+    \param exec_conf Execution configuration (may be NULL)
+
+    Most operating systems place a page of memory in the NUMA domain of the thread that first writes to it. With more
+    than one thread, a large allocation is cleared in one contiguous chunk per thread, so that its pages are spread
+    over the NUMA domains of the TBB worker threads instead of all landing in the domain of the allocating thread.
+    The threaded computes partition their loops independently, so this balances the memory bandwidth between the
+    domains but does not make any given element local to the thread that later processes it.
+*/
+inline void clear_host_memory(void *ptr, size_t bytes, const ExecutionConfiguration *exec_conf)
+    {
+    #ifdef ENABLE_TBB
+    // smaller allocations are not worth the thread synchronization
+    const size_t min_bytes = 1 << 20;
+
+    const unsigned int n_threads = exec_conf ? exec_conf->getNumThreads() : 0;
+    if (n_threads > 1 && bytes >= min_bytes)
+        {
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_threads, 1),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int chunk = r.begin(); chunk != r.end(); ++chunk)
+                {
+                const size_t first = bytes*chunk/n_threads;
+                const size_t last = bytes*(chunk+1)/n_threads;
+                memset((char *)ptr + first, 0, last - first);
+                }
+            }, tbb::simple_partitioner());
+        return;
+        }
+    #endif
+
+    memset(ptr, 0, bytes);
+    }
 } // end namespace detail
 
 } // end namespace hoomd
@@ -967,7 +1004,7 @@ template<class T> void GPUArray<T>::memclear(unsigned int first)
     assert(first < m_num_elements);
 
     // clear memory
-    memset((void *)(h_data.get()+first), 0, sizeof(T)*(m_num_elements-first));
+    hoomd::detail::clear_host_memory((void *)(h_data.get()+first), sizeof(T)*(m_num_elements-first), m_exec_conf.get());
 
 #ifdef ENABLE_CUDA
     if (m_exec_conf && m_exec_conf->isCUDAEnabled())
@@ -1243,7 +1280,7 @@ template<class T> T* GPUArray<T>::resizeHostArray(unsigned int num_elements)
         }
 #endif
     // clear memory
-    memset((void *)h_tmp, 0, sizeof(T)*num_elements);
+    hoomd::detail::clear_host_memory((void *)h_tmp, sizeof(T)*num_elements, m_exec_conf.get());
 
     // copy over data
     unsigned int num_copy_elements = m_num_elements > num_elements ? num_elements : m_num_elements;
@@ -1299,7 +1336,7 @@ template<class T> T* GPUArray<T>::resize2DHostArray(unsigned int pitch, unsigned
 #endif
 
     // clear memory
-    memset((void *)h_tmp, 0, sizeof(T)*new_pitch*new_height);
+    hoomd::detail::clear_host_memory((void *)h_tmp, sizeof(T)*new_pitch*new_height, m_exec_conf.get());
 
     // copy over data
     // every column is copied separately such as to align with the new pitch
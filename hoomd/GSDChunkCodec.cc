@@ -0,0 +1,292 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file GSDChunkCodec.cc
+    \brief Defines the GSDChunkCodec class
+*/
+
+#include "GSDChunkCodec.h"
+
+#ifdef ENABLE_ZLIB
+#include <zlib.h>
+#endif
+
+#include <string.h>
+#include <math.h>
+#include <stdexcept>
+
+using namespace std;
+
+const uint64_t GSDChunkCodec::no_reference;
+
+bool GSDChunkCodec::isDeflateAvailable()
+    {
+    #ifdef ENABLE_ZLIB
+    return true;
+    #else
+    return false;
+    #endif
+    }
+
+/*! \param out Buffer to append the compressed data to
+    \param in Data to compress
+*/
+void GSDChunkCodec::compress(std::vector<char>& out, const std::vector<char>& in)
+    {
+    #ifdef ENABLE_ZLIB
+    size_t offset = out.size();
+    uLongf size = compressBound(in.size());
+    out.resize(offset + size);
+
+    // the lowest compression level is several times faster and compresses shuffled data almost as well
+    int retval = compress2((Bytef *)&out[offset], &size, (const Bytef *)in.data(), in.size(), 1);
+    if (retval != Z_OK)
+        throw runtime_error("Error compressing GSD chunk");
+    out.resize(offset + size);
+    #else
+    throw runtime_error("Compressed GSD chunks require zlib");
+    #endif
+    }
+
+/*! \param out Buffer for the uncompressed data, must be resized to the uncompressed size
+    \param in Compressed data
+    \param size Size of the compressed data
+*/
+void GSDChunkCodec::uncompress(std::vector<char>& out, const char *in, size_t size)
+    {
+    #ifdef ENABLE_ZLIB
+    uLongf out_size = out.size();
+    int retval = ::uncompress((Bytef *)out.data(), &out_size, (const Bytef *)in, size);
+    if (retval != Z_OK || out_size != out.size())
+        throw runtime_error("Error decompressing GSD chunk");
+    #else
+    throw runtime_error("Compressed GSD chunks require zlib");
+    #endif
+    }
+
+/*! \param out Buffer that receives the header and the compressed data
+    \param type Type of the data
+    \param N Number of rows
+    \param M Number of columns
+    \param data Data to encode
+*/
+void GSDChunkCodec::encodeLossless(std::vector<char>& out,
+                                   gsd_type type,
+                                   uint64_t N,
+                                   uint32_t M,
+                                   const void *data)
+    {
+    size_t element_size = gsd_sizeof_type(type);
+    size_t n = N*M;
+
+    // store the n-th byte of all elements contiguously, exponents and high mantissa bits compress much better then
+    std::vector<char> shuffled(n*element_size);
+    const char *in = (const char *)data;
+    for (size_t i = 0; i < n; i++)
+        for (size_t b = 0; b < element_size; b++)
+            shuffled[b*n + i] = in[i*element_size + b];
+
+    Header header;
+    memset(&header, 0, sizeof(header));
+    header.flags = flag_shuffle | flag_deflate;
+    header.type = type;
+    header.M = M;
+    header.N = N;
+    header.ref_frame = no_reference;
+    header.raw_size = shuffled.size();
+
+    out.resize(sizeof(Header));
+    memcpy(out.data(), &header, sizeof(Header));
+    compress(out, shuffled);
+    }
+
+/*! \param q Rounded values (output)
+    \param data Values to round
+    \param n Number of values
+    \param tolerance Rounding step
+*/
+void GSDChunkCodec::quantize(std::vector<int64_t>& q, const float *data, size_t n, double tolerance)
+    {
+    q.resize(n);
+    for (size_t i = 0; i < n; i++)
+        {
+        double v = double(data[i]) / tolerance;
+        if (!(fabs(v) < double(INT64_MAX/2)))
+            throw runtime_error("Value out of range for the GSD compression tolerance");
+        q[i] = llround(v);
+        }
+    }
+
+/*! \param out Values (output, at least q.size() elements)
+    \param q Rounded values
+    \param tolerance Rounding step
+*/
+void GSDChunkCodec::dequantize(float *out, const std::vector<int64_t>& q, double tolerance)
+    {
+    for (size_t i = 0; i < q.size(); i++)
+        out[i] = float(double(q[i]) * tolerance);
+    }
+
+/*! \param out Buffer that receives the header and the encoded data
+    \param N Number of rows
+    \param M Number of columns
+    \param q Rounded values, see quantize()
+    \param ref Rounded values of the reference frame, or NULL
+    \param ref_frame Index of the reference frame in the file (ignored when \a ref is NULL)
+    \param tolerance Rounding step used for \a q and \a ref
+*/
+void GSDChunkCodec::encodeQuantized(std::vector<char>& out,
+                                    uint64_t N,
+                                    uint32_t M,
+                                    const std::vector<int64_t>& q,
+                                    const std::vector<int64_t> *ref,
+                                    uint64_t ref_frame,
+                                    double tolerance)
+    {
+    size_t n = N*M;
+    if (q.size() != n || (ref && ref->size() != n))
+        throw runtime_error("Invalid number of values for GSD chunk");
+
+    // zig-zag encode the (differences of the) values and store them with 7 bits per byte
+    std::vector<char> raw;
+    raw.reserve(n*2);
+    for (size_t i = 0; i < n; i++)
+        {
+        int64_t d = ref ? q[i] - (*ref)[i] : q[i];
+        uint64_t z = (uint64_t(d) << 1) ^ uint64_t(d >> 63);
+        while (z >= 0x80)
+            {
+            raw.push_back(char((z & 0x7f) | 0x80));
+            z >>= 7;
+            }
+        raw.push_back(char(z));
+        }
+
+    Header header;
+    memset(&header, 0, sizeof(header));
+    header.flags = flag_quantize;
+    header.type = GSD_TYPE_FLOAT;
+    header.M = M;
+    header.N = N;
+    header.ref_frame = ref ? ref_frame : no_reference;
+    header.raw_size = raw.size();
+    header.tolerance = tolerance;
+
+    if (isDeflateAvailable())
+        header.flags |= flag_deflate;
+
+    out.resize(sizeof(Header));
+    memcpy(out.data(), &header, sizeof(Header));
+
+    if (header.flags & flag_deflate)
+        compress(out, raw);
+    else
+        out.insert(out.end(), raw.begin(), raw.end());
+    }
+
+/*! \param data Compressed chunk
+    \param size Size of the compressed chunk in bytes
+*/
+GSDChunkCodec::Header GSDChunkCodec::readHeader(const char *data, size_t size)
+    {
+    if (size < sizeof(Header))
+        throw runtime_error("Truncated compressed GSD chunk");
+
+    Header header;
+    memcpy(&header, data, sizeof(Header));
+
+    if (header.reserved != 0 || header.M == 0 || (header.flags & ~(flag_shuffle | flag_deflate | flag_quantize)) != 0)
+        throw runtime_error("Invalid compressed GSD chunk");
+    if ((header.flags & flag_quantize) && (header.type != GSD_TYPE_FLOAT || !(header.tolerance > 0)))
+        throw runtime_error("Invalid compressed GSD chunk");
+    if (!(header.flags & flag_quantize) && header.raw_size != header.N*header.M*gsd_sizeof_type((gsd_type)header.type))
+        throw runtime_error("Invalid compressed GSD chunk");
+
+    return header;
+    }
+
+/*! \param out Decoded data (output), N*M elements of the type given in the header
+    \param data Compressed chunk
+    \param size Size of the compressed chunk in bytes
+*/
+void GSDChunkCodec::decodeLossless(void *out, const char *data, size_t size)
+    {
+    Header header = readHeader(data, size);
+    if (header.flags & flag_quantize)
+        throw runtime_error("Lossy GSD chunk decoded as lossless");
+
+    std::vector<char> raw(header.raw_size);
+    if (header.flags & flag_deflate)
+        uncompress(raw, data + sizeof(Header), size - sizeof(Header));
+    else if (size - sizeof(Header) == raw.size())
+        memcpy(raw.data(), data + sizeof(Header), raw.size());
+    else
+        throw runtime_error("Invalid compressed GSD chunk");
+
+    size_t element_size = gsd_sizeof_type((gsd_type)header.type);
+    size_t n = header.N*header.M;
+    char *dest = (char *)out;
+    if (header.flags & flag_shuffle)
+        {
+        for (size_t i = 0; i < n; i++)
+            for (size_t b = 0; b < element_size; b++)
+                dest[i*element_size + b] = raw[b*n + i];
+        }
+    else
+        {
+        memcpy(dest, raw.data(), raw.size());
+        }
+    }
+
+/*! \param q Rounded values (output). When the chunk holds differences, \a q must hold the values of the reference
+             frame on entry, and the differences are added.
+    \param data Compressed chunk
+    \param size Size of the compressed chunk in bytes
+*/
+void GSDChunkCodec::decodeQuantized(std::vector<int64_t>& q, const char *data, size_t size)
+    {
+    Header header = readHeader(data, size);
+    if (!(header.flags & flag_quantize))
+        throw runtime_error("Lossless GSD chunk decoded as lossy");
+
+    size_t n = header.N*header.M;
+    bool difference = header.ref_frame != no_reference;
+    if (difference && q.size() != n)
+        throw runtime_error("Reference frame of compressed GSD chunk has a different size");
+    if (!difference)
+        q.assign(n, 0);
+
+    std::vector<char> buffer;
+    const char *raw = data + sizeof(Header);
+    if (header.flags & flag_deflate)
+        {
+        buffer.resize(header.raw_size);
+        uncompress(buffer, data + sizeof(Header), size - sizeof(Header));
+        raw = buffer.data();
+        }
+    else if (size - sizeof(Header) != header.raw_size)
+        {
+        throw runtime_error("Invalid compressed GSD chunk");
+        }
+
+    size_t pos = 0;
+    for (size_t i = 0; i < n; i++)
+        {
+        uint64_t z = 0;
+        unsigned int shift = 0;
+        while (true)
+            {
+            if (pos >= header.raw_size || shift > 63)
+                throw runtime_error("Invalid compressed GSD chunk");
+            uint8_t byte = raw[pos++];
+            z |= uint64_t(byte & 0x7f) << shift;
+            shift += 7;
+            if (!(byte & 0x80))
+                break;
+            }
+
+        int64_t d = int64_t(z >> 1) ^ -int64_t(z & 1);
+        q[i] += d;
+        }
+    }
@@ -0,0 +1,115 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file GSDChunkCodec.h
+    \brief Declares the GSDChunkCodec class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "hoomd/extern/gsd.h"
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+
+#ifndef __GSD_CHUNK_CODEC_H__
+#define __GSD_CHUNK_CODEC_H__
+
+//! Encodes and decodes compressed data chunks in GSD files
+/*! GSD stores every chunk as a raw array. GSDDumpWriter can instead store selected per-particle chunks in a
+    compressed form, as a GSD_TYPE_UINT8 chunk named getCompressedName() of the original chunk. The data of such a
+    chunk starts with a Header followed by the encoded payload.
+
+    Two encodings are supported:
+     - Lossless: the bytes of all elements are shuffled so that the n-th byte of every element is stored
+       contiguously, then the result is compressed with deflate (requires zlib).
+     - Lossy: float values are rounded to integer multiples of a tolerance. Optionally, the difference to the
+       rounded values of a reference frame is stored instead. The integers are stored as zig-zag encoded
+       variable length integers, and compressed with deflate when zlib is available. The rounding error of every
+       value is at most half the tolerance, regardless of the number of frames in a chain of differences.
+
+    The byte order is the native one, as in the rest of the GSD file.
+
+    \ingroup utils
+*/
+class PYBIND11_EXPORT GSDChunkCodec
+    {
+    public:
+        //! Flags that describe the encoding of a chunk
+        enum Flags
+            {
+            flag_shuffle = 1,    //!< Bytes of the elements are shuffled
+            flag_deflate = 2,    //!< The payload is compressed with deflate
+            flag_quantize = 4,   //!< Values are rounded to multiples of the tolerance
+            };
+
+        //! Value of Header::ref_frame when a chunk does not refer to another frame
+        static const uint64_t no_reference = UINT64_MAX;
+
+        //! Header at the start of every compressed chunk
+        struct Header
+            {
+            uint8_t flags;          //!< Combination of Flags
+            uint8_t type;           //!< gsd_type of the decoded data
+            uint16_t reserved;      //!< Always zero
+            uint32_t M;             //!< Number of columns of the decoded data
+            uint64_t N;             //!< Number of rows of the decoded data
+            uint64_t ref_frame;     //!< Frame with the reference values of a difference, or no_reference
+            uint64_t raw_size;      //!< Size of the payload before deflate
+            double tolerance;       //!< Rounding tolerance of quantized chunks
+            };
+
+        //! Get the name of the chunk that stores \a name in compressed form
+        static std::string getCompressedName(const std::string& name)
+            {
+            return std::string("compressed/") + name;
+            }
+
+        //! Test if this build can compress chunks losslessly
+        static bool isDeflateAvailable();
+
+        //! Encode a chunk without loss
+        static void encodeLossless(std::vector<char>& out,
+                                   gsd_type type,
+                                   uint64_t N,
+                                   uint32_t M,
+                                   const void *data);
+
+        //! Round float values to integer multiples of the tolerance
+        static void quantize(std::vector<int64_t>& q, const float *data, size_t n, double tolerance);
+
+        //! Convert rounded values back to floats
+        static void dequantize(float *out, const std::vector<int64_t>& q, double tolerance);
+
+        //! Encode rounded float values, optionally as differences to those of a reference frame
+        static void encodeQuantized(std::vector<char>& out,
+                                    uint64_t N,
+                                    uint32_t M,
+                                    const std::vector<int64_t>& q,
+                                    const std::vector<int64_t> *ref,
+                                    uint64_t ref_frame,
+                                    double tolerance);
+
+        //! Read and validate the header of a compressed chunk
+        static Header readHeader(const char *data, size_t size);
+
+        //! Decode a chunk that was encoded with encodeLossless()
+        static void decodeLossless(void *out, const char *data, size_t size);
+
+        //! Decode a chunk that was encoded with encodeQuantized()
+        static void decodeQuantized(std::vector<int64_t>& q, const char *data, size_t size);
+
+    private:
+        //! Compress \a in with deflate and append the result to \a out
+        static void compress(std::vector<char>& out, const std::vector<char>& in);
+
+        //! Uncompress \a size bytes at \a in into \a out (which has the uncompressed size)
+        static void uncompress(std::vector<char>& out, const char *in, size_t size);
+    };
+
+#endif
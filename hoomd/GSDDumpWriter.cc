@@ -9,6 +9,7 @@
 */
 
 #include "GSDDumpWriter.h"
+#include "GSDChunkCodec.h"
 #include "Filesystem.h"
 #include "HOOMDVersion.h"
 
@@ -20,8 +21,10 @@
 #include "hoomd/extern/pybind/include/pybind11/numpy.h"
 
 #include <string.h>
+#include <errno.h>
 #include <stdexcept>
 #include <list>
+#include <algorithm>
 using namespace std;
 namespace py = pybind11;
 
@@ -44,7 +47,22 @@ GSDDumpWriter::GSDDumpWriter(std::shared_ptr<SystemDefinition> sysdef,
     : Analyzer(sysdef), m_fname(fname), m_overwrite(overwrite),
                         m_truncate(truncate),
                         m_is_initialized(false),
-                        m_group(group)
+                        m_group(group),
+                        m_nframes(0),
+                        m_async(false),
+                        m_drop_frames(false),
+                        m_max_queued_frames(2),
+                        m_n_dropped(0),
+                        m_io_stop(false),
+                        m_io_error(GSD_SUCCESS),
+                        m_io_errno(0),
+                        m_distributed(false),
+                        #ifdef ENABLE_MPI
+                        m_mpi_file_open(false),
+                        #endif
+                        m_compression(compression_none),
+                        m_tolerance(0),
+                        m_keyframe_interval(100)
     {
     m_exec_conf->msg->notice(5) << "Constructing GSDDumpWriter: " << m_fname << " " << overwrite << " " << truncate << endl;
     }
@@ -131,6 +149,7 @@ void GSDDumpWriter::initFileIO()
     m_exec_conf->msg->notice(3) << "dump.gsd: open gsd file " << m_fname << endl;
     retval = gsd_open(&m_handle, m_fname.c_str(), GSD_OPEN_APPEND);
     checkError(retval);
+    m_nframes = gsd_get_nframes(&m_handle);
 
     // validate schema
     if (string(m_handle.header.schema) != string("hoomd"))
@@ -156,6 +175,16 @@ GSDDumpWriter::~GSDDumpWriter()
     root = m_exec_conf->isRoot();
     #endif
 
+    // write out all staged frames
+    stopIOThread();
+    if (m_io_error != GSD_SUCCESS)
+        m_exec_conf->msg->error() << "dump.gsd: error " << m_io_error << " writing frames in the background - "
+                                  << m_fname << endl;
+
+    #ifdef ENABLE_MPI
+    closeDistributedFile();
+    #endif
+
     if (root && m_is_initialized)
         {
         m_exec_conf->msg->notice(5) << "dump.gsd: close gsd file " << m_fname << endl;
@@ -163,6 +192,357 @@ GSDDumpWriter::~GSDDumpWriter()
         }
     }
 
+/*! \param b True to write frames from a background thread
+
+    Disabling asynchronous mode writes out all staged frames first.
+*/
+void GSDDumpWriter::setAsync(bool b)
+    {
+    if (b && m_distributed)
+        {
+        m_exec_conf->msg->error() << "dump.gsd: Asynchronous writes are not supported in distributed mode" << endl;
+        throw runtime_error("Error setting up GSD file");
+        }
+
+    if (m_async && !b)
+        {
+        flush();
+        stopIOThread();
+        }
+
+    m_async = b;
+    }
+
+/*! \param n Maximum number of frames that may be staged for the I/O thread at any time
+*/
+void GSDDumpWriter::setMaxQueuedFrames(unsigned int n)
+    {
+    if (n == 0)
+        {
+        m_exec_conf->msg->error() << "dump.gsd: At least one frame must be allowed in the queue" << endl;
+        throw runtime_error("Error setting up GSD file");
+        }
+
+    m_max_queued_frames = n;
+    }
+
+/*! \param b True to write the per-particle chunks from all ranks in parallel
+
+    Distributed mode requires MPI and cannot be combined with asynchronous writes.
+*/
+void GSDDumpWriter::setDistributed(bool b)
+    {
+    #ifdef ENABLE_MPI
+    if (b && m_async)
+        {
+        m_exec_conf->msg->error() << "dump.gsd: Asynchronous writes are not supported in distributed mode" << endl;
+        throw runtime_error("Error setting up GSD file");
+        }
+
+    if (b && m_compression != compression_none)
+        {
+        m_exec_conf->msg->error() << "dump.gsd: Compression is not supported in distributed mode" << endl;
+        throw runtime_error("Error setting up GSD file");
+        }
+
+    if (!b)
+        closeDistributedFile();
+
+    m_distributed = b;
+    #else
+    if (b)
+        {
+        m_exec_conf->msg->error() << "dump.gsd: Distributed writes require MPI" << endl;
+        throw runtime_error("Error setting up GSD file");
+        }
+    #endif
+    }
+
+/*! \param mode One of "none", "lossless" or "lossy"
+    \param tolerance Rounding step of the lossy mode (in the units of the stored quantity)
+
+    Lossless compression requires zlib. Compression is not supported in distributed mode.
+*/
+void GSDDumpWriter::setCompression(const std::string& mode, double tolerance)
+    {
+    compression_mode compression;
+    if (mode == "none")
+        compression = compression_none;
+    else if (mode == "lossless")
+        compression = compression_lossless;
+    else if (mode == "lossy")
+        compression = compression_lossy;
+    else
+        {
+        m_exec_conf->msg->error() << "dump.gsd: Unknown compression mode " << mode << endl;
+        throw runtime_error("Error setting up GSD file");
+        }
+
+    if (compression == compression_lossless && !GSDChunkCodec::isDeflateAvailable())
+        {
+        m_exec_conf->msg->error() << "dump.gsd: Lossless compression requires HOOMD to be built with zlib" << endl;
+        throw runtime_error("Error setting up GSD file");
+        }
+
+    if (compression == compression_lossy && !(tolerance > 0))
+        {
+        m_exec_conf->msg->error() << "dump.gsd: The compression tolerance must be positive" << endl;
+        throw runtime_error("Error setting up GSD file");
+        }
+
+    if (compression != compression_none && m_distributed)
+        {
+        m_exec_conf->msg->error() << "dump.gsd: Compression is not supported in distributed mode" << endl;
+        throw runtime_error("Error setting up GSD file");
+        }
+
+    m_compression = compression;
+    m_tolerance = tolerance;
+    }
+
+/*! \param n Maximum number of frames between two frames that store the full values of a lossy compressed chunk
+*/
+void GSDDumpWriter::setKeyframeInterval(unsigned int n)
+    {
+    if (n == 0)
+        {
+        m_exec_conf->msg->error() << "dump.gsd: The keyframe interval must be positive" << endl;
+        throw runtime_error("Error setting up GSD file");
+        }
+
+    m_keyframe_interval = n;
+    }
+
+/*! Blocks until the I/O thread has written all staged frames to the file. Errors that occurred in the I/O thread
+    are raised here.
+*/
+void GSDDumpWriter::flush()
+    {
+    waitForQueue(1);
+    }
+
+void GSDDumpWriter::printStats()
+    {
+    if (m_n_dropped > 0)
+        m_exec_conf->msg->notice(1) << "dump.gsd: " << m_n_dropped << " frames dropped while the I/O queue was full - "
+                                    << m_fname << endl;
+    }
+
+/*! \param n Return when there are fewer than \a n frames in the queue
+
+    Also raises errors reported by the I/O thread.
+*/
+void GSDDumpWriter::waitForQueue(unsigned int n)
+    {
+    std::unique_lock<std::mutex> lock(m_io_mutex);
+    m_io_cv.wait(lock, [this, n] { return m_queue.size() < n; });
+
+    if (m_io_error != GSD_SUCCESS)
+        {
+        int retval = m_io_error;
+        m_io_error = GSD_SUCCESS;
+        errno = m_io_errno;
+        lock.unlock();
+        checkError(retval);
+        }
+    }
+
+void GSDDumpWriter::stopIOThread()
+    {
+    if (!m_io_thread.joinable())
+        return;
+
+        {
+        std::lock_guard<std::mutex> lock(m_io_mutex);
+        m_io_stop = true;
+        }
+    m_io_cv.notify_all();
+    m_io_thread.join();
+    m_io_stop = false;
+    }
+
+/*! The I/O thread writes the frame at the front of the queue without holding the lock. analyze() only appends to
+    the queue, which does not invalidate references to the front element.
+*/
+void GSDDumpWriter::ioThreadLoop()
+    {
+    std::unique_lock<std::mutex> lock(m_io_mutex);
+    while (true)
+        {
+        m_io_cv.wait(lock, [this] { return m_io_stop || !m_queue.empty(); });
+        if (m_queue.empty())
+            break;
+
+        const StagedFrame& frame = m_queue.front();
+        lock.unlock();
+
+        if (frame.prof)
+            frame.prof->traceBegin("Write GSD");
+
+        int retval = GSD_SUCCESS;
+        uint64_t bytes = 0;
+        for (unsigned int i = 0; i < frame.n_chunks && retval == GSD_SUCCESS; i++)
+            {
+            const StagedChunk& chunk = frame.chunks[i];
+            retval = gsd_write_chunk(&m_handle, chunk.name.c_str(), chunk.type, chunk.N, chunk.M, chunk.flags,
+                                     chunk.data.data());
+            bytes += chunk.data.size();
+            }
+        if (retval == GSD_SUCCESS)
+            retval = gsd_end_frame(&m_handle);
+        int err = errno;
+
+        if (frame.prof)
+            frame.prof->traceEnd(0, bytes);
+
+        lock.lock();
+        if (retval != GSD_SUCCESS && m_io_error == GSD_SUCCESS)
+            {
+            m_io_error = retval;
+            m_io_errno = err;
+            }
+        m_free_frames.push_back(std::move(m_queue.front()));
+        m_queue.pop_front();
+        m_io_cv.notify_all();
+        }
+    }
+
+/*! \param name Name of the chunk
+    \param type Data type
+    \param N Number of rows
+    \param M Number of columns
+    \param flags Flags passed on to gsd_write_chunk()
+    \param data Data to write
+
+    In asynchronous mode the data is copied into m_frame and written later by the I/O thread.
+*/
+int GSDDumpWriter::writeChunk(const char *name, gsd_type type, uint64_t N, uint32_t M, uint8_t flags, const void *data)
+    {
+    if (!m_async)
+        return gsd_write_chunk(&m_handle, name, type, N, M, flags, data);
+
+    if (m_frame.n_chunks == m_frame.chunks.size())
+        m_frame.chunks.push_back(StagedChunk());
+
+    StagedChunk& chunk = m_frame.chunks[m_frame.n_chunks++];
+    chunk.name = name;
+    chunk.type = type;
+    chunk.N = N;
+    chunk.M = M;
+    chunk.flags = flags;
+
+    size_t size = N*M*gsd_sizeof_type(type);
+    chunk.data.resize(size);
+    if (size > 0)
+        memcpy(&chunk.data[0], data, size);
+
+    return GSD_SUCCESS;
+    }
+
+/*! \param name Name of the chunk
+    \param N Number of rows
+    \param M Number of columns
+    \param data Data to write
+
+    Writes the chunk \a name as is, or the compressed chunk GSDChunkCodec::getCompressedName() of it.
+*/
+void GSDDumpWriter::writeParticleChunk(const std::string& name, uint32_t N, uint32_t M, const float *data)
+    {
+    int retval;
+    if (m_compression == compression_none)
+        {
+        retval = writeChunk(name.c_str(), GSD_TYPE_FLOAT, N, M, 0, (void *)data);
+        checkError(retval);
+        return;
+        }
+
+    try
+        {
+        if (m_compression == compression_lossless)
+            {
+            GSDChunkCodec::encodeLossless(m_compressed, GSD_TYPE_FLOAT, N, M, data);
+            }
+        else
+            {
+            std::vector<int64_t> q;
+            GSDChunkCodec::quantize(q, data, size_t(N)*M, m_tolerance);
+
+            // store full values when the values of the previous frame are not in the file (any more)
+            std::map<std::string, CompressionState>::iterator it = m_compression_state.find(name);
+            bool keyframe = it == m_compression_state.end() ||
+                            it->second.q.size() != q.size() ||
+                            it->second.frame >= m_nframes ||
+                            it->second.tolerance != m_tolerance ||
+                            m_nframes - it->second.keyframe >= m_keyframe_interval;
+
+            if (keyframe)
+                {
+                GSDChunkCodec::encodeQuantized(m_compressed, N, M, q, NULL, 0, m_tolerance);
+                }
+            else
+                {
+                GSDChunkCodec::encodeQuantized(m_compressed, N, M, q, &it->second.q, it->second.frame, m_tolerance);
+                }
+
+            CompressionState& state = m_compression_state[name];
+            state.q.swap(q);
+            state.frame = m_nframes;
+            state.tolerance = m_tolerance;
+            if (keyframe)
+                state.keyframe = m_nframes;
+            }
+        }
+    catch (const std::runtime_error& e)
+        {
+        m_exec_conf->msg->error() << "dump.gsd: " << e.what() << " in " << name << " - " << m_fname << endl;
+        throw runtime_error("Error writing GSD file");
+        }
+
+    std::string compressed_name = GSDChunkCodec::getCompressedName(name);
+    retval = writeChunk(compressed_name.c_str(), GSD_TYPE_UINT8, m_compressed.size(), 1, 0, (void *)&m_compressed[0]);
+    checkError(retval);
+    }
+
+/*! In asynchronous mode, the staged frame is passed on to the I/O thread. Blocks while the queue is full.
+*/
+void GSDDumpWriter::endFrame()
+    {
+    if (!m_async)
+        {
+        int retval = gsd_end_frame(&m_handle);
+        checkError(retval);
+        }
+    else
+        {
+        waitForQueue(m_max_queued_frames);
+
+            {
+            std::lock_guard<std::mutex> lock(m_io_mutex);
+            // the I/O thread must not read m_prof, which may be replaced between runs
+            m_frame.prof = m_prof;
+            m_queue.push_back(std::move(m_frame));
+
+            // reuse the storage of a frame that has already been written
+            if (!m_free_frames.empty())
+                {
+                m_frame = std::move(m_free_frames.back());
+                m_free_frames.pop_back();
+                }
+            else
+                {
+                m_frame = StagedFrame();
+                }
+            m_frame.n_chunks = 0;
+            }
+        m_io_cv.notify_all();
+
+        if (!m_io_thread.joinable())
+            m_io_thread = std::thread(&GSDDumpWriter::ioThreadLoop, this);
+        }
+
+    m_nframes++;
+    }
+
 /*! \param timestep Current time step of the simulation
 
     The first call to analyze() will create or overwrite the file and write out the current system configuration
@@ -176,16 +556,44 @@ void GSDDumpWriter::analyze(unsigned int timestep)
     if (m_prof)
         m_prof->push("Dump GSD");
 
-    // take particle data snapshot
-    m_exec_conf->msg->notice(10) << "dump.gsd: taking particle data snapshot" << endl;
-    SnapshotParticleData<float> snapshot;
-    const std::map<unsigned int, unsigned int>& map = m_pdata->takeSnapshot<float>(snapshot);
-
 #ifdef ENABLE_MPI
     // if we are not the root processor, do not perform file I/O
     root = m_exec_conf->isRoot();
 #endif
 
+    // skip this frame when the I/O thread is still busy with the previous ones
+    bool drop = false;
+    if (root && m_async && m_drop_frames)
+        {
+        std::lock_guard<std::mutex> lock(m_io_mutex);
+        drop = m_queue.size() >= m_max_queued_frames;
+        }
+
+    #ifdef ENABLE_MPI
+    bcast(drop, 0, m_exec_conf->getMPICommunicator());
+    #endif
+
+    if (drop)
+        {
+        m_n_dropped++;
+        m_exec_conf->msg->notice(2) << "dump.gsd: I/O queue full, dropping frame at step " << timestep << endl;
+        if (m_prof)
+            m_prof->pop();
+        return;
+        }
+
+    // discard chunks left over from an aborted frame
+    m_frame.n_chunks = 0;
+
+    // take particle data snapshot, in distributed mode the ranks write their particles directly
+    SnapshotParticleData<float> snapshot;
+    std::map<unsigned int, unsigned int> map;
+    if (!m_distributed)
+        {
+        m_exec_conf->msg->notice(10) << "dump.gsd: taking particle data snapshot" << endl;
+        map = m_pdata->takeSnapshot<float>(snapshot);
+        }
+
     // open the file if it is not yet opened
     if (! m_is_initialized && root)
         initFileIO();
@@ -194,26 +602,40 @@ void GSDDumpWriter::analyze(unsigned int timestep)
     if (m_truncate && root)
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: truncating file" << endl;
+        flush();
         retval = gsd_truncate(&m_handle);
         checkError(retval);
+        m_nframes = 0;
         }
 
     uint64_t nframes = 0;
     if (root)
         {
-        nframes = gsd_get_nframes(&m_handle);
+        nframes = m_nframes;
         m_exec_conf->msg->notice(10) << "dump.gsd: " << m_fname << " has " << nframes << " frames" << endl;
         }
 
     #ifdef ENABLE_MPI
     bcast(nframes, 0, m_exec_conf->getMPICommunicator());
+
+    // all ranks decide which chunks to write in distributed mode
+    if (m_distributed)
+        bcast(m_nondefault, 0, m_exec_conf->getMPICommunicator());
     #endif
 
+    // write out the frame header on all frames
     if (root)
-        {
-        // write out the frame header on all frames
         writeFrameHeader(timestep);
 
+    #ifdef ENABLE_MPI
+    if (m_distributed)
+        {
+        writeParticlesDistributed(nframes);
+        }
+    else
+    #endif
+    if (root)
+        {
         // only write out data chunk categories if requested, or if on frame 0
         if (m_write_attribute || nframes == 0)
             writeAttributes(snapshot, map);
@@ -248,6 +670,10 @@ void GSDDumpWriter::analyze(unsigned int timestep)
             writeTopology(bdata_snapshot, adata_snapshot, ddata_snapshot, idata_snapshot, cdata_snapshot, pdata_snapshot);
         }
 
+    // slots write to m_handle directly, make sure the I/O thread is not using it
+    if (root && m_write_signal.getNumSlots() > 0)
+        flush();
+
     // emit on all ranks, the slot needs to handle the mpi logic.
     m_write_signal.emit(m_handle);
 
@@ -256,8 +682,7 @@ void GSDDumpWriter::analyze(unsigned int timestep)
     if (root)
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: ending frame" << endl;
-        retval = gsd_end_frame(&m_handle);
-        checkError(retval);
+        endFrame();
         }
 
     if (m_prof)
@@ -279,7 +704,7 @@ void GSDDumpWriter::writeTypeMapping(std::string chunk, std::vector< std::string
         std::vector<char> types(max_len * type_mapping.size());
         for (unsigned int i = 0; i < type_mapping.size(); i++)
             strncpy(&types[max_len*i], type_mapping[i].c_str(), max_len);
-        int retval = gsd_write_chunk(&m_handle, chunk.c_str(), GSD_TYPE_UINT8, type_mapping.size(), max_len, 0, (void *)&types[0]);
+        int retval = writeChunk(chunk.c_str(), GSD_TYPE_UINT8, type_mapping.size(), max_len, 0, (void *)&types[0]);
         checkError(retval);
         }
 
@@ -298,14 +723,14 @@ void GSDDumpWriter::writeFrameHeader(unsigned int timestep)
     int retval;
     m_exec_conf->msg->notice(10) << "dump.gsd: writing configuration/step" << endl;
     uint64_t step = timestep;
-    retval = gsd_write_chunk(&m_handle, "configuration/step", GSD_TYPE_UINT64, 1, 1, 0, (void *)&step);
+    retval = writeChunk("configuration/step", GSD_TYPE_UINT64, 1, 1, 0, (void *)&step);
     checkError(retval);
 
-    if (gsd_get_nframes(&m_handle) == 0)
+    if (m_nframes == 0)
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: writing configuration/dimensions" << endl;
         uint8_t dimensions = m_sysdef->getNDimensions();
-        retval = gsd_write_chunk(&m_handle, "configuration/dimensions", GSD_TYPE_UINT8, 1, 1, 0, (void *)&dimensions);
+        retval = writeChunk("configuration/dimensions", GSD_TYPE_UINT8, 1, 1, 0, (void *)&dimensions);
         checkError(retval);
         }
 
@@ -318,12 +743,12 @@ void GSDDumpWriter::writeFrameHeader(unsigned int timestep)
     box_a[3] = box.getTiltFactorXY();
     box_a[4] = box.getTiltFactorXZ();
     box_a[5] = box.getTiltFactorYZ();
-    retval = gsd_write_chunk(&m_handle, "configuration/box", GSD_TYPE_FLOAT, 6, 1, 0, (void *)box_a);
+    retval = writeChunk("configuration/box", GSD_TYPE_FLOAT, 6, 1, 0, (void *)box_a);
     checkError(retval);
 
     m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/N" << endl;
     uint32_t N = m_group->getNumMembersGlobal();
-    retval = gsd_write_chunk(&m_handle, "particles/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
+    retval = writeChunk("particles/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
     checkError(retval);
     }
 
@@ -335,7 +760,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
     {
     uint32_t N = m_group->getNumMembersGlobal();
     int retval;
-    uint64_t nframes = gsd_get_nframes(&m_handle);
+    uint64_t nframes = m_nframes;
 
     writeTypeMapping("particles/types", snapshot.type_mapping);
 
@@ -361,7 +786,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
         if (!all_default || (nframes > 0 && m_nondefault["particles/typeid"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/typeid" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&type[0]);
+            retval = writeChunk("particles/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&type[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/typeid"] = true;
@@ -390,7 +815,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
         if (!all_default || (nframes > 0 && m_nondefault["particles/mass"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/mass" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/mass", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
+            retval = writeChunk("particles/mass", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/mass"] = true;
@@ -414,7 +839,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
         if (!all_default || (nframes > 0 && m_nondefault["particles/charge"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/charge" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/charge", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
+            retval = writeChunk("particles/charge", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/charge"] = true;
@@ -439,7 +864,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
         if (!all_default || (nframes > 0 && m_nondefault["particles/diameter"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/diameter" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/diameter", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
+            retval = writeChunk("particles/diameter", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/diameter"] = true;
@@ -468,7 +893,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
         if (!all_default || (nframes > 0 && m_nondefault["particles/body"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/body" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/body", GSD_TYPE_INT32, N, 1, 0, (void *)&body[0]);
+            retval = writeChunk("particles/body", GSD_TYPE_INT32, N, 1, 0, (void *)&body[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/body"] = true;
@@ -503,7 +928,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
         if (!all_default || (nframes > 0 && m_nondefault["particles/moment_inertia"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/moment_inertia" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/moment_inertia", GSD_TYPE_FLOAT, N, 3, 0, (void *)&data[0]);
+            retval = writeChunk("particles/moment_inertia", GSD_TYPE_FLOAT, N, 3, 0, (void *)&data[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/moment_inertia"] = true;
@@ -518,8 +943,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
 void GSDDumpWriter::writeProperties(const SnapshotParticleData<float>& snapshot, const std::map<unsigned int, unsigned int> &map)
     {
     uint32_t N = m_group->getNumMembersGlobal();
-    int retval;
-    uint64_t nframes = gsd_get_nframes(&m_handle);
+    uint64_t nframes = m_nframes;
 
         {
         std::vector<float> data(uint64_t(N)*3);
@@ -539,8 +963,7 @@ void GSDDumpWriter::writeProperties(const SnapshotParticleData<float>& snapshot,
             }
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/position" << endl;
-        retval = gsd_write_chunk(&m_handle, "particles/position", GSD_TYPE_FLOAT, N, 3, 0, (void *)&data[0]);
-        checkError(retval);
+        writeParticleChunk("particles/position", N, 3, &data[0]);
         }
 
         {
@@ -573,8 +996,7 @@ void GSDDumpWriter::writeProperties(const SnapshotParticleData<float>& snapshot,
         if (!all_default || (nframes > 0 && m_nondefault["particles/orientation"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/orientation" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/orientation", GSD_TYPE_FLOAT, N, 4, 0, (void *)&data[0]);
-            checkError(retval);
+            writeParticleChunk("particles/orientation", N, 4, &data[0]);
             if (nframes == 0)
                 m_nondefault["particles/orientation"] = true;
             }
@@ -589,7 +1011,7 @@ void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, co
     {
     uint32_t N = m_group->getNumMembersGlobal();
     int retval;
-    uint64_t nframes = gsd_get_nframes(&m_handle);
+    uint64_t nframes = m_nframes;
 
         {
         std::vector<float> data(uint64_t(N)*3);
@@ -619,8 +1041,7 @@ void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, co
         if (!all_default || (nframes > 0 && m_nondefault["particles/velocity"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/velocity" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/velocity", GSD_TYPE_FLOAT, N, 3, 0, (void *)&data[0]);
-            checkError(retval);
+            writeParticleChunk("particles/velocity", N, 3, &data[0]);
             if (nframes == 0)
                 m_nondefault["particles/velocity"] = true;
             }
@@ -656,7 +1077,7 @@ void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, co
         if (!all_default || (nframes > 0 && m_nondefault["particles/angmom"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/angmom" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/angmom", GSD_TYPE_FLOAT, N, 4, 0, (void *)&data[0]);
+            retval = writeChunk("particles/angmom", GSD_TYPE_FLOAT, N, 4, 0, (void *)&data[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/angmom"] = true;
@@ -691,7 +1112,7 @@ void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, co
         if (!all_default || (nframes > 0 && m_nondefault["particles/image"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/image" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/image", GSD_TYPE_INT32, N, 3, 0, (void *)&data[0]);
+            retval = writeChunk("particles/image", GSD_TYPE_INT32, N, 3, 0, (void *)&data[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/image"] = true;
@@ -699,6 +1120,385 @@ void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, co
         }
     }
 
+#ifdef ENABLE_MPI
+/*! \param nframes Number of frames in the file (the same on all ranks)
+
+    Each rank converts the data of its local group members to the file format and writes it to the rows given by the
+    position of the member tags in the sorted group member list. The same chunks as in writeAttributes(),
+    writeProperties() and writeMomenta() are written, the all-default tests are reduced over all ranks.
+*/
+void GSDDumpWriter::writeParticlesDistributed(uint64_t nframes)
+    {
+    bool root = m_exec_conf->isRoot();
+    bool write_attribute = m_write_attribute || nframes == 0;
+    bool write_property = m_write_property || nframes == 0;
+    bool write_momentum = m_write_momentum || nframes == 0;
+
+    if (root && write_attribute)
+        {
+        std::vector<std::string> type_mapping;
+        for (unsigned int i = 0; i < m_pdata->getNTypes(); i++)
+            type_mapping.push_back(m_pdata->getNameByType(i));
+        writeTypeMapping("particles/types", type_mapping);
+        }
+
+    // find the file rows of the local group members
+    unsigned int N_global = m_group->getNumMembersGlobal();
+    unsigned int n_local = m_group->getNumMembers();
+    const GlobalArray<unsigned int>& member_idx = m_group->getIndexArray();
+    const GlobalArray<unsigned int>& member_tags = m_group->getMemberTagArray();
+
+    std::vector< std::pair<unsigned int, unsigned int> > rows(n_local);
+        {
+        ArrayHandle<unsigned int> h_member_idx(member_idx, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_member_tags(member_tags, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+        for (unsigned int i = 0; i < n_local; i++)
+            {
+            unsigned int idx = h_member_idx.data[i];
+            const unsigned int *row = std::lower_bound(h_member_tags.data, h_member_tags.data + N_global, h_tag.data[idx]);
+            rows[i] = std::make_pair((unsigned int)(row - h_member_tags.data), idx);
+            }
+        }
+    std::sort(rows.begin(), rows.end());
+
+    // merge consecutive rows into runs to keep the file view small
+    DistributedLayout layout;
+    layout.idx.resize(n_local);
+    for (unsigned int i = 0; i < n_local; i++)
+        {
+        layout.idx[i] = rows[i].second;
+        if (i > 0 && rows[i].first == rows[i-1].first + 1)
+            {
+            layout.run_length.back()++;
+            }
+        else
+            {
+            layout.run_start.push_back(rows[i].first);
+            layout.run_length.push_back(1);
+            }
+        }
+
+    // the file stays open for the lifetime of the writer, the root rank has created it by now
+    if (!m_mpi_file_open)
+        {
+        // the file name is only required to be valid on the root rank
+        std::string fname = m_fname;
+        bcast(fname, 0, m_exec_conf->getMPICommunicator());
+
+        int retval = MPI_File_open(m_exec_conf->getMPICommunicator(), (char *)fname.c_str(), MPI_MODE_WRONLY,
+                                   MPI_INFO_NULL, &m_mpi_file);
+        if (retval != MPI_SUCCESS)
+            {
+            m_exec_conf->msg->error() << "dump.gsd: Unable to open " << fname << " with MPI-IO" << endl;
+            throw runtime_error("Error writing GSD file");
+            }
+        m_mpi_file_open = true;
+        }
+    MPI_File fh = m_mpi_file;
+
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+
+    if (write_attribute)
+        {
+        ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+
+            {
+            std::vector<uint32_t> type(n_local);
+            bool all_default = true;
+            for (unsigned int i = 0; i < n_local; i++)
+                {
+                type[i] = uint32_t(__scalar_as_int(h_pos.data[layout.idx[i]].w));
+                if (type[i] != 0)
+                    all_default = false;
+                }
+            writeDistributedChunk(fh, layout, "particles/typeid", GSD_TYPE_UINT32, 1, type.data(), all_default, false,
+                                  nframes);
+            }
+
+            {
+            std::vector<float> data(n_local);
+            bool all_default = true;
+            for (unsigned int i = 0; i < n_local; i++)
+                {
+                data[i] = float(h_vel.data[layout.idx[i]].w);
+                if (data[i] != float(1.0))
+                    all_default = false;
+                }
+            writeDistributedChunk(fh, layout, "particles/mass", GSD_TYPE_FLOAT, 1, data.data(), all_default, false,
+                                  nframes);
+
+            all_default = true;
+            for (unsigned int i = 0; i < n_local; i++)
+                {
+                data[i] = float(h_charge.data[layout.idx[i]]);
+                if (data[i] != float(0.0))
+                    all_default = false;
+                }
+            writeDistributedChunk(fh, layout, "particles/charge", GSD_TYPE_FLOAT, 1, data.data(), all_default, false,
+                                  nframes);
+
+            all_default = true;
+            for (unsigned int i = 0; i < n_local; i++)
+                {
+                data[i] = float(h_diameter.data[layout.idx[i]]);
+                if (data[i] != float(1.0))
+                    all_default = false;
+                }
+            writeDistributedChunk(fh, layout, "particles/diameter", GSD_TYPE_FLOAT, 1, data.data(), all_default, false,
+                                  nframes);
+            }
+
+            {
+            std::vector<int32_t> body(n_local);
+            bool all_default = true;
+            for (unsigned int i = 0; i < n_local; i++)
+                {
+                unsigned int b = h_body.data[layout.idx[i]];
+                if (b != NO_BODY)
+                    all_default = false;
+                body[i] = int32_t(b);
+                }
+            writeDistributedChunk(fh, layout, "particles/body", GSD_TYPE_INT32, 1, body.data(), all_default, false,
+                                  nframes);
+            }
+
+            {
+            std::vector<float> data(uint64_t(n_local)*3);
+            bool all_default = true;
+            for (unsigned int i = 0; i < n_local; i++)
+                {
+                Scalar3 I = h_inertia.data[layout.idx[i]];
+                data[i*3+0] = float(I.x);
+                data[i*3+1] = float(I.y);
+                data[i*3+2] = float(I.z);
+                if (data[i*3+0] != float(0.0) || data[i*3+1] != float(0.0) || data[i*3+2] != float(0.0))
+                    all_default = false;
+                }
+            writeDistributedChunk(fh, layout, "particles/moment_inertia", GSD_TYPE_FLOAT, 3, data.data(), all_default,
+                                  false, nframes);
+            }
+        }
+
+    if (write_property)
+        {
+        const BoxDim& global_box = m_pdata->getGlobalBox();
+        Scalar3 origin = m_pdata->getOrigin();
+        int3 o_image = m_pdata->getOriginImage();
+
+            {
+            std::vector<float> data(uint64_t(n_local)*3);
+            for (unsigned int i = 0; i < n_local; i++)
+                {
+                unsigned int idx = layout.idx[i];
+
+                // same convention as the particle data snapshot
+                Scalar3 pos = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z) - origin;
+                int3 image = h_image.data[idx];
+                image.x -= o_image.x;
+                image.y -= o_image.y;
+                image.z -= o_image.z;
+                global_box.wrap(pos, image);
+
+                data[i*3+0] = float(pos.x);
+                data[i*3+1] = float(pos.y);
+                data[i*3+2] = float(pos.z);
+                }
+            writeDistributedChunk(fh, layout, "particles/position", GSD_TYPE_FLOAT, 3, data.data(), false, true,
+                                  nframes);
+            }
+
+            {
+            ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host,
+                                               access_mode::read);
+            std::vector<float> data(uint64_t(n_local)*4);
+            bool all_default = true;
+            for (unsigned int i = 0; i < n_local; i++)
+                {
+                Scalar4 q = h_orientation.data[layout.idx[i]];
+                data[i*4+0] = float(q.x);
+                data[i*4+1] = float(q.y);
+                data[i*4+2] = float(q.z);
+                data[i*4+3] = float(q.w);
+                if (data[i*4+0] != float(1.0) || data[i*4+1] != float(0.0) || data[i*4+2] != float(0.0) ||
+                    data[i*4+3] != float(0.0))
+                    all_default = false;
+                }
+            writeDistributedChunk(fh, layout, "particles/orientation", GSD_TYPE_FLOAT, 4, data.data(), all_default,
+                                  false, nframes);
+            }
+        }
+
+    if (write_momentum)
+        {
+            {
+            std::vector<float> data(uint64_t(n_local)*3);
+            bool all_default = true;
+            for (unsigned int i = 0; i < n_local; i++)
+                {
+                Scalar4 v = h_vel.data[layout.idx[i]];
+                data[i*3+0] = float(v.x);
+                data[i*3+1] = float(v.y);
+                data[i*3+2] = float(v.z);
+                if (data[i*3+0] != float(0.0) || data[i*3+1] != float(0.0) || data[i*3+2] != float(0.0))
+                    all_default = false;
+                }
+            writeDistributedChunk(fh, layout, "particles/velocity", GSD_TYPE_FLOAT, 3, data.data(), all_default, false,
+                                  nframes);
+            }
+
+            {
+            ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host,
+                                          access_mode::read);
+            std::vector<float> data(uint64_t(n_local)*4);
+            bool all_default = true;
+            for (unsigned int i = 0; i < n_local; i++)
+                {
+                Scalar4 a = h_angmom.data[layout.idx[i]];
+                data[i*4+0] = float(a.x);
+                data[i*4+1] = float(a.y);
+                data[i*4+2] = float(a.z);
+                data[i*4+3] = float(a.w);
+                if (data[i*4+0] != float(0.0) || data[i*4+1] != float(0.0) || data[i*4+2] != float(0.0) ||
+                    data[i*4+3] != float(0.0))
+                    all_default = false;
+                }
+            writeDistributedChunk(fh, layout, "particles/angmom", GSD_TYPE_FLOAT, 4, data.data(), all_default, false,
+                                  nframes);
+            }
+
+            {
+            Scalar3 origin = m_pdata->getOrigin();
+            int3 o_image = m_pdata->getOriginImage();
+            const BoxDim& global_box = m_pdata->getGlobalBox();
+
+            std::vector<int32_t> data(uint64_t(n_local)*3);
+            bool all_default = true;
+            for (unsigned int i = 0; i < n_local; i++)
+                {
+                unsigned int idx = layout.idx[i];
+                Scalar3 pos = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z) - origin;
+                int3 image = h_image.data[idx];
+                image.x -= o_image.x;
+                image.y -= o_image.y;
+                image.z -= o_image.z;
+                global_box.wrap(pos, image);
+
+                data[i*3+0] = image.x;
+                data[i*3+1] = image.y;
+                data[i*3+2] = image.z;
+                if (image.x != 0 || image.y != 0 || image.z != 0)
+                    all_default = false;
+                }
+            writeDistributedChunk(fh, layout, "particles/image", GSD_TYPE_INT32, 3, data.data(), all_default, false,
+                                  nframes);
+            }
+        }
+
+    // make the rows visible to the root rank's file handle before it completes the frame
+    MPI_File_sync(fh);
+    }
+
+/*! The handle is closed when the writer is destroyed or distributed mode is turned off. It is left alone if MPI has
+    already been finalized.
+*/
+void GSDDumpWriter::closeDistributedFile()
+    {
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (m_mpi_file_open && !finalized)
+        MPI_File_close(&m_mpi_file);
+    m_mpi_file_open = false;
+    }
+
+/*! \param fh File opened collectively with MPI-IO
+    \param layout Rows of the local group members
+    \param name Name of the chunk
+    \param type Data type
+    \param M Number of columns
+    \param data Rows of the local group members, in file order
+    \param all_default True if all local rows have the default value
+    \param always True if the chunk is written regardless of its value
+    \param nframes Number of frames in the file
+
+    The root rank reserves the chunk in the file and broadcasts its location, then all ranks write their rows with a
+    single collective call.
+*/
+void GSDDumpWriter::writeDistributedChunk(MPI_File fh,
+                                          const DistributedLayout& layout,
+                                          const char *name,
+                                          gsd_type type,
+                                          uint32_t M,
+                                          const void *data,
+                                          bool all_default,
+                                          bool always,
+                                          uint64_t nframes)
+    {
+    MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
+
+    if (!always)
+        {
+        int local_default = all_default;
+        int global_default = 0;
+        MPI_Allreduce(&local_default, &global_default, 1, MPI_INT, MPI_LAND, mpi_comm);
+        if (global_default && !(nframes > 0 && m_nondefault[name]))
+            return;
+        }
+
+    m_exec_conf->msg->notice(10) << "dump.gsd: writing " << name << endl;
+
+    int retval = GSD_SUCCESS;
+    int64_t location = 0;
+    if (m_exec_conf->isRoot())
+        retval = gsd_reserve_chunk(&m_handle, name, type, m_group->getNumMembersGlobal(), M, 0, &location);
+    bcast(retval, 0, mpi_comm);
+    checkError(retval);
+    bcast(location, 0, mpi_comm);
+
+    // describe the local rows in units of whole rows, so that the int counts passed to MPI hold numbers of rows
+    // and not bytes, which overflow for chunks larger than 2 GiB. Only the byte offsets need 64 bits.
+    size_t row_size = M*gsd_sizeof_type(type);
+    MPI_Datatype rowtype;
+    MPI_Type_contiguous(int(row_size), MPI_BYTE, &rowtype);
+    MPI_Type_commit(&rowtype);
+
+    unsigned int n_runs = layout.run_start.size();
+    std::vector<int> block_length(n_runs);
+    std::vector<MPI_Aint> displacement(n_runs);
+    for (unsigned int r = 0; r < n_runs; r++)
+        {
+        block_length[r] = int(layout.run_length[r]);
+        displacement[r] = MPI_Aint(layout.run_start[r])*MPI_Aint(row_size);
+        }
+
+    MPI_Datatype filetype;
+    MPI_Type_create_hindexed(n_runs, block_length.data(), displacement.data(), rowtype, &filetype);
+    MPI_Type_commit(&filetype);
+
+    MPI_Status status;
+    retval = MPI_File_set_view(fh, MPI_Offset(location), MPI_BYTE, filetype, (char *)"native", MPI_INFO_NULL);
+    if (retval == MPI_SUCCESS)
+        retval = MPI_File_write_all(fh, (void *)data, int(layout.idx.size()), rowtype, &status);
+    MPI_Type_free(&filetype);
+    MPI_Type_free(&rowtype);
+
+    if (retval != MPI_SUCCESS)
+        {
+        m_exec_conf->msg->error() << "dump.gsd: MPI-IO error writing " << name << " - " << m_fname << endl;
+        throw runtime_error("Error writing GSD file");
+        }
+
+    if (nframes == 0 && !always)
+        m_nondefault[name] = true;
+    }
+#endif
+
 /*! \param bond Bond data snapshot
     \param angle Angle data snapshot
     \param dihedral Dihedral data snapshot
@@ -719,68 +1519,68 @@ void GSDDumpWriter::writeTopology(BondData::Snapshot& bond,
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: writing bonds/N" << endl;
         uint32_t N = bond.size;
-        int retval = gsd_write_chunk(&m_handle, "bonds/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
+        int retval = writeChunk("bonds/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
         checkError(retval);
 
         writeTypeMapping("bonds/types", bond.type_mapping);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing bonds/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "bonds/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&bond.type_id[0]);
+        retval = writeChunk("bonds/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&bond.type_id[0]);
         checkError(retval);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing bonds/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "bonds/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&bond.groups[0]);
+        retval = writeChunk("bonds/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&bond.groups[0]);
         checkError(retval);
         }
     if (angle.size > 0)
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: writing angles/N" << endl;
         uint32_t N = angle.size;
-        int retval = gsd_write_chunk(&m_handle, "angles/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
+        int retval = writeChunk("angles/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
         checkError(retval);
 
         writeTypeMapping("angles/types", angle.type_mapping);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing angles/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "angles/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&angle.type_id[0]);
+        retval = writeChunk("angles/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&angle.type_id[0]);
         checkError(retval);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing angles/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "angles/group", GSD_TYPE_UINT32, N, 3, 0, (void *)&angle.groups[0]);
+        retval = writeChunk("angles/group", GSD_TYPE_UINT32, N, 3, 0, (void *)&angle.groups[0]);
         checkError(retval);
         }
     if (dihedral.size > 0)
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: writing dihedrals/N" << endl;
         uint32_t N = dihedral.size;
-        int retval = gsd_write_chunk(&m_handle, "dihedrals/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
+        int retval = writeChunk("dihedrals/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
         checkError(retval);
 
         writeTypeMapping("dihedrals/types", dihedral.type_mapping);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing dihedrals/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "dihedrals/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&dihedral.type_id[0]);
+        retval = writeChunk("dihedrals/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&dihedral.type_id[0]);
         checkError(retval);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing dihedrals/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "dihedrals/group", GSD_TYPE_UINT32, N, 4, 0, (void *)&dihedral.groups[0]);
+        retval = writeChunk("dihedrals/group", GSD_TYPE_UINT32, N, 4, 0, (void *)&dihedral.groups[0]);
         checkError(retval);
         }
     if (improper.size > 0)
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: writing impropers/N" << endl;
         uint32_t N = improper.size;
-        int retval = gsd_write_chunk(&m_handle, "impropers/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
+        int retval = writeChunk("impropers/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
         checkError(retval);
 
         writeTypeMapping("impropers/types", improper.type_mapping);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing impropers/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "impropers/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&improper.type_id[0]);
+        retval = writeChunk("impropers/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&improper.type_id[0]);
         checkError(retval);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing impropers/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "impropers/group", GSD_TYPE_UINT32, N, 4, 0, (void *)&improper.groups[0]);
+        retval = writeChunk("impropers/group", GSD_TYPE_UINT32, N, 4, 0, (void *)&improper.groups[0]);
         checkError(retval);
         }
 
@@ -788,7 +1588,7 @@ void GSDDumpWriter::writeTopology(BondData::Snapshot& bond,
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: writing constraints/N" << endl;
         uint32_t N = constraint.size;
-        int retval = gsd_write_chunk(&m_handle, "constraints/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
+        int retval = writeChunk("constraints/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
         checkError(retval);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing constraints/value" << endl;
@@ -798,12 +1598,12 @@ void GSDDumpWriter::writeTopology(BondData::Snapshot& bond,
             for (unsigned int i = 0; i < N; i++)
                 data[i] = float(constraint.val[i]);
 
-            retval = gsd_write_chunk(&m_handle, "constraints/value", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
+            retval = writeChunk("constraints/value", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
             checkError(retval);
             }
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing constraints/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "constraints/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&constraint.groups[0]);
+        retval = writeChunk("constraints/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&constraint.groups[0]);
         checkError(retval);
         }
 
@@ -811,17 +1611,17 @@ void GSDDumpWriter::writeTopology(BondData::Snapshot& bond,
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: writing pairs/N" << endl;
         uint32_t N = pair.size;
-        int retval = gsd_write_chunk(&m_handle, "pairs/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
+        int retval = writeChunk("pairs/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
         checkError(retval);
 
         writeTypeMapping("pairs/types", pair.type_mapping);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing pairs/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "pairs/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&pair.type_id[0]);
+        retval = writeChunk("pairs/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&pair.type_id[0]);
         checkError(retval);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing pairs/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "pairs/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&pair.groups[0]);
+        retval = writeChunk("pairs/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&pair.groups[0]);
         checkError(retval);
         }
     }
@@ -899,7 +1699,7 @@ void GSDDumpWriter::writeUser(unsigned int timestep, bool root)
                 throw runtime_error("Invalid numpy dimension in gsd user-defined log data [" + item.first + "]");
                 }
 
-            int retval = gsd_write_chunk(&m_handle, name.c_str(), type, arr.shape(0), M, 0, (void *)arr.data());
+            int retval = writeChunk(name.c_str(), type, arr.shape(0), M, 0, (void *)arr.data());
             checkError(retval);
             }
         }
@@ -972,6 +1772,8 @@ void GSDDumpWriter::populateNonDefault()
     for (auto const& chunk : chunks)
         {
         const gsd_index_entry *entry = gsd_find_chunk(&m_handle, 0, chunk.c_str());
+        if (entry == nullptr)
+            entry = gsd_find_chunk(&m_handle, 0, GSDChunkCodec::getCompressedName(chunk).c_str());
         m_nondefault[chunk] = (entry != nullptr);
         }
 
@@ -989,6 +1791,13 @@ void export_GSDDumpWriter(py::module& m)
         .def("setWriteProperty", &GSDDumpWriter::setWriteProperty)
         .def("setWriteMomentum", &GSDDumpWriter::setWriteMomentum)
         .def("setWriteTopology", &GSDDumpWriter::setWriteTopology)
+        .def("setAsync", &GSDDumpWriter::setAsync)
+        .def("setDropFrames", &GSDDumpWriter::setDropFrames)
+        .def("setMaxQueuedFrames", &GSDDumpWriter::setMaxQueuedFrames)
+        .def("flush", &GSDDumpWriter::flush)
+        .def("setDistributed", &GSDDumpWriter::setDistributed)
+        .def("setCompression", &GSDDumpWriter::setCompression)
+        .def("setKeyframeInterval", &GSDDumpWriter::setKeyframeInterval)
         .def_readwrite("user_log", &GSDDumpWriter::m_user_log)
     ;
     }
@@ -11,6 +11,10 @@
 
 #include <string>
 #include <memory>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "hoomd/extern/gsd.h"
 
 /*! \file GSDDumpWriter.h
@@ -31,6 +35,22 @@
     On the first call to analyze() \a fname is created with a dcd header. If it already
     exists, append to the file (unless the user specifies overwrite=True).
 
+    In asynchronous mode (setAsync()), analyze() copies all chunks of the frame into a staging buffer and hands it
+    to a background thread that performs the gsd_write_chunk() and gsd_end_frame() calls. At most
+    m_max_queued_frames frames are staged at a time (two by default, so one frame can be assembled while the previous
+    one is written). When the queue is full, analyze() either waits for the I/O thread or drops the frame, see
+    setDropFrames(). flush() waits until all staged frames are in the file, System calls it at the end of every run.
+
+    In distributed mode (setDistributed(), MPI only), the per-particle chunks are not gathered on the root rank. The
+    root rank reserves space for each chunk with gsd_reserve_chunk() and every rank writes the rows of its local group
+    members directly to the file with collective MPI-IO. The frame header, type names, topology and user log
+    quantities are still written by the root rank.
+
+    With setCompression(), the chunks particles/position, particles/orientation and particles/velocity are stored in
+    compressed form (see GSDChunkCodec). In lossy mode, each chunk is stored as the difference to the last frame in
+    which it was written, except every m_keyframe_interval frames (and whenever the previous values cannot be used)
+    where the full rounded values are stored.
+
     \ingroup analyzers
 */
 class PYBIND11_EXPORT GSDDumpWriter : public Analyzer
@@ -67,6 +87,39 @@ class PYBIND11_EXPORT GSDDumpWriter : public Analyzer
             m_write_topology = b;
             }
 
+        //! Control asynchronous writes
+        void setAsync(bool b);
+
+        //! Drop frames instead of blocking when the asynchronous queue is full
+        void setDropFrames(bool b)
+            {
+            m_drop_frames = b;
+            }
+
+        //! Set the maximum number of frames staged for the I/O thread
+        void setMaxQueuedFrames(unsigned int n);
+
+        //! Write per-particle chunks from all ranks in parallel
+        void setDistributed(bool b);
+
+        //! Set the compression of the position, orientation and velocity chunks
+        void setCompression(const std::string& mode, double tolerance);
+
+        //! Set the maximum number of frames between two frames with full values in lossy mode
+        void setKeyframeInterval(unsigned int n);
+
+        //! Wait until all staged frames have been written
+        virtual void flush();
+
+        //! Print the number of dropped frames
+        virtual void printStats();
+
+        //! Reset the number of dropped frames
+        virtual void resetStats()
+            {
+            m_n_dropped = 0;
+            }
+
         //! Destructor
         ~GSDDumpWriter();
 
@@ -92,6 +145,89 @@ class PYBIND11_EXPORT GSDDumpWriter : public Analyzer
 
         hoomd::detail::SharedSignal<int (gsd_handle&)> m_write_signal;
 
+        //! A data chunk copied into the staging area
+        struct StagedChunk
+            {
+            std::string name;           //!< Chunk name
+            gsd_type type;              //!< Data type
+            uint64_t N;                 //!< Number of rows
+            uint32_t M;                 //!< Number of columns
+            uint8_t flags;              //!< Flags passed to gsd_write_chunk
+            std::vector<char> data;     //!< Copy of the data
+            };
+
+        //! All chunks of one frame
+        struct StagedFrame
+            {
+            StagedFrame() : n_chunks(0) {}
+
+            std::vector<StagedChunk> chunks; //!< Chunks (storage is reused between frames)
+            unsigned int n_chunks;           //!< Number of valid entries in chunks
+            std::shared_ptr<Profiler> prof;  //!< Profiler that traces the write of this frame
+            };
+
+        uint64_t m_nframes;                 //!< Number of frames in the file, including staged frames
+        bool m_async;                       //!< True if frames are written by the I/O thread
+        bool m_drop_frames;                 //!< True if frames are dropped when the queue is full
+        unsigned int m_max_queued_frames;   //!< Maximum number of staged frames
+        unsigned int m_n_dropped;           //!< Number of dropped frames
+
+        StagedFrame m_frame;                //!< Frame being assembled by analyze()
+        std::deque<StagedFrame> m_queue;    //!< Frames waiting for the I/O thread, the front is being written
+        std::vector<StagedFrame> m_free_frames; //!< Written frames whose storage can be reused
+        std::thread m_io_thread;            //!< Background I/O thread
+        std::mutex m_io_mutex;              //!< Protects m_queue, m_free_frames, m_io_error and m_io_stop
+        std::condition_variable m_io_cv;    //!< Signals changes of m_queue
+        bool m_io_stop;                     //!< Tells the I/O thread to exit once the queue is empty
+        int m_io_error;                     //!< First error returned by gsd in the I/O thread
+        int m_io_errno;                     //!< errno at the time of m_io_error
+        bool m_distributed;                 //!< True if all ranks write their particles directly to the file
+        #ifdef ENABLE_MPI
+        MPI_File m_mpi_file;                //!< MPI-IO handle of the file in distributed mode
+        bool m_mpi_file_open;               //!< True if m_mpi_file is open
+        #endif
+
+        //! Compression modes of the particle chunks
+        enum compression_mode
+            {
+            compression_none = 0,   //!< Chunks are written as raw arrays
+            compression_lossless,   //!< Chunks are shuffled and deflated
+            compression_lossy,      //!< Chunks are rounded to multiples of m_tolerance
+            };
+
+        //! Values of a lossy compressed chunk in the last frame it was written to
+        struct CompressionState
+            {
+            std::vector<int64_t> q;     //!< Rounded values
+            uint64_t frame;             //!< Frame index of the values
+            uint64_t keyframe;          //!< Last frame with full values
+            double tolerance;           //!< Rounding tolerance of the values
+            };
+
+        compression_mode m_compression;     //!< Compression of the particle chunks
+        double m_tolerance;                 //!< Tolerance of the lossy compression
+        unsigned int m_keyframe_interval;   //!< Maximum number of frames between full values
+        std::map<std::string, CompressionState> m_compression_state; //!< Lossy compression state by chunk name
+        std::vector<char> m_compressed;     //!< Buffer for the compressed data
+
+        //! Write a chunk, or stage it when in asynchronous mode
+        int writeChunk(const char *name, gsd_type type, uint64_t N, uint32_t M, uint8_t flags, const void *data);
+
+        //! Write a float per-particle chunk, compressed if requested
+        void writeParticleChunk(const std::string& name, uint32_t N, uint32_t M, const float *data);
+
+        //! End the frame, or pass the staged frame to the I/O thread
+        void endFrame();
+
+        //! Wait until there are fewer than \a n frames in the queue
+        void waitForQueue(unsigned int n);
+
+        //! Stop the I/O thread after it has written all staged frames
+        void stopIOThread();
+
+        //! Main loop of the I/O thread
+        void ioThreadLoop();
+
         //! Write a type mapping out to the file
         void writeTypeMapping(std::string chunk, std::vector< std::string > type_mapping);
 
@@ -118,6 +254,33 @@ class PYBIND11_EXPORT GSDDumpWriter : public Analyzer
                            ConstraintData::Snapshot& constraint,
                            PairData::Snapshot& pair);
 
+        #ifdef ENABLE_MPI
+        //! Local group members and the rows they occupy in the per-particle chunks
+        struct DistributedLayout
+            {
+            std::vector<unsigned int> idx;      //!< Particle data indices of the local members, in file order
+            std::vector<unsigned int> run_start;    //!< First row of each run of consecutive rows
+            std::vector<unsigned int> run_length;   //!< Number of rows in each run
+            };
+
+        //! Write the per-particle chunks from all ranks without gathering them
+        void writeParticlesDistributed(uint64_t nframes);
+
+        //! Collectively close the MPI-IO file handle
+        void closeDistributedFile();
+
+        //! Collectively write one per-particle chunk
+        void writeDistributedChunk(MPI_File fh,
+                                   const DistributedLayout& layout,
+                                   const char *name,
+                                   gsd_type type,
+                                   uint32_t M,
+                                   const void *data,
+                                   bool all_default,
+                                   bool always,
+                                   uint64_t nframes);
+        #endif
+
         //! Write user defined log data
         void writeUser(unsigned int timestep, bool root);
 
@@ -11,8 +11,11 @@
 #include "GSDReader.h"
 #include "SnapshotSystemData.h"
 #include "ExecutionConfiguration.h"
+#include "SystemDefinition.h"
+#include "GSDChunkCodec.h"
 #include "hoomd/extern/gsd.h"
 #include <string.h>
+#include <sys/mman.h>
 
 #include <stdexcept>
 using namespace std;
@@ -23,30 +26,36 @@ namespace py = pybind11;
     \param name File name to read
     \param frame Frame index to read from the file
     \param from_end Count frames back from the end of the file
+    \param distributed Open the file on all ranks, see initializeDistributed()
 
-    The GSDReader constructor opens the GSD file, initializes an empty snapshot, and reads the file into
-    memory (on the root rank).
+    The GSDReader constructor opens and maps the GSD file (on the root rank, or on all ranks in distributed mode),
+    initializes an empty snapshot, and reads the frame header. The particles are read when they are first needed.
 */
 GSDReader::GSDReader(std::shared_ptr<const ExecutionConfiguration> exec_conf,
                      const std::string &name,
                      const uint64_t frame,
-                     bool from_end)
-    : m_exec_conf(exec_conf), m_timestep(0), m_name(name), m_frame(frame)
+                     bool from_end,
+                     bool distributed)
+    : m_exec_conf(exec_conf), m_timestep(0), m_name(name), m_frame(frame), m_is_open(false),
+      m_distributed(distributed), m_loaded(false), m_N(0), m_map(NULL), m_map_size(0)
     {
     m_snapshot = std::shared_ptr< SnapshotSystemData<float> >(new SnapshotSystemData<float>);
 
     #ifdef ENABLE_MPI
     // if we are not the root processor, do not perform file I/O
-    if (!m_exec_conf->isRoot())
+    if (!m_exec_conf->isRoot() && !m_distributed)
         {
         return;
         }
+    #else
+    m_distributed = false;
     #endif
 
     // open the GSD file in read mode
     m_exec_conf->msg->notice(3) << "data.gsd_snapshot: open gsd file " << name << endl;
     int retval = gsd_open(&m_handle, name.c_str(), GSD_OPEN_READONLY);
     checkError(retval);
+    m_is_open = true;
 
     // validate schema
     if (string(m_handle.header.schema) != string("hoomd"))
@@ -72,22 +81,220 @@ GSDReader::GSDReader(std::shared_ptr<const ExecutionConfiguration> exec_conf,
         throw runtime_error("Error opening GSD file");
         }
 
+    mapFile();
     readHeader();
-    readParticles();
-    readTopology();
     }
 
 GSDReader::~GSDReader()
     {
-    #ifdef ENABLE_MPI
-    // if we are not the root processor, do not perform file I/O
-    if (!m_exec_conf->isRoot())
+    if (m_map)
+        munmap((void *)m_map, m_map_size);
+
+    if (m_is_open)
+        gsd_close(&m_handle);
+    }
+
+/*! The whole file is mapped read only. Pages are loaded by the operating system when a chunk is first accessed,
+    and are shared with all other processes on the node that map the same file. If the mapping fails, chunks are
+    read with gsd_read_chunk() instead.
+*/
+void GSDReader::mapFile()
+    {
+    if (m_handle.file_size <= 0)
+        return;
+
+    void *ptr = mmap(NULL, m_handle.file_size, PROT_READ, MAP_PRIVATE, m_handle.fd, 0);
+    if (ptr == MAP_FAILED)
         {
+        m_exec_conf->msg->notice(2) << "data.gsd_snapshot: unable to map " << m_name << " into memory: "
+                                    << strerror(errno) << endl;
         return;
         }
-    #endif
 
-    gsd_close(&m_handle);
+    m_map = (const char *)ptr;
+    m_map_size = m_handle.file_size;
+    }
+
+/*! \param frame Frame index to read from
+    \param name Name of the data chunk
+    \param compressed Set to true if the chunk is stored in compressed form
+
+    Looks for the chunk at the given frame, then at frame 0. At each frame, the plain chunk takes precedence over
+    the compressed one written by GSDDumpWriter (see GSDChunkCodec). Returns NULL if neither is present.
+*/
+const struct gsd_index_entry* GSDReader::findEntry(uint64_t frame, const char *name, bool& compressed)
+    {
+    std::string compressed_name = GSDChunkCodec::getCompressedName(name);
+    const struct gsd_index_entry* entry = NULL;
+    uint64_t search_frame = frame;
+
+    while (true)
+        {
+        compressed = false;
+        entry = gsd_find_chunk(&m_handle, search_frame, name);
+        if (entry != NULL)
+            break;
+
+        compressed = true;
+        entry = gsd_find_chunk(&m_handle, search_frame, compressed_name.c_str());
+        if (entry != NULL || search_frame == 0)
+            break;
+
+        search_frame = 0;
+        }
+
+    return entry;
+    }
+
+/*! \param entry Index entry of the chunk
+    \param buffer Storage for the data when the file is not mapped
+
+    Returns a pointer to the raw data of the chunk.
+*/
+const char *GSDReader::readRawChunk(const struct gsd_index_entry* entry, std::vector<char>& buffer)
+    {
+    size_t size = entry->N * entry->M * gsd_sizeof_type((enum gsd_type)entry->type);
+    if (m_map)
+        {
+        if (entry->location < 0 || size_t(entry->location) + size > m_map_size)
+            checkError(GSD_ERROR_FILE_CORRUPT);
+        return m_map + entry->location;
+        }
+
+    buffer.resize(size);
+    int retval = gsd_read_chunk(&m_handle, buffer.data(), entry);
+    checkError(retval);
+    return buffer.data();
+    }
+
+/*! \param entry Index entry of the compressed chunk
+    \param name Name of the data chunk (without the compressed prefix)
+    \param expected_size Expected size of the decoded data in bytes.
+    \param cur_n N in the current frame.
+
+    Decodes the chunk into m_decoded and returns a pointer to the decoded data, or NULL if the number of rows does
+    not match \a cur_n. Chunks stored as differences are decoded starting from the frame that holds the full
+    values.
+*/
+const char *GSDReader::decodeChunk(const struct gsd_index_entry* entry,
+                                   const char *name,
+                                   size_t expected_size,
+                                   unsigned int cur_n)
+    {
+    std::string compressed_name = GSDChunkCodec::getCompressedName(name);
+    std::vector<char> buffer;
+    GSDChunkCodec::Header header;
+    try
+        {
+        header = GSDChunkCodec::readHeader(readRawChunk(entry, buffer), entry->N);
+        }
+    catch (const std::runtime_error& e)
+        {
+        m_exec_conf->msg->error() << "data.gsd_snapshot: " << e.what() << " - " << compressed_name << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+
+    if (cur_n != 0 && header.N != cur_n)
+        {
+        m_exec_conf->msg->notice(10) << "data.gsd_snapshot: chunk not found " << name << endl;
+        return NULL;
+        }
+
+    size_t actual_size = header.N * header.M * gsd_sizeof_type((enum gsd_type)header.type);
+    if (actual_size != expected_size)
+        {
+        m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Expecting " << expected_size << " bytes in " << name << " but found " << actual_size << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+
+    std::map<int64_t, std::vector<char> >::iterator it = m_decoded.find(entry->location);
+    if (it != m_decoded.end())
+        return it->second.data();
+
+    m_exec_conf->msg->notice(7) << "data.gsd_snapshot: decoding chunk " << compressed_name << endl;
+    std::vector<char> out(actual_size);
+    try
+        {
+        if (!(header.flags & GSDChunkCodec::flag_quantize))
+            {
+            GSDChunkCodec::decodeLossless(out.data(), readRawChunk(entry, buffer), entry->N);
+            }
+        else
+            {
+            // walk back to the frame that holds the full values
+            std::vector<const struct gsd_index_entry*> chain(1, entry);
+            GSDChunkCodec::Header ref_header = header;
+            while (ref_header.ref_frame != GSDChunkCodec::no_reference)
+                {
+                const struct gsd_index_entry* ref = NULL;
+                if (ref_header.ref_frame < chain.back()->frame)
+                    ref = gsd_find_chunk(&m_handle, ref_header.ref_frame, compressed_name.c_str());
+                if (ref == NULL)
+                    throw runtime_error("Missing reference frame");
+
+                ref_header = GSDChunkCodec::readHeader(readRawChunk(ref, buffer), ref->N);
+                if (ref_header.tolerance != header.tolerance)
+                    throw runtime_error("Reference frame has a different tolerance");
+                chain.push_back(ref);
+                }
+
+            std::vector<int64_t> q;
+            for (std::vector<const struct gsd_index_entry*>::reverse_iterator rit = chain.rbegin();
+                 rit != chain.rend();
+                 ++rit)
+                {
+                GSDChunkCodec::decodeQuantized(q, readRawChunk(*rit, buffer), (*rit)->N);
+                }
+
+            if (q.size() != header.N*header.M)
+                throw runtime_error("Invalid compressed GSD chunk");
+
+            GSDChunkCodec::dequantize((float *)out.data(), q, header.tolerance);
+            }
+        }
+    catch (const std::runtime_error& e)
+        {
+        m_exec_conf->msg->error() << "data.gsd_snapshot: " << e.what() << " - " << compressed_name << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+
+    std::vector<char>& decoded = m_decoded[entry->location];
+    decoded.swap(out);
+    return decoded.data();
+    }
+
+/*! \param frame Frame index to read from
+    \param name Name of the data chunk
+    \param expected_size Expected size of the data chunk in bytes.
+    \param cur_n N in the current frame.
+
+    Applies the same rules as readChunk(), but returns a pointer to the chunk data in the mapped file (or to the
+    decoded data of a compressed chunk) instead of copying it. Returns NULL if the chunk is not present.
+*/
+const char *GSDReader::findChunkData(uint64_t frame, const char *name, size_t expected_size, unsigned int cur_n)
+    {
+    bool compressed = false;
+    const struct gsd_index_entry* entry = findEntry(frame, name, compressed);
+    if (entry != NULL && compressed)
+        return decodeChunk(entry, name, expected_size, cur_n);
+
+    if (entry == NULL || (cur_n != 0 && entry->N != cur_n))
+        {
+        m_exec_conf->msg->notice(10) << "data.gsd_snapshot: chunk not found " << name << endl;
+        return NULL;
+        }
+
+    size_t actual_size = entry->N * entry->M * gsd_sizeof_type((enum gsd_type)entry->type);
+    if (actual_size != expected_size)
+        {
+        m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Expecting " << expected_size << " bytes in " << name << " but found " << actual_size << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+
+    if (entry->location < 0 || size_t(entry->location) + actual_size > m_map_size)
+        checkError(GSD_ERROR_FILE_CORRUPT);
+
+    return m_map + entry->location;
     }
 
 /*! \param data Pointer to data to read into
@@ -98,7 +305,8 @@ GSDReader::~GSDReader()
 
     Attempts to read the data chunk of the given name at the given frame. If it is not present at this
     frame, attempt to read from frame 0. If it is also not present at frame 0, return false.
-    If the found data chunk is not the expected size, throw an exception.
+    If the found data chunk is not the expected size, throw an exception. Chunks that GSDDumpWriter stored in
+    compressed form are decoded transparently.
 
     Per the GSD spec, keep the default when the frame 0 N does not match the current N.
 
@@ -106,9 +314,18 @@ GSDReader::~GSDReader()
 */
 bool GSDReader::readChunk(void *data, uint64_t frame, const char *name, size_t expected_size, unsigned int cur_n)
     {
-    const struct gsd_index_entry* entry = gsd_find_chunk(&m_handle, frame, name);
-    if (entry == NULL && frame != 0)
-        entry = gsd_find_chunk(&m_handle, 0, name);
+    bool compressed = false;
+    const struct gsd_index_entry* entry = findEntry(frame, name, compressed);
+    if (entry != NULL && compressed)
+        {
+        const char *decoded = decodeChunk(entry, name, expected_size, cur_n);
+        if (decoded == NULL)
+            return false;
+
+        m_exec_conf->msg->notice(7) << "data.gsd_snapshot: reading chunk " << name << endl;
+        memcpy(data, decoded, expected_size);
+        return true;
+        }
 
     if (entry == NULL || (cur_n != 0 && entry->N != cur_n))
         {
@@ -124,13 +341,41 @@ bool GSDReader::readChunk(void *data, uint64_t frame, const char *name, size_t e
             m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Expecting " << expected_size << " bytes in " << name << " but found " << actual_size << endl;
             throw runtime_error("Error reading GSD file");
             }
-        int retval = gsd_read_chunk(&m_handle, data, entry);
-        checkError(retval);
+        if (m_map)
+            {
+            if (entry->location < 0 || size_t(entry->location) + actual_size > m_map_size)
+                checkError(GSD_ERROR_FILE_CORRUPT);
+            memcpy(data, m_map + entry->location, actual_size);
+            }
+        else
+            {
+            int retval = gsd_read_chunk(&m_handle, data, entry);
+            checkError(retval);
+            }
 
         return true;
         }
     }
 
+/*! \param data Pointer to data to read into (one row per entry in \a rows)
+    \param name Name of the per-particle data chunk
+    \param row_size Size of one row in bytes
+    \param rows Rows to copy
+
+    Leaves \a data unchanged if the chunk is not present.
+*/
+void GSDReader::readRows(void *data, const char *name, size_t row_size, const std::vector<unsigned int>& rows)
+    {
+    const char *chunk = findChunkData(m_frame, name, m_N*row_size, m_N);
+    if (chunk == NULL)
+        return;
+
+    m_exec_conf->msg->notice(7) << "data.gsd_snapshot: reading rows of chunk " << name << endl;
+    char *out = (char *)data;
+    for (unsigned int i = 0; i < rows.size(); i++)
+        memcpy(out + i*row_size, chunk + size_t(rows[i])*row_size, row_size);
+    }
+
 /*! \param frame Frame index to read from
     \param name Name of the data chunk
 
@@ -159,8 +404,7 @@ std::vector<std::string> GSDReader::readTypes(uint64_t frame, const char *name)
         {
         size_t actual_size = entry->N * entry->M * gsd_sizeof_type((enum gsd_type)entry->type);
         std::vector<char> data(actual_size);
-        int retval = gsd_read_chunk(&m_handle, &data[0], entry);
-        checkError(retval);
+        readChunk(&data[0], frame, name, actual_size);
 
         type_mapping.clear();
         for (unsigned int i = 0; i < entry->N; i++)
@@ -195,7 +439,13 @@ void GSDReader::readHeader()
         m_exec_conf->msg->error() << "data.gsd_snapshot: " << "cannot read a file with 0 particles" << endl;
         throw runtime_error("Error reading GSD file");
         }
-    m_snapshot->particle_data.resize(N);
+    m_N = N;
+
+    // in distributed mode, the particles are added by initializeDistributed()
+    if (m_distributed)
+        m_snapshot->particle_data.type_mapping = readTypes(m_frame, "particles/types");
+    else
+        m_snapshot->particle_data.resize(N);
     }
 
 /*! Read the same data chunks for particles
@@ -291,6 +541,98 @@ void GSDReader::readTopology()
         }
     }
 
+#ifdef ENABLE_MPI
+/*! \param sysdef System constructed from the snapshot returned by getSnapshot()
+
+    Every rank places all particles into the domains of the decomposition and copies the rows of its own particles
+    out of the mapped file. Only the positions and images are touched for all particles. The bonded groups are read
+    on the root rank and distributed as usual.
+*/
+void GSDReader::initializeDistributed(std::shared_ptr<SystemDefinition> sysdef)
+    {
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    std::shared_ptr<DomainDecomposition> decomposition = pdata->getDomainDecomposition();
+    if (!m_distributed || !decomposition)
+        {
+        m_exec_conf->msg->error() << "data.gsd_snapshot: distributed reads require a domain decomposition" << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+
+    if (!m_map)
+        {
+        m_exec_conf->msg->error() << "data.gsd_snapshot: distributed reads require a memory mapped file" << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+
+    // find the particles in the local domain
+    const BoxDim& global_box = pdata->getGlobalBox();
+    unsigned int my_rank = m_exec_conf->getRank();
+    const float *pos = (const float *)findChunkData(m_frame, "particles/position", m_N*12, m_N);
+    const int32_t *image = (const int32_t *)findChunkData(m_frame, "particles/image", m_N*12, m_N);
+
+    std::vector<unsigned int> tags;
+    std::vector<Scalar3> local_pos;
+    std::vector<int3> local_image;
+        {
+        ArrayHandle<unsigned int> h_cart_ranks(decomposition->getCartRanks(), access_location::host,
+                                               access_mode::read);
+        for (unsigned int tag = 0; tag < m_N; tag++)
+            {
+            Scalar3 p = make_scalar3(0,0,0);
+            if (pos)
+                p = make_scalar3(pos[tag*3+0], pos[tag*3+1], pos[tag*3+2]);
+            int3 img = make_int3(0,0,0);
+            if (image)
+                img = make_int3(image[tag*3+0], image[tag*3+1], image[tag*3+2]);
+
+            global_box.wrap(p, img);
+            if (decomposition->placeParticle(global_box, p, h_cart_ranks.data) == my_rank)
+                {
+                tags.push_back(tag);
+                local_pos.push_back(p);
+                local_image.push_back(img);
+                }
+            }
+        }
+
+    unsigned int n_local = tags.size();
+    m_exec_conf->msg->notice(5) << "data.gsd_snapshot: reading " << n_local << " of " << m_N << " particles" << endl;
+
+    SnapshotParticleData<float> snap(n_local);
+    snap.type_mapping = m_snapshot->particle_data.type_mapping;
+    for (unsigned int i = 0; i < n_local; i++)
+        {
+        snap.pos[i] = vec3<float>(local_pos[i]);
+        snap.image[i] = local_image[i];
+        }
+
+    // the snapshot already has default values, absent chunks are not a problem
+    readRows(&snap.type[0], "particles/typeid", 4, tags);
+    readRows(&snap.mass[0], "particles/mass", 4, tags);
+    readRows(&snap.charge[0], "particles/charge", 4, tags);
+    readRows(&snap.diameter[0], "particles/diameter", 4, tags);
+    readRows(&snap.body[0], "particles/body", 4, tags);
+    readRows(&snap.inertia[0], "particles/moment_inertia", 12, tags);
+    readRows(&snap.orientation[0], "particles/orientation", 16, tags);
+    readRows(&snap.vel[0], "particles/velocity", 12, tags);
+    readRows(&snap.angmom[0], "particles/angmom", 16, tags);
+
+    pdata->initializeFromLocalSnapshot(snap, tags, m_N);
+
+    // topology is read on the root rank and scattered by the bonded group data
+    if (m_exec_conf->isRoot() && !m_loaded)
+        readTopology();
+    m_loaded = true;
+
+    sysdef->getBondData()->initializeFromSnapshot(m_snapshot->bond_data);
+    sysdef->getAngleData()->initializeFromSnapshot(m_snapshot->angle_data);
+    sysdef->getDihedralData()->initializeFromSnapshot(m_snapshot->dihedral_data);
+    sysdef->getImproperData()->initializeFromSnapshot(m_snapshot->improper_data);
+    sysdef->getConstraintData()->initializeFromSnapshot(m_snapshot->constraint_data);
+    sysdef->getPairData()->initializeFromSnapshot(m_snapshot->pair_data);
+    }
+#endif
+
 pybind11::list GSDReader::readTypeShapesPy(uint64_t frame)
     {
     std::vector<std::string> type_mapping = this->readTypes(frame, "particles/type_shapes");
@@ -360,9 +702,13 @@ void export_GSDReader(py::module& m)
     {
     py::class_< GSDReader, std::shared_ptr<GSDReader> >(m,"GSDReader")
     .def(py::init<std::shared_ptr<const ExecutionConfiguration>, const string&, const uint64_t, bool>())
+    .def(py::init<std::shared_ptr<const ExecutionConfiguration>, const string&, const uint64_t, bool, bool>())
     .def("getTimeStep", &GSDReader::getTimeStep)
     .def("getSnapshot", &GSDReader::getSnapshot)
     .def("clearSnapshot", &GSDReader::clearSnapshot)
     .def("readTypeShapesPy", &GSDReader::readTypeShapesPy)
+    #ifdef ENABLE_MPI
+    .def("initializeDistributed", &GSDReader::initializeDistributed)
+    #endif
     ;
     }
@@ -14,6 +14,8 @@
 
 #include "ParticleData.h"
 #include <string>
+#include <map>
+#include <vector>
 #include "hoomd/extern/gsd.h"
 
 #ifdef NVCC
@@ -25,11 +27,23 @@
 
 //! Forward declarations
 template <class Real> struct SnapshotSystemData;
+class SystemDefinition;
 
 //! Reads a GSD input file
 /*! Read an input GSD file and generate a system snapshot. GSDReader can read any frame from a GSD
     file into the snapshot. For information on the GSD specification, see http://gsd.readthedocs.io/
 
+    The file is memory mapped and chunks are copied straight out of the mapping. Only the frame header is read in
+    the constructor, the particle and topology chunks are read on the first call to getSnapshot().
+
+    In distributed mode (MPI only), every rank opens the file. getSnapshot() then returns a snapshot without
+    particles and bonded groups. After the SystemDefinition has been constructed from it, initializeDistributed()
+    lets each rank copy the rows of the particles in its own domain out of the mapping, and distributes the topology
+    read on the root rank.
+
+    Per-particle chunks that GSDDumpWriter stored in compressed form (see GSDChunkCodec) are decoded transparently.
+    The decoded data is cached in m_decoded, so it can be accessed in the same way as the mapped file.
+
     \ingroup data_structs
 */
 class PYBIND11_EXPORT GSDReader
@@ -39,7 +53,8 @@ class PYBIND11_EXPORT GSDReader
         GSDReader(std::shared_ptr<const ExecutionConfiguration> exec_conf,
                   const std::string &name,
                   const uint64_t frame,
-                  bool from_end);
+                  bool from_end,
+                  bool distributed=false);
 
         //! Destructor
         ~GSDReader();
@@ -59,11 +74,22 @@ class PYBIND11_EXPORT GSDReader
             }
 
         //! initializes a snapshot with the particle data
-        std::shared_ptr< SnapshotSystemData<float> > getSnapshot() const
+        std::shared_ptr< SnapshotSystemData<float> > getSnapshot()
             {
+            if (m_snapshot && !m_loaded && m_is_open && !m_distributed)
+                {
+                readParticles();
+                readTopology();
+                m_loaded = true;
+                }
             return m_snapshot;
             }
 
+        #ifdef ENABLE_MPI
+        //! Read the local particles and the topology into a system constructed from getSnapshot()
+        void initializeDistributed(std::shared_ptr<SystemDefinition> sysdef);
+        #endif
+
         //! initializes a snapshot with the particle data
         uint64_t getFrame() const
             {
@@ -94,6 +120,34 @@ class PYBIND11_EXPORT GSDReader
         uint64_t m_frame;                                            //!< Cached frame
         std::shared_ptr< SnapshotSystemData<float> > m_snapshot;   //!< The snapshot to read
         gsd_handle m_handle;                                         //!< Handle to the file
+        bool m_is_open;                                              //!< True if m_handle is open on this rank
+        bool m_distributed;                                          //!< True if every rank reads its own particles
+        bool m_loaded;                                               //!< True if the particles have been read
+        unsigned int m_N;                                            //!< Number of particles in the frame
+        const char *m_map;                                           //!< Read only mapping of the file (or NULL)
+        size_t m_map_size;                                           //!< Size of the mapping in bytes
+        std::map<int64_t, std::vector<char> > m_decoded;             //!< Decoded compressed chunks by file location
+
+        //! Map the file into memory
+        void mapFile();
+
+        //! Find the index entry of a chunk, in plain or compressed form
+        const struct gsd_index_entry* findEntry(uint64_t frame, const char *name, bool& compressed);
+
+        //! Get the raw data of a chunk
+        const char *readRawChunk(const struct gsd_index_entry* entry, std::vector<char>& buffer);
+
+        //! Decode a compressed chunk
+        const char *decodeChunk(const struct gsd_index_entry* entry,
+                                const char *name,
+                                size_t expected_size,
+                                unsigned int cur_n);
+
+        //! Find the data of a chunk in the mapped file
+        const char *findChunkData(uint64_t frame, const char *name, size_t expected_size, unsigned int cur_n);
+
+        //! Copy selected rows of a chunk out of the mapped file
+        void readRows(void *data, const char *name, size_t row_size, const std::vector<unsigned int>& rows);
 
         //! Helper function to read a type list from the file
         std::vector<std::string> readTypes(uint64_t frame, const char *name);
@@ -20,6 +20,10 @@ namespace py = pybind11;
 #include "Communicator.h"
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
 using namespace std;
 
 /*! \param sysdef System to update
@@ -310,9 +314,30 @@ Scalar Integrator::computeTotalMomentum(unsigned int timestep)
 void Integrator::computeNetForce(unsigned int timestep)
     {
     std::vector< std::shared_ptr<ForceCompute> >::iterator force_compute;
+
+    // time the force computation, but not the wait for the ghost particles
+    int64_t start = m_compute_clock.getTime();
+    int64_t compute_time = 0;
+
+    #ifdef ENABLE_MPI
+    if (m_comm && m_comm->isGhostUpdatePending())
+        {
+        // compute what we can while the ghost positions are in flight
+        for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
+            (*force_compute)->computeInterior(timestep);
+
+        compute_time += m_compute_clock.getTime() - start;
+        m_comm->finishUpdateGhosts(timestep);
+        start = m_compute_clock.getTime();
+        }
+    #endif
+
     for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
         (*force_compute)->compute(timestep);
 
+    compute_time += m_compute_clock.getTime() - start;
+    m_sysdef->getIntegratorData()->addComputeTime(double(compute_time)*1e-9);
+
     if (m_prof)
         {
         m_prof->push("Integrate");
@@ -364,22 +389,41 @@ void Integrator::computeNetForce(unsigned int timestep)
             ArrayHandle<Scalar4> h_torque(h_torque_array,access_location::host,access_mode::read);
 
             unsigned int virial_pitch = h_virial_array.getPitch();
-            for (unsigned int j = 0; j < nparticles; j++)
+            auto add_range = [&](unsigned int begin, unsigned int end)
                 {
-                h_net_force.data[j].x += h_force.data[j].x;
-                h_net_force.data[j].y += h_force.data[j].y;
-                h_net_force.data[j].z += h_force.data[j].z;
-                h_net_force.data[j].w += h_force.data[j].w;
-
-                h_net_torque.data[j].x += h_torque.data[j].x;
-                h_net_torque.data[j].y += h_torque.data[j].y;
-                h_net_torque.data[j].z += h_torque.data[j].z;
-                h_net_torque.data[j].w += h_torque.data[j].w;
-
-                for (unsigned int k = 0; k < 6; k++)
+                for (unsigned int j = begin; j < end; j++)
                     {
-                    h_net_virial.data[k*net_virial_pitch+j] += h_virial.data[k*virial_pitch+j];
+                    h_net_force.data[j].x += h_force.data[j].x;
+                    h_net_force.data[j].y += h_force.data[j].y;
+                    h_net_force.data[j].z += h_force.data[j].z;
+                    h_net_force.data[j].w += h_force.data[j].w;
+
+                    h_net_torque.data[j].x += h_torque.data[j].x;
+                    h_net_torque.data[j].y += h_torque.data[j].y;
+                    h_net_torque.data[j].z += h_torque.data[j].z;
+                    h_net_torque.data[j].w += h_torque.data[j].w;
+
+                    for (unsigned int k = 0; k < 6; k++)
+                        {
+                        h_net_virial.data[k*net_virial_pitch+j] += h_virial.data[k*virial_pitch+j];
+                        }
                     }
+                };
+
+            // every particle is summed by exactly one thread, so the result does not depend on the number of threads
+            #ifdef ENABLE_TBB
+            if (m_exec_conf->getNumThreads() > 1)
+                {
+                tbb::parallel_for(tbb::blocked_range<unsigned int>(0, nparticles),
+                    [&](const tbb::blocked_range<unsigned int>& r)
+                    {
+                    add_range(r.begin(), r.end());
+                    });
+                }
+            else
+            #endif
+                {
+                add_range(0, nparticles);
                 }
 
             for (unsigned int k = 0; k < 6; k++)
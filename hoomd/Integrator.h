@@ -20,6 +20,7 @@
 #include "ForceConstraint.h"
 #include "HalfStepHook.h"
 #include "ParticleGroup.h"
+#include "ClockSource.h"
 #include <string>
 #include <vector>
 #include <hoomd/extern/pybind/include/pybind11/pybind11.h>
@@ -147,6 +148,7 @@ class PYBIND11_EXPORT Integrator : public Updater
 
         std::shared_ptr<HalfStepHook> m_half_step_hook;    //!< The HalfStepHook, if active
 
+        ClockSource m_compute_clock;                        //!< Timer for the compute time reported to IntegratorData
 
         //! helper function to compute initial accelerations
         void computeAccelerations(unsigned int timestep);
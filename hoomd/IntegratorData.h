@@ -65,11 +65,11 @@ class PYBIND11_EXPORT IntegratorData
     {
     public:
         //! Constructs an empty list with no integrator variables
-        IntegratorData() : m_num_registered(0) {}
+        IntegratorData() : m_num_registered(0), m_compute_time(0.0) {}
 
         //! Constructs an IntegratorData from a given set of IntegratorVariables
         IntegratorData(const std::vector<IntegratorVariables>& variables)
-            : m_num_registered(0)
+            : m_num_registered(0), m_compute_time(0.0)
             {
             m_integrator_variables = variables;
             }
@@ -115,8 +115,25 @@ class PYBIND11_EXPORT IntegratorData
             assert(i < m_integrator_variables.size()); m_integrator_variables[i] = v;
             }
 
+        //! Accumulate the time this rank spent computing
+        /*! \param seconds Wall time spent in the force computation or the trial moves of a step
+            Integrators add the time of their local work, excluding waits for other ranks. The load balancer
+            compares the accumulated times of the ranks.
+        */
+        void addComputeTime(double seconds)
+            {
+            m_compute_time += seconds;
+            }
+
+        //! Get the total time this rank spent computing
+        double getComputeTime() const
+            {
+            return m_compute_time;
+            }
+
     private:
         unsigned int m_num_registered;                                  //!< Number of integrators that have registered
+        double m_compute_time;                                          //!< Accumulated compute time on this rank (s)
         std::vector<IntegratorVariables> m_integrator_variables;        //!< List of the integrator variables defined
 
     };
@@ -20,6 +20,7 @@
 #include <cmath>
 #include <numeric>
 #include <limits>
+#include <algorithm>
 
 using namespace std;
 namespace py = pybind11;
@@ -33,7 +34,10 @@ LoadBalancer::LoadBalancer(std::shared_ptr<SystemDefinition> sysdef,
         : Updater(sysdef), m_decomposition(decomposition), m_mpi_comm(m_exec_conf->getMPICommunicator()),
           m_max_imbalance(Scalar(1.0)), m_recompute_max_imbalance(true), m_needs_migrate(false),
           m_needs_recount(false), m_tolerance(Scalar(1.05)), m_maxiter(1), m_max_scale(Scalar(0.05)),
-          m_N_own(m_pdata->getN()), m_max_max_imbalance(1.0), m_total_max_imbalance(0.0), m_n_calls(0),
+          m_bisection(false), m_bins_per_domain(64), m_time_weighting(false), m_damping(Scalar(0.5)),
+          m_particle_cost(Scalar(1.0)), m_particle_cost_valid(false),
+          m_last_compute_time(m_sysdef->getIntegratorData()->getComputeTime()),
+          m_N_own(m_pdata->getN()), m_load(Scalar(m_pdata->getN())), m_max_max_imbalance(1.0), m_total_max_imbalance(0.0), m_n_calls(0),
           m_n_iterations(0), m_n_rebalances(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing LoadBalancer" << endl;
@@ -50,6 +54,38 @@ LoadBalancer::~LoadBalancer()
     m_exec_conf->msg->notice(5) << "Destroying LoadBalancer" << endl;
     }
 
+/*!
+ * \param enable If true, weight particles by the compute time per particle of their rank
+ *
+ * The compute time is only measured on the host, so time weighting is not available on the GPU.
+ */
+void LoadBalancer::setTimeWeighting(bool enable)
+    {
+    if (enable && m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "comm.balance: weighting by compute time is not supported on the GPU" << endl;
+        throw runtime_error("Error setting load balancer weighting");
+        }
+
+    m_time_weighting = enable;
+    m_particle_cost = Scalar(1.0);
+    m_particle_cost_valid = false;
+    m_last_compute_time = m_sysdef->getIntegratorData()->getComputeTime();
+    }
+
+/*!
+ * \param damping Weight of the previous estimate in the moving average of the particle cost
+ */
+void LoadBalancer::setDamping(Scalar damping)
+    {
+    if (damping < Scalar(0.0) || damping >= Scalar(1.0))
+        {
+        m_exec_conf->msg->error() << "comm.balance: damping must be in the range [0,1)" << endl;
+        throw runtime_error("Error setting load balancer damping");
+        }
+    m_damping = damping;
+    }
+
 /*!
  * \param timestep Current time step of the simulation
  *
@@ -63,6 +99,9 @@ void LoadBalancer::update(unsigned int timestep)
 
     if (m_prof) m_prof->push(m_exec_conf, "balance");
 
+    // measure the cost of the particles since the last call
+    updateParticleCost();
+
     // no adjustment has been made yet, so set m_N_own to the number of particles on the rank
     resetNOwn(m_pdata->getN());
 
@@ -112,17 +151,30 @@ void LoadBalancer::update(unsigned int timestep)
                 min_frac_i = min_domain_frac.z;
                 }
 
-            vector<unsigned int> N_i;
+            vector<Scalar> cum_frac = m_decomposition->getCumulativeFractions(dim);
             bool adjusted = false;
 
-            // reduce the number of particles in the slice along dim
-            bool active = reduce(N_i, dim, reduce_root);
-
-            // attempt an adjustment
-            vector<Scalar> cum_frac = m_decomposition->getCumulativeFractions(dim);
-            if (active)
+            if (m_bisection)
+                {
+                // reduce the particle histogram along dim and cut it at the medians
+                vector<Scalar> H_i;
+                bool active = histogram(H_i, dim, cum_frac.size()-1, reduce_root);
+                if (active)
+                    {
+                    adjusted = bisect(cum_frac, H_i, min_frac_i);
+                    }
+                }
+            else
                 {
-                adjusted = adjust(cum_frac, N_i, L_i, min_frac_i);
+                // reduce the number of particles in the slice along dim
+                vector<Scalar> N_i;
+                bool active = reduce(N_i, dim, reduce_root);
+
+                // attempt an adjustment
+                if (active)
+                    {
+                    adjusted = adjust(cum_frac, N_i, L_i, min_frac_i);
+                    }
                 }
 
             // broadcast if an adjustment has been made on the root
@@ -154,13 +206,62 @@ void LoadBalancer::update(unsigned int timestep)
     }
 
 /*!
- * Computes the imbalance factor I = N / <N> for each rank, and computes the maximum among all ranks.
+ * Every rank measures the compute time since the previous call and divides it by its number of particles. The cost
+ * of a particle is this time relative to the average time per particle of all ranks, so that it is 1 for a uniform
+ * load. Ranks without particles keep their previous estimate. The new estimate is mixed with the previous one with
+ * weight m_damping.
+ *
+ * If no compute time was recorded (no integrator has run), the previous estimate is kept.
+ *
+ * \note All ranks must call this method since it performs a collective reduction.
+ */
+void LoadBalancer::updateParticleCost()
+    {
+    const double compute_time = m_sysdef->getIntegratorData()->getComputeTime();
+    const double elapsed = compute_time - m_last_compute_time;
+    m_last_compute_time = compute_time;
+
+    if (!m_time_weighting)
+        {
+        m_particle_cost = Scalar(1.0);
+        return;
+        }
+
+    double local[2] = {elapsed, double(m_pdata->getN())};
+    double total[2];
+    MPI_Allreduce(local, total, 2, MPI_DOUBLE, MPI_SUM, m_mpi_comm);
+
+    if (total[0] <= 0.0 || total[1] <= 0.0 || m_pdata->getN() == 0)
+        return;
+
+    const Scalar cost = Scalar((elapsed / local[1]) / (total[0] / total[1]));
+    if (m_particle_cost_valid)
+        m_particle_cost = (Scalar(1.0) - m_damping) * cost + m_damping * m_particle_cost;
+    else
+        m_particle_cost = cost;
+    m_particle_cost_valid = true;
+    }
+
+/*!
+ * Computes the imbalance factor I = N / <N> for each rank, and computes the maximum among all ranks. With time
+ * weighting, N is the weighted load.
  */
 Scalar LoadBalancer::getMaxImbalance()
     {
     if (m_recompute_max_imbalance)
         {
-        Scalar cur_imb = Scalar(getNOwn()) / (Scalar(m_pdata->getNGlobal()) / Scalar(m_exec_conf->getNRanks()));
+        Scalar cur_imb(0.0);
+        if (m_time_weighting)
+            {
+            Scalar load = getLoad();
+            Scalar total_load(0.0);
+            MPI_Allreduce(&load, &total_load, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_mpi_comm);
+            cur_imb = (total_load > Scalar(0.0)) ? load / (total_load / Scalar(m_exec_conf->getNRanks())) : Scalar(1.0);
+            }
+        else
+            {
+            cur_imb = Scalar(getNOwn()) / (Scalar(m_pdata->getNGlobal()) / Scalar(m_exec_conf->getNRanks()));
+            }
         Scalar max_imb(0.0);
         MPI_Allreduce(&cur_imb, &max_imb, 1, MPI_HOOMD_SCALAR, MPI_MAX, m_mpi_comm);
 
@@ -175,7 +276,7 @@ Scalar LoadBalancer::getMaxImbalance()
     }
 
 /*!
- * \param N_i Vector holding the total number of particles in each slice (will be allocated on call)
+ * \param N_i Vector holding the total load (weighted number of particles) in each slice (will be allocated on call)
  * \param dim The dimension of the slices (x=0, y=1, z=2)
  * \param reduce_root The rank to perform the reduction on
  * \returns true if the current rank holds the active \a N_i
@@ -191,18 +292,18 @@ Scalar LoadBalancer::getMaxImbalance()
  * down dimensions. Generally, load balancing should not be performed too frequently, and so we do not pursue this
  * optimization right now.
  */
-bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsigned int reduce_root)
+bool LoadBalancer::reduce(std::vector<Scalar>& N_i, unsigned int dim, unsigned int reduce_root)
     {
     // do nothing if there is only one rank
     if (N_i.size() == 1) return false;
 
     const Index3D& di = m_decomposition->getDomainIndexer();
-    std::vector<unsigned int> N_per_rank(di.getNumElements());
+    std::vector<Scalar> N_per_rank(di.getNumElements());
 
-    // get the number of particles the current rank owns (the quantity to be reduced)
-    unsigned int N_own = getNOwn();
+    // get the load of the particles the current rank owns (the quantity to be reduced)
+    Scalar N_own = getLoad();
 
-    MPI_Gather(&N_own, 1, MPI_UNSIGNED, &N_per_rank[0], 1, MPI_UNSIGNED, reduce_root, m_mpi_comm);
+    MPI_Gather(&N_own, 1, MPI_HOOMD_SCALAR, &N_per_rank[0], 1, MPI_HOOMD_SCALAR, reduce_root, m_mpi_comm);
 
     // only the root rank performs the reduction
     if (m_exec_conf->getRank() != reduce_root)
@@ -210,7 +311,7 @@ bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsi
 
     // rearrange the data from ranks to cartesian order in case it is jumbled around
     ArrayHandle<unsigned int> h_cart_ranks_inv(m_decomposition->getInverseCartRanks(), access_location::host, access_mode::read);
-    std::vector<unsigned int> N_per_cart_rank(di.getNumElements());
+    std::vector<Scalar> N_per_cart_rank(di.getNumElements());
     for (unsigned int cur_rank=0; cur_rank < di.getNumElements(); ++cur_rank)
         {
         N_per_cart_rank[h_cart_ranks_inv.data[cur_rank]] = N_per_rank[cur_rank];
@@ -273,7 +374,7 @@ bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsi
 
 /*!
  * \param cum_frac_i The cumulative fraction array to write output into
- * \param N_i The reduced number of particles along the dimension
+ * \param N_i The reduced load along the dimension
  * \param L_i The global box length along the dimension
  * \param min_frac_i The minimum fractional width of a domain
  *
@@ -291,15 +392,17 @@ bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsi
  *     successful, apply the adjustment to \a cum_frac_i.
  */
 bool LoadBalancer::adjust(vector<Scalar>& cum_frac_i,
-                          const vector<unsigned int>& N_i,
+                          const vector<Scalar>& N_i,
                           Scalar L_i,
                           Scalar min_frac_i)
     {
     if (N_i.size() == 1)
         return false;
 
-    // target particles per rank is uniform distribution
-    const Scalar target = Scalar(m_pdata->getNGlobal()) / Scalar(N_i.size());
+    // target load per rank is uniform distribution
+    const Scalar target = std::accumulate(N_i.begin(), N_i.end(), Scalar(0.0)) / Scalar(N_i.size());
+    if (target <= Scalar(0.0))
+        return false;
 
     // make the minimum domain slightly bigger so that the optimization won't fail at equality
     const Scalar min_domain_size = Scalar(1.00001) * min_frac_i * L_i;
@@ -314,7 +417,7 @@ bool LoadBalancer::adjust(vector<Scalar>& cum_frac_i,
     for (unsigned int i=0; i < N_i.size(); ++i)
         {
         const Scalar imb_factor = Scalar(N_i[i]) / target;
-        Scalar scale_factor = (N_i[i] > 0) ? Scalar(1.0) / imb_factor : (Scalar(1.0) + m_max_scale); // as in gromacs, use half the imbalance factor to scale
+        Scalar scale_factor = (N_i[i] > Scalar(0.0)) ? Scalar(1.0) / imb_factor : (Scalar(1.0) + m_max_scale); // as in gromacs, use half the imbalance factor to scale
 
         // limit rescaling to 5% either direction
         // we should use absolute distance here, it is necessary to control balancing in corrugated systems
@@ -416,6 +519,137 @@ bool LoadBalancer::adjust(vector<Scalar>& cum_frac_i,
     return false;
     }
 
+/*!
+ * \param H_i Vector holding the global histogram of particle loads along \a dim (will be allocated on call)
+ * \param dim The dimension of the histogram (x=0, y=1, z=2)
+ * \param n_domains Number of domains along \a dim
+ * \param reduce_root The rank to perform the reduction on
+ * \returns true if the current rank holds the active \a H_i
+ *
+ * Every rank bins the fractional coordinates of its particles in the global box into m_bins_per_domain bins per
+ * domain, with every particle contributing its cost, and the histograms are summed on \a reduce_root. Like reduce(), all ranks must call this method, but only
+ * \a reduce_root receives the result.
+ */
+bool LoadBalancer::histogram(std::vector<Scalar>& H_i,
+                             unsigned int dim,
+                             unsigned int n_domains,
+                             unsigned int reduce_root)
+    {
+    if (n_domains == 1) return false;
+
+    const unsigned int n_bins = m_bins_per_domain * n_domains;
+    std::vector<Scalar> H_local(n_bins, Scalar(0.0));
+
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        const BoxDim& global_box = m_pdata->getGlobalBox();
+
+        for (unsigned int cur_p=0; cur_p < m_pdata->getN(); ++cur_p)
+            {
+            const Scalar4 cur_postype = h_pos.data[cur_p];
+            const Scalar3 f = global_box.makeFraction(make_scalar3(cur_postype.x, cur_postype.y, cur_postype.z));
+
+            Scalar f_i(0.0);
+            if (dim == 0) f_i = f.x;
+            else if (dim == 1) f_i = f.y;
+            else f_i = f.z;
+
+            int bin = int(f_i * Scalar(n_bins));
+            if (bin < 0) bin = 0;
+            if (bin >= (int)n_bins) bin = n_bins-1;
+            H_local[bin] += m_particle_cost;
+            }
+        }
+
+    H_i.clear(); H_i.resize(n_bins, Scalar(0.0));
+    MPI_Reduce(&H_local[0], &H_i[0], n_bins, MPI_HOOMD_SCALAR, MPI_SUM, reduce_root, m_mpi_comm);
+
+    return m_exec_conf->getRank() == reduce_root;
+    }
+
+/*!
+ * \param cum_frac_i The cumulative fraction array to write output into
+ * \param H_i The global histogram of particle loads along the dimension
+ * \param min_frac_i The minimum fractional width of a domain
+ *
+ * \returns true if an adjustment occurred
+ *
+ * Boundary j is placed where the cumulative load reaches j/n of the total load, interpolating linearly
+ * within a bin. When the count is reached at the edge of a gap with no particles, the boundary is placed in the middle
+ * of the gap. Each boundary is limited to move at most half the width of its neighboring domains, and the result is
+ * rejected if any domain becomes smaller than \a min_frac_i.
+ */
+bool LoadBalancer::bisect(vector<Scalar>& cum_frac_i,
+                          const vector<Scalar>& H_i,
+                          Scalar min_frac_i)
+    {
+    const unsigned int n = cum_frac_i.size()-1;
+    const unsigned int n_bins = H_i.size();
+    if (n == 1 || n_bins == 0)
+        return false;
+
+    // make the minimum domain slightly bigger so that the check won't fail at equality
+    const Scalar min_domain_frac = Scalar(1.00001) * min_frac_i;
+    if (min_domain_frac * Scalar(n) >= Scalar(1.0))
+        {
+        return false;
+        }
+
+    // cumulative histogram, cum_H[b] is the load in bins before b
+    vector<double> cum_H(n_bins+1);
+    cum_H[0] = 0.0;
+    for (unsigned int b=0; b < n_bins; ++b)
+        {
+        cum_H[b+1] = cum_H[b] + H_i[b];
+        }
+    const double N_total = cum_H[n_bins];
+    if (N_total <= 0.0)
+        return false;
+
+    vector<Scalar> new_frac(cum_frac_i);
+    unsigned int b = 0;
+    for (unsigned int j=1; j < n; ++j)
+        {
+        const double target = N_total * double(j) / double(n);
+
+        // find the first bin that contains the target load
+        while (b < n_bins-1 && cum_H[b+1] < target)
+            ++b;
+
+        Scalar f(0.0);
+        if (cum_H[b+1] == target)
+            {
+            // the target is reached at the upper edge of b, center the boundary in the following empty bins
+            unsigned int e = b+1;
+            while (e < n_bins && H_i[e] == 0)
+                ++e;
+            f = Scalar(0.5) * Scalar(b+1+e) / Scalar(n_bins);
+            }
+        else
+            {
+            f = Scalar((double(b) + (target - cum_H[b]) / double(H_i[b])) / double(n_bins));
+            }
+
+        // a boundary cannot move more than half the width of its neighboring domains
+        const Scalar lo = Scalar(0.5) * (cum_frac_i[j-1] + cum_frac_i[j]);
+        const Scalar hi = Scalar(0.5) * (cum_frac_i[j] + cum_frac_i[j+1]);
+        new_frac[j] = std::min(std::max(f, lo), hi);
+        }
+
+    // sanity check the new domains
+    for (unsigned int j=0; j < n; ++j)
+        {
+        if (new_frac[j+1] - new_frac[j] < min_domain_frac)
+            {
+            m_exec_conf->msg->warning() << "comm.balance: bisection would make domains too small" << endl;
+            return false;
+            }
+        }
+
+    cum_frac_i = new_frac;
+    return true;
+    }
+
 /*!
  * \param cnts Map holding result of number of particles on each rank that neighbors the local rank
  */
@@ -516,12 +750,13 @@ void LoadBalancer::computeOwnedParticles()
         }
     countParticlesOffRank(cnts);
 
-    MPI_Request req[2*m_comm->getNUniqueNeighbors()];
-    MPI_Status stat[2*m_comm->getNUniqueNeighbors()];
+    MPI_Request req[4*m_comm->getNUniqueNeighbors()];
+    MPI_Status stat[4*m_comm->getNUniqueNeighbors()];
     unsigned int nreq = 0;
 
     unsigned int n_send_ptls[m_comm->getNUniqueNeighbors()];
     unsigned int n_recv_ptls[m_comm->getNUniqueNeighbors()];
+    Scalar recv_cost[m_comm->getNUniqueNeighbors()];
     for (unsigned int cur_neigh=0; cur_neigh < m_comm->getNUniqueNeighbors(); ++cur_neigh)
         {
         unsigned int neigh_rank = h_unique_neigh.data[cur_neigh];
@@ -529,19 +764,35 @@ void LoadBalancer::computeOwnedParticles()
 
         MPI_Isend(&n_send_ptls[cur_neigh], 1, MPI_UNSIGNED, neigh_rank, 0, m_mpi_comm, & req[nreq++]);
         MPI_Irecv(&n_recv_ptls[cur_neigh], 1, MPI_UNSIGNED, neigh_rank, 0, m_mpi_comm, & req[nreq++]);
+
+        // received particles keep the cost they had on their old rank
+        if (m_time_weighting)
+            {
+            MPI_Isend(&m_particle_cost, 1, MPI_HOOMD_SCALAR, neigh_rank, 1, m_mpi_comm, & req[nreq++]);
+            MPI_Irecv(&recv_cost[cur_neigh], 1, MPI_HOOMD_SCALAR, neigh_rank, 1, m_mpi_comm, & req[nreq++]);
+            }
+        else
+            {
+            recv_cost[cur_neigh] = Scalar(1.0);
+            }
         }
     MPI_Waitall(nreq, req, stat);
 
     // reduce the particles sent to me
     int N_own = m_pdata->getN();
+    Scalar load = Scalar(m_pdata->getN()) * m_particle_cost;
     for (unsigned int cur_neigh = 0; cur_neigh < m_comm->getNUniqueNeighbors(); ++cur_neigh)
         {
         N_own += n_recv_ptls[cur_neigh];
         N_own -= n_send_ptls[cur_neigh];
+
+        load += Scalar(n_recv_ptls[cur_neigh]) * recv_cost[cur_neigh];
+        load -= Scalar(n_send_ptls[cur_neigh]) * m_particle_cost;
         }
 
     // set the count
     resetNOwn(N_own);
+    m_load = load;
     }
 
 /*!
@@ -578,6 +829,12 @@ void export_LoadBalancer(py::module& m)
     .def("setTolerance", &LoadBalancer::setTolerance)
     .def("getMaxIterations", &LoadBalancer::getMaxIterations)
     .def("setMaxIterations", &LoadBalancer::setMaxIterations)
+    .def("getBisection", &LoadBalancer::getBisection)
+    .def("setBisection", &LoadBalancer::setBisection)
+    .def("getTimeWeighting", &LoadBalancer::getTimeWeighting)
+    .def("setTimeWeighting", &LoadBalancer::setTimeWeighting)
+    .def("getDamping", &LoadBalancer::getDamping)
+    .def("setDamping", &LoadBalancer::setDamping)
     ;
     }
 #endif // ENABLE_MPI
@@ -41,6 +41,19 @@
  * Constraints are satisfied by solving a least-squares problem with box constraints, where the cost function is the
  * deviation of the domain sizes from the proposed rescaled width.
  *
+ * Alternatively, the boundaries can be placed by bisection at the particle-count medians (see setBisection()). A
+ * histogram of the particle positions along each dimension is reduced to the root rank, and every boundary is placed
+ * at the position that splits the particles of the slabs it separates evenly. Recursive bisection of the slabs along
+ * one dimension of the rectilinear grid reduces to placing boundary i at the quantile i/n of the particle distribution,
+ * so the domains reach the balanced widths in a few steps instead of approaching them by 5% per step. Constraints 1.
+ * and 2. still apply, so strongly imbalanced systems are rebalanced incrementally over several calls.
+ *
+ * By default, every particle has the same weight. With time weighting (see setTimeWeighting()), each rank measures the
+ * time its integrator spent computing since the last call (IntegratorData::getComputeTime()) and assigns every owned
+ * particle the cost per particle of the rank, relative to the average over all ranks. The load is then the sum of the
+ * particle costs, so ranks with expensive particles (rigid bodies, dense regions, complex shapes) shrink. The cost
+ * estimate is damped with an exponential moving average to avoid oscillations from noisy measurements.
+ *
  * \ingroup updaters
  */
 class PYBIND11_EXPORT LoadBalancer : public Updater
@@ -83,6 +96,46 @@ class PYBIND11_EXPORT LoadBalancer : public Updater
             m_maxiter = maxiter;
             }
 
+        //! Get whether the domain boundaries are placed at the particle-count medians
+        bool getBisection() const
+            {
+            return m_bisection;
+            }
+
+        //! Set whether the domain boundaries are placed at the particle-count medians
+        /*!
+         * \param bisection If true, place boundaries by bisection of the particle histogram, otherwise rescale the
+         *                  domains by their imbalance
+         */
+        void setBisection(bool bisection)
+            {
+            m_bisection = bisection;
+            }
+
+        //! Get whether the particles are weighted by the measured compute time
+        bool getTimeWeighting() const
+            {
+            return m_time_weighting;
+            }
+
+        //! Set whether the particles are weighted by the measured compute time
+        /*!
+         * \param enable If true, weight particles by the compute time per particle of their rank, otherwise count them
+         */
+        void setTimeWeighting(bool enable);
+
+        //! Get the damping of the particle cost estimate
+        Scalar getDamping() const
+            {
+            return m_damping;
+            }
+
+        //! Set the damping of the particle cost estimate
+        /*!
+         * \param damping Weight of the previous estimate in the moving average of the particle cost (0 <= damping < 1)
+         */
+        void setDamping(Scalar damping);
+
         //! Enable / disable load balancing along a dimension
         /*!
          * \param dim Dimension along which to balance
@@ -119,8 +172,19 @@ class PYBIND11_EXPORT LoadBalancer : public Updater
         Scalar m_max_imbalance;             //!< Maximum imbalance
         bool m_recompute_max_imbalance;     //!< Flag if maximum imbalance needs to be computed
 
-        //! Reduce the particle numbers per rank down to one dimension
-        bool reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsigned int reduce_root);
+        //! Reduce the particle loads per rank down to one dimension
+        bool reduce(std::vector<Scalar>& N_i, unsigned int dim, unsigned int reduce_root);
+
+        //! Reduce a histogram of the particle positions along one dimension
+        bool histogram(std::vector<Scalar>& H_i, unsigned int dim, unsigned int n_domains, unsigned int reduce_root);
+
+        //! Place the domain boundaries along a single dimension at the particle-count medians
+        bool bisect(std::vector<Scalar>& cum_frac_i,
+                    const std::vector<Scalar>& H_i,
+                    Scalar min_domain_frac);
+
+        //! Measure the relative cost of a particle on this rank
+        void updateParticleCost();
 
         //! Set flags within the class that a resize has been performed
         void signalResize()
@@ -132,7 +196,7 @@ class PYBIND11_EXPORT LoadBalancer : public Updater
 
         //! Adjust the partitioning along a single dimension
         bool adjust(std::vector<Scalar>& cum_frac_i,
-                    const std::vector<unsigned int>& N_i,
+                    const std::vector<Scalar>& N_i,
                     Scalar L_i,
                     Scalar min_domain_frac);
         bool m_needs_migrate;   //!< Flag to signal that migration is necessary
@@ -150,6 +214,13 @@ class PYBIND11_EXPORT LoadBalancer : public Updater
             return m_N_own;
             }
 
+        //! Gets the weighted load of the owned particles, updating if necessary
+        Scalar getLoad()
+            {
+            computeOwnedParticles();
+            return m_load;
+            }
+
         //! Force a reset of the number of owned particles without counting
         /*!
          * \param N number of particles owned by the rank
@@ -157,6 +228,7 @@ class PYBIND11_EXPORT LoadBalancer : public Updater
         void resetNOwn(unsigned int N)
             {
             m_N_own = N;
+            m_load = Scalar(N) * m_particle_cost;
             m_recompute_max_imbalance = true;
             m_needs_recount = false;
             }
@@ -170,8 +242,18 @@ class PYBIND11_EXPORT LoadBalancer : public Updater
 
         const Scalar m_max_scale;   //!< Maximum fraction to rescale either direction (5%)
 
+        bool m_bisection;                       //!< True if the boundaries are placed at the particle-count medians
+        const unsigned int m_bins_per_domain;   //!< Resolution of the position histogram for bisection
+
+        bool m_time_weighting;          //!< True if particles are weighted by the measured compute time
+        Scalar m_damping;               //!< Weight of the previous particle cost estimate
+        Scalar m_particle_cost;         //!< Relative cost of a particle on this rank (1 without time weighting)
+        bool m_particle_cost_valid;     //!< True if m_particle_cost holds a measurement
+        double m_last_compute_time;     //!< Compute time of this rank at the last call
+
     private:
         unsigned int m_N_own;               //!< Number of particles owned by this rank
+        Scalar m_load;                      //!< Weighted load of the particles owned by this rank
 
         Scalar m_max_max_imbalance;     //!< The maximum imbalance of any check
         double m_total_max_imbalance;   //!< The average imbalance over checks
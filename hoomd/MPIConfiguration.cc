@@ -23,7 +23,7 @@ MPIConfiguration::MPIConfiguration(
     MPI_Comm hoomd_world
     #endif
     )
-    : m_rank(0), m_n_rank(1)
+    : m_rank(0), m_n_rank(1), m_rank_node(0), m_n_rank_node(1)
     {
     #ifdef ENABLE_MPI
     m_mpi_comm = m_hoomd_world = hoomd_world;
@@ -36,9 +36,44 @@ MPIConfiguration::MPIConfiguration(
     int rank;
     MPI_Comm_rank(m_mpi_comm, &rank);
     m_rank = rank;
+
+    // count the ranks of all partitions that share this node
+    MPI_Comm world_node_comm;
+    MPI_Comm_split_type(m_hoomd_world, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &world_node_comm);
+    MPI_Comm_size(world_node_comm, &size);
+    m_n_rank_node = size;
+    MPI_Comm_rank(world_node_comm, &rank);
+    m_rank_node = rank;
+    MPI_Comm_free(&world_node_comm);
+
+    m_node_comm = MPI_COMM_NULL;
+    initNodeCommunicator();
+    #endif
+    }
+
+/*! The node communicator is freed unless MPI has already been finalized (e.g. at interpreter exit), when it no
+    longer exists.
+*/
+MPIConfiguration::~MPIConfiguration()
+    {
+    #ifdef ENABLE_MPI
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (m_node_comm != MPI_COMM_NULL && !finalized)
+        MPI_Comm_free(&m_node_comm);
     #endif
     }
 
+#ifdef ENABLE_MPI
+void MPIConfiguration::initNodeCommunicator()
+    {
+    if (m_node_comm != MPI_COMM_NULL)
+        MPI_Comm_free(&m_node_comm);
+
+    MPI_Comm_split_type(m_mpi_comm, MPI_COMM_TYPE_SHARED, m_rank, MPI_INFO_NULL, &m_node_comm);
+    }
+#endif
+
 
 void MPIConfiguration::splitPartitions(unsigned int nrank)
     {
@@ -69,6 +104,8 @@ void MPIConfiguration::splitPartitions(unsigned int nrank)
 
     MPI_Comm_rank(m_mpi_comm, &rank);
     m_rank = rank;
+
+    initNodeCommunicator();
 #endif
     }
 
@@ -94,6 +131,8 @@ void export_MPIConfiguration(pybind11::module& m)
         .def("barrier", &MPIConfiguration::barrier)
         .def("getNRanksGlobal", &MPIConfiguration::getNRanksGlobal)
         .def("getRankGlobal", &MPIConfiguration::getRankGlobal)
+        .def("getNRanksNode", &MPIConfiguration::getNRanksNode)
+        .def("getRankNode", &MPIConfiguration::getRankNode)
 #ifdef ENABLE_MPI
         .def_static("_make_mpi_conf_mpi_comm",  [](pybind11::object mpi_comm) -> std::shared_ptr<MPIConfiguration>
             {
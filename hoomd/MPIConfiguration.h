@@ -42,7 +42,7 @@ class PYBIND11_EXPORT MPIConfiguration
             );
 
         //! Destructor
-        virtual ~MPIConfiguration() {};
+        virtual ~MPIConfiguration();
 
 #ifdef ENABLE_MPI
         //! Returns the MPI communicator
@@ -55,8 +55,28 @@ class PYBIND11_EXPORT MPIConfiguration
             {
             return m_hoomd_world;
             }
+
+        //! Returns the communicator of the ranks in this partition that share a node (and its memory)
+        MPI_Comm getNodeCommunicator() const
+            {
+            return m_node_comm;
+            }
 #endif
 
+        //! Return the number of ranks of all partitions that run on this node
+        /*! Ranks on the same node share its cores, see ExecutionConfiguration::getNumThreadsPerRank()
+         */
+        unsigned int getNRanksNode() const
+            {
+            return m_n_rank_node;
+            }
+
+        //! Return the rank of this processor among the ranks on this node
+        unsigned int getRankNode() const
+            {
+            return m_rank_node;
+            }
+
         //!< Partition the communicator
         /*! \param nrank Number of ranks per partition
         */
@@ -126,9 +146,17 @@ class PYBIND11_EXPORT MPIConfiguration
 #ifdef ENABLE_MPI
         MPI_Comm m_mpi_comm;                   //!< The MPI communicator
         MPI_Comm m_hoomd_world;                //!< The HOOMD world communicator
+        MPI_Comm m_node_comm;                  //!< Ranks of this partition on the same node
 #endif
         unsigned int m_rank;                   //!< Rank of this processor (0 if running in single-processor mode)
         unsigned int m_n_rank;                 //!< Ranks per partition
+        unsigned int m_rank_node;              //!< Rank of this processor on this node
+        unsigned int m_n_rank_node;            //!< Ranks of all partitions on this node
+
+#ifdef ENABLE_MPI
+        //! Set up the node communicator of the current partition
+        void initNodeCommunicator();
+#endif
     };
 
 
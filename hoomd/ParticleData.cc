@@ -1193,6 +1193,150 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
     m_num_types_signal.emit();
     }
 
+#ifdef ENABLE_MPI
+//! Initialize from particles that every rank has read on its own
+/*! \param snapshot Particles in the local domain
+    \param tags Global tags of the particles in \a snapshot
+    \param nglobal Global number of particles
+
+    Unlike initializeFromSnapshot(), nothing is distributed from the root rank. The caller must provide every tag
+    from 0 to \a nglobal-1 on exactly one rank, in the domain that contains the particle. The type mapping in
+    \a snapshot must be the same on all ranks. A tag that is out of range or repeated within a rank is an error on
+    all ranks.
+ */
+template <class Real>
+void ParticleData::initializeFromLocalSnapshot(const SnapshotParticleData<Real>& snapshot,
+                                               const std::vector<unsigned int>& tags,
+                                               unsigned int nglobal)
+    {
+    m_exec_conf->msg->notice(4) << "ParticleData: initializing from local snapshots" << std::endl;
+    assert(m_decomposition);
+
+    // remove all ghost particles
+    removeAllGhostParticles();
+
+    if (! snapshot.validate() || tags.size() != snapshot.size)
+        {
+        m_exec_conf->msg->error() << "init.*: invalid particle data snapshot."
+                                << std::endl << std::endl;
+        throw std::runtime_error("Error initializing particle data.");
+        }
+
+    // every particle must have been placed on exactly one rank
+    unsigned int n_local = snapshot.size;
+    unsigned int n_total = 0;
+    MPI_Allreduce(&n_local, &n_total, 1, MPI_UNSIGNED, MPI_SUM, m_exec_conf->getMPICommunicator());
+    if (n_total != nglobal)
+        {
+        m_exec_conf->msg->error() << "init.*: " << n_total << " particles placed in domains, expected "
+                                  << nglobal << std::endl;
+        throw std::runtime_error("Error initializing particle data.");
+        }
+
+    // clear set of active tags
+    m_tag_set.clear();
+
+    // clear reservoir of recycled tags
+    while (! m_recycled_tags.empty())
+        m_recycled_tags.pop();
+
+    m_type_mapping = snapshot.type_mapping;
+
+    // resize array for reverse-lookup tags
+    m_rtag.resize(nglobal);
+
+        {
+        // reset all reverse lookup tags to NOT_LOCAL flag
+        ArrayHandle<unsigned int> h_rtag(getRTags(), access_location::host, access_mode::overwrite);
+        for (unsigned int tag = 0; tag < nglobal; tag++)
+            h_rtag.data[tag] = NOT_LOCAL;
+        }
+
+    // update list of active tags
+    for (unsigned int tag = 0; tag < nglobal; tag++)
+        {
+        m_tag_set.insert(tag);
+        }
+
+    // Now that active tag list has changed, invalidate the cache
+    m_invalid_cached_tags = true;
+
+    // resize particle data
+    resize(n_local);
+
+    // set if a tag is out of range or appears twice in this domain
+    unsigned int invalid_tags = 0;
+
+        {
+        ArrayHandle< Scalar4 > h_pos(m_pos, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar4 > h_vel(m_vel, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar3 > h_accel(m_accel, access_location::host, access_mode::overwrite);
+        ArrayHandle< int3 > h_image(m_image, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar > h_charge(m_charge, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar > h_diameter(m_diameter, access_location::host, access_mode::overwrite);
+        ArrayHandle< unsigned int > h_body(m_body, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar4 > h_orientation(m_orientation, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar4 > h_angmom(m_angmom, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar3 > h_inertia(m_inertia, access_location::host, access_mode::overwrite);
+        ArrayHandle< unsigned int > h_tag(m_tag, access_location::host, access_mode::overwrite);
+        ArrayHandle< unsigned int > h_comm_flag(m_comm_flags, access_location::host, access_mode::overwrite);
+        ArrayHandle< unsigned int > h_rtag(m_rtag, access_location::host, access_mode::readwrite);
+
+        for (unsigned int idx = 0; idx < n_local; idx++)
+            {
+            h_pos.data[idx] = make_scalar4(snapshot.pos[idx].x,
+                                           snapshot.pos[idx].y,
+                                           snapshot.pos[idx].z,
+                                           __int_as_scalar(snapshot.type[idx]));
+            h_vel.data[idx] = make_scalar4(snapshot.vel[idx].x,
+                                           snapshot.vel[idx].y,
+                                           snapshot.vel[idx].z,
+                                           snapshot.mass[idx]);
+            h_accel.data[idx] = vec_to_scalar3(snapshot.accel[idx]);
+            h_charge.data[idx] = snapshot.charge[idx];
+            h_diameter.data[idx] = snapshot.diameter[idx];
+            h_image.data[idx] = snapshot.image[idx];
+            h_tag.data[idx] = tags[idx];
+            if (tags[idx] < nglobal && h_rtag.data[tags[idx]] == NOT_LOCAL)
+                h_rtag.data[tags[idx]] = idx;
+            else
+                invalid_tags = 1;
+            h_body.data[idx] = snapshot.body[idx];
+            h_orientation.data[idx] = quat_to_scalar4(snapshot.orientation[idx]);
+            h_angmom.data[idx] = quat_to_scalar4(snapshot.angmom[idx]);
+            h_inertia.data[idx] = vec_to_scalar3(snapshot.inertia[idx]);
+
+            h_comm_flag.data[idx] = 0; // initialize with zero
+            }
+        }
+
+    // all ranks fail together, so that none of them waits in a later collective call
+    MPI_Allreduce(MPI_IN_PLACE, &invalid_tags, 1, MPI_UNSIGNED, MPI_MAX, m_exec_conf->getMPICommunicator());
+    if (invalid_tags)
+        {
+        m_exec_conf->msg->error() << "init.*: invalid particle data snapshot, particle tags are out of range "
+                                  << "or not unique." << std::endl << std::endl;
+        throw std::runtime_error("Error initializing particle data.");
+        }
+
+    // copy over accel_set flag from snapshot
+    m_accel_set = snapshot.is_accel_set;
+
+    // set global number of particles
+    setNGlobal(nglobal);
+
+    // notify listeners about resorting of local particles
+    notifyParticleSort();
+
+    // zero the origin
+    m_origin = make_scalar3(0,0,0);
+    m_o_image = make_int3(0,0,0);
+
+    // notify listeners that number of types has changed
+    m_num_types_signal.emit();
+    }
+#endif
+
 //! take a particle data snapshot
 /* \param snapshot The snapshot to write to
    \returns a map to lookup the snapshot index from a particle tag
@@ -2490,6 +2634,11 @@ template ParticleData::ParticleData(const SnapshotParticleData<float>& snapshot,
                                            std::shared_ptr<DomainDecomposition> decomposition
                                           );
 template void ParticleData::initializeFromSnapshot<float>(const SnapshotParticleData<float> & snapshot, bool ignore_bodies);
+#ifdef ENABLE_MPI
+template void ParticleData::initializeFromLocalSnapshot<float>(const SnapshotParticleData<float>& snapshot,
+                                                               const std::vector<unsigned int>& tags,
+                                                               unsigned int nglobal);
+#endif
 template std::map<unsigned int, unsigned int> ParticleData::takeSnapshot<float>(SnapshotParticleData<float> &snapshot);
 
 
@@ -977,6 +977,14 @@ class PYBIND11_EXPORT ParticleData
         template <class Real>
         void initializeFromSnapshot(const SnapshotParticleData<Real> & snapshot, bool ignore_bodies=false);
 
+        #ifdef ENABLE_MPI
+        //! Initialize from particles that every rank has read on its own
+        template <class Real>
+        void initializeFromLocalSnapshot(const SnapshotParticleData<Real>& snapshot,
+                                         const std::vector<unsigned int>& tags,
+                                         unsigned int nglobal);
+        #endif
+
         //! Take a snapshot
         template <class Real>
         std::map<unsigned int, unsigned int> takeSnapshot(SnapshotParticleData<Real> &snapshot);
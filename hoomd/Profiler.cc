@@ -12,6 +12,9 @@
 
 #include <iomanip>
 #include <sstream>
+#include <fstream>
+#include <stdexcept>
+#include <sys/time.h>
 
 
 using namespace std;
@@ -188,10 +191,57 @@ void ProfileDataElem::output_line(std::ostream &o,
     o << endl;
     }
 
+////////////////////////////////////////////////////////////////////
+// ProfileTraceBuffer
+
+/*! \param events Vector to store the events in (replaced)
+
+    Events that the owning thread overwrites while they are copied are removed from the result.
+*/
+void ProfileTraceBuffer::getEvents(std::vector<ProfileTraceEvent>& events) const
+    {
+    size_t capacity = m_events.size();
+    uint64_t end = m_count.load(std::memory_order_acquire);
+    uint64_t begin = end > capacity ? end - capacity : 0;
+
+    events.clear();
+    events.reserve(end - begin);
+    for (uint64_t i = begin; i < end; i++)
+        events.push_back(m_events[i % capacity]);
+
+    // events before new_begin may have been overwritten during the copy
+    uint64_t new_end = m_count.load(std::memory_order_acquire);
+    uint64_t new_begin = new_end > capacity ? new_end - capacity : 0;
+    if (new_begin > begin)
+        events.erase(events.begin(), events.begin() + std::min(new_begin - begin, uint64_t(events.size())));
+    }
+
 ////////////////////////////////////////////////////////////////////
 // Profiler
 
-Profiler::Profiler(const std::string& name) : m_name(name)
+const size_t Profiler::default_trace_capacity;
+
+//! Counter for the unique ids of the profilers
+static std::atomic<uint64_t> profiler_next_id(1);
+
+//! Quote a string for JSON
+static std::string json_quote(const char *s)
+    {
+    std::string result("\"");
+    for (; *s; s++)
+        {
+        if (*s == '"' || *s == '\\')
+            result += '\\';
+        if ((unsigned char)*s >= 0x20)
+            result += *s;
+        }
+    result += '"';
+    return result;
+    }
+
+Profiler::Profiler(const std::string& name)
+    : m_name(name), m_trace(false), m_id(profiler_next_id++), m_trace_capacity(default_trace_capacity),
+      m_trace_offset(0)
     {
     // push the root onto the top of the stack so that it is the default
     m_stack.push(&m_root);
@@ -223,6 +273,182 @@ void Profiler::output(std::ostream &o)
     m_root.output(o, m_name, 0, m_root.m_elapsed_time, (int)m_name.size());
     }
 
+/*! \param exec_conf Execution configuration (determines the MPI ranks of the trace)
+    \param capacity Number of events kept per thread, older events are overwritten
+
+    Under MPI, this method must be called on all ranks. It aligns the clocks of all ranks to that of the root rank.
+*/
+void Profiler::enableTrace(std::shared_ptr<const ExecutionConfiguration> exec_conf, size_t capacity)
+    {
+    if (capacity == 0)
+        {
+        exec_conf->msg->error() << "Trace capacity must be positive" << endl;
+        throw runtime_error("Error enabling trace");
+        }
+
+    m_trace_exec_conf = exec_conf;
+    m_trace_capacity = capacity;
+    m_trace_main_thread = std::this_thread::get_id();
+
+    // wall clock time at which m_clk reads zero
+    timeval tv;
+    gettimeofday(&tv, NULL);
+    int64_t wall = int64_t(tv.tv_sec) * int64_t(1000000000) + int64_t(tv.tv_usec)*int64_t(1000);
+    int64_t zero = wall - m_clk.getTime();
+    int64_t root_zero = zero;
+
+    #ifdef ENABLE_MPI
+    MPI_Bcast(&root_zero, 1, MPI_LONG_LONG, 0, exec_conf->getMPICommunicator());
+    #endif
+
+    m_trace_offset = zero - root_zero;
+    m_trace = true;
+
+    // register the calling thread first so that it is thread 0 in the trace
+    getTraceBuffer();
+    }
+
+ProfileTraceBuffer *Profiler::getTraceBuffer()
+    {
+    // each thread caches the buffer of the profiler it used last, so the lock is only taken on its first event
+    static thread_local uint64_t cached_id = 0;
+    static thread_local ProfileTraceBuffer *cached_buffer = NULL;
+
+    if (cached_id != m_id)
+        {
+        std::lock_guard<std::mutex> lock(m_trace_mutex);
+        std::unique_ptr<ProfileTraceBuffer>& buffer = m_trace_buffers[std::this_thread::get_id()];
+        if (!buffer)
+            buffer.reset(new ProfileTraceBuffer((unsigned int)m_trace_buffers.size() - 1, m_trace_capacity));
+        cached_buffer = buffer.get();
+        cached_id = m_id;
+        }
+
+    return cached_buffer;
+    }
+
+/*! \param name Name of the region, must remain valid until writeTrace() is called (e.g. a string literal)
+
+    Does nothing when the profiler is not in trace mode.
+*/
+void Profiler::traceBegin(const char *name)
+    {
+    if (m_trace)
+        getTraceBuffer()->record(m_clk.getTime(), name, true, 0, 0);
+    }
+
+/*! \param flop_count Number of floating point operations performed in the region
+    \param byte_count Number of bytes transferred in the region
+*/
+void Profiler::traceEnd(uint64_t flop_count, uint64_t byte_count)
+    {
+    if (m_trace)
+        getTraceBuffer()->record(m_clk.getTime(), NULL, false, flop_count, byte_count);
+    }
+
+/*! \param filename File to write
+
+    The process id of each event is the MPI rank and the thread id is the index of the thread on that rank. End
+    events carry the flop and byte counts given to pop() as arguments. Under MPI, this method must be called on all
+    ranks and the root rank writes the file.
+*/
+void Profiler::writeTrace(const std::string& filename)
+    {
+    if (!m_trace)
+        return;
+
+    unsigned int rank = m_trace_exec_conf->getRank();
+    uint64_t n_dropped = 0;
+    ostringstream o;
+    o << setiosflags(ios::fixed) << setprecision(3);
+
+    o << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank
+      << ",\"args\":{\"name\":\"rank " << rank << "\"}},\n";
+
+        {
+        std::lock_guard<std::mutex> lock(m_trace_mutex);
+        std::vector<ProfileTraceEvent> events;
+
+        for (auto it = m_trace_buffers.begin(); it != m_trace_buffers.end(); ++it)
+            {
+            const ProfileTraceBuffer& buffer = *it->second;
+            unsigned int tid = buffer.getThreadID();
+            n_dropped += buffer.getNumDropped();
+
+            o << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << rank << ",\"tid\":" << tid
+              << ",\"args\":{\"name\":\"";
+            if (it->first == m_trace_main_thread)
+                o << "main";
+            else
+                o << "thread " << tid;
+            o << "\"}},\n";
+
+            buffer.getEvents(events);
+
+            // skip the end events of regions whose beginning was overwritten
+            unsigned int depth = 0;
+            for (unsigned int i = 0; i < events.size(); i++)
+                {
+                const ProfileTraceEvent& event = events[i];
+                if (!event.m_begin && depth == 0)
+                    continue;
+                depth = event.m_begin ? depth + 1 : depth - 1;
+
+                o << "{\"ph\":\"" << (event.m_begin ? 'B' : 'E') << "\",\"pid\":" << rank << ",\"tid\":" << tid
+                  << ",\"ts\":" << double(event.m_time + m_trace_offset) / 1e3;
+                if (event.m_begin)
+                    o << ",\"name\":" << json_quote(event.m_name);
+                else if (event.m_flop_count || event.m_mem_byte_count)
+                    o << ",\"args\":{\"flops\":" << event.m_flop_count << ",\"bytes\":" << event.m_mem_byte_count << "}";
+                o << "},\n";
+                }
+            }
+        }
+
+    string local = o.str();
+    string all;
+
+    #ifdef ENABLE_MPI
+    MPI_Comm comm = m_trace_exec_conf->getMPICommunicator();
+    unsigned int n_ranks = m_trace_exec_conf->getNRanks();
+    int size = (int)local.size();
+    std::vector<int> sizes(n_ranks);
+    MPI_Gather(&size, 1, MPI_INT, sizes.data(), 1, MPI_INT, 0, comm);
+
+    std::vector<int> displs(n_ranks, 0);
+    if (rank == 0)
+        {
+        for (unsigned int i = 1; i < n_ranks; i++)
+            displs[i] = displs[i-1] + sizes[i-1];
+        all.resize(displs[n_ranks-1] + sizes[n_ranks-1]);
+        }
+    MPI_Gatherv(&local[0], size, MPI_CHAR, &all[0], sizes.data(), displs.data(), MPI_CHAR, 0, comm);
+
+    MPI_Allreduce(MPI_IN_PLACE, &n_dropped, 1, MPI_UINT64_T, MPI_SUM, comm);
+    #else
+    all.swap(local);
+    #endif
+
+    if (n_dropped > 0)
+        m_trace_exec_conf->msg->warning() << "Profiler: " << n_dropped << " trace events were overwritten, "
+                                          << "the trace only contains the most recent ones" << endl;
+
+    if (rank != 0)
+        return;
+
+    // remove the separator of the last event
+    if (all.size() >= 2)
+        all.resize(all.size()-2);
+
+    ofstream f(filename.c_str());
+    f << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" << all << "\n]}\n";
+    if (!f.good())
+        {
+        m_trace_exec_conf->msg->error() << "Error writing trace file " << filename << endl;
+        throw runtime_error("Error writing trace");
+        }
+    }
+
 /*! \param o Stream to output to
     \param prof Profiler to print
 */
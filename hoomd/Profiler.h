@@ -26,6 +26,11 @@
 #include <string>
 #include <stack>
 #include <map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
 #include <iostream>
 #include <cassert>
 
@@ -41,6 +46,7 @@
 
 // forward declarations
 class ProfileDataElem;
+class ProfileTraceBuffer;
 class Profiler;
 
 /*! \ingroup hoomd_lib
@@ -100,6 +106,68 @@ class PYBIND11_EXPORT ProfileDataElem
     };
 
 
+//! Event recorded by a Profiler in trace mode
+/*! \ingroup utils
+*/
+struct ProfileTraceEvent
+    {
+    int64_t m_time;             //!< Time of the event (nanoseconds on the clock of the Profiler)
+    const char *m_name;         //!< Name of the region (begin events only)
+    uint64_t m_flop_count;      //!< Floating point operations performed in the region (end events only)
+    uint64_t m_mem_byte_count;  //!< Memory bytes transferred in the region (end events only)
+    bool m_begin;               //!< True for the beginning of a region, false for its end
+    };
+
+//! Ring buffer of the trace events of a single thread
+/*! Only the owning thread writes to the buffer, so recording an event needs neither a lock nor an atomic
+    read-modify-write. When the buffer is full, the oldest events are overwritten. getEvents() may be called from
+    another thread and returns only the events that were not overwritten while it copied them.
+
+    \ingroup utils
+*/
+class PYBIND11_EXPORT ProfileTraceBuffer
+    {
+    public:
+        //! Constructs an empty buffer
+        ProfileTraceBuffer(unsigned int thread_id, size_t capacity)
+            : m_events(capacity), m_count(0), m_thread_id(thread_id)
+            {
+            }
+
+        //! Records an event
+        void record(int64_t time, const char *name, bool begin, uint64_t flop_count, uint64_t byte_count)
+            {
+            uint64_t n = m_count.load(std::memory_order_relaxed);
+            ProfileTraceEvent& event = m_events[n % m_events.size()];
+            event.m_time = time;
+            event.m_name = name;
+            event.m_flop_count = flop_count;
+            event.m_mem_byte_count = byte_count;
+            event.m_begin = begin;
+            m_count.store(n+1, std::memory_order_release);
+            }
+
+        //! Copies the events in the buffer, oldest first
+        void getEvents(std::vector<ProfileTraceEvent>& events) const;
+
+        //! Returns the number of events that were overwritten
+        uint64_t getNumDropped() const
+            {
+            uint64_t n = m_count.load(std::memory_order_acquire);
+            return n > m_events.size() ? n - m_events.size() : 0;
+            }
+
+        //! Returns the index of the thread in the trace
+        unsigned int getThreadID() const
+            {
+            return m_thread_id;
+            }
+
+    private:
+        std::vector<ProfileTraceEvent> m_events;    //!< Storage of the ring buffer
+        std::atomic<uint64_t> m_count;              //!< Total number of recorded events
+        unsigned int m_thread_id;                   //!< Index of the thread in the trace
+    };
 
 //! A class for doing coarse-level profiling of code
 /*! Stores and organizes a tree of profiles that can be created with a simple push/pop
@@ -118,6 +186,13 @@ class PYBIND11_EXPORT ProfileDataElem
     to provide accurate timing information.
 
     These profiles can of course be output via normal ostream operators.
+
+    In trace mode (enableTrace()), every push() and pop() additionally records a timestamped event in a ring buffer
+    of the calling thread, and writeTrace() exports the events of all threads and MPI ranks in the Chrome trace
+    event format, which chrome://tracing and Perfetto display as a timeline. The tree is still accumulated. push() and
+    pop() are not thread safe, other threads (such as background I/O threads) mark their regions with traceBegin()
+    and traceEnd() instead. The versions of push() and pop() that take an ExecutionConfiguration do not synchronize
+    with the GPU in trace mode, so that the trace shows the overlap of CPU and GPU work as it happens.
     \ingroup utils
     */
 class PYBIND11_EXPORT Profiler
@@ -135,12 +210,45 @@ class PYBIND11_EXPORT Profiler
         //! Pops back up to the next super-category & syncs the GPUs
         void pop(std::shared_ptr<const ExecutionConfiguration> exec_conf, uint64_t flop_count = 0, uint64_t byte_count = 0);
 
+        //! Default number of trace events kept per thread
+        static const size_t default_trace_capacity = 1 << 20;
+
+        //! Starts recording trace events
+        void enableTrace(std::shared_ptr<const ExecutionConfiguration> exec_conf,
+                         size_t capacity = default_trace_capacity);
+
+        //! Returns true if trace events are recorded
+        bool isTracing() const
+            {
+            return m_trace;
+            }
+
+        //! Marks the beginning of a region in the trace (thread safe)
+        void traceBegin(const char *name);
+        //! Marks the end of the most recent region of the calling thread in the trace (thread safe)
+        void traceEnd(uint64_t flop_count = 0, uint64_t byte_count = 0);
+
+        //! Writes the events of all threads and ranks to a Chrome trace file
+        void writeTrace(const std::string& filename);
+
     private:
         ClockSource m_clk;  //!< Clock to provide timing information
         std::string m_name; //!< The name of this profile
         ProfileDataElem m_root; //!< The root profile element
         std::stack<ProfileDataElem *> m_stack;  //!< A stack of data elements for the push/pop structure
 
+        bool m_trace;                                   //!< True if trace events are recorded
+        uint64_t m_id;                                  //!< Unique id of this profiler
+        size_t m_trace_capacity;                        //!< Number of events kept per thread
+        int64_t m_trace_offset;                         //!< Offset from m_clk to the clock of the root rank
+        std::thread::id m_trace_main_thread;            //!< Thread that enabled the trace
+        std::shared_ptr<const ExecutionConfiguration> m_trace_exec_conf; //!< Execution configuration of the trace
+        std::mutex m_trace_mutex;                       //!< Protects m_trace_buffers
+        std::map<std::thread::id, std::unique_ptr<ProfileTraceBuffer> > m_trace_buffers; //!< Buffers of all threads
+
+        //! Returns the trace buffer of the calling thread
+        ProfileTraceBuffer *getTraceBuffer();
+
         //! Output helper function
         void output(std::ostream &o);
 
@@ -163,8 +271,8 @@ PYBIND11_EXPORT std::ostream& operator<<(std::ostream &o, Profiler& prof);
 inline void Profiler::push(std::shared_ptr<const ExecutionConfiguration> exec_conf, const std::string& name)
     {
 #if defined(ENABLE_CUDA) && !defined(ENABLE_NVTOOLS)
-    // nvtools profiling disables synchronization so that async CPU/GPU overlap can be seen
-    if(exec_conf->isCUDAEnabled())
+    // nvtools profiling and tracing disable synchronization so that async CPU/GPU overlap can be seen
+    if(exec_conf->isCUDAEnabled() && !m_trace)
         {
         exec_conf->multiGPUBarrier();
         cudaDeviceSynchronize();
@@ -176,8 +284,8 @@ inline void Profiler::push(std::shared_ptr<const ExecutionConfiguration> exec_co
 inline void Profiler::pop(std::shared_ptr<const ExecutionConfiguration> exec_conf, uint64_t flop_count, uint64_t byte_count)
     {
 #if defined(ENABLE_CUDA) && !defined(ENABLE_NVTOOLS)
-    // nvtools profiling disables synchronization so that async CPU/GPU overlap can be seen
-    if(exec_conf->isCUDAEnabled())
+    // nvtools profiling and tracing disable synchronization so that async CPU/GPU overlap can be seen
+    if(exec_conf->isCUDAEnabled() && !m_trace)
         {
         exec_conf->multiGPUBarrier();
         cudaDeviceSynchronize();
@@ -201,14 +309,21 @@ inline void Profiler::push(const std::string& name)
     ProfileDataElem *cur = m_stack.top();
 
     // then creating (or accessing) the named sample and setting the start time
-    cur->m_children[name].m_start_time = t;
+    std::map<std::string, ProfileDataElem>::iterator child = cur->m_children.lower_bound(name);
+    if (child == cur->m_children.end() || child->first != name)
+        child = cur->m_children.insert(child, std::make_pair(name, ProfileDataElem()));
+    child->second.m_start_time = t;
 
     // and updating the stack
-    m_stack.push(&cur->m_children[name]);
+    m_stack.push(&child->second);
+
+    // the key in the tree outlives the trace, so the event can point to it
+    if (m_trace)
+        getTraceBuffer()->record(t, child->first.c_str(), true, 0, 0);
 
     #ifdef SCOREP_USER_ENABLE
     // log Score-P region
-    SCOREP_USER_REGION_BEGIN( cur->m_children[name].m_scorep_region, name.c_str(),SCOREP_USER_REGION_TYPE_COMMON )
+    SCOREP_USER_REGION_BEGIN( child->second.m_scorep_region, name.c_str(),SCOREP_USER_REGION_TYPE_COMMON )
     #endif
     }
 
@@ -236,6 +351,9 @@ inline void Profiler::pop(uint64_t flop_count, uint64_t byte_count)
     cur->m_flop_count += flop_count;
     cur->m_mem_byte_count += byte_count;
 
+    if (m_trace)
+        getTraceBuffer()->record(t, NULL, false, flop_count, byte_count);
+
     // and finally popping the stack so that the next pop will access the correct element
     m_stack.pop();
     }
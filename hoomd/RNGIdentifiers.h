@@ -27,6 +27,9 @@ struct RNGIdentifier
     static const uint32_t HPMCMonoShuffle = 0xfa870af6;
     static const uint32_t HPMCMonoTrialMove = 0x754dea60;
     static const uint32_t HPMCMonoShift = 0xf4a3210e;
+    static const uint32_t HPMCMonoCheckerboardShift = 0x3c81d92b;
+    static const uint32_t HPMCMonoCheckerboardCell = 0x8e5f07a4;
+    static const uint32_t HPMCMonoEventChain = 0x5d2b7c13;
     static const uint32_t UpdaterBoxMC= 0xf6a510ab;
     static const uint32_t UpdaterClusters =  0x09365bf5;
     static const uint32_t UpdaterClustersPairwise = 0x50060112;
@@ -39,16 +39,24 @@ template< class SignalType >
 class SharedSignal : public Nano::Signal<SignalType>
     {
     public:
-        SharedSignal(){}
+        SharedSignal() : m_num_slots(0) {}
         virtual ~SharedSignal()
             {
             // The shared signal is being destroyed so we need to clean up any
             // references to the signal before it is freed.
             disconnect_signal.emit();
             }
+
+        //! Get the number of SharedSignalSlots connected to the signal
+        unsigned int getNumSlots() const
+            {
+            return m_num_slots;
+            }
+
         friend class SharedSignalSlot<SignalType>;
     private:
         Nano::Signal<void ()>   disconnect_signal;    //!< Disconnect Signal
+        unsigned int            m_num_slots;          //!< Number of connected SharedSignalSlots
     };
 
 //! Manages signal lifetime and slot lifetime
@@ -124,6 +132,7 @@ class SharedSignalSlot<R(Args...)> : public SignalSlot
                 return;
             m_signal.disconnect(m_func);
             m_signal.disconnect_signal.template disconnect<SharedSignalSlot<R(Args...)>, &SharedSignalSlot<R(Args...)>::disconnect >(this);
+            m_signal.m_num_slots--;
             m_connected = false;
             }
 
@@ -132,6 +141,7 @@ class SharedSignalSlot<R(Args...)> : public SignalSlot
             {
             m_signal.disconnect_signal.template connect<SharedSignalSlot<R(Args...)>, &SharedSignalSlot<R(Args...)>::disconnect >(this);
             m_signal.connect(m_func);
+            m_signal.m_num_slots++;
             m_connected = true;
             }
 
@@ -605,14 +605,22 @@ void System::run(unsigned int nsteps, unsigned int cb_frequency,
         if (m_integrator)
             m_integrator->update(m_cur_tstep);
 
-        // quit if Ctrl-C was pressed
+        // quit if Ctrl-C was pressed, after the output written so far is complete
         if (g_sigint_recvd)
             {
             g_sigint_recvd = 0;
+            flushAnalyzers();
+
+            // keep the trace of the interrupted run
+            if (m_profiler && !m_trace_file.empty())
+                m_profiler->writeTrace(m_trace_file);
             return;
             }
         }
 
+    // make sure all output of this run has been written
+    flushAnalyzers();
+
     // generate a final status line
     generateStatusLine();
     m_last_status_tstep = m_cur_tstep;
@@ -638,9 +646,12 @@ void System::run(unsigned int nsteps, unsigned int cb_frequency,
         m_exec_conf->msg->notice(1) << "Average TPS: " << m_last_TPS << endl;
 
     // write out the profile data
-    if (m_profiler)
+    if (m_profiler && m_profile)
         m_exec_conf->msg->notice(1) << *m_profiler;
 
+    if (m_profiler && !m_trace_file.empty())
+        m_profiler->writeTrace(m_trace_file);
+
     if (!m_quiet_run)
         printStats();
 
@@ -659,6 +670,13 @@ void System::enableProfiler(bool enable)
     m_profile = enable;
     }
 
+/*! \param filename File to write a Chrome trace of each run to, or an empty string to disable tracing
+*/
+void System::enableTrace(const std::string& filename)
+    {
+    m_trace_file = filename;
+    }
+
 /*! \param logger Logger to register computes and updaters with
     All computes and updaters registered with the system are also registered with the logger.
 */
@@ -720,11 +738,14 @@ void System::setAutotunerParams(bool enabled, unsigned int period)
 
 void System::setupProfiling()
     {
-    if (m_profile)
+    if (m_profile || !m_trace_file.empty())
         m_profiler = std::shared_ptr<Profiler>(new Profiler("Simulation"));
     else
         m_profiler = std::shared_ptr<Profiler>();
 
+    if (!m_trace_file.empty())
+        m_profiler->enableTrace(m_exec_conf);
+
     // set the profiler on everything
     if (m_integrator)
         m_integrator->setProfiler(m_profiler);
@@ -785,6 +806,13 @@ void System::printStats()
         m_exec_conf->getMemoryTracer()->outputTraces(m_exec_conf->msg);
     }
 
+void System::flushAnalyzers()
+    {
+    vector<analyzer_item>::iterator analyzer;
+    for (analyzer = m_analyzers.begin(); analyzer != m_analyzers.end(); ++analyzer)
+        analyzer->m_analyzer->flush();
+    }
+
 void System::resetStats()
     {
     if (m_integrator)
@@ -928,6 +956,7 @@ void export_System(py::module& m)
     .def("setStatsPeriod", &System::setStatsPeriod)
     .def("setAutotunerParams", &System::setAutotunerParams)
     .def("enableProfiler", &System::enableProfiler)
+    .def("enableTrace", &System::enableTrace)
     .def("enableQuietRun", &System::enableQuietRun)
     .def("run", &System::run)
 
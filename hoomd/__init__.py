@@ -86,7 +86,7 @@ sys.excepthook = _hoomd_sys_excepthook
 
 __version__ = "{0}.{1}.{2}".format(*_hoomd.__version__)
 
-def run(tsteps, profile=False, limit_hours=None, limit_multiple=1, callback_period=0, callback=None, quiet=False):
+def run(tsteps, profile=False, limit_hours=None, limit_multiple=1, callback_period=0, callback=None, quiet=False, trace=None):
     """ Runs the simulation for a given number of time steps.
 
     Args:
@@ -99,12 +99,14 @@ def run(tsteps, profile=False, limit_hours=None, limit_multiple=1, callback_peri
         callback (`callable`): Sets a Python function to be called regularly during a run.
         callback_period (int): Sets the period, in time steps, between calls made to ``callback``.
         quiet (bool): Set to True to disable the status information printed to the screen by the run.
+        trace (str): If not None, write a timeline of the run to this file in the Chrome trace format.
 
     Example::
 
             hoomd.run(10)
             hoomd.run(10e6, limit_hours=1.0/3600.0, limit_multiple=10)
             hoomd.run(10, profile=True)
+            hoomd.run(1000, trace='trace.json')
             hoomd.run(10, quiet=True)
             hoomd.run(10, callback_period=2, callback=lambda step: print(step))
 
@@ -125,6 +127,14 @@ def run(tsteps, profile=False, limit_hours=None, limit_multiple=1, callback_peri
     portion of the calculation is printed at the end of the run. Collecting this timing information
     slows the simulation.
 
+    When `trace` is set, the beginning and end of every profiled region (computes, updaters, communication, I/O) is
+    recorded with a timestamp on every thread and MPI rank, and written to the given file at the end of the run,
+    also when the run is interrupted with Ctrl-C. Open the file in ``chrome://tracing`` or https://ui.perfetto.dev
+    to see the timeline of each time step, one row per rank and thread, and find load imbalance and stalls. Regions
+    that report them carry the number of floating point operations and bytes transferred as arguments. Unlike
+    `profile`, tracing does not synchronize with the GPU, so GPU regions show the time spent launching kernels. Each
+    thread keeps the most recent 2^20 events.
+
     **Wallclock limited runs:**
 
     There are a number of mechanisms to limit the time of a running hoomd script. Use these in a job
@@ -182,6 +192,7 @@ def run(tsteps, profile=False, limit_hours=None, limit_multiple=1, callback_peri
     for logger in context.current.loggers:
         logger.update_quantities();
     context.current.system.enableProfiler(profile);
+    context.current.system.enableTrace(trace if trace is not None else '');
     context.current.system.enableQuietRun(quiet);
 
     # update all user-defined neighbor lists
@@ -0,0 +1,299 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file BenchmarkSuite.h
+    \brief Declares the BenchmarkSuite class used by the C++ microbenchmarks
+    \note This file should be included only by benchmark executables, it defines all methods inline.
+*/
+
+#ifndef __BENCHMARK_SUITE_H__
+#define __BENCHMARK_SUITE_H__
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include "hoomd/ClockSource.h"
+#include "hoomd/HOOMDVersion.h"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+//! Times kernels in isolation and writes the results as JSON
+/*! Every benchmark executable constructs one BenchmarkSuite from the command line, sets up its systems, and calls
+    run() once per kernel. The kernels execute on the CPU, so the benchmarks run on any machine. run() calls the
+    kernel a few times to warm up caches and internal buffers, then times every one of the following calls
+    individually with ClockSource. Each call is passed a new time step, so computes that cache their results per time
+    step do the full work on every call.
+
+    Command line options:
+     - `--repeat N`: number of timed calls per kernel (default 20)
+     - `--warmup N`: number of untimed calls before the timed ones (default 3)
+     - `--scale X`: multiply the number of particles of every system by X (default 1)
+     - `--filter S`: only run the benchmarks whose name contains S
+     - `--output F`: write the JSON results to F instead of standard output
+
+    finish() writes one JSON document with the HOOMD version, git revision, and compile flags, followed by one record
+    per benchmark with the minimum, median, mean and standard deviation of the call time in seconds. Comparing the
+    medians of two builds gives the change of each kernel.
+
+    \ingroup utils
+*/
+class BenchmarkSuite
+    {
+    public:
+        //! Result of one benchmark
+        struct Result
+            {
+            std::string name;           //!< Unique name of the benchmark
+            std::string system;         //!< Name of the system
+            std::string kernel;         //!< Name of the timed method
+            unsigned int N;             //!< Number of particles in the system
+            unsigned int repeat;        //!< Number of timed calls
+            double min;                 //!< Fastest call (seconds)
+            double median;              //!< Median call time (seconds)
+            double mean;                //!< Mean call time (seconds)
+            double stddev;              //!< Standard deviation of the call times (seconds)
+            };
+
+        //! Parse the command line and set up the execution configuration
+        BenchmarkSuite(int argc, char **argv, const std::string& suite)
+            : m_suite(suite), m_repeat(20), m_warmup(3), m_scale(1.0), m_status(0)
+            {
+            #ifdef ENABLE_MPI
+            MPI_Init(&argc, &argv);
+            #endif
+
+            for (int i = 1; i < argc; i++)
+                {
+                std::string arg(argv[i]);
+                bool has_value = i+1 < argc;
+
+                if (arg == "--repeat" && has_value)
+                    m_repeat = std::max(1, atoi(argv[++i]));
+                else if (arg == "--warmup" && has_value)
+                    m_warmup = std::max(0, atoi(argv[++i]));
+                else if (arg == "--scale" && has_value)
+                    m_scale = atof(argv[++i]);
+                else if (arg == "--filter" && has_value)
+                    m_filter = argv[++i];
+                else if (arg == "--output" && has_value)
+                    m_output = argv[++i];
+                else
+                    {
+                    std::cerr << "Usage: " << argv[0] << " [--repeat N] [--warmup N] [--scale X] [--filter S]"
+                              << " [--output file.json]" << std::endl;
+                    m_status = 1;
+                    }
+                }
+
+            if (!(m_scale > 0))
+                {
+                std::cerr << "--scale must be positive" << std::endl;
+                m_status = 1;
+                }
+
+            if (m_status == 0)
+                m_exec_conf = std::shared_ptr<ExecutionConfiguration>(
+                                    new ExecutionConfiguration(ExecutionConfiguration::CPU));
+            }
+
+        //! Shut down MPI
+        ~BenchmarkSuite()
+            {
+            m_exec_conf.reset();
+
+            #ifdef ENABLE_MPI
+            MPI_Finalize();
+            #endif
+            }
+
+        //! Get the execution configuration to construct the systems with
+        std::shared_ptr<ExecutionConfiguration> getExecConf() const
+            {
+            return m_exec_conf;
+            }
+
+        //! Scale a number of particles by the --scale option
+        unsigned int scaled(unsigned int N) const
+            {
+            return std::max(1u, (unsigned int)(N*m_scale + 0.5));
+            }
+
+        //! Test if the benchmark of \a kernel in \a system is selected by the --filter option
+        /*! Benchmarks use this to skip setting up systems that are not needed.
+        */
+        bool isSelected(const std::string& system, const std::string& kernel) const
+            {
+            return m_status == 0 && getName(system, kernel).find(m_filter) != std::string::npos;
+            }
+
+        //! Time a kernel
+        /*! \param system Name of the system
+            \param kernel Name of the timed method
+            \param N Number of particles in the system
+            \param f Function that calls the kernel once at the given time step
+
+            The benchmark is named system/kernel and skipped when it does not match the --filter option.
+        */
+        void run(const std::string& system,
+                 const std::string& kernel,
+                 unsigned int N,
+                 std::function<void (unsigned int)> f)
+            {
+            if (!isSelected(system, kernel))
+                return;
+
+            std::string name = getName(system, kernel);
+
+            std::cerr << "Running " << name << " (N=" << N << ")" << std::endl;
+
+            unsigned int timestep = 0;
+            for (unsigned int i = 0; i < m_warmup; i++)
+                f(timestep++);
+
+            std::vector<double> times(m_repeat);
+            for (unsigned int i = 0; i < m_repeat; i++)
+                {
+                int64_t start = m_clock.getTime();
+                f(timestep++);
+                times[i] = double(m_clock.getTime() - start) * 1e-9;
+                }
+
+            Result result;
+            result.name = name;
+            result.system = system;
+            result.kernel = kernel;
+            result.N = N;
+            result.repeat = m_repeat;
+
+            double sum = 0;
+            for (unsigned int i = 0; i < times.size(); i++)
+                sum += times[i];
+            result.mean = sum / times.size();
+
+            double sum_sq = 0;
+            for (unsigned int i = 0; i < times.size(); i++)
+                sum_sq += (times[i] - result.mean)*(times[i] - result.mean);
+            result.stddev = times.size() > 1 ? sqrt(sum_sq / (times.size()-1)) : 0.0;
+
+            std::sort(times.begin(), times.end());
+            result.min = times[0];
+            result.median = (times.size() % 2) ? times[times.size()/2]
+                                               : 0.5*(times[times.size()/2-1] + times[times.size()/2]);
+
+            m_results.push_back(result);
+            }
+
+        //! Write the results and return the exit code of the executable
+        int finish()
+            {
+            if (m_status != 0)
+                return m_status;
+
+            bool root = true;
+            #ifdef ENABLE_MPI
+            root = m_exec_conf->isRoot();
+            #endif
+            if (!root)
+                return 0;
+
+            std::ostringstream o;
+            o << "{\n";
+            o << "  \"suite\": " << quote(m_suite) << ",\n";
+            o << "  \"hoomd_version\": " << quote(HOOMD_VERSION) << ",\n";
+            o << "  \"git_sha1\": " << quote(HOOMD_GIT_SHA1) << ",\n";
+            o << "  \"git_refspec\": " << quote(HOOMD_GIT_REFSPEC) << ",\n";
+            o << "  \"compile_flags\": " << quote(hoomd_compile_flags()) << ",\n";
+            o << "  \"repeat\": " << m_repeat << ",\n";
+            o << "  \"warmup\": " << m_warmup << ",\n";
+            o << "  \"benchmarks\": [";
+            for (unsigned int i = 0; i < m_results.size(); i++)
+                {
+                const Result& r = m_results[i];
+                o.precision(6);
+                o << (i > 0 ? "," : "") << "\n    {";
+                o << "\"name\": " << quote(r.name) << ", ";
+                o << "\"system\": " << quote(r.system) << ", ";
+                o << "\"kernel\": " << quote(r.kernel) << ", ";
+                o << "\"N\": " << r.N << ", ";
+                o << "\"repeat\": " << r.repeat << ", ";
+                o << std::scientific;
+                o << "\"min_s\": " << r.min << ", ";
+                o << "\"median_s\": " << r.median << ", ";
+                o << "\"mean_s\": " << r.mean << ", ";
+                o << "\"stddev_s\": " << r.stddev << ", ";
+                o << "\"particles_per_s\": " << (r.median > 0 ? r.N / r.median : 0.0);
+                o << std::defaultfloat;
+                o << "}";
+                }
+            o << "\n  ]\n}\n";
+
+            if (m_output.empty())
+                {
+                std::cout << o.str();
+                }
+            else
+                {
+                std::ofstream f(m_output.c_str());
+                f << o.str();
+                if (!f.good())
+                    {
+                    std::cerr << "Error writing " << m_output << std::endl;
+                    return 1;
+                    }
+                }
+
+            return 0;
+            }
+
+    private:
+        std::string m_suite;            //!< Name of the benchmark executable
+        unsigned int m_repeat;          //!< Number of timed calls
+        unsigned int m_warmup;          //!< Number of untimed calls
+        double m_scale;                 //!< Factor for the number of particles
+        std::string m_filter;           //!< Only run benchmarks whose name contains this string
+        std::string m_output;           //!< Output file name (empty for stdout)
+        int m_status;                   //!< Nonzero if the command line was invalid
+        ClockSource m_clock;            //!< Timer
+        std::vector<Result> m_results;  //!< Results of all benchmarks run so far
+        std::shared_ptr<ExecutionConfiguration> m_exec_conf; //!< Execution configuration
+
+        //! Get the full name of a benchmark
+        std::string getName(const std::string& system, const std::string& kernel) const
+            {
+            return m_suite + "/" + system + "/" + kernel;
+            }
+
+        //! Quote a string for JSON
+        static std::string quote(const std::string& s)
+            {
+            std::string result("\"");
+            for (unsigned int i = 0; i < s.size(); i++)
+                {
+                char c = s[i];
+                if (c == '"' || c == '\\')
+                    {
+                    result += '\\';
+                    result += c;
+                    }
+                else if (c == '\n')
+                    result += "\\n";
+                else if ((unsigned char)c >= 0x20)
+                    result += c;
+                }
+            result += '"';
+            return result;
+            }
+    };
+
+#endif
@@ -0,0 +1,108 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file BenchmarkSystems.h
+    \brief Builds the standard systems used by the C++ microbenchmarks
+*/
+
+#ifndef __BENCHMARK_SYSTEMS_H__
+#define __BENCHMARK_SYSTEMS_H__
+
+#include "hoomd/SnapshotSystemData.h"
+#include "hoomd/RandomNumbers.h"
+
+#include <memory>
+#include <math.h>
+
+//! Place N particles on a simple cubic lattice
+/*! \param N Number of particles
+    \param density Number density
+    \param jitter Maximum random displacement of each particle from its lattice site, in units of the lattice spacing
+    \param seed Seed for the displacements
+
+    The sites are filled in a snake order, so that consecutive particles are always nearest neighbors on the lattice.
+    All particles have type A. The lattice spacing is returned in \a spacing.
+*/
+inline std::shared_ptr< SnapshotSystemData<Scalar> > make_lattice_snapshot(unsigned int N,
+                                                                           Scalar density,
+                                                                           Scalar jitter,
+                                                                           unsigned int seed,
+                                                                           Scalar *spacing=NULL)
+    {
+    unsigned int n = (unsigned int)ceil(cbrt(double(N)) - 1e-9);
+    Scalar L = cbrt(Scalar(N) / density);
+    Scalar a = L / Scalar(n);
+
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap(new SnapshotSystemData<Scalar>());
+    snap->global_box = BoxDim(L);
+    snap->particle_data.type_mapping.push_back("A");
+    snap->particle_data.resize(N);
+
+    hoomd::RandomGenerator rng(seed, 0);
+    hoomd::UniformDistribution<Scalar> uniform(-jitter*a, jitter*a);
+
+    for (unsigned int i = 0; i < N; i++)
+        {
+        // snake through the lattice: reverse the direction of every other row and plane
+        unsigned int plane = i / (n*n);
+        unsigned int row = (i / n) % n;
+        unsigned int col = i % n;
+        if ((plane*n + row) % 2)
+            col = n - 1 - col;
+        if (plane % 2)
+            row = n - 1 - row;
+
+        vec3<Scalar> r(Scalar(col) + Scalar(0.5), Scalar(row) + Scalar(0.5), Scalar(plane) + Scalar(0.5));
+        r = r * a - vec3<Scalar>(L/2, L/2, L/2);
+        r += vec3<Scalar>(uniform(rng), uniform(rng), uniform(rng));
+        snap->particle_data.pos[i] = r;
+        }
+
+    if (spacing)
+        *spacing = a;
+
+    return snap;
+    }
+
+//! Build a Lennard-Jones liquid
+/*! \param N Number of particles
+
+    Particles are displaced randomly from the sites of a simple cubic lattice at the typical liquid density 0.85.
+*/
+inline std::shared_ptr< SnapshotSystemData<Scalar> > make_lj_liquid_snapshot(unsigned int N)
+    {
+    return make_lattice_snapshot(N, Scalar(0.85), Scalar(0.15), 1);
+    }
+
+//! Build a polymer melt
+/*! \param N Number of particles
+    \param chain_length Number of monomers per chain
+
+    Chains follow the snake order of the lattice, so every bond connects two neighboring sites. All bonds have type A.
+*/
+inline std::shared_ptr< SnapshotSystemData<Scalar> > make_polymer_melt_snapshot(unsigned int N,
+                                                                                 unsigned int chain_length)
+    {
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = make_lattice_snapshot(N, Scalar(0.85), Scalar(0.1), 2);
+
+    unsigned int n_chains = N / chain_length;
+    snap->bond_data.type_mapping.push_back("A");
+    snap->bond_data.resize(n_chains*(chain_length-1));
+
+    unsigned int bond = 0;
+    for (unsigned int chain = 0; chain < n_chains; chain++)
+        {
+        for (unsigned int j = 0; j + 1 < chain_length; j++)
+            {
+            snap->bond_data.groups[bond].tag[0] = chain*chain_length + j;
+            snap->bond_data.groups[bond].tag[1] = chain*chain_length + j + 1;
+            snap->bond_data.type_id[bond] = 0;
+            bond++;
+            }
+        }
+
+    return snap;
+    }
+
+#endif
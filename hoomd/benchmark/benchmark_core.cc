@@ -0,0 +1,56 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file benchmark_core.cc
+    \brief Benchmarks of the cell list and particle sorter
+    \ingroup benchmarks
+*/
+
+#include "BenchmarkSuite.h"
+#include "BenchmarkSystems.h"
+
+#include "hoomd/CellList.h"
+#include "hoomd/SFCPackUpdater.h"
+#include "hoomd/SystemDefinition.h"
+
+using namespace std;
+
+//! Benchmark CellList::compute with the cell width of an LJ neighbor list
+void benchmark_cell_list(BenchmarkSuite& suite)
+    {
+    if (!suite.isSelected("lj_liquid", "CellList::compute"))
+        return;
+
+    unsigned int N = suite.scaled(64000);
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(make_lj_liquid_snapshot(N), suite.getExecConf()));
+
+    std::shared_ptr<CellList> cl(new CellList(sysdef));
+
+    cl->setNominalWidth(Scalar(2.8));
+    suite.run("lj_liquid", "CellList::compute", N, [&](unsigned int timestep) { cl->compute(timestep); });
+    }
+
+//! Benchmark SFCPackUpdater::update
+void benchmark_sfc_pack(BenchmarkSuite& suite)
+    {
+    if (!suite.isSelected("lj_liquid", "SFCPackUpdater::update"))
+        return;
+
+    unsigned int N = suite.scaled(64000);
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(make_lj_liquid_snapshot(N), suite.getExecConf()));
+
+    std::shared_ptr<SFCPackUpdater> sorter(new SFCPackUpdater(sysdef));
+
+    suite.run("lj_liquid", "SFCPackUpdater::update", N, [&](unsigned int timestep) { sorter->update(timestep); });
+    }
+
+int main(int argc, char **argv)
+    {
+    BenchmarkSuite suite(argc, argv, "core");
+
+    benchmark_cell_list(suite);
+    benchmark_sfc_pack(suite);
+
+    return suite.finish();
+    }
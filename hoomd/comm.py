@@ -82,6 +82,263 @@ def barrier():
     if _hoomd.is_MPI_available():
         hoomd.context.mpi_conf.barrier()
 
+def overlap_ghosts(enable=True):
+    """ Overlap the ghost particle update with the computation of forces.
+
+    Args:
+        enable (bool): Set to True to overlap communication and computation
+
+    In MPI simulations, the positions of ghost particles are updated on every time step that does not migrate
+    particles. With *enable* set to True, the update is started before the forces are computed, and the forces on
+    particles that have no ghost neighbors are computed while the messages are in flight. The remaining forces are
+    computed when the update has completed. This hides part of the communication latency when the domains are large
+    compared to the ghost layer.
+
+    Pair forces (except DPD) and bond forces are split, other forces are computed after the update completes.
+    Forces are summed in a different order, so results are not bitwise identical to runs without overlap.
+
+    Examples::
+
+        comm.overlap_ghosts()
+        comm.overlap_ghosts(enable=False)
+
+    Note:
+        Only supported on the CPU. Does nothing in non-MPI builds or on a single rank.
+
+    Warning:
+        This command must be invoked *after* the system is initialized.
+    """
+    hoomd.util.print_status_line();
+
+    if not hoomd.init.is_initialized():
+        hoomd.context.msg.error("comm.overlap_ghosts: cannot enable overlap before the system is initialized\n");
+        raise RuntimeError("Error enabling ghost overlap");
+
+    if not _hoomd.is_MPI_available():
+        return;
+
+    cpp_comm = hoomd.context.current.system.getCommunicator();
+    if cpp_comm is None:
+        hoomd.context.msg.notice(2, "comm.overlap_ghosts: no communicator, ignoring\n");
+        return;
+
+    cpp_comm.setGhostOverlap(enable);
+
+def persistent_requests(enable=True):
+    """ Reuse the MPI requests of the ghost particle update.
+
+    Args:
+        enable (bool): Set to True to use persistent requests
+
+    Between neighbor list builds, the ghost particles are sent to the same neighbors every time step. With *enable*
+    set to True, the sends and receives of the ghost update are set up once with persistent MPI requests after every
+    exchange of ghost particles, and only started on the following time steps. This reduces the overhead per message in
+    latency-bound simulations with few particles per rank.
+
+    Examples::
+
+        comm.persistent_requests()
+        comm.persistent_requests(enable=False)
+
+    Note:
+        Only supported on the CPU. Does nothing in non-MPI builds or on a single rank.
+
+    Warning:
+        This command must be invoked *after* the system is initialized.
+    """
+    hoomd.util.print_status_line();
+
+    if not hoomd.init.is_initialized():
+        hoomd.context.msg.error("comm.persistent_requests: cannot enable persistent requests before the system is initialized\n");
+        raise RuntimeError("Error enabling persistent requests");
+
+    if not _hoomd.is_MPI_available():
+        return;
+
+    cpp_comm = hoomd.context.current.system.getCommunicator();
+    if cpp_comm is None:
+        hoomd.context.msg.notice(2, "comm.persistent_requests: no communicator, ignoring\n");
+        return;
+
+    cpp_comm.setPersistentRequests(enable);
+
+def shared_memory_ghosts(enable=True):
+    """ Exchange ghost particles with ranks on the same node through shared memory.
+
+    Args:
+        enable (bool): Set to True to use shared memory
+
+    With *enable* set to True, every rank places the send buffers of the ghost particle update in a shared memory window
+    of its node. Neighbors on the same node copy the ghost positions directly from this window after the sender signals
+    that they are ready, which avoids the copies and message matching of the MPI library. Ghosts sent to other nodes
+    still use messages. This reduces the cost of the ghost update when many neighboring domains share a node, see
+    :py:func:`get_ghost_traffic()`.
+
+    The shared memory window grows with the number of ghost particles, it is reallocated when the ghost particles are
+    exchanged.
+
+    Examples::
+
+        comm.shared_memory_ghosts()
+        comm.shared_memory_ghosts(enable=False)
+
+    Note:
+        Only supported on the CPU. Requires an MPI library that supports MPI-3 shared memory windows. Does nothing in
+        non-MPI builds or on a single rank.
+
+    Warning:
+        This command must be invoked *after* the system is initialized, and on all ranks.
+    """
+    hoomd.util.print_status_line();
+
+    if not hoomd.init.is_initialized():
+        hoomd.context.msg.error("comm.shared_memory_ghosts: cannot enable shared memory before the system is initialized\n");
+        raise RuntimeError("Error enabling shared memory ghosts");
+
+    if not _hoomd.is_MPI_available():
+        return;
+
+    cpp_comm = hoomd.context.current.system.getCommunicator();
+    if cpp_comm is None:
+        hoomd.context.msg.notice(2, "comm.shared_memory_ghosts: no communicator, ignoring\n");
+        return;
+
+    cpp_comm.setSharedMemoryGhosts(enable);
+
+def compress_ghosts(enable=True, tolerance=1e-6):
+    """ Send the ghost particle updates in reduced precision.
+
+    Args:
+        enable (bool): Set to True to compress the ghost updates
+        tolerance (float): Maximum allowed error of the ghost positions (in distance units)
+
+    With *enable* set to True, the positions of ghost particles are sent as 32 bit fixed point fractions of the global
+    box and their velocities in single precision, instead of four double precision values each. The particle types and
+    masses do not change between ghost exchanges and are not sent. This reduces the size of the ghost updates by more
+    than half in double precision builds. Owned particles and forces are unaffected, only the ghost copies seen by the
+    neighboring ranks are rounded.
+
+    The rounding error of the positions grows with the box size. HOOMD raises an error when it exceeds *tolerance*,
+    both when this command is called and when the box changes. Ghosts exchanged through shared memory
+    (:py:func:`shared_memory_ghosts()`) and orientations are always sent in full precision.
+
+    Examples::
+
+        comm.compress_ghosts()
+        comm.compress_ghosts(tolerance=1e-5)
+        comm.compress_ghosts(enable=False)
+
+    Note:
+        Only supported on the CPU. Does nothing in non-MPI builds or on a single rank.
+
+    Warning:
+        This command must be invoked *after* the system is initialized, and on all ranks.
+    """
+    hoomd.util.print_status_line();
+
+    if not hoomd.init.is_initialized():
+        hoomd.context.msg.error("comm.compress_ghosts: cannot enable compression before the system is initialized\n");
+        raise RuntimeError("Error enabling ghost compression");
+
+    if not _hoomd.is_MPI_available():
+        return;
+
+    cpp_comm = hoomd.context.current.system.getCommunicator();
+    if cpp_comm is None:
+        hoomd.context.msg.notice(2, "comm.compress_ghosts: no communicator, ignoring\n");
+        return;
+
+    cpp_comm.setGhostCompression(enable, float(tolerance));
+
+def ghost_skin(skin):
+    """ Widen the ghost layer to exchange ghost particles less often.
+
+    Args:
+        skin (float): Width added to the ghost layer of every particle type (in distance units)
+
+    By default, particles are migrated between the domains and the ghost particles are selected again every time a
+    neighbor list is rebuilt. With a nonzero *skin*, the ghost layer is wider than the neighbor lists require. HOOMD
+    then tracks the largest displacement of any particle since the last ghost exchange and keeps the current ghosts
+    for a neighbor list rebuild as long as it is smaller than half of the *skin*, updating only their positions. A
+    larger skin sends more ghost particles on every step, but fewer full exchanges. Set *skin* to 0 to exchange
+    ghosts on every neighbor list rebuild.
+
+    The ghost layer widths are set per particle type from the cutoffs of the neighbor lists (see
+    :py:meth:`hoomd.md.nlist.nlist.set_params()`), the skin is added to every type that is communicated.
+
+    Examples::
+
+        comm.ghost_skin(0.4)
+        comm.ghost_skin(0)
+
+    Note:
+        Only supported on the CPU. Does nothing in non-MPI builds or on a single rank.
+
+    Warning:
+        This command must be invoked *after* the system is initialized, and on all ranks.
+    """
+    hoomd.util.print_status_line();
+
+    if not hoomd.init.is_initialized():
+        hoomd.context.msg.error("comm.ghost_skin: cannot set the ghost skin before the system is initialized\n");
+        raise RuntimeError("Error setting ghost skin");
+
+    if not _hoomd.is_MPI_available():
+        return;
+
+    cpp_comm = hoomd.context.current.system.getCommunicator();
+    if cpp_comm is None:
+        hoomd.context.msg.notice(2, "comm.ghost_skin: no communicator, ignoring\n");
+        return;
+
+    cpp_comm.setGhostSkin(float(skin));
+
+def get_ghost_traffic(reset=False):
+    """ Get the volume of the ghost particle updates by the topological distance of the ranks.
+
+    Args:
+        reset (bool): Set to True to reset the counters after reading them
+
+    Returns:
+        A dict with the bytes sent by all ranks to neighbors in the same NUMA domain (``'numa'``), the same socket
+        (``'socket'``), the same node (``'node'``), and on other nodes (``'network'``).
+
+    With the default decomposition, neighboring domains are placed on ranks that share a node, and, when the ranks are
+    bound to cores, a socket and NUMA domain. Use this command to check how much of the ghost traffic stays in shared
+    memory. Ranks that are not bound count as sharing a node, but not a socket.
+
+    Examples::
+
+        run(1000)
+        traffic = comm.get_ghost_traffic()
+        print(traffic['network'] / sum(traffic.values()))
+
+    Note:
+        This is a collective call and must be executed on all ranks. Only the ghost updates between neighbor list builds
+        on the CPU are counted. Returns all zeros in non-MPI builds or on a single rank.
+    """
+    keys = ['numa', 'socket', 'node', 'network']
+    traffic = dict((k, 0.0) for k in keys)
+
+    if not hoomd.init.is_initialized():
+        hoomd.context.msg.error("comm.get_ghost_traffic: cannot get the ghost traffic before the system is initialized\n");
+        raise RuntimeError("Error getting ghost traffic");
+
+    if not _hoomd.is_MPI_available():
+        return traffic;
+
+    cpp_comm = hoomd.context.current.system.getCommunicator();
+    if cpp_comm is None:
+        return traffic;
+
+    for k, v in zip(keys, cpp_comm.getGhostTraffic()):
+        traffic[k] = v;
+
+    if reset:
+        cpp_comm.resetGhostTraffic();
+
+    return traffic;
+
 class decomposition(object):
     """ Set the domain decomposition.
 
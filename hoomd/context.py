@@ -380,7 +380,9 @@ def _create_exec_conf(mpi_config, msg, options):
 
     if _hoomd.is_TBB_available():
         # set the number of TBB threads as necessary
-        if options.nthreads != None:
+        if options.nthreads == 'auto':
+            exec_conf.setNumThreads(exec_conf.getNumThreadsPerRank())
+        elif options.nthreads != None:
             exec_conf.setNumThreads(options.nthreads)
 
     exec_conf = exec_conf;
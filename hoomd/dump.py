@@ -504,6 +504,15 @@ class gsd(hoomd.analyze._analyzer):
         time_step (int): Time step to write to the file (only used when period is None)
         dynamic (list): A list of quantity categories to save every frame. (added in version 2.2)
         static (list): A list of quantity categories save only in frame 0 (may not be set in conjunction with *dynamic*, deprecated in version 2.2).
+        async_write (bool): When True, write frames from a background thread. (added in version 2.10)
+        drop_frames (bool): When True and *async_write* is set, skip frames while the background thread is still
+                            writing previous frames instead of waiting for it. (added in version 2.10)
+        distributed (bool): When True, every MPI rank writes the per-particle data of its own particles directly to the
+                            file. Has no effect in serial simulations. (added in version 2.10)
+        compression (str): Store positions, orientations and velocities compressed, either ``'lossless'`` or
+                           ``'lossy'``. When None (the default), store them as plain arrays. (added in version 2.10)
+        tolerance (float): Rounding step of the ``'lossy'`` compression, in the units of the stored quantity.
+                           (added in version 2.10)
 
     Write a simulation snapshot to the specified GSD file at regular intervals. GSD is capable of storing all particle
     and bond data fields in hoomd, in every frame of the trajectory. This allows GSD to store simulations where the
@@ -560,6 +569,36 @@ class gsd(hoomd.analyze._analyzer):
     To write restart files with gsd, set `truncate=True`. This will cause :py:class:`gsd` to write a new frame 0
     to the file every period steps.
 
+    .. rubric:: Asynchronous output
+
+    With ``async_write=True``, :py:class:`gsd` copies each frame into a staging buffer and returns to the simulation
+    while a background thread writes the buffer to the file. Up to two frames are staged at a time. When both are
+    still being written, the next frame waits for the background thread, or is skipped with ``drop_frames=True``.
+    All staged frames are written to the file at the end of every :py:func:`hoomd.run()`, and when :py:meth:`flush`
+    is called.
+
+    .. rubric:: Distributed output
+
+    By default, :py:class:`gsd` gathers the particle data on the root rank in MPI simulations and writes it from
+    there. With ``distributed=True``, each rank writes the per-particle fields of its local particles directly to
+    their place in the file with collective MPI-IO, so neither the memory use nor the communication of the root rank
+    grows with the number of particles. The frame header, topology, and log data are still written by the root rank.
+    The file must reside on a file system that all ranks can write to, and ``distributed=True`` cannot be combined
+    with ``async_write=True``.
+
+    .. rubric:: Compressed output
+
+    With ``compression='lossless'``, :py:class:`gsd` stores ``particles/position``, ``particles/orientation``, and
+    ``particles/velocity`` with their bytes regrouped and compressed with deflate. This requires HOOMD to be built with
+    zlib. With ``compression='lossy'``, the values are rounded to the nearest multiple of *tolerance* (so the error of
+    every value is at most ``tolerance/2``) and are stored as differences to the previous frame, with the full values
+    stored every 100 frames. Both modes typically reduce the size of these fields several fold.
+
+    Compressed fields are stored in the chunks ``compressed/particles/position``, etc.
+    :py:func:`hoomd.init.read_gsd()` and :py:func:`hoomd.data.gsd_snapshot()` decode them transparently. Other tools
+    that read GSD files do not know this encoding and will not find the compressed fields. Compression cannot be
+    combined with ``distributed=True``.
+
     .. rubric:: State data
 
     :py:class:`gsd` can save internal state data for the following hoomd objects:
@@ -584,6 +623,9 @@ class gsd(hoomd.analyze._analyzer):
         dump.gsd(filename="configuration.gsd", overwrite=True, period=None, group=group.all(), time_step=0)
         dump.gsd(filename="momentum_too.gsd", period=1000, group=group.all(), phase=0, dynamic=['momentum'])
         dump.gsd(filename="saveall.gsd", overwrite=True, period=1000, group=group.all(), dynamic=['attribute', 'momentum', 'topology'])
+        dump.gsd(filename="trajectory.gsd", period=1000, group=group.all(), async_write=True)
+        dump.gsd(filename="trajectory.gsd", period=1000, group=group.all(), distributed=True)
+        dump.gsd(filename="trajectory.gsd", period=1000, group=group.all(), compression='lossy', tolerance=1e-4)
 
     """
     def __init__(self,
@@ -595,12 +637,26 @@ class gsd(hoomd.analyze._analyzer):
                  phase=0,
                  time_step=None,
                  static=None,
-                 dynamic=None):
+                 dynamic=None,
+                 async_write=False,
+                 drop_frames=False,
+                 distributed=False,
+                 compression=None,
+                 tolerance=1e-3):
         hoomd.util.print_status_line();
 
         if static is not None and dynamic is not None:
             raise ValueError("Cannot specify both static and dynamic arguments");
 
+        if async_write and distributed:
+            raise ValueError("Cannot specify both async_write and distributed");
+
+        if compression not in (None, 'lossless', 'lossy'):
+            raise ValueError("compression must be None, 'lossless', or 'lossy'");
+
+        if compression is not None and distributed:
+            raise ValueError("Cannot specify both compression and distributed");
+
         categories = ['attribute', 'property', 'momentum', 'topology'];
         dynamic_quantities = ['property']
 
@@ -635,6 +691,12 @@ class gsd(hoomd.analyze._analyzer):
         self.cpp_analyzer.setWriteProperty('property' in dynamic_quantities);
         self.cpp_analyzer.setWriteMomentum('momentum' in dynamic_quantities);
         self.cpp_analyzer.setWriteTopology('topology' in dynamic_quantities);
+        self.cpp_analyzer.setAsync(async_write);
+        self.cpp_analyzer.setDropFrames(drop_frames);
+        if distributed and _hoomd.is_MPI_available():
+            self.cpp_analyzer.setDistributed(True);
+        if compression is not None:
+            self.cpp_analyzer.setCompression(compression, tolerance);
 
         if period is not None:
             self.setupAnalyzer(period, phase);
@@ -642,6 +704,7 @@ class gsd(hoomd.analyze._analyzer):
             if time_step is None:
                 time_step = hoomd.context.current.system.getCurrentTimeStep()
             self.cpp_analyzer.analyze(time_step);
+            self.cpp_analyzer.flush();
             hoomd.context.current.analyzers.remove(self)
 
         # store metadata
@@ -661,6 +724,16 @@ class gsd(hoomd.analyze._analyzer):
 
         time_step = hoomd.context.current.system.getCurrentTimeStep()
         self.cpp_analyzer.analyze(time_step);
+        self.cpp_analyzer.flush();
+
+    def flush(self):
+        """ Write all staged frames to the file.
+
+        Only needed with ``async_write=True``, when the file is read before the end of the current run.
+
+        .. versionadded:: 2.10
+        """
+        self.cpp_analyzer.flush();
 
     def dump_state(self, obj):
         """Write state information for a hoomd object.
@@ -21,7 +21,7 @@ IntegratorHPMC::IntegratorHPMC(std::shared_ptr<SystemDefinition> sysdef,
                                unsigned int seed)
     : Integrator(sysdef, 0.005), m_seed(seed),  m_move_ratio(32768), m_nselect(4),
       m_nominal_width(1.0), m_extra_ghost_width(0), m_external_base(NULL), m_patch_log(false),
-      m_past_first_run(false)
+      m_past_first_run(false), m_decorrelation_ref_time(0.0)
       #ifdef ENABLE_MPI
       ,m_communicator_ghost_width_connected(false),
       m_communicator_flags_connected(false)
@@ -119,6 +119,7 @@ std::vector< std::string > IntegratorHPMC::getProvidedLogQuantities()
     result.push_back("hpmc_a");
     result.push_back("hpmc_move_ratio");
     result.push_back("hpmc_overlap_count");
+    result.push_back("hpmc_decorrelation_rate");
     for (unsigned int typ=0; typ<m_pdata->getNTypes();typ++)
       {
       ostringstream tmp_str0;
@@ -171,6 +172,10 @@ Scalar IntegratorHPMC::getLogValue(const std::string& quantity, unsigned int tim
         {
         return countOverlaps(timestep, false);
         }
+    else if (quantity == "hpmc_decorrelation_rate")
+        {
+        return computeDecorrelationRate();
+        }
     else
         {
         //loop over per particle move size quantities
@@ -228,6 +233,81 @@ bool IntegratorHPMC::checkParticleOrientations()
     return result;
     }
 
+/*! \returns Mean square displacement in units of the maximum core diameter squared, per CPU hour
+
+    The first call stores the unwrapped positions of all particles by tag and the CPU time spent in trial moves so far,
+    and returns 0. Later calls measure the displacement and the CPU time relative to this reference. The CPU time is
+    the compute time of the integrator, summed over all ranks and threads, so that serial, multithreaded, and MPI runs
+    of different integrators can be compared by the cost of decorrelating the system.
+
+    The reference is taken again when the number of particles changes.
+*/
+Scalar IntegratorHPMC::computeDecorrelationRate()
+    {
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+    Scalar3 origin = m_pdata->getOrigin();
+    int3 origin_image = m_pdata->getOriginImage();
+    unsigned int n_tags = m_pdata->getMaximumTag() + 1;
+
+    double cpu_time = m_sysdef->getIntegratorData()->getComputeTime() * m_exec_conf->getNumThreads();
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        MPI_Allreduce(MPI_IN_PLACE, &cpu_time, 1, MPI_DOUBLE, MPI_SUM, m_exec_conf->getMPICommunicator());
+    #endif
+
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+    if (m_decorrelation_ref_pos.size() != n_tags)
+        {
+        // every rank fills in its own particles, the others are zero
+        std::vector< vec3<Scalar> > ref_pos(n_tags, vec3<Scalar>(0,0,0));
+        for (unsigned int i = 0; i < m_pdata->getN(); i++)
+            {
+            int3 image = make_int3(h_image.data[i].x - origin_image.x,
+                                   h_image.data[i].y - origin_image.y,
+                                   h_image.data[i].z - origin_image.z);
+            Scalar3 pos = make_scalar3(h_postype.data[i].x, h_postype.data[i].y, h_postype.data[i].z) - origin;
+            ref_pos[h_tag.data[i]] = vec3<Scalar>(global_box.shift(pos, image));
+            }
+
+        #ifdef ENABLE_MPI
+        if (m_pdata->getDomainDecomposition())
+            MPI_Allreduce(MPI_IN_PLACE, &ref_pos[0], 3*n_tags, MPI_HOOMD_SCALAR, MPI_SUM,
+                m_exec_conf->getMPICommunicator());
+        #endif
+
+        m_decorrelation_ref_pos.swap(ref_pos);
+        m_decorrelation_ref_time = cpu_time;
+        return Scalar(0.0);
+        }
+
+    double msd = 0.0;
+    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+        {
+        int3 image = make_int3(h_image.data[i].x - origin_image.x,
+                               h_image.data[i].y - origin_image.y,
+                               h_image.data[i].z - origin_image.z);
+        Scalar3 pos = make_scalar3(h_postype.data[i].x, h_postype.data[i].y, h_postype.data[i].z) - origin;
+        vec3<Scalar> dr = vec3<Scalar>(global_box.shift(pos, image)) - m_decorrelation_ref_pos[h_tag.data[i]];
+        msd += dot(dr, dr);
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        MPI_Allreduce(MPI_IN_PLACE, &msd, 1, MPI_DOUBLE, MPI_SUM, m_exec_conf->getMPICommunicator());
+    #endif
+    msd /= double(m_pdata->getNGlobal());
+
+    double cpu_hours = (cpu_time - m_decorrelation_ref_time) / 3600.0;
+    Scalar diameter = getMaxCoreDiameter();
+    if (cpu_hours <= 0.0 || diameter <= Scalar(0.0))
+        return Scalar(0.0);
+
+    return msd / (diameter*diameter) / cpu_hours;
+    }
+
 /*! Set new box with particle positions scaled from previous box
     and check for overlaps
 
@@ -330,6 +410,9 @@ void export_IntegratorHPMC(py::module& m)
     .def("communicate", &IntegratorHPMC::communicate)
     .def("slotNumTypesChange", &IntegratorHPMC::slotNumTypesChange)
     .def("setDeterministic", &IntegratorHPMC::setDeterministic)
+    .def("setCheckerboard", &IntegratorHPMC::setCheckerboard)
+    .def("setIncrementalAABBTree", &IntegratorHPMC::setIncrementalAABBTree)
+    .def("setSeparatingAxisCache", &IntegratorHPMC::setSeparatingAxisCache)
     .def("disablePatchEnergyLogOnly", &IntegratorHPMC::disablePatchEnergyLogOnly)
     ;
 
@@ -263,6 +263,9 @@ class PYBIND11_EXPORT IntegratorHPMC : public Integrator
         //! Check the particle data for non-normalized orientations
         virtual bool checkParticleOrientations();
 
+        //! Compute the mean square displacement per CPU hour since the first call
+        Scalar computeDecorrelationRate();
+
         //! Get the current counter values
         hpmc_counters_t getCounters(unsigned int mode=0);
 
@@ -322,6 +325,15 @@ class PYBIND11_EXPORT IntegratorHPMC : public Integrator
         //! Enable deterministic simulations
         virtual void setDeterministic(bool deterministic) {};
 
+        //! Enable the checkerboard sweep on the CPU
+        virtual void setCheckerboard(bool checkerboard) {};
+
+        //! Keep the AABB tree between steps and refit it instead of rebuilding it
+        virtual void setIncrementalAABBTree(bool incremental) {};
+
+        //! Start the overlap tests from the separating axes of earlier tests
+        virtual void setSeparatingAxisCache(bool enable) {};
+
         //! Prepare for the run
         virtual void prepRun(unsigned int timestep)
             {
@@ -413,6 +425,9 @@ class PYBIND11_EXPORT IntegratorHPMC : public Integrator
         hpmc_counters_t m_count_run_start;             //!< Count saved at run() start
         hpmc_counters_t m_count_step_start;            //!< Count saved at the start of the last step
 
+        std::vector< vec3<Scalar> > m_decorrelation_ref_pos; //!< Unwrapped reference positions by tag
+        double m_decorrelation_ref_time;               //!< CPU time spent in trial moves at the reference (s)
+
         #ifdef ENABLE_MPI
         bool m_communicator_ghost_width_connected;     //!< True if we have connected to Communicator's ghost layer width signal
         bool m_communicator_flags_connected;           //!< True if we have connected to Communicator's communication flags signal
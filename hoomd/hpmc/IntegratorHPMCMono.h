@@ -18,12 +18,17 @@
 #include "IntegratorHPMC.h"
 #include "Moves.h"
 #include "hoomd/AABBTree.h"
+#include "SeparatingAxisCache.h"
 #include "GSDHPMCSchema.h"
 #include "hoomd/Index1D.h"
 #include "hoomd/RNGIdentifiers.h"
 #include "hoomd/managed_allocator.h"
 #include "hoomd/GSDShapeSpecWriter.h"
 
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
 #ifdef ENABLE_MPI
 #include "hoomd/Communicator.h"
 #include "hoomd/HOOMDMPI.h"
@@ -133,6 +138,7 @@ class IntegratorHPMCMono : public IntegratorHPMC
                 free(m_aabbs);
             m_pdata->getBoxChangeSignal().template disconnect<IntegratorHPMCMono<Shape>, &IntegratorHPMCMono<Shape>::slotBoxChanged>(this);
             m_pdata->getParticleSortSignal().template disconnect<IntegratorHPMCMono<Shape>, &IntegratorHPMCMono<Shape>::slotSorted>(this);
+            m_pdata->getGhostParticlesRemovedSignal().template disconnect<IntegratorHPMCMono<Shape>, &IntegratorHPMCMono<Shape>::slotGhostParticlesRemoved>(this);
             }
 
         virtual void printStats();
@@ -154,6 +160,47 @@ class IntegratorHPMCMono : public IntegratorHPMC
         //! Set elements of the interaction matrix
         virtual void setOverlapChecks(unsigned int typi, unsigned int typj, bool check_overlaps);
 
+        //! Enable or disable the checkerboard sweep
+        /*! The local domain is divided into cells at least m_nominal_width wide, with an even number of cells in
+            every direction. Cells of the same color in a checkerboard pattern do not share any interacting
+            particles, as long as particles stay in their cells. The sweep moves the cells of one color concurrently,
+            and rejects moves that leave the cell. The grid is shifted randomly on every step.
+
+            The sweep falls back to the serial order when running on a single thread, when the box is too small for
+            two cells in every direction, or when an external field is set.
+        */
+        virtual void setCheckerboard(bool checkerboard)
+            {
+            m_checkerboard = checkerboard;
+            }
+
+        //! Enable or disable the incremental maintenance of the AABB tree
+        /*! In incremental mode, the tree is kept between steps. When particles have moved, it is refit to their new
+            AABBs in O(N), and only rebuilt when the particle indices change, or when the leaf nodes have grown by more
+            than m_aabb_tree_max_growth since the last build.
+        */
+        virtual void setIncrementalAABBTree(bool incremental)
+            {
+            m_aabb_tree_incremental = incremental;
+            }
+
+        //! Enable or disable the cache of separating axes between pairs of particles
+        /*! With the cache, the overlap test of a pair starts from the separating axis that proved the pair disjoint in
+            an earlier test, and only runs the full test when that axis no longer separates the shapes. The cache is
+            not used when the sweep runs in multiple threads.
+        */
+        virtual void setSeparatingAxisCache(bool enable)
+            {
+            if (enable && !detail::SeparatingAxisTraits<Shape>::supported)
+                {
+                m_exec_conf->msg->error() << "integrate.mode_hpmc: The separating axis cache is not supported for this shape" << std::endl;
+                throw std::runtime_error("Error setting up HPMC integrator");
+                }
+
+            m_sep_axis_cache_enabled = enable;
+            m_sep_axis_cache.clear();
+            }
+
         //! Set the external field for the integrator
         void setExternalField(std::shared_ptr< ExternalFieldMono<Shape> > external)
             {
@@ -368,11 +415,116 @@ class IntegratorHPMCMono : public IntegratorHPMC
         detail::AABB* m_aabbs;                      //!< list of AABBs, one per particle
         unsigned int m_aabbs_capacity;              //!< Capacity of m_aabbs list
         bool m_aabb_tree_invalid;                   //!< Flag if the aabb tree has been invalidated
+        bool m_aabb_tree_needs_build;               //!< Flag if the particle indices have changed since the last build
+        bool m_aabb_tree_incremental;               //!< True if the tree is refit instead of rebuilt when possible
+        Scalar m_aabb_tree_max_growth;              //!< Growth of the leaf nodes at which the tree is rebuilt
+        unsigned int m_aabb_tree_builds;            //!< Number of times the tree was built
+        unsigned int m_aabb_tree_refits;            //!< Number of times the tree was refit
+
+        detail::SeparatingAxisCache m_sep_axis_cache;   //!< Separating axes of the pairs tested in earlier sweeps
+        bool m_sep_axis_cache_enabled;                  //!< True if the overlap tests use the separating axis cache
+        unsigned long long int m_sep_axis_lookups;      //!< Number of overlap tests that found an axis in the cache
+        unsigned long long int m_sep_axis_reuses;       //!< Number of overlap tests resolved by the cached axis
 
         Scalar m_extra_image_width;                 //! Extra width to extend the image list
 
         Index2D m_overlap_idx;                      //!!< Indexer for interaction matrix
 
+        bool m_checkerboard;                        //!< True if the CPU sweep uses a checkerboard of cells
+        uint3 m_cb_dim;                             //!< Number of checkerboard cells in every direction
+        Scalar3 m_cb_offset;                        //!< Shift of the cell grid in the current step (in cells)
+        std::vector<unsigned int> m_cb_cell;        //!< Checkerboard cell of every local particle
+        std::vector<unsigned int> m_cb_color;       //!< Color of the cell of every local particle
+        std::vector<unsigned int> m_cb_cell_start;  //!< Index of the first particle of every cell in m_cb_cell_particles
+        std::vector<unsigned int> m_cb_cell_particles; //!< Local particles sorted by cell
+        std::vector<unsigned int> m_cb_color_cells; //!< Occupied cells sorted by color
+        unsigned int m_cb_color_start[9];           //!< Index of the first cell of every color in m_cb_color_cells
+        bool m_cb_warning_issued;                   //!< True if the small box warning has been issued
+
+        //! Set up the checkerboard cells for the current step
+        bool initCheckerboard(unsigned int timestep);
+
+        //! Get the checkerboard cell of a position in the local box
+        unsigned int getCheckerboardCell(const vec3<Scalar>& pos, const BoxDim& box) const
+            {
+            Scalar3 f = box.makeFraction(vec_to_scalar3(pos));
+            int cx = int(floor(f.x*Scalar(m_cb_dim.x) + m_cb_offset.x));
+            int cy = int(floor(f.y*Scalar(m_cb_dim.y) + m_cb_offset.y));
+            int cz = int(floor(f.z*Scalar(m_cb_dim.z) + m_cb_offset.z));
+
+            // cells wrap around the box, so that the shifted grid covers it
+            cx = ((cx % int(m_cb_dim.x)) + int(m_cb_dim.x)) % int(m_cb_dim.x);
+            cy = ((cy % int(m_cb_dim.y)) + int(m_cb_dim.y)) % int(m_cb_dim.y);
+            cz = ((cz % int(m_cb_dim.z)) + int(m_cb_dim.z)) % int(m_cb_dim.z);
+            return cx + m_cb_dim.x*(cy + m_cb_dim.y*cz);
+            }
+
+        //! Get the color of a checkerboard cell
+        unsigned int getCheckerboardColor(unsigned int cell) const
+            {
+            unsigned int cx = cell % m_cb_dim.x;
+            unsigned int cy = (cell / m_cb_dim.x) % m_cb_dim.y;
+            unsigned int cz = cell / (m_cb_dim.x*m_cb_dim.y);
+            return (cx & 1) + 2*(cy & 1) + 4*(cz & 1);
+            }
+
+        //! Test for overlap of a pair, starting from the separating axis in the cache
+        bool testOverlapCached(const vec3<Scalar>& r_ij, const Shape& shape_i, const Shape& shape_j,
+            unsigned int tag_i, unsigned int tag_j, unsigned int& err);
+
+        //! Test for overlap of a pair, starting from the cached separating axis if requested
+        bool testOverlapPair(const vec3<Scalar>& r_ij, const Shape& shape_i, const Shape& shape_j,
+            unsigned int tag_i, unsigned int tag_j, bool sep_axis_cache, unsigned int& err)
+            {
+            // the images of a particle share its tag and are not cached
+            if (sep_axis_cache && tag_i != tag_j)
+                return testOverlapCached(r_ij, shape_i, shape_j, tag_i, tag_j, err);
+            else
+                return test_overlap(r_ij, shape_i, shape_j, err);
+            }
+
+        //! Visit the particles in the AABB tree near every image of a particle
+        /*! \param pos_i Position of the particle
+            \param aabb_i_local AABB of the particle relative to pos_i
+            \param visit Called as visit(j, cur_image, pos_i_image) for every particle j in a leaf node that overlaps
+                   the AABB in the image, returns true to stop the search
+            \returns True if visit stopped the search
+        */
+        template<class Visitor>
+        bool visitImageNeighbors(const vec3<Scalar>& pos_i, const detail::AABB& aabb_i_local, const Visitor& visit)
+            {
+            const unsigned int n_images = m_image_list.size();
+            for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+                {
+                vec3<Scalar> pos_i_image = pos_i + m_image_list[cur_image];
+                detail::AABB aabb = aabb_i_local;
+                aabb.translate(pos_i_image);
+
+                // stackless search
+                for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
+                    {
+                    if (detail::overlap(m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                        {
+                        if (m_aabb_tree.isNodeLeaf(cur_node_idx))
+                            {
+                            for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                                {
+                                if (visit(m_aabb_tree.getNodeParticle(cur_node_idx, cur_p), cur_image, pos_i_image))
+                                    return true;
+                                }
+                            }
+                        }
+                    else
+                        {
+                        // skip ahead
+                        cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
+                        }
+                    }  // end loop over AABB nodes
+                } // end loop over images
+
+            return false;
+            }
+
         //! Set the nominal width appropriate for looped moves
         virtual void updateCellWidth();
 
@@ -396,6 +548,17 @@ class IntegratorHPMCMono : public IntegratorHPMC
         virtual void slotSorted()
             {
             m_aabb_tree_invalid = true;
+            m_aabb_tree_needs_build = true;
+
+            // particles have been sorted, migrated, added or removed
+            m_sep_axis_cache.clear();
+            }
+
+        //! callback so that removing the ghosts forces a rebuild of the AABB tree, which contains them
+        void slotGhostParticlesRemoved()
+            {
+            m_aabb_tree_invalid = true;
+            m_aabb_tree_needs_build = true;
             }
     };
 
@@ -407,7 +570,11 @@ IntegratorHPMCMono<Shape>::IntegratorHPMCMono(std::shared_ptr<SystemDefinition>
               m_image_list_is_initialized(false),
               m_image_list_valid(false),
               m_hasOrientation(true),
-              m_extra_image_width(0.0)
+              m_extra_image_width(0.0),
+              m_checkerboard(false),
+              m_cb_dim(make_uint3(0,0,0)),
+              m_cb_offset(make_scalar3(0,0,0)),
+              m_cb_warning_issued(false)
     {
     // allocate the parameter storage
     m_params = std::vector<param_type, managed_allocator<param_type> >(m_pdata->getNTypes(), param_type(), managed_allocator<param_type>(m_exec_conf->isCUDAEnabled()));
@@ -424,6 +591,7 @@ IntegratorHPMCMono<Shape>::IntegratorHPMCMono(std::shared_ptr<SystemDefinition>
     // Connect to the BoxChange signal
     m_pdata->getBoxChangeSignal().template connect<IntegratorHPMCMono<Shape>, &IntegratorHPMCMono<Shape>::slotBoxChanged>(this);
     m_pdata->getParticleSortSignal().template connect<IntegratorHPMCMono<Shape>, &IntegratorHPMCMono<Shape>::slotSorted>(this);
+    m_pdata->getGhostParticlesRemovedSignal().template connect<IntegratorHPMCMono<Shape>, &IntegratorHPMCMono<Shape>::slotGhostParticlesRemoved>(this);
 
     m_image_list_rebuilds = 0;
     m_image_list_warning_issued = false;
@@ -432,6 +600,15 @@ IntegratorHPMCMono<Shape>::IntegratorHPMCMono(std::shared_ptr<SystemDefinition>
     m_aabbs = NULL;
     m_aabbs_capacity = 0;
     m_aabb_tree_invalid = true;
+    m_aabb_tree_needs_build = true;
+    m_aabb_tree_incremental = false;
+    m_aabb_tree_max_growth = Scalar(1.5);
+    m_aabb_tree_builds = 0;
+    m_aabb_tree_refits = 0;
+
+    m_sep_axis_cache_enabled = false;
+    m_sep_axis_lookups = 0;
+    m_sep_axis_reuses = 0;
     }
 
 
@@ -502,12 +679,27 @@ void IntegratorHPMCMono<Shape>::printStats()
 
     m_exec_conf->msg->notice(2) << "Avg AABB tree height: " << total_height / Scalar(m_pdata->getN()) << std::endl;
     m_exec_conf->msg->notice(2) << "Max AABB tree height: " << max_height << std::endl;*/
+
+    if (m_aabb_tree_incremental)
+        {
+        m_exec_conf->msg->notice(2) << "AABB tree builds:                   " << m_aabb_tree_builds << std::endl;
+        m_exec_conf->msg->notice(2) << "AABB tree refits:                   " << m_aabb_tree_refits << std::endl;
+        }
+
+    if (m_sep_axis_cache_enabled && m_sep_axis_lookups > 0)
+        {
+        m_exec_conf->msg->notice(2) << "Separating axis cache reuse:        "
+                                    << Scalar(m_sep_axis_reuses) / Scalar(m_sep_axis_lookups) << std::endl;
+        }
     }
 
 template <class Shape>
 void IntegratorHPMCMono<Shape>::resetStats()
     {
     IntegratorHPMC::resetStats();
+
+    m_sep_axis_lookups = 0;
+    m_sep_axis_reuses = 0;
     }
 
 template <class Shape>
@@ -561,6 +753,9 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
     m_exec_conf->msg->notice(10) << "HPMCMono update: " << timestep << std::endl;
     IntegratorHPMC::update(timestep);
 
+    // time the trial moves for the load balancer
+    int64_t start = this->m_compute_clock.getTime();
+
     // get needed vars
     ArrayHandle<hpmc_counters_t> h_counters(m_count_total, access_location::host, access_mode::readwrite);
     hpmc_counters_t& counters = h_counters.data[0];
@@ -594,6 +789,18 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
     // access interaction matrix
     ArrayHandle<unsigned int> h_overlaps(m_overlaps, access_location::host, access_mode::read);
 
+    // sweep the particles in a checkerboard of independent cells, if enabled, possible in this box and there is more
+    // than one thread to sweep the cells concurrently
+    bool checkerboard = false;
+    #ifdef ENABLE_TBB
+    checkerboard = m_checkerboard && m_exec_conf->getNumThreads() > 1 && initCheckerboard(timestep);
+    #endif
+
+    // the separating axis cache is shared by all particles, so it is only used in a serial sweep
+    bool sep_axis_cache = m_sep_axis_cache_enabled && !checkerboard;
+    if (sep_axis_cache)
+        m_sep_axis_cache.reserve(m_pdata->getN() + m_pdata->getNGhosts());
+
     // loop over local particles nselect times
     for (unsigned int i_nselect = 0; i_nselect < m_nselect; i_nselect++)
         {
@@ -602,16 +809,21 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
         ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
         ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
         ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
 
         //access move sizes
         ArrayHandle<Scalar> h_d(m_d, access_location::host, access_mode::read);
         ArrayHandle<Scalar> h_a(m_a, access_location::host, access_mode::read);
 
-        // loop through N particles in a shuffled order
-        for (unsigned int cur_particle = 0; cur_particle < m_pdata->getN(); cur_particle++)
-            {
-            unsigned int i = m_update_order[cur_particle];
+        // color of the checkerboard cells that are currently moved
+        unsigned int active_color = 0;
 
+        // Make a trial move of particle i, and accept or reject it
+        // In a checkerboard sweep, the other particles in the cell of i are checked at their current positions, because
+        // the AABB tree is only updated after all cells of a color are done. Particles in the other cells of the active
+        // color are moved by other threads, they are too far away to interact with i.
+        auto trial_move = [&](unsigned int i, hpmc_counters_t& counters, std::vector<unsigned int>& moved)
+            {
             // read in the current position and orientation
             Scalar4 postype_i = h_postype.data[i];
             Scalar4 orientation_i = h_orientation.data[i];
@@ -622,7 +834,7 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                 {
                 // only move particle if active
                 if (!isActive(make_scalar3(postype_i.x, postype_i.y, postype_i.z), box, ghost_fraction))
-                    continue;
+                    return;
                 }
             #endif
 
@@ -643,7 +855,7 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                     {
                     if (!shape_i.ignoreStatistics())
                         counters.translate_accept_count++;
-                    continue;
+                    return;
                     }
 
                 move_translate(pos_i, rng_i, h_d.data[typ_i], ndim);
@@ -653,9 +865,17 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                     {
                     // check if particle has moved into the ghost layer, and skip if it is
                     if (!isActive(vec_to_scalar3(pos_i), box, ghost_fraction))
-                        continue;
+                        return;
                     }
                 #endif
+
+                // particles may not leave their checkerboard cell, reject the move if it does
+                if (checkerboard && getCheckerboardCell(pos_i, box) != m_cb_cell[i])
+                    {
+                    if (!shape_i.ignoreStatistics())
+                        counters.translate_reject_count++;
+                    return;
+                    }
                 }
             else
                 {
@@ -663,7 +883,7 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                     {
                     if (!shape_i.ignoreStatistics())
                         counters.rotate_accept_count++;
-                    continue;
+                    return;
                     }
 
                 move_rotate(shape_i.orientation, rng_i, h_a.data[typ_i], ndim);
@@ -686,174 +906,173 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
             // patch + field interaction deltaU
             double patch_field_energy_diff = 0;
 
-            // check for overlaps with neighboring particle's positions (also calculate the new energy)
-            // All image boxes (including the primary)
-            const unsigned int n_images = m_image_list.size();
-            for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+            // check particle j in the given image for overlaps with the trial configuration of i, and add its
+            // contribution to the patch energy of the trial configuration
+            auto check_new = [&](unsigned int j, unsigned int cur_image, const vec3<Scalar>& pos_i_image) -> bool
                 {
-                vec3<Scalar> pos_i_image = pos_i + m_image_list[cur_image];
-                detail::AABB aabb = aabb_i_local;
-                aabb.translate(pos_i_image);
+                Scalar4 postype_j;
+                Scalar4 orientation_j;
 
-                // stackless search
-                for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
+                // handle j==i situations
+                if ( j != i )
                     {
-                    if (detail::overlap(m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                    // load the position and orientation of the j particle
+                    postype_j = h_postype.data[j];
+                    orientation_j = h_orientation.data[j];
+                    }
+                else
+                    {
+                    if (cur_image == 0)
                         {
-                        if (m_aabb_tree.isNodeLeaf(cur_node_idx))
-                            {
-                            for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
-                                {
-                                // read in its position and orientation
-                                unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                        // in the first image, skip i == j
+                        return false;
+                        }
+                    else
+                        {
+                        // If this is particle i and we are in an outside image, use the translated position and orientation
+                        postype_j = make_scalar4(pos_i.x, pos_i.y, pos_i.z, postype_i.w);
+                        orientation_j = quat_to_scalar4(shape_i.orientation);
+                        }
+                    }
 
-                                Scalar4 postype_j;
-                                Scalar4 orientation_j;
+                // put particles in coordinate system of particle i
+                vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
 
-                                // handle j==i situations
-                                if ( j != i )
-                                    {
-                                    // load the position and orientation of the j particle
-                                    postype_j = h_postype.data[j];
-                                    orientation_j = h_orientation.data[j];
-                                    }
-                                else
-                                    {
-                                    if (cur_image == 0)
-                                        {
-                                        // in the first image, skip i == j
-                                        continue;
-                                        }
-                                    else
-                                        {
-                                        // If this is particle i and we are in an outside image, use the translated position and orientation
-                                        postype_j = make_scalar4(pos_i.x, pos_i.y, pos_i.z, postype_i.w);
-                                        orientation_j = quat_to_scalar4(shape_i.orientation);
-                                        }
-                                    }
+                unsigned int typ_j = __scalar_as_int(postype_j.w);
+                Shape shape_j(quat<Scalar>(orientation_j), m_params[typ_j]);
 
-                                // put particles in coordinate system of particle i
-                                vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+                Scalar rcut = 0.0;
+                if (m_patch)
+                    rcut = r_cut_patch + 0.5 * m_patch->getAdditiveCutoff(typ_j);
 
-                                unsigned int typ_j = __scalar_as_int(postype_j.w);
-                                Shape shape_j(quat<Scalar>(orientation_j), m_params[typ_j]);
+                counters.overlap_checks++;
+                if (h_overlaps.data[m_overlap_idx(typ_i, typ_j)]
+                    && check_circumsphere_overlap(r_ij, shape_i, shape_j)
+                    && testOverlapPair(r_ij, shape_i, shape_j, h_tag.data[i], h_tag.data[j], sep_axis_cache,
+                        counters.overlap_err_count))
+                    {
+                    return true;
+                    }
+                else if (m_patch && !m_patch_log && dot(r_ij,r_ij) <= rcut*rcut) // If there is no overlap and m_patch is not NULL, calculate energy
+                    {
+                    // deltaU = U_old - U_new: subtract energy of new configuration
+                    patch_field_energy_diff -= m_patch->energy(r_ij, typ_i,
+                                               quat<float>(shape_i.orientation),
+                                               h_diameter.data[i],
+                                               h_charge.data[i],
+                                               typ_j,
+                                               quat<float>(orientation_j),
+                                               h_diameter.data[j],
+                                               h_charge.data[j]
+                                               );
+                    }
+                return false;
+                };
 
-                                Scalar rcut = 0.0;
-                                if (m_patch)
-                                    rcut = r_cut_patch + 0.5 * m_patch->getAdditiveCutoff(typ_j);
+            // add the contribution of particle j in the given image to the patch energy of the old configuration of i
+            auto add_old_energy = [&](unsigned int j, unsigned int cur_image, const vec3<Scalar>& pos_i_image)
+                {
+                Scalar4 postype_j;
+                Scalar4 orientation_j;
 
-                                counters.overlap_checks++;
-                                if (h_overlaps.data[m_overlap_idx(typ_i, typ_j)]
-                                    && check_circumsphere_overlap(r_ij, shape_i, shape_j)
-                                    && test_overlap(r_ij, shape_i, shape_j, counters.overlap_err_count))
-                                    {
-                                    overlap = true;
-                                    break;
-                                    }
-                                else if (m_patch && !m_patch_log && dot(r_ij,r_ij) <= rcut*rcut) // If there is no overlap and m_patch is not NULL, calculate energy
-                                    {
-                                    // deltaU = U_old - U_new: subtract energy of new configuration
-                                    patch_field_energy_diff -= m_patch->energy(r_ij, typ_i,
-                                                               quat<float>(shape_i.orientation),
-                                                               h_diameter.data[i],
-                                                               h_charge.data[i],
-                                                               typ_j,
-                                                               quat<float>(orientation_j),
-                                                               h_diameter.data[j],
-                                                               h_charge.data[j]
-                                                               );
-                                    }
-                                }
-                            }
+                // handle j==i situations
+                if ( j != i )
+                    {
+                    // load the position and orientation of the j particle
+                    postype_j = h_postype.data[j];
+                    orientation_j = h_orientation.data[j];
+                    }
+                else
+                    {
+                    if (cur_image == 0)
+                        {
+                        // in the first image, skip i == j
+                        return;
                         }
                     else
                         {
-                        // skip ahead
-                        cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
+                        // If this is particle i and we are in an outside image, use the translated position and orientation
+                        postype_j = make_scalar4(pos_old.x, pos_old.y, pos_old.z, postype_i.w);
+                        orientation_j = quat_to_scalar4(shape_old.orientation);
                         }
+                    }
 
-                    if (overlap)
-                        break;
-                    }  // end loop over AABB nodes
+                // put particles in coordinate system of particle i
+                vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+                unsigned int typ_j = __scalar_as_int(postype_j.w);
+                Shape shape_j(quat<Scalar>(orientation_j), m_params[typ_j]);
+
+                Scalar rcut = r_cut_patch + 0.5 * m_patch->getAdditiveCutoff(typ_j);
+
+                // deltaU = U_old - U_new: add energy of old configuration
+                if (dot(r_ij,r_ij) <= rcut*rcut)
+                    patch_field_energy_diff += m_patch->energy(r_ij,
+                                               typ_i,
+                                               quat<float>(orientation_i),
+                                               h_diameter.data[i],
+                                               h_charge.data[i],
+                                               typ_j,
+                                               quat<float>(orientation_j),
+                                               h_diameter.data[j],
+                                               h_charge.data[j]);
+                };
+
+            // in a checkerboard sweep, the tree is not used for the particles of the active color
+            const unsigned int N = m_pdata->getN();
+            auto skip_in_tree = [&](unsigned int j) -> bool
+                {
+                return checkerboard && j < N && m_cb_color[j] == active_color;
+                };
 
-                if (overlap)
-                    break;
-                } // end loop over images
+            // check for overlaps with neighboring particle's positions (also calculate the new energy)
+            // All image boxes (including the primary)
+            overlap = visitImageNeighbors(pos_i, aabb_i_local,
+                [&](unsigned int j, unsigned int cur_image, const vec3<Scalar>& pos_i_image) -> bool
+                {
+                return !skip_in_tree(j) && check_new(j, cur_image, pos_i_image);
+                });
+
+            // check the particles in the same checkerboard cell
+            const unsigned int n_images = m_image_list.size();
+            if (checkerboard && !overlap)
+                {
+                unsigned int cell_i = m_cb_cell[i];
+                for (unsigned int cur_image = 0; cur_image < n_images && !overlap; cur_image++)
+                    {
+                    vec3<Scalar> pos_i_image = pos_i + m_image_list[cur_image];
+                    for (unsigned int k = m_cb_cell_start[cell_i]; k < m_cb_cell_start[cell_i+1]; k++)
+                        {
+                        if (check_new(m_cb_cell_particles[k], cur_image, pos_i_image))
+                            {
+                            overlap = true;
+                            break;
+                            }
+                        }
+                    }
+                }
 
             // calculate old patch energy only if m_patch not NULL and no overlaps
             if (m_patch && !m_patch_log && !overlap)
                 {
-                for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+                visitImageNeighbors(pos_old, aabb_i_local,
+                    [&](unsigned int j, unsigned int cur_image, const vec3<Scalar>& pos_i_image) -> bool
                     {
-                    vec3<Scalar> pos_i_image = pos_old + m_image_list[cur_image];
-                    detail::AABB aabb = aabb_i_local;
-                    aabb.translate(pos_i_image);
+                    if (!skip_in_tree(j))
+                        add_old_energy(j, cur_image, pos_i_image);
+                    return false;
+                    });
 
-                    // stackless search
-                    for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
+                // add the particles in the same checkerboard cell
+                if (checkerboard)
+                    {
+                    unsigned int cell_i = m_cb_cell[i];
+                    for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
                         {
-                        if (detail::overlap(m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
-                            {
-                            if (m_aabb_tree.isNodeLeaf(cur_node_idx))
-                                {
-                                for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
-                                    {
-                                    // read in its position and orientation
-                                    unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
-
-                                    Scalar4 postype_j;
-                                    Scalar4 orientation_j;
-
-                                    // handle j==i situations
-                                    if ( j != i )
-                                        {
-                                        // load the position and orientation of the j particle
-                                        postype_j = h_postype.data[j];
-                                        orientation_j = h_orientation.data[j];
-                                        }
-                                    else
-                                        {
-                                        if (cur_image == 0)
-                                            {
-                                            // in the first image, skip i == j
-                                            continue;
-                                            }
-                                        else
-                                            {
-                                            // If this is particle i and we are in an outside image, use the translated position and orientation
-                                            postype_j = make_scalar4(pos_old.x, pos_old.y, pos_old.z, postype_i.w);
-                                            orientation_j = quat_to_scalar4(shape_old.orientation);
-                                            }
-                                        }
-
-                                    // put particles in coordinate system of particle i
-                                    vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
-                                    unsigned int typ_j = __scalar_as_int(postype_j.w);
-                                    Shape shape_j(quat<Scalar>(orientation_j), m_params[typ_j]);
-
-                                    Scalar rcut = r_cut_patch + 0.5 * m_patch->getAdditiveCutoff(typ_j);
-
-                                    // deltaU = U_old - U_new: add energy of old configuration
-                                    if (dot(r_ij,r_ij) <= rcut*rcut)
-                                        patch_field_energy_diff += m_patch->energy(r_ij,
-                                                                   typ_i,
-                                                                   quat<float>(orientation_i),
-                                                                   h_diameter.data[i],
-                                                                   h_charge.data[i],
-                                                                   typ_j,
-                                                                   quat<float>(orientation_j),
-                                                                   h_diameter.data[j],
-                                                                   h_charge.data[j]);
-                                    }
-                                }
-                            }
-                        else
-                            {
-                            // skip ahead
-                            cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
-                            }
-                        }  // end loop over AABB nodes
-                    } // end loop over images
+                        vec3<Scalar> pos_i_image = pos_old + m_image_list[cur_image];
+                        for (unsigned int k = m_cb_cell_start[cell_i]; k < m_cb_cell_start[cell_i+1]; k++)
+                            add_old_energy(m_cb_cell_particles[k], cur_image, pos_i_image);
+                        }
+                    }
                 } // end if (m_patch)
 
             // Add external energetic contribution
@@ -878,7 +1097,16 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                 // update the position of the particle in the tree for future updates
                 detail::AABB aabb = aabb_i_local;
                 aabb.translate(pos_i);
-                m_aabb_tree.update(i, aabb);
+                if (checkerboard)
+                    {
+                    // the tree is shared by all threads, it is updated after the color is done
+                    m_aabbs[i] = aabb;
+                    moved.push_back(i);
+                    }
+                else
+                    {
+                    m_aabb_tree.update(i, aabb);
+                    }
 
                 // update position of particle
                 h_postype.data[i] = make_scalar4(pos_i.x,pos_i.y,pos_i.z,postype_i.w);
@@ -899,7 +1127,69 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                         counters.rotate_reject_count++;
                     }
                 }
-            } // end loop over all particles
+            };
+
+        #ifdef ENABLE_TBB
+        if (checkerboard)
+            {
+            // Sweep the cells of one color after the other, in random order. The cells of one color are independent,
+            // and are swept concurrently.
+            unsigned int n_colors = (ndim == 3) ? 8 : 4;
+            unsigned int colors[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+            hoomd::RandomGenerator rng_colors(hoomd::RNGIdentifier::HPMCMonoCheckerboardCell, m_seed, 0xffffffff, m_exec_conf->getRank()*m_nselect + i_nselect, timestep);
+            for (unsigned int k = n_colors-1; k > 0; k--)
+                std::swap(colors[k], colors[hoomd::UniformIntDistribution(k)(rng_colors)]);
+
+            for (unsigned int cur_color = 0; cur_color < n_colors; cur_color++)
+                {
+                active_color = colors[cur_color];
+                unsigned int first_cell = m_cb_color_start[active_color];
+                unsigned int last_cell = m_cb_color_start[active_color+1];
+
+                // sweep the particles of a cell in random order
+                auto sweep_cell = [&](unsigned int cell, hpmc_counters_t& cell_counters, std::vector<unsigned int>& moved)
+                    {
+                    unsigned int first = m_cb_cell_start[cell];
+                    unsigned int n = m_cb_cell_start[cell+1] - first;
+                    hoomd::RandomGenerator rng_cell(hoomd::RNGIdentifier::HPMCMonoCheckerboardCell, m_seed, cell, m_exec_conf->getRank()*m_nselect + i_nselect, timestep);
+                    for (unsigned int k = n; k > 1; k--)
+                        std::swap(m_cb_cell_particles[first+k-1], m_cb_cell_particles[first+hoomd::UniformIntDistribution(k-1)(rng_cell)]);
+
+                    for (unsigned int k = 0; k < n; k++)
+                        trial_move(m_cb_cell_particles[first+k], cell_counters, moved);
+                    };
+
+                tbb::enumerable_thread_specific<hpmc_counters_t> thread_counters;
+                tbb::enumerable_thread_specific< std::vector<unsigned int> > thread_moved;
+                tbb::parallel_for(tbb::blocked_range<unsigned int>(first_cell, last_cell),
+                    [&](const tbb::blocked_range<unsigned int>& r)
+                    {
+                    hpmc_counters_t& cell_counters = thread_counters.local();
+                    std::vector<unsigned int>& moved = thread_moved.local();
+                    for (unsigned int k = r.begin(); k != r.end(); ++k)
+                        sweep_cell(m_cb_color_cells[k], cell_counters, moved);
+                    });
+
+                for (auto it = thread_counters.begin(); it != thread_counters.end(); ++it)
+                    counters = counters + *it;
+
+                // update the AABB tree with the moved particles
+                for (auto it = thread_moved.begin(); it != thread_moved.end(); ++it)
+                    for (unsigned int k = 0; k < it->size(); k++)
+                        m_aabb_tree.update((*it)[k], m_aabbs[(*it)[k]]);
+                }
+            }
+        else
+        #endif
+            {
+            std::vector<unsigned int> moved;
+
+            // loop through N particles in a shuffled order
+            for (unsigned int cur_particle = 0; cur_particle < m_pdata->getN(); cur_particle++)
+                {
+                trial_move(m_update_order[cur_particle], counters, moved);
+                }
+            }
         } // end loop over nselect
 
         {
@@ -944,6 +1234,8 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
 
     if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
 
+    this->m_sysdef->getIntegratorData()->addComputeTime(double(this->m_compute_clock.getTime() - start)*1e-9);
+
     // migrate and exchange particles
     communicate(true);
 
@@ -1492,6 +1784,140 @@ void IntegratorHPMCMono<Shape>::updateCellWidth()
     m_aabb_tree_invalid = true;
     }
 
+/*! \param r_ij Position of particle j relative to particle i
+    \param shape_i Shape of particle i
+    \param shape_j Shape of particle j
+    \param tag_i Tag of particle i
+    \param tag_j Tag of particle j
+    \param err Error counter of the overlap test
+    \returns true if the particles overlap
+
+    When the pair is disjoint, the axis that separates it is stored in the cache for the next test.
+*/
+template <class Shape>
+bool IntegratorHPMCMono<Shape>::testOverlapCached(const vec3<Scalar>& r_ij, const Shape& shape_i, const Shape& shape_j,
+    unsigned int tag_i, unsigned int tag_j, unsigned int& err)
+    {
+    vec3<OverlapReal> axis = m_sep_axis_cache.find(tag_i, tag_j);
+    vec3<OverlapReal> axis_old = axis;
+    bool cached = dot(axis, axis) > OverlapReal(0.0);
+    if (cached)
+        m_sep_axis_lookups++;
+
+    bool overlap = test_overlap(r_ij, shape_i, shape_j, err, axis);
+
+    if (!overlap)
+        {
+        if (!(axis == axis_old))
+            m_sep_axis_cache.insert(tag_i, tag_j, axis);
+        else if (cached)
+            m_sep_axis_reuses++;
+        }
+
+    return overlap;
+    }
+
+/*! \param timestep Current time step
+    \returns True if the checkerboard sweep can be used in this step
+
+    The cells of one color are separated by at least one cell of another color, which is at least m_nominal_width
+    wide. The number of cells is limited to about twice the number of particles.
+*/
+template <class Shape>
+bool IntegratorHPMCMono<Shape>::initCheckerboard(unsigned int timestep)
+    {
+    // external fields are not required to be thread safe
+    if (m_external || m_nominal_width <= Scalar(0.0))
+        return false;
+
+    const BoxDim& box = m_pdata->getBox();
+    Scalar3 npd = box.getNearestPlaneDistance();
+    unsigned int ndim = this->m_sysdef->getNDimensions();
+    unsigned int N = m_pdata->getN();
+
+    // the largest even number of cells that are wider than the nominal width
+    Scalar3 dim = make_scalar3(Scalar(2.0)*floor(npd.x/(Scalar(2.0)*m_nominal_width)),
+                               Scalar(2.0)*floor(npd.y/(Scalar(2.0)*m_nominal_width)),
+                               (ndim == 3) ? Scalar(2.0)*floor(npd.z/(Scalar(2.0)*m_nominal_width)) : Scalar(1.0));
+
+    if (dim.x < Scalar(2.0) || dim.y < Scalar(2.0) || dim.z < Scalar(1.0) || (ndim == 3 && dim.z < Scalar(2.0)))
+        {
+        if (!m_cb_warning_issued)
+            {
+            m_exec_conf->msg->notice(2) << "HPMC: the local box is too small for a checkerboard sweep, "
+                                        << "moving particles in serial order" << std::endl;
+            m_cb_warning_issued = true;
+            }
+        return false;
+        }
+
+    // use larger cells in dilute systems
+    Scalar n_cells_max = Scalar(std::max(2*N, 8u));
+    if (dim.x*dim.y*dim.z > n_cells_max)
+        {
+        Scalar scale = (ndim == 3) ? cbrt(n_cells_max/(dim.x*dim.y*dim.z)) : sqrt(n_cells_max/(dim.x*dim.y));
+        dim.x = std::max(Scalar(2.0), Scalar(2.0)*floor(dim.x*scale/Scalar(2.0)));
+        dim.y = std::max(Scalar(2.0), Scalar(2.0)*floor(dim.y*scale/Scalar(2.0)));
+        if (ndim == 3)
+            dim.z = std::max(Scalar(2.0), Scalar(2.0)*floor(dim.z*scale/Scalar(2.0)));
+        }
+    m_cb_dim = make_uint3((unsigned int)dim.x, (unsigned int)dim.y, (unsigned int)dim.z);
+
+    // shift the grid randomly, so that particles can cross the cell boundaries between steps
+    hoomd::RandomGenerator rng(hoomd::RNGIdentifier::HPMCMonoCheckerboardShift, m_seed, timestep);
+    m_cb_offset.x = hoomd::detail::generate_canonical<Scalar>(rng);
+    m_cb_offset.y = hoomd::detail::generate_canonical<Scalar>(rng);
+    m_cb_offset.z = (ndim == 3) ? hoomd::detail::generate_canonical<Scalar>(rng) : Scalar(0.0);
+
+    // sort the local particles into the cells
+    unsigned int n_cells = m_cb_dim.x*m_cb_dim.y*m_cb_dim.z;
+    m_cb_cell.resize(N);
+    m_cb_color.resize(N);
+    m_cb_cell_particles.resize(N);
+    m_cb_cell_start.assign(n_cells+1, 0);
+
+        {
+        ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            unsigned int cell = getCheckerboardCell(vec3<Scalar>(h_postype.data[i]), box);
+            m_cb_cell[i] = cell;
+            m_cb_color[i] = getCheckerboardColor(cell);
+            m_cb_cell_start[cell+1]++;
+            }
+        }
+
+    for (unsigned int cell = 0; cell < n_cells; cell++)
+        m_cb_cell_start[cell+1] += m_cb_cell_start[cell];
+
+    std::vector<unsigned int> cell_size(n_cells, 0);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        unsigned int cell = m_cb_cell[i];
+        m_cb_cell_particles[m_cb_cell_start[cell] + cell_size[cell]++] = i;
+        }
+
+    // list the occupied cells by color
+    for (unsigned int color = 0; color < 9; color++)
+        m_cb_color_start[color] = 0;
+    for (unsigned int cell = 0; cell < n_cells; cell++)
+        if (cell_size[cell] > 0)
+            m_cb_color_start[getCheckerboardColor(cell)+1]++;
+    for (unsigned int color = 0; color < 8; color++)
+        m_cb_color_start[color+1] += m_cb_color_start[color];
+
+    m_cb_color_cells.resize(m_cb_color_start[8]);
+    unsigned int color_size[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    for (unsigned int cell = 0; cell < n_cells; cell++)
+        if (cell_size[cell] > 0)
+            {
+            unsigned int color = getCheckerboardColor(cell);
+            m_cb_color_cells[m_cb_color_start[color] + color_size[color]++] = cell;
+            }
+
+    return true;
+    }
+
 template <class Shape>
 void IntegratorHPMCMono<Shape>::growAABBList(unsigned int N)
     {
@@ -1520,6 +1946,10 @@ void IntegratorHPMCMono<Shape>::growAABBList(unsigned int N)
     this is on the next timestep. But in some cases (i.e. NPT), the tree may need to be rebuilt several times in a
     single step because of box volume moves.
 
+    In incremental mode, an invalid tree is refit to the current AABBs of the particles instead, as long as the particle
+    indices have not changed (m_aabb_tree_needs_build, set on sorts and ghost removal) and the tree quality stays
+    within m_aabb_tree_max_growth.
+
     Subclasses that override update() or other methods must be user to set m_aabb_tree_invalid appropriately, or
     erroneous simulations will result.
 
@@ -1557,7 +1987,16 @@ const detail::AABBTree& IntegratorHPMCMono<Shape>::buildAABBTree()
                         m_aabbs[i] = detail::AABB(vec3<Scalar>(h_postype.data[i]), radius);
                         }
                     }
-                m_aabb_tree.buildTree(m_aabbs, n_aabb);
+                if (m_aabb_tree_incremental && !m_aabb_tree_needs_build
+                    && m_aabb_tree.refit(m_aabbs, n_aabb, m_aabb_tree_max_growth))
+                    {
+                    m_aabb_tree_refits++;
+                    }
+                else
+                    {
+                    m_aabb_tree.buildTree(m_aabbs, n_aabb);
+                    m_aabb_tree_builds++;
+                    }
                 }
             }
 
@@ -1565,6 +2004,7 @@ const detail::AABBTree& IntegratorHPMCMono<Shape>::buildAABBTree()
         }
 
     m_aabb_tree_invalid = false;
+    m_aabb_tree_needs_build = false;
     return m_aabb_tree;
     }
 
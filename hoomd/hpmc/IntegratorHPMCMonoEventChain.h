@@ -0,0 +1,718 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __HPMC_MONO_EVENT_CHAIN__H__
+#define __HPMC_MONO_EVENT_CHAIN__H__
+
+#include "IntegratorHPMCMono.h"
+#include "ShapeSphere.h"
+#include "ShapeConvexPolyhedron.h"
+#include "XenoCollide3D.h"
+
+#include <climits>
+
+/*! \file IntegratorHPMCMonoEventChain.h
+    \brief Defines the template class for event-chain Monte Carlo of hard shapes
+    \note This header cannot be compiled by nvcc
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+namespace hpmc
+{
+
+namespace detail
+{
+
+//! Support function of a shape swept along a segment
+/*! The Minkowski sum of the shape and the segment from the origin to \a sweep. Both the support function of the shape
+    and \a sweep are in the local frame of the shape.
+
+    \ingroup minkowski
+*/
+template<class SupportFunc>
+class SupportFuncSwept
+    {
+    public:
+        //! Construct a support function for a swept shape
+        /*! \param sf Support function of the shape
+            \param sweep End point of the segment
+        */
+        DEVICE SupportFuncSwept(const SupportFunc& sf, const vec3<OverlapReal>& sweep)
+            : m_sf(sf), m_sweep(sweep)
+            {
+            }
+
+        //! Compute the support function
+        /*! \param n Normal vector input (in the local frame)
+            \returns Local coords of the point furthest in the direction of n
+        */
+        DEVICE vec3<OverlapReal> operator() (const vec3<OverlapReal>& n) const
+            {
+            vec3<OverlapReal> s = m_sf(n);
+            if (dot(n, m_sweep) > OverlapReal(0.0))
+                s += m_sweep;
+            return s;
+            }
+
+    private:
+        const SupportFunc& m_sf;        //!< Support function of the shape
+        vec3<OverlapReal> m_sweep;      //!< End point of the segment
+    };
+
+//! Distance between the circumspheres of two shapes along a direction
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
+    \param e Unit vector along which shape a moves
+    \param sigma Sum of the radii
+    \param s_max Maximum distance
+    \returns The distance that a sphere of radius sigma can move along e before it touches b, or s_max if it does not
+             touch b before
+*/
+DEVICE inline OverlapReal sphere_sweep_distance(const vec3<OverlapReal>& r_ab,
+                                                const vec3<OverlapReal>& e,
+                                                OverlapReal sigma,
+                                                OverlapReal s_max)
+    {
+    OverlapReal b_par = dot(r_ab, e);
+    OverlapReal d_perp_sq = dot(r_ab, r_ab) - b_par*b_par;
+
+    // b is behind a or is passed at a distance
+    if (b_par <= OverlapReal(0.0) || d_perp_sq >= sigma*sigma)
+        return s_max;
+
+    OverlapReal s = b_par - fast::sqrt(sigma*sigma - d_perp_sq);
+    if (s >= s_max)
+        return s_max;
+    return detail::max(s, OverlapReal(0.0));
+    }
+
+}; // end namespace detail
+
+//! Distance that shape a can move along a direction before it collides with shape b
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
+    \param e Unit vector along which shape a moves
+    \param a first shape
+    \param b second shape
+    \param s_max Maximum distance
+    \param err in/out variable incremented when error conditions occur in the overlap test
+    \returns The distance to the collision, or s_max when there is no collision before s_max
+
+    A distance smaller than s_max signals a collision. Shape a can move by the returned distance without overlapping b.
+    Shapes that support event-chain moves specialize this function.
+
+    \ingroup shape
+*/
+template<class Shape>
+inline OverlapReal sweep_distance(const vec3<Scalar>& r_ab,
+                                  const vec3<Scalar>& e,
+                                  const Shape& a,
+                                  const Shape& b,
+                                  OverlapReal s_max,
+                                  unsigned int& err);
+
+//! Sphere sweep distance
+/*! The distance is computed exactly. It is reduced by a small fraction of the diameters, so that round off never
+    leaves the spheres overlapping.
+
+    \ingroup shape
+*/
+template<>
+inline OverlapReal sweep_distance(const vec3<Scalar>& r_ab,
+                                  const vec3<Scalar>& e,
+                                  const ShapeSphere& a,
+                                  const ShapeSphere& b,
+                                  OverlapReal s_max,
+                                  unsigned int& err)
+    {
+    OverlapReal sigma = a.params.radius + b.params.radius;
+    OverlapReal s = detail::sphere_sweep_distance(vec3<OverlapReal>(r_ab), vec3<OverlapReal>(e), sigma, s_max);
+    if (s >= s_max)
+        return s_max;
+    return detail::max(s - sigma*OverlapReal(1e-5), OverlapReal(0.0));
+    }
+
+//! Convex polyhedron sweep distance
+/*! The overlap of shape a at distance s with shape b is tested with XenoCollide on the Minkowski sum of b with the
+    segment from 0 to -s*e. This sum contains all positions that b takes relative to a while a moves by s, so the test
+    is monotonic in s, and a collision found by bisection is never missed between the tested distances. The search
+    starts at the distance at which the circumspheres touch, and ends when the bracket is smaller than a small fraction
+    of the diameters. The lower end of the bracket, at which the shapes do not overlap, is returned.
+
+    \ingroup shape
+*/
+template<>
+inline OverlapReal sweep_distance(const vec3<Scalar>& r_ab,
+                                  const vec3<Scalar>& e,
+                                  const ShapeConvexPolyhedron& a,
+                                  const ShapeConvexPolyhedron& b,
+                                  OverlapReal s_max,
+                                  unsigned int& err)
+    {
+    vec3<OverlapReal> dr(r_ab);
+    vec3<OverlapReal> e_world(e);
+    OverlapReal DaDb = a.getCircumsphereDiameter() + b.getCircumsphereDiameter();
+
+    // the shapes cannot collide before their circumspheres do
+    OverlapReal s_lo = detail::sphere_sweep_distance(dr, e_world, DaDb/OverlapReal(2.0), s_max);
+    if (s_lo >= s_max)
+        return s_max;
+
+    quat<OverlapReal> q_a(a.orientation);
+    quat<OverlapReal> q_b(b.orientation);
+    vec3<OverlapReal> ab_t = rotate(conj(q_a), dr);
+    quat<OverlapReal> q_ab = conj(q_a) * q_b;
+    // direction of the motion of b relative to a, in the frame of b
+    vec3<OverlapReal> e_b = -rotate(conj(q_b), e_world);
+
+    detail::SupportFuncConvexPolyhedron sa(a.verts);
+    detail::SupportFuncConvexPolyhedron sb(b.verts);
+
+    // test if a overlaps b anywhere on its way from 0 to s
+    auto collides = [&](OverlapReal s) -> bool
+        {
+        return detail::xenocollide_3d(sa,
+                                      detail::SupportFuncSwept<detail::SupportFuncConvexPolyhedron>(sb, s*e_b),
+                                      ab_t,
+                                      q_ab,
+                                      DaDb/OverlapReal(2.0) + s,
+                                      err);
+        };
+
+    if (!collides(s_max))
+        return s_max;
+
+    OverlapReal s_hi = s_max;
+    const OverlapReal tol = DaDb*OverlapReal(1e-5);
+    for (unsigned int iter = 0; iter < 64 && s_hi - s_lo > tol; iter++)
+        {
+        OverlapReal s = OverlapReal(0.5)*(s_lo + s_hi);
+        if (collides(s))
+            s_hi = s;
+        else
+            s_lo = s;
+        }
+
+    return s_lo;
+    }
+
+//! Template class for event-chain Monte Carlo of hard shapes
+/*! Instead of single particle trial moves, the translation moves are event chains. A chain moves a particle along a
+    random direction until it collides with another particle, and then continues with the hit particle, until the total
+    displacement of the chain reaches the chain length. All moves of a chain are accepted. Rotation moves are
+    Metropolis trial moves as in IntegratorHPMCMono, and are interleaved with the chains according to the move ratio.
+
+    Each of the nselect sweeps starts one chain or one rotation move from every local particle, in random order. The
+    distance to a collision is given by sweep_distance(), which is specialized for the supported shapes. The particles
+    in reach of the moving particle are found with a query of the AABB tree for the box swept along the chain.
+
+    With domain decomposition, chains are truncated where a particle would leave the active region of the domain, and
+    where they would continue with a ghost particle. This is the event-chain equivalent of the rejection of trial moves
+    into the ghost layer in IntegratorHPMCMono. Patch energies and external fields are not supported.
+
+    \ingroup hpmc_integrators
+*/
+template< class Shape >
+class IntegratorHPMCMonoEventChain : public IntegratorHPMCMono<Shape>
+    {
+    public:
+        //! Construct the integrator
+        IntegratorHPMCMonoEventChain(std::shared_ptr<SystemDefinition> sysdef,
+                                     unsigned int seed);
+
+        //! Destructor
+        virtual ~IntegratorHPMCMonoEventChain()
+            {
+            this->m_exec_conf->msg->notice(5) << "Destroying IntegratorHPMCMonoEventChain" << std::endl;
+            }
+
+        //! Set the total displacement of one chain
+        void setChainLength(Scalar chain_length)
+            {
+            if (chain_length < Scalar(0.0))
+                {
+                this->m_exec_conf->msg->error() << "integrate.event_chain: chain_length must be non-negative" << std::endl;
+                throw std::runtime_error("Error setting chain length");
+                }
+            m_chain_length = chain_length;
+
+            // a particle may move by up to the chain length before it is wrapped back into the box
+            this->m_extra_image_width = m_chain_length;
+            this->m_image_list_valid = false;
+            }
+
+        //! Get the total displacement of one chain
+        Scalar getChainLength()
+            {
+            return m_chain_length;
+            }
+
+        //! Get a list of logged quantities
+        virtual std::vector< std::string > getProvidedLogQuantities();
+
+        //! Get the value of a logged quantity
+        virtual Scalar getLogValue(const std::string& quantity, unsigned int timestep);
+
+        //! Take one timestep forward
+        virtual void update(unsigned int timestep);
+
+    protected:
+        Scalar m_chain_length;                  //!< Total displacement of one chain
+        unsigned int m_n_chains;                //!< Number of chains in the last step
+        unsigned int m_n_collisions;            //!< Number of collisions in the last step
+        Scalar m_displacement;                  //!< Total displacement of all chains in the last step
+
+        //! Test a configuration of particle i for overlaps
+        bool checkOverlaps(unsigned int i,
+                           const vec3<Scalar>& pos_i,
+                           const Shape& shape_i,
+                           unsigned int typ_i,
+                           const Scalar4 *h_postype,
+                           const Scalar4 *h_orientation,
+                           const unsigned int *h_overlaps,
+                           const unsigned int *h_tag,
+                           bool sep_axis_cache,
+                           hpmc_counters_t& counters);
+
+        //! Find the first collision of particle i moving along a direction
+        OverlapReal findCollision(unsigned int i,
+                                  const vec3<Scalar>& pos_i,
+                                  const Shape& shape_i,
+                                  unsigned int typ_i,
+                                  const vec3<Scalar>& e,
+                                  OverlapReal s_max,
+                                  const Scalar4 *h_postype,
+                                  const Scalar4 *h_orientation,
+                                  const unsigned int *h_overlaps,
+                                  hpmc_counters_t& counters,
+                                  unsigned int& j_hit);
+    };
+
+/*! \param sysdef System definition
+    \param seed Random number seed
+*/
+template< class Shape >
+IntegratorHPMCMonoEventChain< Shape >::IntegratorHPMCMonoEventChain(std::shared_ptr<SystemDefinition> sysdef,
+                                                                   unsigned int seed)
+    : IntegratorHPMCMono<Shape>(sysdef, seed), m_chain_length(0.0), m_n_chains(0), m_n_collisions(0),
+      m_displacement(0.0)
+    {
+    this->m_exec_conf->msg->notice(5) << "Constructing IntegratorHPMCMonoEventChain" << std::endl;
+
+    setChainLength(Scalar(1.0));
+    }
+
+/*! \returns a list of provided quantities
+*/
+template< class Shape >
+std::vector< std::string > IntegratorHPMCMonoEventChain< Shape >::getProvidedLogQuantities()
+    {
+    std::vector< std::string > result = IntegratorHPMCMono<Shape>::getProvidedLogQuantities();
+    result.push_back("hpmc_chain_collisions");
+    result.push_back("hpmc_chain_displacement");
+    return result;
+    }
+
+/*! \param quantity Name of the log quantity to get
+    \param timestep Current time step of the simulation
+    \return the requested log quantity.
+*/
+template< class Shape >
+Scalar IntegratorHPMCMonoEventChain< Shape >::getLogValue(const std::string& quantity, unsigned int timestep)
+    {
+    if (quantity == "hpmc_chain_collisions" || quantity == "hpmc_chain_displacement")
+        {
+        unsigned int n_chains = m_n_chains;
+        unsigned int n_collisions = m_n_collisions;
+        Scalar displacement = m_displacement;
+
+        #ifdef ENABLE_MPI
+        if (this->m_pdata->getDomainDecomposition())
+            {
+            MPI_Allreduce(MPI_IN_PLACE, &n_chains, 1, MPI_UNSIGNED, MPI_SUM, this->m_exec_conf->getMPICommunicator());
+            MPI_Allreduce(MPI_IN_PLACE, &n_collisions, 1, MPI_UNSIGNED, MPI_SUM, this->m_exec_conf->getMPICommunicator());
+            MPI_Allreduce(MPI_IN_PLACE, &displacement, 1, MPI_HOOMD_SCALAR, MPI_SUM, this->m_exec_conf->getMPICommunicator());
+            }
+        #endif
+
+        if (n_chains == 0)
+            return Scalar(0.0);
+
+        if (quantity == "hpmc_chain_collisions")
+            return Scalar(n_collisions) / Scalar(n_chains);
+        else
+            return displacement / Scalar(n_chains);
+        }
+
+    return IntegratorHPMCMono<Shape>::getLogValue(quantity, timestep);
+    }
+
+/*! \param i Index of the particle
+    \param pos_i Position of the particle
+    \param shape_i Shape of the particle
+    \param typ_i Type of the particle
+    \param h_postype Positions and types of all particles
+    \param h_orientation Orientations of all particles
+    \param h_overlaps Interaction matrix
+    \param h_tag Tags of all particles
+    \param sep_axis_cache True if the overlap tests start from the cached separating axes
+    \param counters Counters to update
+    \returns True if particle i overlaps with any other particle in the given configuration
+*/
+template< class Shape >
+bool IntegratorHPMCMonoEventChain< Shape >::checkOverlaps(unsigned int i,
+                                                          const vec3<Scalar>& pos_i,
+                                                          const Shape& shape_i,
+                                                          unsigned int typ_i,
+                                                          const Scalar4 *h_postype,
+                                                          const Scalar4 *h_orientation,
+                                                          const unsigned int *h_overlaps,
+                                                          const unsigned int *h_tag,
+                                                          bool sep_axis_cache,
+                                                          hpmc_counters_t& counters)
+    {
+    detail::AABB aabb_i_local = shape_i.getAABB(vec3<Scalar>(0,0,0));
+
+    return this->visitImageNeighbors(pos_i, aabb_i_local,
+        [&](unsigned int j, unsigned int cur_image, const vec3<Scalar>& pos_i_image) -> bool
+        {
+        Scalar4 postype_j;
+        Scalar4 orientation_j;
+        if (j != i)
+            {
+            postype_j = h_postype[j];
+            orientation_j = h_orientation[j];
+            }
+        else
+            {
+            // in the first image, skip i == j, in the others use the trial configuration of i
+            if (cur_image == 0)
+                return false;
+            postype_j = make_scalar4(pos_i.x, pos_i.y, pos_i.z, __int_as_scalar(typ_i));
+            orientation_j = quat_to_scalar4(shape_i.orientation);
+            }
+
+        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+        unsigned int typ_j = __scalar_as_int(postype_j.w);
+        Shape shape_j(quat<Scalar>(orientation_j), this->m_params[typ_j]);
+
+        counters.overlap_checks++;
+        return h_overlaps[this->m_overlap_idx(typ_i, typ_j)]
+            && check_circumsphere_overlap(r_ij, shape_i, shape_j)
+            && this->testOverlapPair(r_ij, shape_i, shape_j, h_tag[i], h_tag[j], sep_axis_cache,
+                counters.overlap_err_count);
+        });
+    }
+
+/*! \param i Index of the moving particle
+    \param pos_i Position of the particle
+    \param shape_i Shape of the particle
+    \param typ_i Type of the particle
+    \param e Unit vector along which the particle moves
+    \param s_max Maximum displacement
+    \param h_postype Positions and types of all particles
+    \param h_orientation Orientations of all particles
+    \param h_overlaps Interaction matrix
+    \param counters Counters to update
+    \param j_hit Set to the index of the hit particle, if there is a collision
+    \returns The distance to the first collision, or s_max if there is none
+
+    All particles in reach are found with one query of the tree for the AABB of the particle swept by s_max along e.
+*/
+template< class Shape >
+OverlapReal IntegratorHPMCMonoEventChain< Shape >::findCollision(unsigned int i,
+                                                                 const vec3<Scalar>& pos_i,
+                                                                 const Shape& shape_i,
+                                                                 unsigned int typ_i,
+                                                                 const vec3<Scalar>& e,
+                                                                 OverlapReal s_max,
+                                                                 const Scalar4 *h_postype,
+                                                                 const Scalar4 *h_orientation,
+                                                                 const unsigned int *h_overlaps,
+                                                                 hpmc_counters_t& counters,
+                                                                 unsigned int& j_hit)
+    {
+    detail::AABB aabb_start = shape_i.getAABB(vec3<Scalar>(0,0,0));
+    detail::AABB aabb_end = aabb_start;
+    aabb_end.translate(e*Scalar(s_max));
+    detail::AABB aabb_sweep_local = detail::merge(aabb_start, aabb_end);
+
+    OverlapReal s_min = s_max;
+
+    this->visitImageNeighbors(pos_i, aabb_sweep_local,
+        [&](unsigned int j, unsigned int cur_image, const vec3<Scalar>& pos_i_image) -> bool
+        {
+        // the images of i move along with it
+        if (j == i)
+            return false;
+
+        Scalar4 postype_j = h_postype[j];
+        unsigned int typ_j = __scalar_as_int(postype_j.w);
+        if (!h_overlaps[this->m_overlap_idx(typ_i, typ_j)])
+            return false;
+
+        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+        Shape shape_j(quat<Scalar>(h_orientation[j]), this->m_params[typ_j]);
+
+        counters.overlap_checks++;
+        OverlapReal s = sweep_distance(r_ij, e, shape_i, shape_j, s_min, counters.overlap_err_count);
+        if (s < s_min)
+            {
+            s_min = s;
+            j_hit = j;
+            }
+        return false;
+        });
+
+    return s_min;
+    }
+
+/*! \param timestep Current time step
+*/
+template< class Shape >
+void IntegratorHPMCMonoEventChain< Shape >::update(unsigned int timestep)
+    {
+    this->m_exec_conf->msg->notice(10) << "HPMCMonoEventChain update: " << timestep << std::endl;
+    IntegratorHPMC::update(timestep);
+
+    if (this->m_patch || this->m_external)
+        {
+        this->m_exec_conf->msg->error() << "integrate.event_chain: Patch energies and external fields are not supported"
+                                        << std::endl;
+        throw std::runtime_error("Error in event-chain integrator");
+        }
+
+    // time the trial moves for the load balancer
+    int64_t start = this->m_compute_clock.getTime();
+
+    // get needed vars
+    ArrayHandle<hpmc_counters_t> h_counters(this->m_count_total, access_location::host, access_mode::readwrite);
+    hpmc_counters_t& counters = h_counters.data[0];
+    const BoxDim& box = this->m_pdata->getBox();
+    unsigned int ndim = this->m_sysdef->getNDimensions();
+
+    #ifdef ENABLE_MPI
+    // compute the width of the active region
+    Scalar3 npd = box.getNearestPlaneDistance();
+    Scalar3 ghost_fraction = this->m_nominal_width / npd;
+    #endif
+
+    // Shuffle the order of particles for this step
+    this->m_update_order.resize(this->m_pdata->getN());
+    this->m_update_order.shuffle(timestep);
+
+    // update the AABB Tree
+    this->buildAABBTree();
+    // limit m_d entries so that particles cannot possibly wander more than one box image in one time step
+    this->limitMoveDistances();
+    // update the image list
+    this->updateImageList();
+
+    if (this->m_prof) this->m_prof->push(this->m_exec_conf, "HPMC event chain");
+
+    m_n_chains = 0;
+    m_n_collisions = 0;
+    m_displacement = 0.0;
+
+    // access interaction matrix
+    ArrayHandle<unsigned int> h_overlaps(this->m_overlaps, access_location::host, access_mode::read);
+
+    // the chains are serial, so the rotation moves can always use the separating axis cache
+    bool sep_axis_cache = this->m_sep_axis_cache_enabled;
+    if (sep_axis_cache)
+        this->m_sep_axis_cache.reserve(this->m_pdata->getN() + this->m_pdata->getNGhosts());
+
+    // loop over local particles nselect times
+    for (unsigned int i_nselect = 0; i_nselect < this->m_nselect; i_nselect++)
+        {
+        // access particle data and system box
+        ArrayHandle<Scalar4> h_postype(this->m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_orientation(this->m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+        ArrayHandle<int3> h_image(this->m_pdata->getImages(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_tag(this->m_pdata->getTags(), access_location::host, access_mode::read);
+
+        //access move sizes
+        ArrayHandle<Scalar> h_a(this->m_a, access_location::host, access_mode::read);
+
+        const unsigned int N = this->m_pdata->getN();
+
+        // loop through N particles in a shuffled order
+        for (unsigned int cur_particle = 0; cur_particle < N; cur_particle++)
+            {
+            unsigned int i = this->m_update_order[cur_particle];
+
+            Scalar4 postype_i = h_postype.data[i];
+            vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
+
+            #ifdef ENABLE_MPI
+            if (this->m_comm)
+                {
+                // only move particle if active
+                if (!isActive(make_scalar3(postype_i.x, postype_i.y, postype_i.z), box, ghost_fraction))
+                    continue;
+                }
+            #endif
+
+            hoomd::RandomGenerator rng_i(hoomd::RNGIdentifier::HPMCMonoEventChain, this->m_seed, i,
+                this->m_exec_conf->getRank()*this->m_nselect + i_nselect, timestep);
+            unsigned int typ_i = __scalar_as_int(postype_i.w);
+            Shape shape_i(quat<Scalar>(h_orientation.data[i]), this->m_params[typ_i]);
+            unsigned int move_type_select = hoomd::UniformIntDistribution(0xffff)(rng_i);
+            bool move_type_translate = !shape_i.hasOrientation() || (move_type_select < this->m_move_ratio);
+
+            if (!move_type_translate)
+                {
+                if (h_a.data[typ_i] == 0.0)
+                    {
+                    if (!shape_i.ignoreStatistics())
+                        counters.rotate_accept_count++;
+                    continue;
+                    }
+
+                move_rotate(shape_i.orientation, rng_i, h_a.data[typ_i], ndim);
+
+                bool overlap = checkOverlaps(i, pos_i, shape_i, typ_i, h_postype.data, h_orientation.data,
+                    h_overlaps.data, h_tag.data, sep_axis_cache, counters);
+
+                if (!overlap)
+                    {
+                    if (!shape_i.ignoreStatistics())
+                        counters.rotate_accept_count++;
+                    h_orientation.data[i] = quat_to_scalar4(shape_i.orientation);
+                    }
+                else
+                    {
+                    if (!shape_i.ignoreStatistics())
+                        counters.rotate_reject_count++;
+                    }
+                continue;
+                }
+
+            // choose the direction of the chain along one of the box axes
+            unsigned int axis_select = hoomd::UniformIntDistribution(2*ndim-1)(rng_i);
+            vec3<Scalar> e(0,0,0);
+            Scalar sign = (axis_select & 1) ? Scalar(-1.0) : Scalar(1.0);
+            if (axis_select/2 == 0)
+                e.x = sign;
+            else if (axis_select/2 == 1)
+                e.y = sign;
+            else
+                e.z = sign;
+
+            m_n_chains++;
+
+            // follow the chain until its length is used up, or it is truncated. The number of links is limited, so
+            // that chains through touching particles wrapped around the box terminate.
+            OverlapReal remaining = m_chain_length;
+            unsigned int cur = i;
+            for (unsigned int link = 0; link <= N && remaining > OverlapReal(0.0); link++)
+                {
+                Scalar4 postype_cur = h_postype.data[cur];
+                vec3<Scalar> pos_cur = vec3<Scalar>(postype_cur);
+                unsigned int typ_cur = __scalar_as_int(postype_cur.w);
+                Shape shape_cur(quat<Scalar>(h_orientation.data[cur]), this->m_params[typ_cur]);
+
+                unsigned int j_hit = UINT_MAX;
+                OverlapReal s = findCollision(cur, pos_cur, shape_cur, typ_cur, e, remaining, h_postype.data,
+                    h_orientation.data, h_overlaps.data, counters, j_hit);
+                bool collision = s < remaining;
+
+                pos_cur += e*Scalar(s);
+
+                #ifdef ENABLE_MPI
+                if (this->m_comm)
+                    {
+                    // truncate the chain where the particle would move into the ghost layer
+                    if (!isActive(vec_to_scalar3(pos_cur), box, ghost_fraction))
+                        break;
+                    }
+                #endif
+
+                // a chain link is counted as one accepted translation move
+                if (!shape_cur.ignoreStatistics())
+                    counters.translate_accept_count++;
+                m_displacement += s;
+                remaining -= s;
+
+                // wrap the particle back into the box, so that the image list covers one chain of displacement
+                Scalar4 postype_new = make_scalar4(pos_cur.x, pos_cur.y, pos_cur.z, postype_cur.w);
+                box.wrap(postype_new, h_image.data[cur]);
+                h_postype.data[cur] = postype_new;
+
+                // update the position of the particle in the tree for the following links
+                this->m_aabb_tree.update(cur, shape_cur.getAABB(vec3<Scalar>(postype_new)));
+
+                if (!collision)
+                    break;
+
+                m_n_collisions++;
+
+                // truncate the chain where it would continue with a ghost particle
+                if (j_hit >= N)
+                    break;
+
+                cur = j_hit;
+                }
+            }
+        } // end loop over nselect
+
+    // perform the grid shift
+    #ifdef ENABLE_MPI
+    if (this->m_comm)
+        {
+        ArrayHandle<Scalar4> h_postype(this->m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<int3> h_image(this->m_pdata->getImages(), access_location::host, access_mode::readwrite);
+
+        // precalculate the grid shift
+        hoomd::RandomGenerator rng(hoomd::RNGIdentifier::HPMCMonoShift, this->m_seed, timestep);
+        Scalar3 shift = make_scalar3(0,0,0);
+        hoomd::UniformDistribution<Scalar> uniform(-this->m_nominal_width/Scalar(2.0),this->m_nominal_width/Scalar(2.0));
+        shift.x = uniform(rng);
+        shift.y = uniform(rng);
+        if (this->m_sysdef->getNDimensions() == 3)
+            {
+            shift.z = uniform(rng);
+            }
+        for (unsigned int i = 0; i < this->m_pdata->getN(); i++)
+            {
+            // read in the current position and orientation
+            Scalar4 postype_i = h_postype.data[i];
+            vec3<Scalar> r_i = vec3<Scalar>(postype_i); // translation from local to global coordinates
+            r_i += vec3<Scalar>(shift);
+            h_postype.data[i] = vec_to_scalar4(r_i, postype_i.w);
+            box.wrap(h_postype.data[i], h_image.data[i]);
+            }
+        this->m_pdata->translateOrigin(shift);
+        }
+    #endif
+
+    if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+
+    this->m_sysdef->getIntegratorData()->addComputeTime(double(this->m_compute_clock.getTime() - start)*1e-9);
+
+    // migrate and exchange particles
+    this->communicate(true);
+
+    // all particle have been moved, the aabb tree is now invalid
+    this->m_aabb_tree_invalid = true;
+    }
+
+//! Export the IntegratorHPMCMonoEventChain class to python
+/*! \param name Name of the class in the exported python module
+    \tparam Shape An instantiation of IntegratorHPMCMonoEventChain<Shape> will be exported
+*/
+template < class Shape > void export_IntegratorHPMCMonoEventChain(pybind11::module& m, const std::string& name)
+    {
+    pybind11::class_< IntegratorHPMCMonoEventChain<Shape>, std::shared_ptr< IntegratorHPMCMonoEventChain<Shape> > >(m, name.c_str(), pybind11::base< IntegratorHPMCMono<Shape> >())
+          .def(pybind11::init< std::shared_ptr<SystemDefinition>, unsigned int >())
+          .def("setChainLength", &IntegratorHPMCMonoEventChain<Shape>::setChainLength)
+          .def("getChainLength", &IntegratorHPMCMonoEventChain<Shape>::getChainLength)
+          ;
+    }
+
+} // end namespace hpmc
+
+#endif // __HPMC_MONO_EVENT_CHAIN__H__
@@ -0,0 +1,165 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __SEPARATING_AXIS_CACHE_H__
+#define __SEPARATING_AXIS_CACHE_H__
+
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/VectorMath.h"
+#include "HPMCPrecisionSetup.h"
+
+#ifndef NVCC
+#include <vector>
+#include <algorithm>
+#endif
+
+/*! \file SeparatingAxisCache.h
+    \brief Declares a cache of separating axes between pairs of particles
+*/
+
+namespace hpmc
+{
+
+namespace detail
+{
+
+//! Trait for shapes whose overlap test can start from a separating axis
+/*! Shapes that support it specialize this template with supported = true, and provide an overload
+    test_overlap(r_ab, a, b, err, axis). The axis is given in the space frame and points such that the Minkowski
+    difference {b}-{a} lies on its negative side.
+
+    \ingroup shape
+*/
+template<class Shape>
+struct SeparatingAxisTraits
+    {
+    static const bool supported = false;    //!< True if the overlap test uses the separating axis
+    };
+
+#ifndef NVCC
+//! Cache of the separating axes between pairs of particles
+/*! The axes are stored in a direct-mapped hash table keyed by the tags of the pair. A new entry evicts the entry in
+    the same slot, so the table has a fixed size and lookups never probe. A stale or colliding entry is harmless
+    because the overlap test validates the axis before using it.
+
+    The axis is stored for the pair ordered by tag, and is negated when looked up in the opposite order, so that both
+    particles of a pair share the same entry.
+
+    \ingroup hpmc_data_structs
+*/
+class SeparatingAxisCache
+    {
+    public:
+        //! Construct an empty cache
+        SeparatingAxisCache()
+            : m_mask(0)
+            { }
+
+        //! Make room for a number of particles
+        /*! \param N Number of particles (including ghosts)
+
+            The table has about 8 slots per particle, rounded up to a power of two. It is cleared when it grows.
+        */
+        void reserve(unsigned int N)
+            {
+            if (m_keys.size() >= 8*N)
+                return;
+
+            unsigned int size = 1;
+            while (size < 8*N)
+                size <<= 1;
+
+            // empty slots have a key that is never a valid pair
+            m_keys.assign(size, ~0ull);
+            m_axes.resize(size);
+            m_mask = size - 1;
+            }
+
+        //! Get the number of slots
+        unsigned int getSize() const
+            {
+            return m_keys.size();
+            }
+
+        //! Remove all entries
+        void clear()
+            {
+            std::fill(m_keys.begin(), m_keys.end(), ~0ull);
+            }
+
+        //! Look up the separating axis of a pair
+        /*! \param tag_i Tag of the first particle
+            \param tag_j Tag of the second particle
+            \returns The axis from i to j, or zero if there is no entry
+        */
+        vec3<OverlapReal> find(unsigned int tag_i, unsigned int tag_j) const
+            {
+            unsigned long long int key = getKey(tag_i, tag_j);
+            unsigned int slot = getSlot(key);
+            if (m_keys[slot] != key)
+                return vec3<OverlapReal>(0,0,0);
+
+            return (tag_i < tag_j) ? m_axes[slot] : -m_axes[slot];
+            }
+
+        //! Store the separating axis of a pair
+        /*! \param tag_i Tag of the first particle
+            \param tag_j Tag of the second particle
+            \param axis The axis from i to j
+        */
+        void insert(unsigned int tag_i, unsigned int tag_j, const vec3<OverlapReal>& axis)
+            {
+            unsigned long long int key = getKey(tag_i, tag_j);
+            unsigned int slot = getSlot(key);
+            m_keys[slot] = key;
+            m_axes[slot] = (tag_i < tag_j) ? axis : -axis;
+            }
+
+    private:
+        std::vector<unsigned long long int> m_keys;    //!< Pair keys
+        std::vector< vec3<OverlapReal> > m_axes;       //!< Separating axes of the pairs
+        unsigned int m_mask;                           //!< Number of slots - 1
+
+        //! Get the key of a pair, independent of the order
+        static unsigned long long int getKey(unsigned int tag_i, unsigned int tag_j)
+            {
+            unsigned int a = std::min(tag_i, tag_j);
+            unsigned int b = std::max(tag_i, tag_j);
+            return ((unsigned long long int)a << 32) | b;
+            }
+
+        //! Get the slot of a key (Fibonacci hashing)
+        unsigned int getSlot(unsigned long long int key) const
+            {
+            return (unsigned int)((key * 0x9e3779b97f4a7c15ull) >> 32) & m_mask;
+            }
+    };
+#endif
+
+} // end namespace detail
+
+#ifndef NVCC
+//! Overlap test starting from a separating axis, for shapes that do not use the axis
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
+    \param a first shape
+    \param b second shape
+    \param err in/out variable incremented when error conditions occur in the overlap test
+    \param axis Separating axis (unused)
+    \returns true when *a* and *b* overlap, and false when they are disjoint
+
+    \ingroup shape
+*/
+template<class Shape>
+inline bool test_overlap(const vec3<Scalar>& r_ab,
+                         const Shape& a,
+                         const Shape& b,
+                         unsigned int& err,
+                         vec3<OverlapReal>& axis)
+    {
+    return test_overlap(r_ab, a, b, err);
+    }
+#endif
+
+} // end namespace hpmc
+
+#endif // __SEPARATING_AXIS_CACHE_H__
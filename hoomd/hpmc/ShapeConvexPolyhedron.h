@@ -6,6 +6,7 @@
 #include "hoomd/VectorMath.h"
 #include "ShapeSphere.h"    //< For the base template of test_overlap
 #include "XenoCollide3D.h"
+#include "SeparatingAxisCache.h"
 #include "hoomd/ManagedArray.h"
 
 #ifndef __SHAPE_CONVEX_POLYHEDRON_H__
@@ -57,7 +58,11 @@ struct poly3d_verts : param_base
     poly3d_verts(unsigned int _N, bool _managed)
         : N(_N), diameter(0.0), sweep_radius(0.0), ignore(0)
         {
+        #if defined(__AVX512F__)
+        unsigned int align_size = 16; //for AVX-512
+        #else
         unsigned int align_size = 8; //for AVX
+        #endif
         unsigned int N_align =((N + align_size - 1)/align_size)*align_size;
         x = ManagedArray<OverlapReal>(N_align,_managed);
         y = ManagedArray<OverlapReal>(N_align,_managed);
@@ -130,7 +135,84 @@ class SupportFuncConvexPolyhedron
 
             if (verts.N > 0)
                 {
-                #if !defined(NVCC) && defined(__AVX__) && (defined(SINGLE_PRECISION) || defined(ENABLE_HPMC_MIXED_PRECISION))
+                #if !defined(NVCC) && defined(__AVX512F__) && (defined(SINGLE_PRECISION) || defined(ENABLE_HPMC_MIXED_PRECISION))
+                // process dot products with AVX-512 16 at a time on the CPU
+                __m512 nx_v = _mm512_set1_ps(n.x);
+                __m512 ny_v = _mm512_set1_ps(n.y);
+                __m512 nz_v = _mm512_set1_ps(n.z);
+                __m512 max_dot_v = _mm512_set1_ps(max_dot);
+                float d_s[verts.x.size()] __attribute__((aligned(64)));
+
+                for (unsigned int i = 0; i < verts.N; i+=16)
+                    {
+                    // the vertex arrays are only guaranteed to be 32 byte aligned
+                    __m512 x_v = _mm512_loadu_ps(verts.x.get() + i);
+                    __m512 y_v = _mm512_loadu_ps(verts.y.get() + i);
+                    __m512 z_v = _mm512_loadu_ps(verts.z.get() + i);
+
+                    __m512 d_v = _mm512_fmadd_ps(nx_v, x_v, _mm512_fmadd_ps(ny_v, y_v, _mm512_mul_ps(nz_v, z_v)));
+
+                    // determine a maximum in each of the 16 channels as we go
+                    max_dot_v = _mm512_max_ps(max_dot_v, d_v);
+
+                    _mm512_store_ps(d_s + i, d_v);
+                    }
+
+                // find the maximum of the 16 channels and broadcast it back
+                max_dot_v = _mm512_set1_ps(_mm512_reduce_max_ps(max_dot_v));
+
+                // loop again and find the first index of the max element, the comparison directly yields a bit mask
+                for (unsigned int i = 0; i < verts.N; i+=16)
+                    {
+                    __m512 d_v = _mm512_load_ps(d_s + i);
+
+                    int id = __builtin_ffs(_mm512_cmp_ps_mask(max_dot_v, d_v, _CMP_EQ_OQ));
+
+                    if (id)
+                        {
+                        max_idx = i + id - 1;
+                        break;
+                        }
+                    }
+                #elif !defined(NVCC) && defined(__AVX512F__)
+                // process dot products with AVX-512 8 at a time on the CPU in double precision
+                __m512d nx_v = _mm512_set1_pd(n.x);
+                __m512d ny_v = _mm512_set1_pd(n.y);
+                __m512d nz_v = _mm512_set1_pd(n.z);
+                __m512d max_dot_v = _mm512_set1_pd(max_dot);
+                double d_s[verts.x.size()] __attribute__((aligned(64)));
+
+                for (unsigned int i = 0; i < verts.N; i+=8)
+                    {
+                    // the vertex arrays are only guaranteed to be 32 byte aligned
+                    __m512d x_v = _mm512_loadu_pd(verts.x.get() + i);
+                    __m512d y_v = _mm512_loadu_pd(verts.y.get() + i);
+                    __m512d z_v = _mm512_loadu_pd(verts.z.get() + i);
+
+                    __m512d d_v = _mm512_fmadd_pd(nx_v, x_v, _mm512_fmadd_pd(ny_v, y_v, _mm512_mul_pd(nz_v, z_v)));
+
+                    // determine a maximum in each of the 8 channels as we go
+                    max_dot_v = _mm512_max_pd(max_dot_v, d_v);
+
+                    _mm512_store_pd(d_s + i, d_v);
+                    }
+
+                // find the maximum of the 8 channels and broadcast it back
+                max_dot_v = _mm512_set1_pd(_mm512_reduce_max_pd(max_dot_v));
+
+                for (unsigned int i = 0; i < verts.N; i+=8)
+                    {
+                    __m512d d_v = _mm512_load_pd(d_s + i);
+
+                    int id = __builtin_ffs(_mm512_cmp_pd_mask(max_dot_v, d_v, _CMP_EQ_OQ));
+
+                    if (id)
+                        {
+                        max_idx = i + id - 1;
+                        break;
+                        }
+                    }
+                #elif !defined(NVCC) && defined(__AVX__) && (defined(SINGLE_PRECISION) || defined(ENABLE_HPMC_MIXED_PRECISION))
                 // process dot products with AVX 8 at a time on the CPU when working with more than 4 verts
                 __m256 nx_v = _mm256_broadcast_ss(&n.x);
                 __m256 ny_v = _mm256_broadcast_ss(&n.y);
@@ -170,6 +252,44 @@ class SupportFuncConvexPolyhedron
 
                     int id = __builtin_ffs(_mm256_movemask_ps(_mm256_cmp_ps(max_dot_v, d_v, 0)));
 
+                    if (id)
+                        {
+                        max_idx = i + id - 1;
+                        break;
+                        }
+                    }
+                #elif !defined(NVCC) && defined(__AVX__)
+                // process dot products with AVX 4 at a time on the CPU in double precision
+                __m256d nx_v = _mm256_broadcast_sd(&n.x);
+                __m256d ny_v = _mm256_broadcast_sd(&n.y);
+                __m256d nz_v = _mm256_broadcast_sd(&n.z);
+                __m256d max_dot_v = _mm256_broadcast_sd(&max_dot);
+                double d_s[verts.x.size()] __attribute__((aligned(32)));
+
+                for (unsigned int i = 0; i < verts.N; i+=4)
+                    {
+                    __m256d x_v = _mm256_load_pd(verts.x.get() + i);
+                    __m256d y_v = _mm256_load_pd(verts.y.get() + i);
+                    __m256d z_v = _mm256_load_pd(verts.z.get() + i);
+
+                    __m256d d_v = _mm256_add_pd(_mm256_mul_pd(nx_v, x_v), _mm256_add_pd(_mm256_mul_pd(ny_v, y_v), _mm256_mul_pd(nz_v, z_v)));
+
+                    // determine a maximum in each of the 4 channels as we go
+                    max_dot_v = _mm256_max_pd(max_dot_v, d_v);
+
+                    _mm256_store_pd(d_s + i, d_v);
+                    }
+
+                // find the maximum of the 4 channels: swap the two 128b halves, then the two elements within each half
+                max_dot_v = _mm256_max_pd(max_dot_v, _mm256_permute2f128_pd(max_dot_v, max_dot_v, 1));
+                max_dot_v = _mm256_max_pd(max_dot_v, _mm256_shuffle_pd(max_dot_v, max_dot_v, 0x5));
+
+                for (unsigned int i = 0; i < verts.N; i+=4)
+                    {
+                    __m256d d_v = _mm256_load_pd(d_s + i);
+
+                    int id = __builtin_ffs(_mm256_movemask_pd(_mm256_cmp_pd(max_dot_v, d_v, _CMP_EQ_OQ)));
+
                     if (id)
                         {
                         max_idx = i + id - 1;
@@ -221,7 +341,7 @@ class SupportFuncConvexPolyhedron
                     }
                 #else
 
-                // if no AVX or SSE, or running in double precision, fall back on serial computation
+                // if no AVX or SSE, or running in double precision without AVX, fall back on serial computation
                 // this code path also triggers on the GPU
 
                 OverlapReal max_dot0 = dot(n, vec3<OverlapReal>(verts.x[0], verts.y[0], verts.z[0]));
@@ -441,6 +561,57 @@ DEVICE inline bool test_overlap(const vec3<Scalar>& r_ab,
     */
     }
 
+//! Convex polyhedron overlap test starting from a separating axis
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
+    \param a first shape
+    \param b second shape
+    \param err in/out variable incremented when error conditions occur in the overlap test
+    \param axis in/out separating axis in the space frame, or zero. It is left unchanged when it still separates the
+           shapes, and replaced by the axis found by the overlap test otherwise.
+    \returns true when *a* and *b* overlap, and false when they are disjoint
+
+    \ingroup shape
+*/
+DEVICE inline bool test_overlap(const vec3<Scalar>& r_ab,
+                                 const ShapeConvexPolyhedron& a,
+                                 const ShapeConvexPolyhedron& b,
+                                 unsigned int& err,
+                                 vec3<OverlapReal>& axis)
+    {
+    vec3<OverlapReal> dr(r_ab);
+    OverlapReal DaDb = a.getCircumsphereDiameter() + b.getCircumsphereDiameter();
+    quat<OverlapReal> q_a(a.orientation);
+
+    // the overlap check is done in the frame of a
+    vec3<OverlapReal> axis_a = rotate(conj(q_a), axis);
+    vec3<OverlapReal> sep = axis_a;
+
+    bool overlap = detail::xenocollide_3d(detail::SupportFuncConvexPolyhedron(a.verts),
+                                          detail::SupportFuncConvexPolyhedron(b.verts),
+                                          rotate(conj(q_a), dr),
+                                          conj(q_a) * quat<OverlapReal>(b.orientation),
+                                          DaDb/2.0,
+                                          err,
+                                          sep);
+
+    if (!overlap && !(sep == axis_a))
+        axis = rotate(q_a, sep);
+
+    return overlap;
+    }
+
+namespace detail
+{
+
+//! Convex polyhedra can start their overlap test from a separating axis
+template<>
+struct SeparatingAxisTraits<ShapeConvexPolyhedron>
+    {
+    static const bool supported = true;
+    };
+
+} // end namespace detail
+
 }; // end namespace hpmc
 
 #undef DEVICE
@@ -7,6 +7,7 @@
 #include "ShapeSphere.h"    //< For the base template of test_overlap
 #include "ShapeConvexPolyhedron.h"
 #include "XenoCollide3D.h"
+#include "SeparatingAxisCache.h"
 
 #ifndef __SHAPE_SPHEROPOLYHEDRON_H__
 #define __SHAPE_SPHEROPOLYHEDRON_H__
@@ -245,6 +246,57 @@ DEVICE inline bool test_overlap(const vec3<Scalar>& r_ab,
     */
     }
 
+//! Spheropolyhedron overlap test starting from a separating axis
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
+    \param a first shape
+    \param b second shape
+    \param err in/out variable incremented when error conditions occur in the overlap test
+    \param axis in/out separating axis in the space frame, or zero. It is left unchanged when it still separates the
+           shapes, and replaced by the axis found by the overlap test otherwise.
+    \returns true when *a* and *b* overlap, and false when they are disjoint
+
+    \ingroup shape
+*/
+DEVICE inline bool test_overlap(const vec3<Scalar>& r_ab,
+                                 const ShapeSpheropolyhedron& a,
+                                 const ShapeSpheropolyhedron& b,
+                                 unsigned int& err,
+                                 vec3<OverlapReal>& axis)
+    {
+    vec3<OverlapReal> dr(r_ab);
+    OverlapReal DaDb = a.getCircumsphereDiameter() + b.getCircumsphereDiameter();
+    quat<OverlapReal> q_a(a.orientation);
+
+    // the overlap check is done in the frame of a
+    vec3<OverlapReal> axis_a = rotate(conj(q_a), axis);
+    vec3<OverlapReal> sep = axis_a;
+
+    bool overlap = xenocollide_3d(detail::SupportFuncSpheropolyhedron(a.verts),
+                                  detail::SupportFuncSpheropolyhedron(b.verts),
+                                  rotate(conj(q_a), dr),
+                                  conj(q_a) * quat<OverlapReal>(b.orientation),
+                                  DaDb/2.0,
+                                  err,
+                                  sep);
+
+    if (!overlap && !(sep == axis_a))
+        axis = rotate(q_a, sep);
+
+    return overlap;
+    }
+
+namespace detail
+{
+
+//! Spheropolyhedra can start their overlap test from a separating axis
+template<>
+struct SeparatingAxisTraits<ShapeSpheropolyhedron>
+    {
+    static const bool supported = true;
+    };
+
+} // end namespace detail
+
 }; // end namespace hpmc
 
 #undef DEVICE
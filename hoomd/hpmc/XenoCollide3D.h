@@ -39,6 +39,8 @@ const unsigned int XENOCOLLIDE_3D_MAX_ITERATIONS = 1024;
     \param q Orientation of shape B in frame A
     \param R Approximate radius of Minkowski difference for scaling tolerance value
     \param err_count Error counter to increment whenever an infinite loop is encountered
+    \param sep Candidate separating axis in frame A (in), or zero if there is none. When the shapes are found to be
+           disjoint by a new search, the axis that proved it (out).
     \returns true when the two shapes overlap and false when they are disjoint.
 
     XenoCollide is a generic algorithm for detecting overlaps between two shapes. It operates with the support function
@@ -65,6 +67,12 @@ const unsigned int XENOCOLLIDE_3D_MAX_ITERATIONS = 1024;
     and we avoid it for performance reasons. Support functions that require the use of normal n vectors should normalize
     it when needed.
 
+    **Separating axis**
+    A separating axis *sep* is a direction in which the Minkowski difference {B}-{A} lies entirely on the negative side
+    of the origin. The candidate is tried first with a single evaluation of the support function, and *sep* is left
+    unchanged if it still separates the shapes. Otherwise, the full XenoCollide search is run. Between two trial moves
+    of a particle, the axis of the previous test is almost always still valid.
+
     \ingroup minkowski
 */
 template<class SupportFuncA, class SupportFuncB>
@@ -73,7 +81,8 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
                                   const vec3<OverlapReal>& ab_t,
                                   const quat<OverlapReal>& q,
                                   const OverlapReal R,
-                                  unsigned int& err_count)
+                                  unsigned int& err_count,
+                                  vec3<OverlapReal>& sep)
     {
     // This implementation of XenoCollide is hand-written from the description of the algorithm on page 171 of _Games
     // Programming Gems 7_
@@ -84,6 +93,10 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
     const OverlapReal precision_tol = 1e-7;        // precision tolerance for single-precision floats near 1.0
     const OverlapReal root_tol = 3e-4;   // square root of precision tolerance
 
+    // try the candidate separating axis
+    if (dot(sep, sep) > OverlapReal(0.0) && dot(S(sep), sep) < OverlapReal(0.0))
+        return false;
+
     if (fabs(ab_t.x) < root_tol && fabs(ab_t.y) < root_tol && fabs(ab_t.z) < root_tol)
         {
         // Interior point is at origin => particles overlap
@@ -104,7 +117,10 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
 
     /* if (dot(v1, v1 - v0) <= 0) // by convexity */
     if (dot(v1, v0) > OverlapReal(0.0))
+        {
+        sep = -v0;
         return false;   // origin is outside v1 support plane
+        }
 
     // find support v2 perpendicular to v0, v1 plane
     n = cross(v1, v0);
@@ -117,7 +133,10 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
     v2 = S(n); // Convexity should guarantee ||v2|| > 0, but v2 == v1 may be possible in edge cases of {B}-{A}
     // particles do not overlap if origin outside v2 support plane
     if (dot(v2, n) < OverlapReal(0.0))
+        {
+        sep = n;
         return false;
+        }
 
     // Find next support direction perpendicular to plane (v1,v0,v2)
     n = cross(v1 - v0, v2 - v0);
@@ -145,7 +164,10 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
         // Get the next support point
         v3 = S(n);
         if (dot(v3, n) <= 0)
+            {
+            sep = n;
             return false; // check if origin outside v3 support plane
+            }
 
         // If origin lies on opposite side of a plane from the third support point, use outer-facing plane normal
         // to find a new support point.
@@ -199,6 +221,7 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
         // if (origin outside support plane) return false
         if (dot(v4, n) < OverlapReal(0.0))
             {
+            sep = n;
             return false;
             }
 
@@ -211,7 +234,12 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
 
         // First, check if v4 is on plane (v2,v1,v3)
         if (fabs(d) < tol)
-            return false; // no more refinement possible, but not intersection detected
+            {
+            // no more refinement possible, but not intersection detected
+            // the portal normal is the best available guess for a separating axis
+            sep = n;
+            return false;
+            }
 
         // Second, check if origin is on plane (v2,v1,v3) and has been missed by other checks
         d = dot(v1 * tol_multiplier, n);
@@ -278,6 +306,30 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
 
         }
     }
+
+//! XenoCollide overlap check in 3D without a candidate separating axis
+/*! \param sa Support function for shape A
+    \param sb Support function for shape B
+    \param ab_t Vector pointing from a's center to b's center, in frame A
+    \param q Orientation of shape B in frame A
+    \param R Approximate radius of Minkowski difference for scaling tolerance value
+    \param err_count Error counter to increment whenever an infinite loop is encountered
+    \returns true when the two shapes overlap and false when they are disjoint.
+
+    \ingroup minkowski
+*/
+template<class SupportFuncA, class SupportFuncB>
+DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
+                                  const SupportFuncB& sb,
+                                  const vec3<OverlapReal>& ab_t,
+                                  const quat<OverlapReal>& q,
+                                  const OverlapReal R,
+                                  unsigned int& err_count)
+    {
+    vec3<OverlapReal> sep(0,0,0);
+    return xenocollide_3d(sa, sb, ab_t, q, R, err_count, sep);
+    }
+
 } // end namespace hpmc::detail
 
 }; // end namespace hpmc
@@ -20,6 +20,9 @@ The following quantities are provided by the integrator for use in HOOMD-blue's
 - ``hpmc_a`` - Maximum rotation move
 - ``hpmc_move_ratio`` - Probability of making a translation move (1- P(rotate move))
 - ``hpmc_overlap_count`` - Count of the number of particle-particle overlaps in the current system configuration
+- ``hpmc_decorrelation_rate`` - Mean square displacement in units of the largest particle diameter squared, per CPU
+  hour spent in trial moves on all ranks and threads since the quantity was first logged. Compare it between
+  integrators to find the one that decorrelates a system at the lowest cost.
 
 With non-interacting depletant (**implicit=True**), the following log quantities are available:
 
@@ -36,6 +39,12 @@ With patch energies defined, the following quantities are available:
 - ``hpmc_patch_energy`` - The potential energy of the system resulting from the patch interaction.
 - ``hpmc_patch_rcut`` - The cutoff radius in the patch energy interaction.
 
+With the event-chain integrators (**event_chain=True**), the following quantities are available:
+
+- ``hpmc_chain_collisions`` - Average number of collisions per event chain (averaged only over the last time step)
+- ``hpmc_chain_displacement`` - Average displacement of the particles per event chain (averaged only over the last
+  time step)
+
 :py:class:`compute.free_volume` provides the following loggable quantities:
 - ``hpmc_free_volume`` - The free volume estimate in the simulation box obtained by MC sampling (in volume units)
 
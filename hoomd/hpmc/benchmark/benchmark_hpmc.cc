@@ -0,0 +1,91 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file benchmark_hpmc.cc
+    \brief Benchmarks of the HPMC trial move sweep
+    \ingroup benchmarks
+*/
+
+#include "hoomd/benchmark/BenchmarkSuite.h"
+#include "hoomd/benchmark/BenchmarkSystems.h"
+
+#include "hoomd/hpmc/IntegratorHPMCMono.h"
+#include "hoomd/hpmc/ShapeSphere.h"
+#include "hoomd/hpmc/ShapeConvexPolyhedron.h"
+#include "hoomd/SystemDefinition.h"
+
+using namespace std;
+using namespace hpmc;
+using namespace hpmc::detail;
+
+//! Benchmark a sweep of hard sphere trial moves
+void benchmark_hard_spheres(BenchmarkSuite& suite)
+    {
+    if (!suite.isSelected("hard_spheres", "IntegratorHPMCMono<ShapeSphere>::update"))
+        return;
+
+    // the lattice spacing of a dense fluid, jitter keeps particles from overlapping
+    unsigned int N = suite.scaled(64000);
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(make_lattice_snapshot(N, Scalar(0.86), Scalar(0.02), 3),
+                                                                  suite.getExecConf()));
+
+    std::shared_ptr< IntegratorHPMCMono<ShapeSphere> > mc(new IntegratorHPMCMono<ShapeSphere>(sysdef, 12345));
+    sph_params params;
+    params.radius = OverlapReal(0.5);
+    params.ignore = 0;
+    params.isOriented = false;
+    mc->setParam(0, params);
+    mc->setD(Scalar(0.1), 0);
+    mc->prepRun(0);
+
+    suite.run("hard_spheres", "IntegratorHPMCMono<ShapeSphere>::update", N, [&](unsigned int timestep)
+        {
+        mc->update(timestep);
+        });
+    }
+
+//! Benchmark a sweep of hard cube trial moves
+void benchmark_hard_cubes(BenchmarkSuite& suite)
+    {
+    if (!suite.isSelected("hard_cubes", "IntegratorHPMCMono<ShapeConvexPolyhedron>::update"))
+        return;
+
+    // a lattice spacing of 1.8 leaves room for the unit cubes to rotate freely
+    unsigned int N = suite.scaled(32000);
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(make_lattice_snapshot(N, Scalar(1.0/5.832), Scalar(0.0), 4),
+                                                                  suite.getExecConf()));
+
+    poly3d_verts verts(8, false);
+    for (unsigned int i = 0; i < 8; i++)
+        {
+        verts.x[i] = (i & 1) ? OverlapReal(0.5) : OverlapReal(-0.5);
+        verts.y[i] = (i & 2) ? OverlapReal(0.5) : OverlapReal(-0.5);
+        verts.z[i] = (i & 4) ? OverlapReal(0.5) : OverlapReal(-0.5);
+        }
+    verts.diameter = OverlapReal(sqrt(3.0));
+    verts.sweep_radius = OverlapReal(0.0);
+    verts.ignore = 0;
+
+    std::shared_ptr< IntegratorHPMCMono<ShapeConvexPolyhedron> > mc(
+        new IntegratorHPMCMono<ShapeConvexPolyhedron>(sysdef, 12345));
+    mc->setParam(0, verts);
+    mc->setD(Scalar(0.1), 0);
+    mc->setA(Scalar(0.1), 0);
+    mc->prepRun(0);
+
+    suite.run("hard_cubes", "IntegratorHPMCMono<ShapeConvexPolyhedron>::update", N, [&](unsigned int timestep)
+        {
+        mc->update(timestep);
+        });
+    }
+
+int main(int argc, char **argv)
+    {
+    BenchmarkSuite suite(argc, argv, "hpmc");
+
+    benchmark_hard_spheres(suite);
+    benchmark_hard_cubes(suite);
+
+    return suite.finish();
+    }
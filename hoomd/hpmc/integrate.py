@@ -202,6 +202,7 @@ class mode_hpmc(_integrator):
         _integrator.__init__(self);
         self.implicit=implicit
         self.depletant_mode=depletant_mode
+        self.event_chain=False
 
         # setup the shape parameters
         self.shape_param = data.param_dict(self); # must call initialize_shape_params() after the cpp_integrator is created.
@@ -391,7 +392,11 @@ class mode_hpmc(_integrator):
                    nR=None,
                    depletant_type=None,
                    ntrial=None,
-                   deterministic=None):
+                   deterministic=None,
+                   checkerboard=None,
+                   chain_length=None,
+                   incremental_tree=None,
+                   separating_axis_cache=None):
         R""" Changes parameters of an existing integration mode.
 
         Args:
@@ -404,6 +409,16 @@ class mode_hpmc(_integrator):
             ntrial (int): (if set) **Implicit depletants only**: Number of re-insertion attempts per overlapping depletant.
                 (Only supported with **depletant_mode='circumsphere'**)
             deterministic (bool): (if set) Make HPMC integration deterministic on the GPU by sorting the cell list.
+            checkerboard (bool): (if set) Move the particles in a checkerboard of independent cells on the CPU, using
+                multiple threads. Only supported without implicit depletants and external fields, and only used with
+                more than one thread. Moves that leave the cell of the particle are rejected.
+            chain_length (float): (if set) **Event chains only**: Total displacement of one event chain.
+            incremental_tree (bool): (if set) Keep the bounding volume tree of the particles between steps and update it
+                in place, rebuilding it only when the particle order changes or the tree has degraded. This saves the
+                rebuild on every step in simulations without domain decomposition.
+            separating_axis_cache (bool): (if set) Remember the axis that separated each pair of particles in its last
+                overlap check, and check it first in the next one. Only supported for **convex_polyhedron** and
+                **convex_spheropolyhedron** on the CPU, and only used when the particles are swept in a single thread.
 
         .. note:: Simulations are only deterministic with respect to the same execution configuration (CPU or GPU) and
                   number of MPI ranks. Simulation output will not be identical if either of these is changed.
@@ -458,6 +473,24 @@ class mode_hpmc(_integrator):
         if deterministic is not None:
             self.cpp_integrator.setDeterministic(deterministic);
 
+        if checkerboard is not None:
+            if self.implicit or hoomd.context.exec_conf.isCUDAEnabled():
+                hoomd.context.msg.warning("The checkerboard sweep is only supported on the CPU without implicit depletants. Ignoring.\n")
+            else:
+                self.cpp_integrator.setCheckerboard(checkerboard);
+
+        if chain_length is not None:
+            if self.event_chain:
+                self.cpp_integrator.setChainLength(chain_length);
+            else:
+                hoomd.context.msg.warning("chain_length is only supported with event_chain=True. Ignoring.\n")
+
+        if incremental_tree is not None:
+            self.cpp_integrator.setIncrementalAABBTree(incremental_tree);
+
+        if separating_axis_cache is not None:
+            self.cpp_integrator.setSeparatingAxisCache(separating_axis_cache);
+
     def map_overlaps(self):
         R""" Build an overlap map of the system
 
@@ -754,9 +787,18 @@ class sphere(mode_hpmc):
             (added in version 2.2)
         restore_state(bool): Restore internal state from initialization file when True. See :py:class:`mode_hpmc`
                              for a description of what state data restored. (added in version 2.2)
+        event_chain (bool): Move the spheres in event chains instead of single particle trial moves (CPU only).
+        chain_length (float, only with **event_chain=True**): Total displacement of one event chain.
 
     Hard particle Monte Carlo integration method for spheres.
 
+    With **event_chain=True**, every translation move is an event chain: a sphere moves along a random box axis until
+    it collides with another sphere, which then continues the move, until the displacements add up to *chain_length*.
+    The moves are always accepted, and *d* is not used. Rotation moves of orientable spheres are made as usual.
+    In MPI simulations, chains end where they would move a particle into the ghost layer of a domain, or continue
+    with a particle of another domain. Event chains do not support implicit depletants, patch energies, and external
+    fields.
+
     Sphere parameters:
 
     * *diameter* (**required**) - diameter of the sphere (distance units)
@@ -781,17 +823,30 @@ class sphere(mode_hpmc):
         mc.set_params(nselect=8,nR=3,depletant_type='B')
         mc.shape_param.set('A', diameter=1.0)
         mc.shape_param.set('B', diameter=.1)
+
+    Event chain Example::
+
+        mc = hpmc.integrate.sphere(seed=415236, event_chain=True, chain_length=2.0)
+        mc.shape_param.set('A', diameter=1.0)
     """
 
-    def __init__(self, seed, d=0.1, a=0.1, move_ratio=0.5, nselect=4, implicit=False, depletant_mode='circumsphere',restore_state=False):
+    def __init__(self, seed, d=0.1, a=0.1, move_ratio=0.5, nselect=4, implicit=False, depletant_mode='circumsphere',restore_state=False, event_chain=False, chain_length=1.0):
         hoomd.util.print_status_line();
 
         # initialize base class
         mode_hpmc.__init__(self,implicit, depletant_mode);
 
+        if event_chain and (implicit or hoomd.context.exec_conf.isCUDAEnabled()):
+            hoomd.context.msg.error("integrate.sphere: event_chain=True is only supported on the CPU without implicit depletants.\n");
+            raise RuntimeError('Error initializing integrate.sphere');
+
         # initialize the reflected c++ class
         if not hoomd.context.exec_conf.isCUDAEnabled():
-            if(implicit):
+            if event_chain:
+                self.cpp_integrator = _hpmc.IntegratorHPMCMonoEventChainSphere(hoomd.context.current.system_definition, seed);
+                self.cpp_integrator.setChainLength(chain_length);
+                self.event_chain = True
+            elif(implicit):
                 # In C++ mode circumsphere = 0 and mode overlap_regions = 1
                 if depletant_mode_circumsphere(depletant_mode):
                     self.cpp_integrator = _hpmc.IntegratorHPMCMonoImplicitSphere(hoomd.context.current.system_definition, seed, 0)
@@ -1310,6 +1365,12 @@ class convex_polyhedron(mode_hpmc):
         max_verts (int): Set the maximum number of vertices in a polyhedron. (deprecated in version 2.2)
         restore_state(bool): Restore internal state from initialization file when True. See :py:class:`mode_hpmc`
                              for a description of what state data restored. (added in version 2.2)
+        event_chain (bool): Make the translation moves in event chains instead of single particle trial moves (CPU only).
+        chain_length (float, only with **event_chain=True**): Total displacement of one event chain.
+
+    With **event_chain=True**, translation moves are event chains as in :py:class:`sphere`. The distance to the next
+    collision is found by bisection with an overlap test of the polyhedron swept along the move, and is accurate to
+    a small fraction of the circumsphere diameter. Rotation moves are made as usual.
 
     Convex polyhedron parameters:
 
@@ -1341,8 +1402,13 @@ class convex_polyhedron(mode_hpmc):
         mc.set_params(nselect=1,nR=3,depletant_type='B')
         mc.shape_param.set('A', vertices=[(0.5, 0.5, 0.5), (0.5, -0.5, -0.5), (-0.5, 0.5, -0.5), (-0.5, -0.5, 0.5)]);
         mc.shape_param.set('B', vertices=[(0.05, 0.05, 0.05), (0.05, -0.05, -0.05), (-0.05, 0.05, -0.05), (-0.05, -0.05, 0.05)]);
+
+    Event chain Example::
+
+        mc = hpmc.integrate.convex_polyhedron(seed=415236, a=0.4, event_chain=True, chain_length=2.0)
+        mc.shape_param.set('A', vertices=[(0.5, 0.5, 0.5), (0.5, -0.5, -0.5), (-0.5, 0.5, -0.5), (-0.5, -0.5, 0.5)]);
     """
-    def __init__(self, seed, d=0.1, a=0.1, move_ratio=0.5, nselect=4, implicit=False, depletant_mode='circumsphere', max_verts=None, restore_state=False):
+    def __init__(self, seed, d=0.1, a=0.1, move_ratio=0.5, nselect=4, implicit=False, depletant_mode='circumsphere', max_verts=None, restore_state=False, event_chain=False, chain_length=1.0):
         hoomd.util.print_status_line();
 
         if max_verts is not None:
@@ -1351,9 +1417,17 @@ class convex_polyhedron(mode_hpmc):
         # initialize base class
         mode_hpmc.__init__(self,implicit, depletant_mode);
 
+        if event_chain and (implicit or hoomd.context.exec_conf.isCUDAEnabled()):
+            hoomd.context.msg.error("integrate.convex_polyhedron: event_chain=True is only supported on the CPU without implicit depletants.\n");
+            raise RuntimeError('Error initializing integrate.convex_polyhedron');
+
         # initialize the reflected c++ class
         if not hoomd.context.exec_conf.isCUDAEnabled():
-            if(implicit):
+            if event_chain:
+                self.cpp_integrator = _hpmc.IntegratorHPMCMonoEventChainConvexPolyhedron(hoomd.context.current.system_definition, seed);
+                self.cpp_integrator.setChainLength(chain_length);
+                self.event_chain = True
+            elif(implicit):
                 # In C++ mode circumsphere = 0 and mode overlap_regions = 1
                 if depletant_mode_circumsphere(depletant_mode):
                     self.cpp_integrator = _hpmc.IntegratorHPMCMonoImplicitConvexPolyhedron(hoomd.context.current.system_definition, seed, 0);
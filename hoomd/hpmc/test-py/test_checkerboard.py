@@ -0,0 +1,62 @@
+from __future__ import print_function
+from __future__ import division
+from hoomd import *
+from hoomd import hpmc
+import unittest
+
+context.initialize()
+
+# tests for the checkerboard sweep of the CPU integrators
+class test_checkerboard(unittest.TestCase):
+    def test_spheres(self):
+        system = init.create_lattice(unitcell=lattice.sc(a=1.2), n=8)
+
+        mc = hpmc.integrate.sphere(seed=42, d=0.1)
+        mc.shape_param.set('A', diameter=1.0)
+        mc.set_params(checkerboard=True)
+
+        run(100)
+        self.assertEqual(mc.count_overlaps(), 0)
+        self.assertGreater(mc.get_translate_acceptance(), 0)
+
+    def test_polygons(self):
+        system = init.create_lattice(unitcell=lattice.sq(a=1.5), n=16)
+
+        mc = hpmc.integrate.convex_polygon(seed=42, d=0.1, a=0.1)
+        mc.shape_param.set('A', vertices=[(-0.5,-0.5), (0.5,-0.5), (0.5,0.5), (-0.5,0.5)])
+        mc.set_params(checkerboard=True)
+
+        run(100)
+        self.assertEqual(mc.count_overlaps(), 0)
+        self.assertGreater(mc.get_translate_acceptance(), 0)
+        self.assertGreater(mc.get_rotate_acceptance(), 0)
+
+    # moves that leave the cell are counted as rejected, so every trial move is counted
+    def test_counters(self):
+        system = init.create_lattice(unitcell=lattice.sc(a=1.2), n=8)
+
+        mc = hpmc.integrate.sphere(seed=42, d=0.5, nselect=1)
+        mc.shape_param.set('A', diameter=1.0)
+        mc.set_params(checkerboard=True)
+
+        run(10)
+        counters = mc.get_counters()
+        self.assertEqual(counters['translate_accept_count'] + counters['translate_reject_count'],
+                         10*len(system.particles))
+
+    # a box that fits less than two cells falls back to the serial sweep
+    def test_small_box(self):
+        system = init.create_lattice(unitcell=lattice.sc(a=1.2), n=1)
+
+        mc = hpmc.integrate.sphere(seed=42, d=0.1)
+        mc.shape_param.set('A', diameter=1.0)
+        mc.set_params(checkerboard=True)
+
+        run(10)
+        self.assertEqual(mc.count_overlaps(), 0)
+
+    def tearDown(self):
+        context.initialize();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
@@ -0,0 +1,59 @@
+from __future__ import print_function
+from __future__ import division
+from hoomd import *
+from hoomd import hpmc
+import unittest
+
+context.initialize()
+
+# tests for the event chain integrators
+class test_event_chain(unittest.TestCase):
+    def test_spheres(self):
+        system = init.create_lattice(unitcell=lattice.sc(a=1.2), n=8)
+        snap = system.take_snapshot()
+
+        mc = hpmc.integrate.sphere(seed=42, event_chain=True, chain_length=2.0)
+        mc.shape_param.set('A', diameter=1.0)
+
+        log = analyze.log(filename=None, quantities=['hpmc_chain_collisions', 'hpmc_chain_displacement',
+                                                     'hpmc_decorrelation_rate'], period=10)
+        run(100)
+        self.assertEqual(mc.count_overlaps(), 0)
+        self.assertGreater(log.query('hpmc_chain_collisions'), 0)
+        # chains are only truncated at domain boundaries
+        self.assertGreater(log.query('hpmc_chain_displacement'), 0)
+        self.assertLessEqual(log.query('hpmc_chain_displacement'), 2.0 + 1e-5)
+        self.assertGreater(log.query('hpmc_decorrelation_rate'), 0)
+
+        # the particles have moved
+        snap_new = system.take_snapshot()
+        if comm.get_rank() == 0:
+            moved = False
+            for r, r0 in zip(snap_new.particles.position, snap.particles.position):
+                if any(abs(r[k] - r0[k]) > 1e-3 for k in range(3)):
+                    moved = True
+            self.assertTrue(moved)
+
+    def test_polyhedra(self):
+        system = init.create_lattice(unitcell=lattice.sc(a=1.5), n=6)
+
+        mc = hpmc.integrate.convex_polyhedron(seed=42, a=0.1, event_chain=True)
+        mc.shape_param.set('A', vertices=[(-0.5,-0.5,-0.5), (-0.5,-0.5,0.5), (-0.5,0.5,-0.5), (-0.5,0.5,0.5),
+                                          (0.5,-0.5,-0.5), (0.5,-0.5,0.5), (0.5,0.5,-0.5), (0.5,0.5,0.5)])
+        mc.set_params(chain_length=1.5)
+
+        run(50)
+        self.assertEqual(mc.count_overlaps(), 0)
+        self.assertGreater(mc.get_rotate_acceptance(), 0)
+
+    def test_not_supported(self):
+        system = init.create_lattice(unitcell=lattice.sc(a=1.2), n=2)
+
+        with self.assertRaises(RuntimeError):
+            hpmc.integrate.sphere(seed=42, implicit=True, event_chain=True)
+
+    def tearDown(self):
+        context.initialize();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
@@ -0,0 +1,55 @@
+from __future__ import print_function
+from __future__ import division
+from hoomd import *
+from hoomd import hpmc
+import unittest
+
+context.initialize()
+
+cube = [(-0.5,-0.5,-0.5), (-0.5,-0.5,0.5), (-0.5,0.5,-0.5), (-0.5,0.5,0.5),
+        (0.5,-0.5,-0.5), (0.5,-0.5,0.5), (0.5,0.5,-0.5), (0.5,0.5,0.5)]
+
+# tests for the separating axis cache of the CPU integrators
+class test_separating_axis_cache(unittest.TestCase):
+    def test_polyhedra(self):
+        system = init.create_lattice(unitcell=lattice.sc(a=1.1), n=6)
+
+        mc = hpmc.integrate.convex_polyhedron(seed=42, d=0.05, a=0.05)
+        mc.shape_param.set('A', vertices=cube)
+        mc.set_params(separating_axis_cache=True)
+
+        run(100)
+        self.assertEqual(mc.count_overlaps(), 0)
+        self.assertGreater(mc.get_translate_acceptance(), 0)
+        self.assertGreater(mc.get_rotate_acceptance(), 0)
+
+        # the cache can be disabled again
+        mc.set_params(separating_axis_cache=False)
+        run(10)
+        self.assertEqual(mc.count_overlaps(), 0)
+
+    def test_spheropolyhedra(self):
+        system = init.create_lattice(unitcell=lattice.sc(a=1.3), n=6)
+
+        mc = hpmc.integrate.convex_spheropolyhedron(seed=42, d=0.05, a=0.05)
+        mc.shape_param.set('A', vertices=cube, sweep_radius=0.1)
+        mc.set_params(separating_axis_cache=True)
+
+        run(100)
+        self.assertEqual(mc.count_overlaps(), 0)
+        self.assertGreater(mc.get_translate_acceptance(), 0)
+
+    def test_not_supported(self):
+        system = init.create_lattice(unitcell=lattice.sc(a=1.2), n=2)
+
+        mc = hpmc.integrate.sphere(seed=42)
+        mc.shape_param.set('A', diameter=1.0)
+        if not context.current.on_gpu():
+            with self.assertRaises(RuntimeError):
+                mc.set_params(separating_axis_cache=True)
+
+    def tearDown(self):
+        context.initialize();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
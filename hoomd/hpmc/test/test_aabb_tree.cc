@@ -106,3 +106,64 @@ UP_TEST( bigger )
         UP_ASSERT(in(i, hits));
         }
     }
+
+UP_TEST( refit )
+    {
+    const unsigned int N = 1000;
+    hoomd::RandomGenerator rng(2);
+
+    std::vector< vec3<Scalar> > points(N);
+    AABB aabbs[N];
+    for (unsigned int i = 0; i < N; i++)
+        {
+        points[i] = vec3<Scalar>(hoomd::detail::generate_canonical<float>(rng),
+                                  hoomd::detail::generate_canonical<float>(rng),
+                                  hoomd::detail::generate_canonical<float>(rng))
+                                  * Scalar(100);
+        aabbs[i] = AABB(points[i], Scalar(1.0));
+        }
+
+    AABBTree tree;
+    tree.buildTree(aabbs, N);
+    UP_ASSERT_EQUAL(tree.getGrowth(), Scalar(1.0));
+
+    // small moves keep the tree quality, and all particles are found after the refit
+    for (unsigned int i = 0; i < N; i++)
+        {
+        points[i] += vec3<Scalar>(hoomd::detail::generate_canonical<float>(rng) - Scalar(0.5),
+                                  hoomd::detail::generate_canonical<float>(rng) - Scalar(0.5),
+                                  hoomd::detail::generate_canonical<float>(rng) - Scalar(0.5));
+        aabbs[i] = AABB(points[i], Scalar(1.0));
+        }
+    UP_ASSERT(tree.refit(aabbs, N, Scalar(1.5)));
+
+    std::vector<unsigned int> hits;
+    for (unsigned int i = 0; i < N; i++)
+        {
+        hits.clear();
+        tree.query(hits, AABB(points[i], Scalar(0.01)));
+        UP_ASSERT(in(i, hits));
+        }
+
+    // placing the particles anew degrades the tree, it remains valid but asks for a rebuild
+    for (unsigned int i = 0; i < N; i++)
+        {
+        points[i] = vec3<Scalar>(hoomd::detail::generate_canonical<float>(rng),
+                                 hoomd::detail::generate_canonical<float>(rng),
+                                 hoomd::detail::generate_canonical<float>(rng))
+                                 * Scalar(100);
+        aabbs[i] = AABB(points[i], Scalar(1.0));
+        }
+    UP_ASSERT(!tree.refit(aabbs, N, Scalar(1.5)));
+    UP_ASSERT(tree.getGrowth() > Scalar(1.5));
+
+    for (unsigned int i = 0; i < N; i++)
+        {
+        hits.clear();
+        tree.query(hits, AABB(points[i], Scalar(0.01)));
+        UP_ASSERT(in(i, hits));
+        }
+
+    // a different number of particles cannot be refit
+    UP_ASSERT(!tree.refit(aabbs, N-1, Scalar(1.5)));
+    }
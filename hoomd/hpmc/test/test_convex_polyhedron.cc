@@ -113,6 +113,43 @@ UP_TEST( support )
     UP_ASSERT(v1 == v2);
     }
 
+UP_TEST( support_many_verts )
+    {
+    // check the vectorized support function against a serial search for vertex counts
+    // that do not fill all SIMD lanes
+    unsigned int n_verts[] = {5, 13, 37, 64, 100};
+    const OverlapReal golden_angle = M_PI*(OverlapReal(3.0) - sqrt(OverlapReal(5.0)));
+
+    for (unsigned int k = 0; k < 5; k++)
+        {
+        // distribute the vertices on a sphere
+        vector< vec3<OverlapReal> > vlist;
+        for (unsigned int i = 0; i < n_verts[k]; i++)
+            {
+            OverlapReal z = OverlapReal(1.0) - OverlapReal(2*i+1)/OverlapReal(n_verts[k]);
+            OverlapReal r = sqrt(OverlapReal(1.0) - z*z);
+            vlist.push_back(vec3<OverlapReal>(r*cos(golden_angle*i), r*sin(golden_angle*i), z));
+            }
+        poly3d_verts verts = setup_verts(vlist);
+        SupportFuncConvexPolyhedron sa = SupportFuncConvexPolyhedron(verts);
+
+        for (unsigned int j = 0; j < 100; j++)
+            {
+            vec3<OverlapReal> n(cos(OverlapReal(0.1)*j), sin(OverlapReal(0.37)*j), cos(OverlapReal(0.73)*j+OverlapReal(0.5)));
+
+            unsigned int max_idx = 0;
+            for (unsigned int i = 1; i < vlist.size(); i++)
+                {
+                if (dot(n, vlist[i]) > dot(n, vlist[max_idx]))
+                    max_idx = i;
+                }
+
+            vec3<OverlapReal> v = sa(n);
+            MY_CHECK_CLOSE(dot(n, v), dot(n, vlist[max_idx]), tol);
+            }
+        }
+    }
+
 /*! Not sure how best to test this because not sure what a valid support has to be...
 UP_TEST( composite_support )
     {
@@ -620,3 +657,66 @@ UP_TEST( overlap_cube_rot3 )
     UP_ASSERT(test_overlap(-r_ij,b,a,err_count));
 
     }
+
+UP_TEST( overlap_separating_axis )
+    {
+    // overlap checks of two cubes that start from a separating axis
+    quat<Scalar> o;
+    vec3<OverlapReal> axis(0,0,0);
+
+    vector< vec3<OverlapReal> > vlist;
+    vlist.push_back(vec3<OverlapReal>(-0.5,-0.5,-0.5));
+    vlist.push_back(vec3<OverlapReal>(0.5,-0.5,-0.5));
+    vlist.push_back(vec3<OverlapReal>(0.5,0.5,-0.5));
+    vlist.push_back(vec3<OverlapReal>(-0.5,0.5,-0.5));
+    vlist.push_back(vec3<OverlapReal>(-0.5,-0.5,0.5));
+    vlist.push_back(vec3<OverlapReal>(0.5,-0.5,0.5));
+    vlist.push_back(vec3<OverlapReal>(0.5,0.5,0.5));
+    vlist.push_back(vec3<OverlapReal>(-0.5,0.5,0.5));
+    poly3d_verts verts = setup_verts(vlist);
+
+    ShapeConvexPolyhedron a(o, verts);
+    quat<Scalar> o_b(1.0, vec3<Scalar>(0.05, 0.0, 0.02));
+    o_b = o_b * (Scalar)(Scalar(1.0) / sqrt(norm2(o_b)));
+    ShapeConvexPolyhedron b(o_b, verts);
+
+    UP_ASSERT(detail::SeparatingAxisTraits<ShapeConvexPolyhedron>::supported);
+
+    // without an axis, a separating axis is returned for disjoint shapes
+    vec3<Scalar> r_ij(1.2,0.1,0);
+    UP_ASSERT(!test_overlap(r_ij,a,b,err_count,axis));
+    UP_ASSERT(dot(axis,axis) > 0);
+    // the Minkowski difference b-a lies on the negative side of the axis
+    UP_ASSERT(dot(axis, vec3<OverlapReal>(r_ij)) < 0);
+
+    // after a small move, the axis still separates the shapes and is kept
+    vec3<OverlapReal> axis_old = axis;
+    r_ij = vec3<Scalar>(1.18,0.12,0.01);
+    UP_ASSERT(!test_overlap(r_ij,a,b,err_count,axis));
+    UP_ASSERT(axis == axis_old);
+
+    // a stale axis does not hide an overlap
+    r_ij = vec3<Scalar>(0.9,0.1,0);
+    UP_ASSERT(test_overlap(r_ij,a,b,err_count,axis));
+
+    // an axis that does not separate the shapes is replaced
+    axis = vec3<OverlapReal>(0,1,0);
+    r_ij = vec3<Scalar>(-1.2,0.1,0);
+    UP_ASSERT(!test_overlap(r_ij,a,b,err_count,axis));
+    UP_ASSERT(dot(axis, vec3<OverlapReal>(r_ij)) < 0);
+
+    // the cache returns the axis for both orders of the pair
+    SeparatingAxisCache cache;
+    cache.reserve(10);
+    UP_ASSERT_EQUAL(cache.getSize(), (unsigned int)128);
+    vec3<OverlapReal> none = cache.find(3,7);
+    UP_ASSERT(dot(none,none) == 0);
+
+    cache.insert(7,3,axis);
+    UP_ASSERT(cache.find(7,3) == axis);
+    UP_ASSERT(cache.find(3,7) == -axis);
+
+    cache.clear();
+    none = cache.find(7,3);
+    UP_ASSERT(dot(none,none) == 0);
+    }
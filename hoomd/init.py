@@ -250,7 +250,7 @@ def read_snapshot(snapshot):
     _perform_common_init_tasks();
     return hoomd.data.system_data(hoomd.context.current.system_definition);
 
-def read_gsd(filename, restart = None, frame = 0, time_step = None):
+def read_gsd(filename, restart = None, frame = 0, time_step = None, distributed = False):
     R""" Read initial system state from an GSD file.
 
     Args:
@@ -258,6 +258,8 @@ def read_gsd(filename, restart = None, frame = 0, time_step = None):
         restart (str): If it exists, read the file *restart* instead of *filename*.
         frame (int): Index of the frame to read from the GSD file. Negative values index from the end of the file.
         time_step (int): (if specified) Time step number to initialize instead of the one stored in the GSD file.
+        distributed (bool): When True, every MPI rank reads the particles in its own domain directly from the file.
+                            Has no effect in serial simulations. (added in version 2.10)
 
     All particles, bonds, angles, dihedrals, impropers, constraints, and box information
     are read from the given GSD file at the given frame index. To read and write GSD files
@@ -270,6 +272,11 @@ def read_gsd(filename, restart = None, frame = 0, time_step = None):
     step of the simulation instead of the one read from the GSD file *filename*.
     *time_step* is not applied when the file *restart* is read.
 
+    The GSD file is memory mapped. By default, the root rank reads the whole frame and distributes the particles to
+    the other ranks. With ``distributed=True``, each rank instead copies only the particles that fall into its domain
+    out of the file, which reduces the time and the memory needed on the root rank to restart large simulations. The
+    file must be readable from all ranks.
+
     The result of :py:func:`hoomd.init.read_gsd` can be saved in a variable and later used to read and/or
     change particle properties later in the script. See :py:mod:`hoomd.data` for more information.
 
@@ -287,11 +294,14 @@ def read_gsd(filename, restart = None, frame = 0, time_step = None):
     filename = _hoomd.mpi_bcast_str(filename, hoomd.context.exec_conf);
     restart = _hoomd.mpi_bcast_str(restart, hoomd.context.exec_conf);
 
+    # only read particles on all ranks when there is a domain decomposition
+    distributed = distributed and hoomd.comm.get_num_ranks() > 1;
+
     if restart is not None and os.path.exists(restart):
-        reader = _hoomd.GSDReader(hoomd.context.exec_conf, restart, abs(frame), frame < 0);
+        reader = _hoomd.GSDReader(hoomd.context.exec_conf, restart, abs(frame), frame < 0, distributed);
         time_step = reader.getTimeStep();
     else:
-        reader = _hoomd.GSDReader(hoomd.context.exec_conf, filename, abs(frame), frame < 0);
+        reader = _hoomd.GSDReader(hoomd.context.exec_conf, filename, abs(frame), frame < 0, distributed);
         if time_step is None:
             time_step = reader.getTimeStep();
 
@@ -306,6 +316,10 @@ def read_gsd(filename, restart = None, frame = 0, time_step = None):
     else:
         hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf);
 
+    # the snapshot holds no particles in distributed mode, every rank reads its own
+    if distributed:
+        reader.initializeDistributed(hoomd.context.current.system_definition);
+
     # initialize the system
     hoomd.context.current.system = _hoomd.System(hoomd.context.current.system_definition, time_step);
 
@@ -13,6 +13,10 @@
 
 #include "hoomd/HOOMDMath.h"
 
+#ifndef NVCC
+#include "PairSIMD.h"
+#endif
+
 /*! \file EvaluatorPairGauss.h
     \brief Defines the pair evaluator class for Gaussian potentials
 */
@@ -106,6 +110,44 @@ class EvaluatorPairGauss
                 return false;
             }
 
+        #ifdef ENABLE_PAIR_SIMD
+        //! Evaluate the force and energy for pair_simd::width pairs at once
+        /*! \param rsq Squared distances between the particles
+            \param rcutsq Squared cutoff distances
+            \param params Per type pair parameters of this potential
+            \param typpair Type pair index of every lane
+            \param energy_shift If true, the potential must be shifted so that V(r) is continuous at the cutoff
+            \param force_divr Output parameter to write the computed forces divided by r
+            \param pair_eng Output parameter to write the computed pair energies
+            \return The mask of lanes that are evaluated
+        */
+        static pair_simd::vmask evalForceAndEnergySIMD(const pair_simd::vreal& rsq,
+                                                       const pair_simd::vreal& rcutsq,
+                                                       const param_type *params,
+                                                       const int *typpair,
+                                                       bool energy_shift,
+                                                       pair_simd::vreal& force_divr,
+                                                       pair_simd::vreal& pair_eng)
+            {
+            using namespace pair_simd;
+            const vreal epsilon = gather_param(params, typpair, 0);
+            const vreal sigma = gather_param(params, typpair, 1);
+
+            vreal sigma_sq = sigma*sigma;
+            vreal r_over_sigma_sq = rsq / sigma_sq;
+            vreal exp_val = exp(-set1(Scalar(1.0)/Scalar(2.0)) * r_over_sigma_sq);
+
+            force_divr = epsilon / sigma_sq * exp_val;
+            pair_eng = epsilon * exp_val;
+
+            if (energy_shift)
+                {
+                pair_eng -= epsilon * exp(-set1(Scalar(1.0)/Scalar(2.0)) * rcutsq / sigma_sq);
+                }
+            return rsq < rcutsq;
+            }
+        #endif
+
         #ifndef NVCC
         //! Get the name of this potential
         /*! \returns The potential name. Must be short and all lowercase, as this is the name energies will be logged as
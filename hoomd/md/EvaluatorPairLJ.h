@@ -13,6 +13,10 @@
 
 #include "hoomd/HOOMDMath.h"
 
+#ifndef NVCC
+#include "PairSIMD.h"
+#endif
+
 /*! \file EvaluatorPairLJ.h
     \brief Defines the pair evaluator class for LJ potentials
     \details As the prototypical example of a MD pair potential, this also serves as the primary documentation and
@@ -157,6 +161,43 @@ class EvaluatorPairLJ
                 return false;
             }
 
+        #ifdef ENABLE_PAIR_SIMD
+        //! Evaluate the force and energy for pair_simd::width pairs at once
+        /*! \param rsq Squared distances between the particles
+            \param rcutsq Squared cutoff distances
+            \param params Per type pair parameters of this potential
+            \param typpair Type pair index of every lane
+            \param energy_shift If true, the potential must be shifted so that V(r) is continuous at the cutoff
+            \param force_divr Output parameter to write the computed forces divided by r
+            \param pair_eng Output parameter to write the computed pair energies
+            \return The mask of lanes that are evaluated
+        */
+        static pair_simd::vmask evalForceAndEnergySIMD(const pair_simd::vreal& rsq,
+                                                       const pair_simd::vreal& rcutsq,
+                                                       const param_type *params,
+                                                       const int *typpair,
+                                                       bool energy_shift,
+                                                       pair_simd::vreal& force_divr,
+                                                       pair_simd::vreal& pair_eng)
+            {
+            using namespace pair_simd;
+            const vreal lj1 = gather_param(params, typpair, 0);
+            const vreal lj2 = gather_param(params, typpair, 1);
+
+            vreal r2inv = set1(Scalar(1.0))/rsq;
+            vreal r6inv = r2inv * r2inv * r2inv;
+            force_divr = r2inv * r6inv * (set1(Scalar(12.0))*lj1*r6inv - set1(Scalar(6.0))*lj2);
+            pair_eng = r6inv * (lj1*r6inv - lj2);
+            if (energy_shift)
+                {
+                vreal rcut2inv = set1(Scalar(1.0))/rcutsq;
+                vreal rcut6inv = rcut2inv * rcut2inv * rcut2inv;
+                pair_eng -= rcut6inv * (lj1*rcut6inv - lj2);
+                }
+            return (rsq < rcutsq) & (lj1 != set1(Scalar(0.0)));
+            }
+        #endif
+
         #ifndef NVCC
         //! Get the name of this potential
         /*! \returns The potential name. Must be short and all lowercase, as this is the name energies will be logged as
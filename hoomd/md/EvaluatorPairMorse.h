@@ -13,6 +13,10 @@
 
 #include "hoomd/HOOMDMath.h"
 
+#ifndef NVCC
+#include "PairSIMD.h"
+#endif
+
 /*! \file EvaluatorPairMorse.h
     \brief Defines the pair evaluator class for Morse potential
 */
@@ -105,6 +109,46 @@ class EvaluatorPairMorse
                 return false;
             }
 
+        #ifdef ENABLE_PAIR_SIMD
+        //! Evaluate the force and energy for pair_simd::width pairs at once
+        /*! \param rsq Squared distances between the particles
+            \param rcutsq Squared cutoff distances
+            \param params Per type pair parameters of this potential
+            \param typpair Type pair index of every lane
+            \param energy_shift If true, the potential must be shifted so that V(r) is continuous at the cutoff
+            \param force_divr Output parameter to write the computed forces divided by r
+            \param pair_eng Output parameter to write the computed pair energies
+            \return The mask of lanes that are evaluated
+        */
+        static pair_simd::vmask evalForceAndEnergySIMD(const pair_simd::vreal& rsq,
+                                                       const pair_simd::vreal& rcutsq,
+                                                       const param_type *params,
+                                                       const int *typpair,
+                                                       bool energy_shift,
+                                                       pair_simd::vreal& force_divr,
+                                                       pair_simd::vreal& pair_eng)
+            {
+            using namespace pair_simd;
+            const vreal D0 = gather_param(params, typpair, 0);
+            const vreal alpha = gather_param(params, typpair, 1);
+            const vreal r0 = gather_param(params, typpair, 2);
+
+            vreal r = sqrt(rsq);
+            vreal Exp_factor = exp(-alpha*(r-r0));
+
+            pair_eng = D0 * Exp_factor * (Exp_factor - set1(Scalar(2.0)));
+            force_divr = set1(Scalar(2.0)) * D0 * alpha * Exp_factor * (Exp_factor - set1(Scalar(1.0))) / r;
+
+            if (energy_shift)
+                {
+                vreal rcut = sqrt(rcutsq);
+                vreal Exp_factor_cut = exp(-alpha*(rcut-r0));
+                pair_eng -= D0 * Exp_factor_cut * (Exp_factor_cut - set1(Scalar(2.0)));
+                }
+            return rsq < rcutsq;
+            }
+        #endif
+
         #ifndef NVCC
         //! Get the name of this potential
         /*! \returns The potential name. Must be short and all lowercase, as this is the name energies will be logged as
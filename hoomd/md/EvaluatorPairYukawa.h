@@ -13,6 +13,10 @@
 
 #include "hoomd/HOOMDMath.h"
 
+#ifndef NVCC
+#include "PairSIMD.h"
+#endif
+
 /*! \file EvaluatorPairYukawa.h
     \brief Defines the pair evaluator class for Yukawa potentials
 */
@@ -110,6 +114,48 @@ class EvaluatorPairYukawa
                 return false;
             }
 
+        #ifdef ENABLE_PAIR_SIMD
+        //! Evaluate the force and energy for pair_simd::width pairs at once
+        /*! \param rsq Squared distances between the particles
+            \param rcutsq Squared cutoff distances
+            \param params Per type pair parameters of this potential
+            \param typpair Type pair index of every lane
+            \param energy_shift If true, the potential must be shifted so that V(r) is continuous at the cutoff
+            \param force_divr Output parameter to write the computed forces divided by r
+            \param pair_eng Output parameter to write the computed pair energies
+            \return The mask of lanes that are evaluated
+        */
+        static pair_simd::vmask evalForceAndEnergySIMD(const pair_simd::vreal& rsq,
+                                                       const pair_simd::vreal& rcutsq,
+                                                       const param_type *params,
+                                                       const int *typpair,
+                                                       bool energy_shift,
+                                                       pair_simd::vreal& force_divr,
+                                                       pair_simd::vreal& pair_eng)
+            {
+            using namespace pair_simd;
+            const vreal epsilon = gather_param(params, typpair, 0);
+            const vreal kappa = gather_param(params, typpair, 1);
+
+            vreal r = sqrt(rsq);
+            vreal rinv = set1(Scalar(1.0)) / r;
+            vreal r2inv = set1(Scalar(1.0)) / rsq;
+
+            vreal exp_val = exp(-kappa * r);
+
+            force_divr = epsilon * exp_val * r2inv * (rinv + kappa);
+            pair_eng = epsilon * exp_val * rinv;
+
+            if (energy_shift)
+                {
+                vreal rcut = sqrt(rcutsq);
+                vreal rcutinv = set1(Scalar(1.0)) / rcut;
+                pair_eng -= epsilon * exp(-kappa * rcut) * rcutinv;
+                }
+            return (rsq < rcutsq) & (epsilon != set1(Scalar(0.0)));
+            }
+        #endif
+
         #ifndef NVCC
         //! Get the name of this potential
         /*! \returns The potential name. Must be short and all lowercase, as this is the name energies will be logged as
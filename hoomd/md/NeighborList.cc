@@ -16,6 +16,10 @@ namespace py = pybind11;
 #include <iostream>
 #include <stdexcept>
 
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
 using namespace std;
 
 /*! \file NeighborList.cc
@@ -1399,7 +1403,7 @@ void NeighborList::updateExListIdx()
     ArrayHandle<unsigned int> h_ex_list_idx(m_ex_list_idx, access_location::host, access_mode::overwrite);
 
     // translate the number and exclusions from one array to the other
-    for (unsigned int idx = 0; idx < m_pdata->getN(); idx++)
+    auto translate_exclusions = [&](unsigned int idx)
         {
         // get the tag for this index
         unsigned int tag = h_tag.data[idx];
@@ -1417,6 +1421,23 @@ void NeighborList::updateExListIdx()
             // store excluded particle idx
             h_ex_list_idx.data[m_ex_list_indexer(idx, offset)] = ex_idx;
             }
+        };
+
+    #ifdef ENABLE_TBB
+    if (m_exec_conf->getNumThreads() > 1)
+        {
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, m_pdata->getN()),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int idx = r.begin(); idx != r.end(); ++idx)
+                translate_exclusions(idx);
+            });
+        }
+    else
+    #endif
+        {
+        for (unsigned int idx = 0; idx < m_pdata->getN(); idx++)
+            translate_exclusions(idx);
         }
 
     if (m_prof)
@@ -1438,7 +1459,7 @@ void NeighborList::filterNlist()
     ArrayHandle<unsigned int> h_nlist(m_nlist, access_location::host, access_mode::readwrite);
 
     // for each particle's neighbor list
-    for (unsigned int idx = 0; idx < m_pdata->getN(); idx++)
+    auto filter_particle = [&](unsigned int idx)
         {
         unsigned int myHead = h_head_list.data[idx];
         unsigned int n_neigh = h_n_neigh.data[idx];
@@ -1472,6 +1493,23 @@ void NeighborList::filterNlist()
 
         // update the number of neighbors
         h_n_neigh.data[idx] = new_n_neigh;
+        };
+
+    #ifdef ENABLE_TBB
+    if (m_exec_conf->getNumThreads() > 1)
+        {
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, m_pdata->getN()),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int idx = r.begin(); idx != r.end(); ++idx)
+                filter_particle(idx);
+            });
+        }
+    else
+    #endif
+        {
+        for (unsigned int idx = 0; idx < m_pdata->getN(); idx++)
+            filter_particle(idx);
         }
 
     if (m_prof)
@@ -1535,6 +1573,26 @@ void NeighborList::resizeNlist(unsigned int size)
         }
     }
 
+/*! \param h_pos Particle positions and types
+    \param h_n_neigh Number of neighbors found per particle (may exceed the allocated size)
+    \param h_Nmax Allocated neighbors per particle type
+    \param h_conditions Overflow flags per particle type
+
+    The CPU builds count all neighbors, even those that do not fit into the allocated list. The overflow flags are
+    derived from these counts after the build so that the (possibly threaded) build loops do not need to write to
+    shared memory.
+*/
+void NeighborList::flagOverflow(const Scalar4 *h_pos, const unsigned int *h_n_neigh, const unsigned int *h_Nmax,
+    unsigned int *h_conditions)
+    {
+    for (unsigned int i = 0; i < m_pdata->getN(); ++i)
+        {
+        const unsigned int type_i = __scalar_as_int(h_pos[i].w);
+        if (h_n_neigh[i] > h_Nmax[type_i])
+            h_conditions[type_i] = max(h_conditions[type_i], h_n_neigh[i]);
+        }
+    }
+
 /*!
  * \returns true if an overflow is detected for any particle type
  * \returns false if all particle types have enough memory for their neighbors
@@ -441,6 +441,18 @@ class PYBIND11_EXPORT NeighborList : public Compute
         /*! \param timestep The current timestep
          */
         bool peekUpdate(unsigned int timestep);
+
+        //! Returns true if compute() will not rebuild the neighbor list at this time step
+        /*! The neighbor list is current when the rebuild check of \a timestep has already been done (for example by
+         *  peekUpdate() during communication) and found that no rebuild is needed. Only then the list can be used
+         *  before the ghost positions are updated.
+         *  \param timestep The current timestep
+         */
+        bool isCurrent(unsigned int timestep) const
+            {
+            return m_has_been_updated_once && m_last_checked_tstep == timestep && !m_last_check_result
+                && !m_force_update && !m_rcut_changed;
+            }
 #endif
 
         //! Return true if the neighbor list has been updated this time step
@@ -517,6 +529,10 @@ class PYBIND11_EXPORT NeighborList : public Compute
         //! Build the head list to allocated memory
         virtual void buildHeadList();
 
+        //! Set the overflow conditions from the neighbor counts of a finished build
+        void flagOverflow(const Scalar4 *h_pos, const unsigned int *h_n_neigh, const unsigned int *h_Nmax,
+            unsigned int *h_conditions);
+
         //! Amortized resizing of the neighborlist
         void resizeNlist(unsigned int size);
 
@@ -14,6 +14,10 @@
 #include "hoomd/Communicator.h"
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
 
 using namespace std;
 namespace py = pybind11;
@@ -133,7 +137,7 @@ void NeighborListBinned::buildNlist(unsigned int timestep)
     // for each local particle
     unsigned int nparticles = m_pdata->getN();
 
-    for (int i = 0; i < (int)nparticles; i++)
+    auto build_particle = [&](unsigned int i)
         {
         unsigned int cur_n_neigh = 0;
 
@@ -182,7 +186,7 @@ void NeighborListBinned::buildNlist(unsigned int timestep)
                 // (1) they are the same particle, or
                 // (2) the r_cut(i,j) indicates to skip, or
                 // (3) they are in the same body
-                bool excluded = ((i == (int)cur_neigh) || (r_cut <= Scalar(0.0)));
+                bool excluded = ((i == cur_neigh) || (r_cut <= Scalar(0.0)));
                 if (m_filter_body && body_i != NO_BODY)
                     excluded = excluded | (body_i == h_body.data[cur_neigh]);
                 if (excluded)
@@ -208,15 +212,13 @@ void NeighborListBinned::buildNlist(unsigned int timestep)
                 Scalar r_listsq = h_r_listsq.data[m_typpair_idx(type_i,cur_neigh_type)];
                 if (dr_sq <= (r_listsq + sqshift) && !excluded)
                     {
-                    if (m_storage_mode == full || i < (int)cur_neigh)
+                    if (m_storage_mode == full || i < cur_neigh)
                         {
                         // local neighbor
                         if (cur_n_neigh < Nmax_i)
                             {
                             h_nlist.data[head_idx_i + cur_n_neigh] = cur_neigh;
                             }
-                        else
-                            h_conditions.data[type_i] = max(h_conditions.data[type_i], cur_n_neigh+1);
 
                         cur_n_neigh++;
                         }
@@ -225,8 +227,28 @@ void NeighborListBinned::buildNlist(unsigned int timestep)
             }
 
         h_n_neigh.data[i] = cur_n_neigh;
+        };
+
+    #ifdef ENABLE_TBB
+    if (m_exec_conf->getNumThreads() > 1)
+        {
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, nparticles),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int i = r.begin(); i != r.end(); ++i)
+                build_particle(i);
+            });
+        }
+    else
+    #endif
+        {
+        for (unsigned int i = 0; i < nparticles; i++)
+            build_particle(i);
         }
 
+    // neighbors that did not fit have been counted, flag the overflow now that the build is complete
+    flagOverflow(h_pos.data, h_n_neigh.data, h_Nmax.data, h_conditions.data);
+
     if (m_prof)
         m_prof->pop(m_exec_conf);
     }
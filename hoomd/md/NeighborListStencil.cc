@@ -14,6 +14,10 @@
 #include "hoomd/Communicator.h"
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
 using namespace std;
 namespace py = pybind11;
 /*!
@@ -194,7 +198,7 @@ void NeighborListStencil::buildNlist(unsigned int timestep)
     // for each local particle
     unsigned int nparticles = m_pdata->getN();
 
-    for (int i = 0; i < (int)nparticles; i++)
+    auto build_particle = [&](unsigned int i)
         {
         unsigned int cur_n_neigh = 0;
 
@@ -308,7 +312,7 @@ void NeighborListStencil::buildNlist(unsigned int timestep)
                 unsigned int cur_neigh = __scalar_as_int(neigh_xyzf.w);
 
                 // a particle cannot neighbor itself
-                if (i == (int)cur_neigh) continue;
+                if (i == cur_neigh) continue;
 
                 Scalar3 neigh_pos = make_scalar3(neigh_xyzf.x, neigh_xyzf.y, neigh_xyzf.z);
                 Scalar3 dx = my_pos - neigh_pos;
@@ -318,15 +322,13 @@ void NeighborListStencil::buildNlist(unsigned int timestep)
 
                 if (dr_sq <= r_listsq)
                     {
-                    if (m_storage_mode == full || i < (int)cur_neigh)
+                    if (m_storage_mode == full || i < cur_neigh)
                         {
                         // local neighbor
                         if (cur_n_neigh < Nmax_i)
                             {
                             h_nlist.data[head_idx_i + cur_n_neigh] = cur_neigh;
                             }
-                        else
-                            h_conditions.data[type_i] = max(h_conditions.data[type_i], cur_n_neigh+1);
 
                         ++cur_n_neigh;
                         }
@@ -335,8 +337,28 @@ void NeighborListStencil::buildNlist(unsigned int timestep)
             }
 
         h_n_neigh.data[i] = cur_n_neigh;
+        };
+
+    #ifdef ENABLE_TBB
+    if (m_exec_conf->getNumThreads() > 1)
+        {
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, nparticles),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int i = r.begin(); i != r.end(); ++i)
+                build_particle(i);
+            });
+        }
+    else
+    #endif
+        {
+        for (unsigned int i = 0; i < nparticles; i++)
+            build_particle(i);
         }
 
+    // neighbors that did not fit have been counted, flag the overflow now that the build is complete
+    flagOverflow(h_pos.data, h_n_neigh.data, h_Nmax.data, h_conditions.data);
+
     if (m_prof)
         m_prof->pop(m_exec_conf);
     }
@@ -17,6 +17,10 @@ namespace py = pybind11;
 #include "hoomd/Communicator.h"
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
 using namespace std;
 using namespace hpmc::detail;
 
@@ -241,12 +245,29 @@ void NeighborListTree::buildTree()
         }
 
     // call the tree build routine, one tree per type
-    for (unsigned int i=0; i < m_pdata->getNTypes(); ++i)
+    auto build_tree = [&](unsigned int i)
         {
         if (m_num_per_type[i] > 0)
             {
             m_aabb_trees[i].buildTree(&(h_aabbs.data[0]) + m_type_head[i], m_num_per_type[i]);
             }
+        };
+
+    #ifdef ENABLE_TBB
+    if (m_exec_conf->getNumThreads() > 1)
+        {
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, m_pdata->getNTypes(), 1),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int i = r.begin(); i != r.end(); ++i)
+                build_tree(i);
+            });
+        }
+    else
+    #endif
+        {
+        for (unsigned int i = 0; i < m_pdata->getNTypes(); i++)
+            build_tree(i);
         }
     if (this->m_prof) this->m_prof->pop();
     }
@@ -276,7 +297,7 @@ void NeighborListTree::traverseTree()
     ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::overwrite);
 
     // Loop over all particles
-    for (unsigned int i=0; i < m_pdata->getN(); ++i)
+    auto traverse_particle = [&](unsigned int i)
         {
         // read in the current position and orientation
         const Scalar4 postype_i = h_postype.data[i];
@@ -362,8 +383,6 @@ void NeighborListTree::traverseTree()
                                             {
                                             if (n_neigh_i < Nmax_i)
                                                 h_nlist.data[nlist_head_i + n_neigh_i] = j;
-                                            else
-                                                h_conditions.data[type_i] = max(h_conditions.data[type_i], n_neigh_i+1);
 
                                             ++n_neigh_i;
                                             }
@@ -381,7 +400,27 @@ void NeighborListTree::traverseTree()
                 } // end loop over images
             } // end loop over pair types
             h_n_neigh.data[i] = n_neigh_i;
-        } // end loop over particles
+        };
+
+    #ifdef ENABLE_TBB
+    if (m_exec_conf->getNumThreads() > 1)
+        {
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, m_pdata->getN()),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int i = r.begin(); i != r.end(); ++i)
+                traverse_particle(i);
+            });
+        }
+    else
+    #endif
+        {
+        for (unsigned int i = 0; i < m_pdata->getN(); i++)
+            traverse_particle(i);
+        }
+
+    // neighbors that did not fit have been counted, flag the overflow now that the traversal is complete
+    flagOverflow(h_postype.data, h_n_neigh.data, h_Nmax.data, h_conditions.data);
 
     if (this->m_prof) this->m_prof->pop();
     }
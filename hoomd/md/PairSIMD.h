@@ -0,0 +1,263 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+#ifndef __PAIR_SIMD_H__
+#define __PAIR_SIMD_H__
+
+#include "hoomd/HOOMDMath.h"
+
+#include <cmath>
+#include <type_traits>
+
+/*! \file PairSIMD.h
+    \brief Thin wrappers around AVX/AVX-512 intrinsics used by the vectorized CPU pair kernel
+    \details PotentialPair processes pair_simd::width neighbors of a particle at once when the evaluator opts in to
+    vectorization. Evaluators opt in by providing
+
+    \code
+    static pair_simd::vmask evalForceAndEnergySIMD(const pair_simd::vreal& rsq,
+                                                   const pair_simd::vreal& rcutsq,
+                                                   const param_type *params,
+                                                   const int *typpair,
+                                                   bool energy_shift,
+                                                   pair_simd::vreal& force_divr,
+                                                   pair_simd::vreal& pair_eng);
+    \endcode
+
+    which evaluates all lanes and returns the mask of lanes within the cutoff. Lanes outside the mask may contain
+    garbage (including inf and nan), PotentialPair discards them. \a typpair holds the type pair index of every lane,
+    evaluators gather their parameters with it. PotentialPair detects the method with pair_simd::has_simd_eval.
+
+    The vectorized path is only compiled in when the host compiler targets AVX or AVX-512 (e.g. with -march=native),
+    following the same pattern as AABB.h.
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define ENABLE_PAIR_SIMD
+#endif
+
+namespace pair_simd
+{
+
+#ifdef ENABLE_PAIR_SIMD
+
+#if defined(__AVX512F__) && defined(SINGLE_PRECISION)
+typedef __m512 native_real;
+typedef __mmask16 native_mask;
+const unsigned int width = 16;
+#elif defined(__AVX512F__)
+typedef __m512d native_real;
+typedef __mmask8 native_mask;
+const unsigned int width = 8;
+#elif defined(SINGLE_PRECISION)
+typedef __m256 native_real;
+typedef __m256 native_mask;
+const unsigned int width = 8;
+#else
+typedef __m256d native_real;
+typedef __m256d native_mask;
+const unsigned int width = 4;
+#endif
+
+//! A vector of pair_simd::width Scalars
+struct vreal
+    {
+    native_real v;
+
+    vreal() {}
+    vreal(native_real _v) : v(_v) {}
+    };
+
+//! A lane mask for vreal
+struct vmask
+    {
+    native_mask m;
+
+    vmask() {}
+    vmask(native_mask _m) : m(_m) {}
+    };
+
+#if defined(__AVX512F__) && defined(SINGLE_PRECISION)
+inline vreal set1(Scalar a) { return _mm512_set1_ps(a); }
+inline vreal load(const Scalar *p) { return _mm512_loadu_ps(p); }
+inline void store(Scalar *p, const vreal& a) { _mm512_storeu_ps(p, a.v); }
+inline vreal operator+(const vreal& a, const vreal& b) { return _mm512_add_ps(a.v, b.v); }
+inline vreal operator-(const vreal& a, const vreal& b) { return _mm512_sub_ps(a.v, b.v); }
+inline vreal operator*(const vreal& a, const vreal& b) { return _mm512_mul_ps(a.v, b.v); }
+inline vreal operator/(const vreal& a, const vreal& b) { return _mm512_div_ps(a.v, b.v); }
+inline vreal sqrt(const vreal& a) { return _mm512_sqrt_ps(a.v); }
+inline vreal round(const vreal& a) { return _mm512_roundscale_ps(a.v, _MM_FROUND_TO_NEAREST_INT); }
+inline vmask operator<(const vreal& a, const vreal& b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ); }
+inline vmask operator!=(const vreal& a, const vreal& b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_NEQ_UQ); }
+inline vmask operator&(const vmask& a, const vmask& b) { return (native_mask)(a.m & b.m); }
+inline vmask first_lanes(unsigned int n) { return (native_mask)((n >= width) ? 0xffff : ((1u << n) - 1)); }
+inline vreal select(const vmask& m, const vreal& a, const vreal& b) { return _mm512_mask_blend_ps(m.m, b.v, a.v); }
+inline bool any(const vmask& m) { return m.m != 0; }
+inline vreal gather(const Scalar *base, const int *offsets)
+    {
+    return _mm512_mask_i32gather_ps(_mm512_setzero_ps(), 0xffff, _mm512_loadu_si512((const void *)offsets), base,
+        sizeof(Scalar));
+    }
+#elif defined(__AVX512F__)
+inline vreal set1(Scalar a) { return _mm512_set1_pd(a); }
+inline vreal load(const Scalar *p) { return _mm512_loadu_pd(p); }
+inline void store(Scalar *p, const vreal& a) { _mm512_storeu_pd(p, a.v); }
+inline vreal operator+(const vreal& a, const vreal& b) { return _mm512_add_pd(a.v, b.v); }
+inline vreal operator-(const vreal& a, const vreal& b) { return _mm512_sub_pd(a.v, b.v); }
+inline vreal operator*(const vreal& a, const vreal& b) { return _mm512_mul_pd(a.v, b.v); }
+inline vreal operator/(const vreal& a, const vreal& b) { return _mm512_div_pd(a.v, b.v); }
+inline vreal sqrt(const vreal& a) { return _mm512_sqrt_pd(a.v); }
+inline vreal round(const vreal& a) { return _mm512_roundscale_pd(a.v, _MM_FROUND_TO_NEAREST_INT); }
+inline vmask operator<(const vreal& a, const vreal& b) { return _mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ); }
+inline vmask operator!=(const vreal& a, const vreal& b) { return _mm512_cmp_pd_mask(a.v, b.v, _CMP_NEQ_UQ); }
+inline vmask operator&(const vmask& a, const vmask& b) { return (native_mask)(a.m & b.m); }
+inline vmask first_lanes(unsigned int n) { return (native_mask)((n >= width) ? 0xff : ((1u << n) - 1)); }
+inline vreal select(const vmask& m, const vreal& a, const vreal& b) { return _mm512_mask_blend_pd(m.m, b.v, a.v); }
+inline bool any(const vmask& m) { return m.m != 0; }
+inline vreal gather(const Scalar *base, const int *offsets)
+    {
+    return _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xff, _mm256_loadu_si256((const __m256i *)offsets), base,
+        sizeof(Scalar));
+    }
+#elif defined(SINGLE_PRECISION)
+inline vreal set1(Scalar a) { return _mm256_set1_ps(a); }
+inline vreal load(const Scalar *p) { return _mm256_loadu_ps(p); }
+inline void store(Scalar *p, const vreal& a) { _mm256_storeu_ps(p, a.v); }
+inline vreal operator+(const vreal& a, const vreal& b) { return _mm256_add_ps(a.v, b.v); }
+inline vreal operator-(const vreal& a, const vreal& b) { return _mm256_sub_ps(a.v, b.v); }
+inline vreal operator*(const vreal& a, const vreal& b) { return _mm256_mul_ps(a.v, b.v); }
+inline vreal operator/(const vreal& a, const vreal& b) { return _mm256_div_ps(a.v, b.v); }
+inline vreal sqrt(const vreal& a) { return _mm256_sqrt_ps(a.v); }
+inline vreal round(const vreal& a) { return _mm256_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+inline vmask operator<(const vreal& a, const vreal& b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+inline vmask operator!=(const vreal& a, const vreal& b) { return _mm256_cmp_ps(a.v, b.v, _CMP_NEQ_UQ); }
+inline vmask operator&(const vmask& a, const vmask& b) { return _mm256_and_ps(a.m, b.m); }
+inline vmask first_lanes(unsigned int n)
+    {
+    const __m256i lane = _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    return _mm256_cmp_ps(_mm256_cvtepi32_ps(lane), _mm256_set1_ps(float(n)), _CMP_LT_OQ);
+    }
+inline vreal select(const vmask& m, const vreal& a, const vreal& b) { return _mm256_blendv_ps(b.v, a.v, m.m); }
+inline bool any(const vmask& m) { return _mm256_movemask_ps(m.m) != 0; }
+inline vreal gather(const Scalar *base, const int *offsets)
+    {
+    #ifdef __AVX2__
+    return _mm256_mask_i32gather_ps(_mm256_setzero_ps(), base, _mm256_loadu_si256((const __m256i *)offsets),
+        _mm256_castsi256_ps(_mm256_set1_epi32(-1)), sizeof(Scalar));
+    #else
+    return _mm256_setr_ps(base[offsets[0]], base[offsets[1]], base[offsets[2]], base[offsets[3]],
+                          base[offsets[4]], base[offsets[5]], base[offsets[6]], base[offsets[7]]);
+    #endif
+    }
+#else
+inline vreal set1(Scalar a) { return _mm256_set1_pd(a); }
+inline vreal load(const Scalar *p) { return _mm256_loadu_pd(p); }
+inline void store(Scalar *p, const vreal& a) { _mm256_storeu_pd(p, a.v); }
+inline vreal operator+(const vreal& a, const vreal& b) { return _mm256_add_pd(a.v, b.v); }
+inline vreal operator-(const vreal& a, const vreal& b) { return _mm256_sub_pd(a.v, b.v); }
+inline vreal operator*(const vreal& a, const vreal& b) { return _mm256_mul_pd(a.v, b.v); }
+inline vreal operator/(const vreal& a, const vreal& b) { return _mm256_div_pd(a.v, b.v); }
+inline vreal sqrt(const vreal& a) { return _mm256_sqrt_pd(a.v); }
+inline vreal round(const vreal& a) { return _mm256_round_pd(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+inline vmask operator<(const vreal& a, const vreal& b) { return _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ); }
+inline vmask operator!=(const vreal& a, const vreal& b) { return _mm256_cmp_pd(a.v, b.v, _CMP_NEQ_UQ); }
+inline vmask operator&(const vmask& a, const vmask& b) { return _mm256_and_pd(a.m, b.m); }
+inline vmask first_lanes(unsigned int n)
+    {
+    return _mm256_cmp_pd(_mm256_set_pd(3.0, 2.0, 1.0, 0.0), _mm256_set1_pd(double(n)), _CMP_LT_OQ);
+    }
+inline vreal select(const vmask& m, const vreal& a, const vreal& b) { return _mm256_blendv_pd(b.v, a.v, m.m); }
+inline bool any(const vmask& m) { return _mm256_movemask_pd(m.m) != 0; }
+inline vreal gather(const Scalar *base, const int *offsets)
+    {
+    #ifdef __AVX2__
+    return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, _mm_loadu_si128((const __m128i *)offsets),
+        _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), sizeof(Scalar));
+    #else
+    return _mm256_setr_pd(base[offsets[0]], base[offsets[1]], base[offsets[2]], base[offsets[3]]);
+    #endif
+    }
+#endif
+
+inline vreal& operator+=(vreal& a, const vreal& b) { a = a + b; return a; }
+inline vreal& operator-=(vreal& a, const vreal& b) { a = a - b; return a; }
+inline vreal operator-(const vreal& a) { return set1(Scalar(0.0)) - a; }
+
+//! Zero out all lanes not set in the mask
+inline vreal mask_zero(const vmask& m, const vreal& a)
+    {
+    return select(m, a, set1(Scalar(0.0)));
+    }
+
+//! Sum all lanes
+inline Scalar hsum(const vreal& a)
+    {
+    Scalar tmp[width];
+    store(tmp, a);
+    Scalar sum(0.0);
+    for (unsigned int l = 0; l < width; ++l)
+        sum += tmp[l];
+    return sum;
+    }
+
+//! Lane-wise exponential
+/*! There is no exp instruction in AVX, the lanes are evaluated with the scalar math library.
+*/
+inline vreal exp(const vreal& a)
+    {
+    Scalar tmp[width];
+    store(tmp, a);
+    for (unsigned int l = 0; l < width; ++l)
+        tmp[l] = fast::exp(tmp[l]);
+    return load(tmp);
+    }
+
+//! Gather one Scalar member of a parameter struct for every lane
+/*! \param params Per type pair parameters
+    \param typpair Type pair index of every lane
+    \param member Offset of the member in units of Scalar
+    \tparam param_type Parameter struct, must consist only of Scalars
+*/
+template<class param_type>
+inline vreal gather_param(const param_type *params, const int *typpair, unsigned int member)
+    {
+    static_assert(sizeof(param_type) % sizeof(Scalar) == 0, "param_type must consist of Scalars");
+    const int stride = sizeof(param_type)/sizeof(Scalar);
+    int offsets[width];
+    for (unsigned int l = 0; l < width; ++l)
+        offsets[l] = typpair[l]*stride + member;
+    return gather((const Scalar *)params, offsets);
+    }
+
+//! Detects whether an evaluator provides evalForceAndEnergySIMD()
+template<class evaluator>
+struct has_simd_eval
+    {
+    template<class U> static std::true_type test(decltype(&U::evalForceAndEnergySIMD));
+    template<class U> static std::false_type test(...);
+
+    static const bool value = decltype(test<evaluator>(0))::value;
+    };
+
+#else
+
+//! Without AVX, no evaluator is vectorized
+template<class evaluator>
+struct has_simd_eval
+    {
+    static const bool value = false;
+    };
+
+#endif // ENABLE_PAIR_SIMD
+
+} // end namespace pair_simd
+
+#endif // __PAIR_SIMD_H__
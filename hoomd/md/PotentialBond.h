@@ -58,8 +58,28 @@ class PotentialBond : public ForceCompute
         std::string m_log_name;                     //!< Cached log name
         std::string m_prof_name;                    //!< Cached profiler name
 
+        //! Subsets of the bonds for computeBonds()
+        enum bond_subset
+            {
+            all_bonds,          //!< All bonds
+            interior_bonds,     //!< Bonds between local particles, collects the other bonds
+            boundary_bonds      //!< Bonds collected by the interior pass, adds to the forces
+            };
+
+        #ifdef ENABLE_MPI
+        std::vector<unsigned int> m_boundary_bonds; //!< Bonds with a ghost member
+        #endif
+
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
+
+        #ifdef ENABLE_MPI
+        //! Compute the forces of the bonds between local particles
+        virtual bool computeForcesInterior(unsigned int timestep);
+        #endif
+
+        //! Compute the forces of a subset of the bonds
+        void computeBonds(bond_subset subset);
     };
 
 /*! \param sysdef System to compute forces on
@@ -145,6 +165,39 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
     {
     if (m_prof) m_prof->push(m_prof_name);
 
+    if (m_interior_computed)
+        computeBonds(boundary_bonds);
+    else
+        computeBonds(all_bonds);
+
+    if (m_prof) m_prof->pop();
+    }
+
+#ifdef ENABLE_MPI
+/*! \param timestep Current time step
+    \returns true, bonds between local particles never depend on ghost positions
+ */
+template< class evaluator >
+bool PotentialBond< evaluator >::computeForcesInterior(unsigned int timestep)
+    {
+    if (m_prof) m_prof->push(m_prof_name);
+
+    computeBonds(interior_bonds);
+
+    if (m_prof) m_prof->pop();
+
+    return true;
+    }
+#endif
+
+/*! \param subset Bonds whose forces are computed
+
+    With \a subset all_bonds or interior_bonds, the forces are reset first. With boundary_bonds, the forces are added
+    to those of the interior bonds.
+ */
+template< class evaluator >
+void PotentialBond< evaluator >::computeBonds(bond_subset subset)
+    {
     assert(m_pdata);
 
     // access the particle data arrays
@@ -168,8 +221,11 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
     assert(h_charge.data);
 
     // Zero data for force calculation
-    memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
-    memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
+    if (subset != boundary_bonds)
+        {
+        memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
+        memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
+        }
 
     // we are using the minimum image of the global box here
     // to ensure that ghosts are always correctly wrapped (even if a bond exceeds half the domain length)
@@ -185,12 +241,25 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
     ArrayHandle<typename BondData::members_t> h_bonds(m_bond_data->getMembersArray(), access_location::host, access_mode::read);
     ArrayHandle<typeval_t> h_typeval(m_bond_data->getTypeValArray(), access_location::host, access_mode::read);
 
-    unsigned int max_local = m_pdata->getN() + m_pdata->getNGhosts();
+    const unsigned int N = m_pdata->getN();
+    unsigned int max_local = N + m_pdata->getNGhosts();
 
     // for each of the bonds
-    const unsigned int size = (unsigned int)m_bond_data->getN();
-    for (unsigned int i = 0; i < size; i++)
+    unsigned int size = (unsigned int)m_bond_data->getN();
+    #ifdef ENABLE_MPI
+    if (subset == interior_bonds)
+        m_boundary_bonds.clear();
+    else if (subset == boundary_bonds)
+        size = (unsigned int)m_boundary_bonds.size();
+    #endif
+    for (unsigned int n = 0; n < size; n++)
         {
+        unsigned int i = n;
+        #ifdef ENABLE_MPI
+        if (subset == boundary_bonds)
+            i = m_boundary_bonds[n];
+        #endif
+
         // lookup the tag of each of the particles participating in the bond
         const typename BondData::members_t& bond = h_bonds.data[i];
         assert(bond.tag[0] < m_pdata->getMaximumTag()+1);
@@ -209,6 +278,15 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
             throw std::runtime_error("Error in bond calculation");
             }
 
+        #ifdef ENABLE_MPI
+        // bonds with a ghost member have to wait for the ghost positions
+        if (subset == interior_bonds && (idx_a >= N || idx_b >= N))
+            {
+            m_boundary_bonds.push_back(i);
+            continue;
+            }
+        #endif
+
         // calculate d\vec{r}
         // (MEM TRANSFER: 6 Scalars / FLOPS: 3)
         Scalar3 posa = make_scalar3(h_pos.data[idx_a].x, h_pos.data[idx_a].y, h_pos.data[idx_a].z);
@@ -272,7 +350,7 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
                 }
 
             // add the force to the particles (only for non-ghost particles)
-            if (idx_b < m_pdata->getN())
+            if (idx_b < N)
                 {
                 h_force.data[idx_b].x += force_divr * dx.x;
                 h_force.data[idx_b].y += force_divr * dx.y;
@@ -283,7 +361,7 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
                         h_virial.data[i*m_virial_pitch+idx_b]  += bond_virial[i];
                 }
 
-            if (idx_a < m_pdata->getN())
+            if (idx_a < N)
                 {
                 h_force.data[idx_a].x -= force_divr * dx.x;
                 h_force.data[idx_a].y -= force_divr * dx.y;
@@ -300,8 +378,6 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
             throw std::runtime_error("Error in bond calculation");
             }
         }
-
-    if (m_prof) m_prof->pop();
     }
 
 #ifdef ENABLE_MPI
@@ -10,6 +10,9 @@
 #include <iostream>
 #include <stdexcept>
 #include <memory>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
 #include <hoomd/extern/pybind/include/pybind11/pybind11.h>
 #include "hoomd/extern/pybind/include/pybind11/numpy.h"
 
@@ -18,6 +21,7 @@
 #include "hoomd/GlobalArray.h"
 #include "hoomd/ForceCompute.h"
 #include "NeighborList.h"
+#include "PairSIMD.h"
 #include "hoomd/GSDShapeSpecWriter.h"
 
 #ifdef ENABLE_CUDA
@@ -28,6 +32,10 @@
 #include "hoomd/Communicator.h"
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
 
 /*! \file PotentialPair.h
     \brief Defines the template class for standard pair potentials
@@ -78,6 +86,19 @@
     potential evaluator class passed in. See the appropriate documentation for the evaluator for the definition of each
     element of the parameters.
 
+    When HOOMD is built with TBB and more than one thread is active, the CPU force loop is split across threads. With
+    a full neighbor list every particle only writes to its own force, so particles are simply partitioned. With a half
+    neighbor list, the third law contributions are accumulated into per-thread force and virial buffers (statically
+    partitioned so the result is independent of the task scheduling) and summed in a fixed order afterwards. Each
+    thread's buffer only spans the index range [lo,hi) of the particles its chunk writes to, so the buffers cost
+    10 Scalars per index in these ranges. For particles sorted in space, this is little more than 10 x N Scalars in
+    total, and at most (number of threads) x (N + ghosts) x 10 Scalars when the neighbors are spread over all indices.
+
+    Evaluators that provide evalForceAndEnergySIMD() (see PairSIMD.h) are evaluated pair_simd::width neighbors at a
+    time when HOOMD is compiled for AVX or AVX-512. Neighbor positions and parameters are gathered into vector
+    registers, the minimum image convention is applied lane-wise and lanes beyond the cutoff are masked out. XPLOR
+    smoothing always uses the scalar path. The vectorized path can be disabled with setVectorization().
+
     For profiling and logging, PotentialPair needs to know the name of the potential. For now, that will be queried from
     the evaluator. Perhaps in the future we could allow users to change that so multiple pair potentials could be logged
     independently.
@@ -130,6 +151,15 @@ class PotentialPair : public ForceCompute
             m_shift_mode = mode;
             }
 
+        //! Enable or disable the vectorized CPU kernel
+        /*! \param enable Set to false to always use the scalar kernel
+            \note This has no effect for evaluators that do not provide a vectorized kernel
+        */
+        void setVectorization(bool enable)
+            {
+            m_vectorize = enable;
+            }
+
         #ifdef ENABLE_MPI
         //! Get ghost particle fields requested by this pair potential
         virtual CommFlags getRequestedCommFlags(unsigned int timestep);
@@ -166,9 +196,65 @@ class PotentialPair : public ForceCompute
         std::string m_prof_name;                    //!< Cached profiler name
         std::string m_log_name;                     //!< Cached log name
 
+        bool m_vectorize;                           //!< True if the vectorized CPU kernel may be used
+
+        #ifdef ENABLE_TBB
+        std::vector< std::vector<Scalar4> > m_thread_force; //!< Per-thread force accumulators (half neighbor list)
+        std::vector< std::vector<Scalar> > m_thread_virial; //!< Per-thread virial accumulators (half neighbor list)
+        #endif
+
+        //! Subsets of the local particles for computeParticles()
+        enum particle_subset
+            {
+            all_particles,          //!< All local particles
+            interior_particles,     //!< Particles without ghost neighbors, classifies the particles
+            boundary_particles      //!< Particles classified as having ghost neighbors, adds to the forces
+            };
+
+        #ifdef ENABLE_MPI
+        std::vector<unsigned int> m_interior_idx;   //!< Local particles without ghost neighbors
+        std::vector<unsigned int> m_boundary_idx;   //!< Local particles with ghost neighbors
+        #endif
+
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
 
+        #ifdef ENABLE_MPI
+        //! Compute the forces of the particles without ghost neighbors
+        virtual bool computeForcesInterior(unsigned int timestep);
+        #endif
+
+        //! Compute the forces on a subset of the particles
+        void computeParticles(particle_subset subset);
+
+        #ifdef ENABLE_PAIR_SIMD
+        //! Read-only data needed by the vectorized kernel
+        struct simd_args
+            {
+            const Scalar4 *pos;               //!< Particle positions and types
+            const unsigned int *n_neigh;      //!< Number of neighbors
+            const unsigned int *nlist;        //!< Neighbor list
+            const unsigned int *head_list;    //!< Offsets into the neighbor list
+            const Scalar *rcutsq;             //!< Cutoff radius squared per type pair
+            const param_type *params;         //!< Pair parameters per type pair
+            BoxDim box;                       //!< Global simulation box
+            unsigned int N;                   //!< Number of local particles
+            bool third_law;                   //!< True if the neighbor list is half
+            bool energy_shift;                //!< True if the energy is shifted at the cutoff
+            bool compute_virial;              //!< True if the virial is needed
+            };
+
+        //! Compute the forces on particle i with the vectorized kernel
+        void computeParticleSIMD(std::true_type, unsigned int i, const simd_args& args,
+            Scalar4 *force, Scalar *virial, unsigned int virial_pitch, unsigned int offset);
+
+        //! Fallback for evaluators without a vectorized kernel, never called
+        void computeParticleSIMD(std::false_type, unsigned int i, const simd_args& args,
+            Scalar4 *force, Scalar *virial, unsigned int virial_pitch, unsigned int offset)
+            {
+            }
+        #endif
+
         //! Method to be called when number of types changes
         virtual void slotNumTypesChange()
             {
@@ -220,7 +306,8 @@ template < class evaluator >
 PotentialPair< evaluator >::PotentialPair(std::shared_ptr<SystemDefinition> sysdef,
                                                 std::shared_ptr<NeighborList> nlist,
                                                 const std::string& log_suffix)
-    : ForceCompute(sysdef), m_nlist(nlist), m_shift_mode(no_shift), m_typpair_idx(m_pdata->getNTypes())
+    : ForceCompute(sysdef), m_nlist(nlist), m_shift_mode(no_shift), m_typpair_idx(m_pdata->getNTypes()),
+      m_vectorize(true)
     {
     m_exec_conf->msg->notice(5) << "Constructing PotentialPair<" << evaluator::getName() << ">" << std::endl;
 
@@ -396,6 +483,56 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
     // start the profile for this compute
     if (m_prof) m_prof->push(m_prof_name);
 
+    if (m_interior_computed)
+        computeParticles(boundary_particles);
+    else
+        computeParticles(all_particles);
+
+    if (m_prof) m_prof->pop();
+    }
+
+#ifdef ENABLE_MPI
+/*! \param timestep specifies the current time step of the simulation
+    \returns true if the forces of the interior particles were computed
+
+    Particles without ghost neighbors do not need the ghost positions, so their forces can be computed while the
+    ghost update is in progress. This requires the neighbor list to be current, since a rebuild would use the
+    ghost positions. With a half neighbor list, the multithreaded kernel accumulates into per-thread buffers that
+    cannot be split into two passes, so it falls back to computing all forces in computeForces().
+*/
+template< class evaluator >
+bool PotentialPair< evaluator >::computeForcesInterior(unsigned int timestep)
+    {
+    if (!m_nlist->isCurrent(timestep))
+        return false;
+
+    #ifdef ENABLE_TBB
+    if (m_exec_conf->getNumThreads() > 1 && m_nlist->getStorageMode() == NeighborList::half)
+        return false;
+    #endif
+
+    // does not rebuild, but updates the internal state of the neighbor list for this time step
+    m_nlist->compute(timestep);
+
+    if (m_prof) m_prof->push(m_prof_name);
+
+    computeParticles(interior_particles);
+
+    if (m_prof) m_prof->pop();
+
+    return true;
+    }
+#endif
+
+/*! \param subset Particles whose forces are computed
+
+    With \a subset all_particles or interior_particles, the forces are reset first. With boundary_particles, the
+    forces are added to those of the interior particles. With a half neighbor list, every pair is stored in the row
+    of only one of the particles, so the pairs are split between the two passes without double counting.
+*/
+template< class evaluator >
+void PotentialPair< evaluator >::computeParticles(particle_subset subset)
+    {
     // depending on the neighborlist settings, we can take advantage of newton's third law
     // to reduce computations at the cost of memory access complexity: set that flag now
     bool third_law = m_nlist->getStorageMode() == NeighborList::half;
@@ -412,8 +549,9 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
 
 
     //force arrays
-    ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
-    ArrayHandle<Scalar>  h_virial(m_virial,access_location::host, access_mode::overwrite);
+    const access_mode::Enum force_mode = (subset == boundary_particles) ? access_mode::readwrite : access_mode::overwrite;
+    ArrayHandle<Scalar4> h_force(m_force,access_location::host, force_mode);
+    ArrayHandle<Scalar>  h_virial(m_virial,access_location::host, force_mode);
 
 
     const BoxDim& box = m_pdata->getGlobalBox();
@@ -425,12 +563,47 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
     bool compute_virial = flags[pdata_flag::pressure_tensor] || flags[pdata_flag::isotropic_virial];
 
     // need to start from a zero force, energy and virial
-    memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
-    memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
+    if (subset != boundary_particles)
+        {
+        memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
+        memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
+        }
 
-    // for each particle
-    for (int i = 0; i < (int)m_pdata->getN(); i++)
+    const unsigned int N = m_pdata->getN();
+
+    #ifdef ENABLE_PAIR_SIMD
+    // the vectorized kernel does not implement xplor smoothing, diameter or charge
+    const bool use_simd = m_vectorize && pair_simd::has_simd_eval<evaluator>::value && m_shift_mode != xplor
+        && !evaluator::needsDiameter() && !evaluator::needsCharge();
+
+    simd_args args;
+    args.pos = h_pos.data;
+    args.n_neigh = h_n_neigh.data;
+    args.nlist = h_nlist.data;
+    args.head_list = h_head_list.data;
+    args.rcutsq = h_rcutsq.data;
+    args.params = h_params.data;
+    args.box = box;
+    args.N = N;
+    args.third_law = third_law;
+    args.energy_shift = (m_shift_mode == shift);
+    args.compute_virial = compute_virial;
+    #endif
+
+    // computes the forces on particle i and accumulates them into the given force and virial arrays, whose first
+    // element belongs to particle offset
+    auto compute_particle = [&](unsigned int i, Scalar4 *force, Scalar *virial, unsigned int virial_pitch,
+        unsigned int offset)
         {
+        #ifdef ENABLE_PAIR_SIMD
+        if (use_simd)
+            {
+            computeParticleSIMD(std::integral_constant<bool, pair_simd::has_simd_eval<evaluator>::value>(),
+                i, args, force, virial, virial_pitch, offset);
+            return;
+            }
+        #endif
+
         // access the particle's position and type (MEM TRANSFER: 4 scalars)
         Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
         unsigned int typei = __scalar_as_int(h_pos.data[i].w);
@@ -563,45 +736,370 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
 
                 // add the force to particle j if we are using the third law (MEM TRANSFER: 10 scalars / FLOPS: 8)
                 // only add force to local particles
-                if (third_law && j < m_pdata->getN())
+                if (third_law && j < N)
                     {
-                    unsigned int mem_idx = j;
-                    h_force.data[mem_idx].x -= dx.x*force_divr;
-                    h_force.data[mem_idx].y -= dx.y*force_divr;
-                    h_force.data[mem_idx].z -= dx.z*force_divr;
-                    h_force.data[mem_idx].w += pair_eng * Scalar(0.5);
+                    unsigned int mem_idx = j - offset;
+                    force[mem_idx].x -= dx.x*force_divr;
+                    force[mem_idx].y -= dx.y*force_divr;
+                    force[mem_idx].z -= dx.z*force_divr;
+                    force[mem_idx].w += pair_eng * Scalar(0.5);
                     if (compute_virial)
                         {
-                        h_virial.data[0*m_virial_pitch+mem_idx] += force_div2r*dx.x*dx.x;
-                        h_virial.data[1*m_virial_pitch+mem_idx] += force_div2r*dx.x*dx.y;
-                        h_virial.data[2*m_virial_pitch+mem_idx] += force_div2r*dx.x*dx.z;
-                        h_virial.data[3*m_virial_pitch+mem_idx] += force_div2r*dx.y*dx.y;
-                        h_virial.data[4*m_virial_pitch+mem_idx] += force_div2r*dx.y*dx.z;
-                        h_virial.data[5*m_virial_pitch+mem_idx] += force_div2r*dx.z*dx.z;
+                        virial[0*virial_pitch+mem_idx] += force_div2r*dx.x*dx.x;
+                        virial[1*virial_pitch+mem_idx] += force_div2r*dx.x*dx.y;
+                        virial[2*virial_pitch+mem_idx] += force_div2r*dx.x*dx.z;
+                        virial[3*virial_pitch+mem_idx] += force_div2r*dx.y*dx.y;
+                        virial[4*virial_pitch+mem_idx] += force_div2r*dx.y*dx.z;
+                        virial[5*virial_pitch+mem_idx] += force_div2r*dx.z*dx.z;
                         }
                     }
                 }
             }
 
         // finally, increment the force, potential energy and virial for particle i
-        unsigned int mem_idx = i;
-        h_force.data[mem_idx].x += fi.x;
-        h_force.data[mem_idx].y += fi.y;
-        h_force.data[mem_idx].z += fi.z;
-        h_force.data[mem_idx].w += pei;
+        unsigned int mem_idx = i - offset;
+        force[mem_idx].x += fi.x;
+        force[mem_idx].y += fi.y;
+        force[mem_idx].z += fi.z;
+        force[mem_idx].w += pei;
         if (compute_virial)
             {
-            h_virial.data[0*m_virial_pitch+mem_idx] += virialxxi;
-            h_virial.data[1*m_virial_pitch+mem_idx] += virialxyi;
-            h_virial.data[2*m_virial_pitch+mem_idx] += virialxzi;
-            h_virial.data[3*m_virial_pitch+mem_idx] += virialyyi;
-            h_virial.data[4*m_virial_pitch+mem_idx] += virialyzi;
-            h_virial.data[5*m_virial_pitch+mem_idx] += virialzzi;
+            virial[0*virial_pitch+mem_idx] += virialxxi;
+            virial[1*virial_pitch+mem_idx] += virialxyi;
+            virial[2*virial_pitch+mem_idx] += virialxzi;
+            virial[3*virial_pitch+mem_idx] += virialyyi;
+            virial[4*virial_pitch+mem_idx] += virialyzi;
+            virial[5*virial_pitch+mem_idx] += virialzzi;
+            }
+        };
+
+    #ifdef ENABLE_MPI
+    if (subset != all_particles)
+        {
+        if (subset == interior_particles)
+            {
+            // classify the particles by whether they have ghost neighbors
+            m_interior_idx.clear();
+            m_boundary_idx.clear();
+            for (unsigned int i = 0; i < N; i++)
+                {
+                const unsigned int myHead = h_head_list.data[i];
+                const unsigned int size = (unsigned int)h_n_neigh.data[i];
+                bool boundary = false;
+                for (unsigned int k = 0; k < size && !boundary; k++)
+                    boundary = h_nlist.data[myHead + k] >= N;
+
+                if (boundary)
+                    m_boundary_idx.push_back(i);
+                else
+                    m_interior_idx.push_back(i);
+                }
+            }
+
+        const std::vector<unsigned int>& idx = (subset == interior_particles) ? m_interior_idx : m_boundary_idx;
+
+        // process the particles in blocks, and give the ghost update a chance to progress between blocks
+        #ifdef ENABLE_TBB
+        const bool parallel = m_exec_conf->getNumThreads() > 1 && !third_law;
+        const unsigned int block_size = parallel ? 512*m_exec_conf->getNumThreads() : 512;
+        #else
+        const unsigned int block_size = 512;
+        #endif
+        for (unsigned int first = 0; first < idx.size(); first += block_size)
+            {
+            const unsigned int last = std::min((unsigned int)idx.size(), first + block_size);
+
+            #ifdef ENABLE_TBB
+            if (parallel)
+                {
+                tbb::parallel_for(tbb::blocked_range<unsigned int>(first, last),
+                    [&](const tbb::blocked_range<unsigned int>& r)
+                    {
+                    for (unsigned int n = r.begin(); n != r.end(); ++n)
+                        compute_particle(idx[n], h_force.data, h_virial.data, m_virial_pitch, 0);
+                    });
+                }
+            else
+            #endif
+                {
+                for (unsigned int n = first; n < last; n++)
+                    compute_particle(idx[n], h_force.data, h_virial.data, m_virial_pitch, 0);
+                }
+
+            if (subset == interior_particles && m_comm)
+                m_comm->progressUpdateGhosts();
+            }
+
+        return;
+        }
+    #endif
+
+    #ifdef ENABLE_TBB
+    const unsigned int n_threads = m_exec_conf->getNumThreads();
+    if (n_threads > 1 && !third_law)
+        {
+        // with a full neighbor list, every particle only writes to its own force and virial
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int i = r.begin(); i != r.end(); ++i)
+                compute_particle(i, h_force.data, h_virial.data, m_virial_pitch, 0);
+            });
+        }
+    else if (n_threads > 1)
+        {
+        // with a half neighbor list, the third law writes to arbitrary particles j. Every thread accumulates into
+        // its own buffer, which are summed in a fixed order afterwards so that the result does not depend
+        // on the task scheduling. A buffer only covers the range of particles its chunk writes to, which is little
+        // more than the chunk itself when the particles are sorted
+        const unsigned int n_chunks = std::min(n_threads, std::max(N, 1u));
+        m_thread_force.resize(n_chunks);
+        m_thread_virial.resize(n_chunks);
+        std::vector<unsigned int> chunk_lo(n_chunks);
+        std::vector<unsigned int> chunk_hi(n_chunks);
+
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_chunks, 1),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int chunk = r.begin(); chunk != r.end(); ++chunk)
+                {
+                // static partitioning of the particles
+                const unsigned int first = (unsigned int)(((unsigned long)N*chunk)/n_chunks);
+                const unsigned int last = (unsigned int)(((unsigned long)N*(chunk+1))/n_chunks);
+
+                // find the range of local particles written to
+                unsigned int lo = first;
+                unsigned int hi = last;
+                for (unsigned int i = first; i < last; ++i)
+                    {
+                    const unsigned int myHead = h_head_list.data[i];
+                    const unsigned int size = (unsigned int)h_n_neigh.data[i];
+                    for (unsigned int k = 0; k < size; k++)
+                        {
+                        const unsigned int j = h_nlist.data[myHead + k];
+                        if (j < N)
+                            {
+                            lo = std::min(lo, j);
+                            hi = std::max(hi, j+1);
+                            }
+                        }
+                    }
+                chunk_lo[chunk] = lo;
+                chunk_hi[chunk] = hi;
+
+                const unsigned int n_touched = hi - lo;
+                std::vector<Scalar4>& force = m_thread_force[chunk];
+                std::vector<Scalar>& virial = m_thread_virial[chunk];
+                if (force.size() < n_touched)
+                    force.resize(n_touched);
+                memset((void*)force.data(), 0, sizeof(Scalar4)*n_touched);
+                if (compute_virial)
+                    {
+                    if (virial.size() < 6*n_touched)
+                        virial.resize(6*n_touched);
+                    memset((void*)virial.data(), 0, sizeof(Scalar)*6*n_touched);
+                    }
+
+                for (unsigned int i = first; i < last; ++i)
+                    compute_particle(i, force.data(), compute_virial ? virial.data() : NULL, n_touched, lo);
+                }
+            }, tbb::simple_partitioner());
+
+        // reduce the per-thread accumulators
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int i = r.begin(); i != r.end(); ++i)
+                {
+                Scalar4 f = make_scalar4(0,0,0,0);
+                Scalar v[6] = {0,0,0,0,0,0};
+                for (unsigned int chunk = 0; chunk < n_chunks; ++chunk)
+                    {
+                    if (i < chunk_lo[chunk] || i >= chunk_hi[chunk])
+                        continue;
+
+                    const unsigned int n_touched = chunk_hi[chunk] - chunk_lo[chunk];
+                    const unsigned int mem_idx = i - chunk_lo[chunk];
+                    const Scalar4& fc = m_thread_force[chunk][mem_idx];
+                    f.x += fc.x; f.y += fc.y; f.z += fc.z; f.w += fc.w;
+                    if (compute_virial)
+                        for (unsigned int l = 0; l < 6; ++l)
+                            v[l] += m_thread_virial[chunk][l*n_touched+mem_idx];
+                    }
+                h_force.data[i] = f;
+                if (compute_virial)
+                    for (unsigned int l = 0; l < 6; ++l)
+                        h_virial.data[l*m_virial_pitch+i] = v[l];
+                }
+            });
+        }
+    else
+    #endif
+        {
+        // for each particle
+        for (unsigned int i = 0; i < N; i++)
+            compute_particle(i, h_force.data, h_virial.data, m_virial_pitch, 0);
+        }
+    }
+
+#ifdef ENABLE_PAIR_SIMD
+/*! \param i Index of the particle
+    \param args Particle, neighbor list and parameter data
+    \param force Force array to accumulate into
+    \param virial Virial array to accumulate into
+    \param virial_pitch Pitch of \a virial
+    \param offset Index of the particle that the first element of \a force and \a virial belong to
+
+    The neighbors of particle i are processed in batches of pair_simd::width. The last batch is padded with
+    particle i itself, which is masked out.
+*/
+template< class evaluator >
+void PotentialPair< evaluator >::computeParticleSIMD(std::true_type, unsigned int i, const simd_args& args,
+    Scalar4 *force, Scalar *virial, unsigned int virial_pitch, unsigned int offset)
+    {
+    using namespace pair_simd;
+    static_assert(sizeof(Scalar4) == 4*sizeof(Scalar), "Scalar4 must be packed for the gathers");
+
+    const Scalar4 postype_i = args.pos[i];
+    const unsigned int typei = __scalar_as_int(postype_i.w);
+    const vreal xi = set1(postype_i.x);
+    const vreal yi = set1(postype_i.y);
+    const vreal zi = set1(postype_i.z);
+
+    // box parameters for the minimum image convention
+    const uchar3 periodic = args.box.getPeriodic();
+    const Scalar3 L = args.box.getL();
+    const vreal Lx = set1(L.x), Ly = set1(L.y), Lz = set1(L.z);
+    const vreal Lxinv = set1(Scalar(1.0)/L.x), Lyinv = set1(Scalar(1.0)/L.y), Lzinv = set1(Scalar(1.0)/L.z);
+    const vreal xy = set1(args.box.getTiltFactorXY());
+    const vreal xz = set1(args.box.getTiltFactorXZ());
+    const vreal yz = set1(args.box.getTiltFactorYZ());
+
+    const vreal zero = set1(Scalar(0.0));
+    vreal fx = zero, fy = zero, fz = zero, pe = zero;
+    vreal vxx = zero, vxy = zero, vxz = zero, vyy = zero, vyz = zero, vzz = zero;
+
+    const Scalar *pos_base = (const Scalar *)args.pos;
+    const unsigned int head = args.head_list[i];
+    const unsigned int size = args.n_neigh[i];
+
+    unsigned int j_idx[width];
+    int pos_offsets[width];
+    int typpair[width];
+    Scalar rcutsq[width];
+
+    for (unsigned int k = 0; k < size; k += width)
+        {
+        const unsigned int n = std::min(width, size - k);
+        for (unsigned int l = 0; l < width; ++l)
+            {
+            unsigned int j = (l < n) ? args.nlist[head + k + l] : i;
+            j_idx[l] = j;
+            pos_offsets[l] = 4*j;
+            typpair[l] = m_typpair_idx(typei, __scalar_as_int(args.pos[j].w));
+            rcutsq[l] = args.rcutsq[typpair[l]];
+            }
+
+        // calculate dr_ji
+        vreal dx = xi - gather(pos_base, pos_offsets);
+        vreal dy = yi - gather(pos_base + 1, pos_offsets);
+        vreal dz = zi - gather(pos_base + 2, pos_offsets);
+
+        // apply periodic boundary conditions
+        if (periodic.z)
+            {
+            vreal img = round(dz * Lzinv);
+            dz -= Lz * img;
+            dy -= Lz * yz * img;
+            dx -= Lz * xz * img;
+            }
+        if (periodic.y)
+            {
+            vreal img = round(dy * Lyinv);
+            dy -= Ly * img;
+            dx -= Ly * xy * img;
+            }
+        if (periodic.x)
+            {
+            dx -= Lx * round(dx * Lxinv);
+            }
+
+        vreal rsq = dx*dx + dy*dy + dz*dz;
+
+        vreal force_divr, pair_eng;
+        vmask mask = evaluator::evalForceAndEnergySIMD(rsq, load(rcutsq), args.params, typpair, args.energy_shift,
+            force_divr, pair_eng) & first_lanes(n);
+        if (!any(mask))
+            continue;
+
+        force_divr = mask_zero(mask, force_divr);
+        pair_eng = mask_zero(mask, pair_eng);
+
+        fx += dx*force_divr;
+        fy += dy*force_divr;
+        fz += dz*force_divr;
+        pe += pair_eng;
+        if (args.compute_virial)
+            {
+            vxx += force_divr*dx*dx;
+            vxy += force_divr*dx*dy;
+            vxz += force_divr*dx*dz;
+            vyy += force_divr*dy*dy;
+            vyz += force_divr*dy*dz;
+            vzz += force_divr*dz*dz;
+            }
+
+        // add the force to particle j if we are using the third law, only add force to local particles
+        if (args.third_law)
+            {
+            Scalar f_l[width], e_l[width], dx_l[width], dy_l[width], dz_l[width];
+            store(f_l, force_divr);
+            store(e_l, pair_eng);
+            store(dx_l, dx);
+            store(dy_l, dy);
+            store(dz_l, dz);
+            for (unsigned int l = 0; l < n; ++l)
+                {
+                unsigned int j = j_idx[l];
+                if (j >= args.N)
+                    continue;
+                unsigned int mem_idx = j - offset;
+
+                force[mem_idx].x -= dx_l[l]*f_l[l];
+                force[mem_idx].y -= dy_l[l]*f_l[l];
+                force[mem_idx].z -= dz_l[l]*f_l[l];
+                force[mem_idx].w += e_l[l] * Scalar(0.5);
+                if (args.compute_virial)
+                    {
+                    Scalar force_div2r = f_l[l] * Scalar(0.5);
+                    virial[0*virial_pitch+mem_idx] += force_div2r*dx_l[l]*dx_l[l];
+                    virial[1*virial_pitch+mem_idx] += force_div2r*dx_l[l]*dy_l[l];
+                    virial[2*virial_pitch+mem_idx] += force_div2r*dx_l[l]*dz_l[l];
+                    virial[3*virial_pitch+mem_idx] += force_div2r*dy_l[l]*dy_l[l];
+                    virial[4*virial_pitch+mem_idx] += force_div2r*dy_l[l]*dz_l[l];
+                    virial[5*virial_pitch+mem_idx] += force_div2r*dz_l[l]*dz_l[l];
+                    }
+                }
             }
         }
 
-    if (m_prof) m_prof->pop();
+    // finally, increment the force, potential energy and virial for particle i
+    unsigned int mem_idx = i - offset;
+    force[mem_idx].x += hsum(fx);
+    force[mem_idx].y += hsum(fy);
+    force[mem_idx].z += hsum(fz);
+    force[mem_idx].w += hsum(pe) * Scalar(0.5);
+    if (args.compute_virial)
+        {
+        virial[0*virial_pitch+mem_idx] += hsum(vxx) * Scalar(0.5);
+        virial[1*virial_pitch+mem_idx] += hsum(vxy) * Scalar(0.5);
+        virial[2*virial_pitch+mem_idx] += hsum(vxz) * Scalar(0.5);
+        virial[3*virial_pitch+mem_idx] += hsum(vyy) * Scalar(0.5);
+        virial[4*virial_pitch+mem_idx] += hsum(vyz) * Scalar(0.5);
+        virial[5*virial_pitch+mem_idx] += hsum(vzz) * Scalar(0.5);
+        }
     }
+#endif
 
 #ifdef ENABLE_MPI
 /*! \param timestep Current time step
@@ -822,6 +1320,7 @@ template < class T > void export_PotentialPair(pybind11::module& m, const std::s
         .def("setRcut", &T::setRcut)
         .def("setRon", &T::setRon)
         .def("setShiftMode", &T::setShiftMode)
+        .def("setVectorization", &T::setVectorization)
         .def("computeEnergyBetweenSets", &T::computeEnergyBetweenSetsPythonList)
         .def("slotWriteGSDShapeSpec", &T::slotWriteGSDShapeSpec)
         .def("connectGSDShapeSpec", &T::connectGSDShapeSpec)
@@ -72,6 +72,14 @@ class PotentialPairDPDThermo : public PotentialPair<evaluator>
 
         //! Actually compute the forces (overwrites PotentialPair::computeForces())
         virtual void computeForces(unsigned int timestep);
+
+        #ifdef ENABLE_MPI
+        //! The thermostat needs ghost velocities, so the forces are not split (overrides PotentialPair)
+        virtual bool computeForcesInterior(unsigned int timestep)
+            {
+            return false;
+            }
+        #endif
     };
 
 /*! \param sysdef System to compute forces on
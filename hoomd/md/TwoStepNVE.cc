@@ -9,6 +9,10 @@
 #include "TwoStepNVE.h"
 #include "hoomd/VectorMath.h"
 
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
 
 using namespace std;
 namespace py = pybind11;
@@ -85,12 +89,18 @@ void TwoStepNVE::integrateStepOne(unsigned int timestep)
     ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
 
+    // particles may be moved slightly outside the box by the first half step, wrap them back into place
+    const BoxDim& box = m_pdata->getBox();
+
+    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_index(m_group->getIndexArray(), access_location::host, access_mode::read);
+
     // perform the first half step of velocity verlet
     // r(t+deltaT) = r(t) + v(t)*deltaT + (1/2)a(t)*deltaT^2
     // v(t+deltaT/2) = v(t) + (1/2)a*deltaT
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    auto step_one = [&](unsigned int group_idx)
         {
-        unsigned int j = m_group->getMemberIndex(group_idx);
+        unsigned int j = h_index.data[group_idx];
         if (m_zero_force)
             h_accel.data[j].x = h_accel.data[j].y = h_accel.data[j].z = 0.0;
 
@@ -117,17 +127,25 @@ void TwoStepNVE::integrateStepOne(unsigned int timestep)
         h_vel.data[j].x += Scalar(1.0/2.0)*h_accel.data[j].x*m_deltaT;
         h_vel.data[j].y += Scalar(1.0/2.0)*h_accel.data[j].y*m_deltaT;
         h_vel.data[j].z += Scalar(1.0/2.0)*h_accel.data[j].z*m_deltaT;
-        }
 
-    // particles may have been moved slightly outside the box by the above steps, wrap them back into place
-    const BoxDim& box = m_pdata->getBox();
-
-    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+        box.wrap(h_pos.data[j], h_image.data[j]);
+        };
 
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    #ifdef ENABLE_TBB
+    if (m_exec_conf->getNumThreads() > 1)
         {
-        unsigned int j = m_group->getMemberIndex(group_idx);
-        box.wrap(h_pos.data[j], h_image.data[j]);
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, group_size),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int group_idx = r.begin(); group_idx != r.end(); ++group_idx)
+                step_one(group_idx);
+            });
+        }
+    else
+    #endif
+        {
+        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+            step_one(group_idx);
         }
 
     // Integration of angular degrees of freedom using symplectic and
@@ -261,10 +279,12 @@ void TwoStepNVE::integrateStepTwo(unsigned int timestep)
 
     ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::read);
 
+    ArrayHandle<unsigned int> h_index(m_group->getIndexArray(), access_location::host, access_mode::read);
+
     // v(t+deltaT) = v(t+deltaT/2) + 1/2 * a(t+deltaT)*deltaT
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    auto step_two = [&](unsigned int group_idx)
         {
-        unsigned int j = m_group->getMemberIndex(group_idx);
+        unsigned int j = h_index.data[group_idx];
 
         if (m_zero_force)
             {
@@ -295,6 +315,23 @@ void TwoStepNVE::integrateStepTwo(unsigned int timestep)
                 h_vel.data[j].z = h_vel.data[j].z / vel * m_limit_val / m_deltaT;
                 }
             }
+        };
+
+    #ifdef ENABLE_TBB
+    if (m_exec_conf->getNumThreads() > 1)
+        {
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, group_size),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int group_idx = r.begin(); group_idx != r.end(); ++group_idx)
+                step_two(group_idx);
+            });
+        }
+    else
+    #endif
+        {
+        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+            step_two(group_idx);
         }
 
     if (m_aniso)
@@ -0,0 +1,156 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file benchmark_md.cc
+    \brief Benchmarks of the neighbor lists and the pair, bond and PPPM force computes
+    \ingroup benchmarks
+*/
+
+#include "hoomd/benchmark/BenchmarkSuite.h"
+#include "hoomd/benchmark/BenchmarkSystems.h"
+
+#include "hoomd/md/AllPairPotentials.h"
+#include "hoomd/md/AllBondPotentials.h"
+#include "hoomd/md/NeighborListBinned.h"
+#include "hoomd/md/NeighborListStencil.h"
+#include "hoomd/md/NeighborListTree.h"
+#include "hoomd/md/PPPMForceCompute.h"
+#include "hoomd/ParticleGroup.h"
+#include "hoomd/SystemDefinition.h"
+
+using namespace std;
+
+//! Cutoff of the LJ potential
+const Scalar lj_r_cut = Scalar(2.5);
+//! Neighbor list buffer
+const Scalar lj_r_buff = Scalar(0.4);
+
+//! Benchmark a neighbor list build
+/*! \param suite The benchmark suite
+    \param kernel Name of the benchmark
+    \param N Number of particles
+*/
+template<class NL>
+void benchmark_nlist(BenchmarkSuite& suite, const std::string& kernel, unsigned int N)
+    {
+    if (!suite.isSelected("lj_liquid", kernel))
+        return;
+
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(make_lj_liquid_snapshot(N), suite.getExecConf()));
+    std::shared_ptr<NeighborList> nlist(new NL(sysdef, lj_r_cut, lj_r_buff));
+    nlist->setStorageMode(NeighborList::half);
+
+    suite.run("lj_liquid", kernel, N, [&](unsigned int timestep)
+        {
+        nlist->forceUpdate();
+        nlist->compute(timestep);
+        });
+    }
+
+//! Benchmark the LJ pair force on a neighbor list that is built once
+void benchmark_pair_lj(BenchmarkSuite& suite, unsigned int N)
+    {
+    if (!suite.isSelected("lj_liquid", "PotentialPairLJ::computeForces"))
+        return;
+
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(make_lj_liquid_snapshot(N), suite.getExecConf()));
+    std::shared_ptr<NeighborList> nlist(new NeighborListTree(sysdef, lj_r_cut, lj_r_buff));
+    nlist->setStorageMode(NeighborList::half);
+
+    std::shared_ptr<PotentialPairLJ> lj(new PotentialPairLJ(sysdef, nlist));
+    lj->setRcut(0, 0, lj_r_cut);
+    lj->setParams(0, 0, make_scalar2(Scalar(4.0), Scalar(4.0)));
+
+    // the particles do not move, so the neighbor list is not rebuilt after the first call
+    suite.run("lj_liquid", "PotentialPairLJ::computeForces", N, [&](unsigned int timestep)
+        {
+        lj->compute(timestep);
+        });
+    }
+
+//! Benchmark the harmonic bond force in a polymer melt
+void benchmark_bond_harmonic(BenchmarkSuite& suite, unsigned int N)
+    {
+    if (!suite.isSelected("polymer_melt", "PotentialBondHarmonic::computeForces"))
+        return;
+
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(make_polymer_melt_snapshot(N, 10),
+                                                                  suite.getExecConf()));
+    std::shared_ptr<PotentialBondHarmonic> bond(new PotentialBondHarmonic(sysdef));
+    bond->setParams(0, make_scalar2(Scalar(300.0), Scalar(1.0)));
+
+    suite.run("polymer_melt", "PotentialBondHarmonic::computeForces", N, [&](unsigned int timestep)
+        {
+        bond->compute(timestep);
+        });
+    }
+
+//! Benchmark the pair force of the polymer melt, which includes the bond exclusions
+void benchmark_pair_polymer(BenchmarkSuite& suite, unsigned int N)
+    {
+    if (!suite.isSelected("polymer_melt", "PotentialPairLJ::computeForces"))
+        return;
+
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(make_polymer_melt_snapshot(N, 10),
+                                                                  suite.getExecConf()));
+    std::shared_ptr<NeighborList> nlist(new NeighborListTree(sysdef, Scalar(1.122462), lj_r_buff));
+    nlist->setStorageMode(NeighborList::half);
+    nlist->addExclusionsFromBonds();
+
+    std::shared_ptr<PotentialPairLJ> lj(new PotentialPairLJ(sysdef, nlist));
+    lj->setRcut(0, 0, Scalar(1.122462));
+    lj->setShiftMode(PotentialPairLJ::shift);
+    lj->setParams(0, 0, make_scalar2(Scalar(4.0), Scalar(4.0)));
+
+    suite.run("polymer_melt", "PotentialPairLJ::computeForces", N, [&](unsigned int timestep)
+        {
+        lj->compute(timestep);
+        });
+    }
+
+//! Benchmark PPPM in a system of alternating unit charges
+void benchmark_pppm(BenchmarkSuite& suite, unsigned int N)
+    {
+    if (!suite.isSelected("charged_liquid", "PPPMForceCompute::computeForces"))
+        return;
+
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = make_lj_liquid_snapshot(N);
+    for (unsigned int i = 0; i < N; i++)
+        snap->particle_data.charge[i] = (i % 2) ? Scalar(-1.0) : Scalar(1.0);
+
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, suite.getExecConf()));
+    std::shared_ptr<NeighborList> nlist(new NeighborListTree(sysdef, lj_r_cut, lj_r_buff));
+    std::shared_ptr<ParticleSelector> selector_all(new ParticleSelectorAll(sysdef));
+    std::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef, selector_all));
+
+    std::shared_ptr<PPPMForceCompute> pppm(new PPPMForceCompute(sysdef, nlist, group_all));
+
+    // power of two mesh with a spacing close to the particle diameter
+    Scalar L = sysdef->getParticleData()->getGlobalBox().getL().x;
+    unsigned int n_mesh = 1;
+    while (L / Scalar(n_mesh) > Scalar(1.1))
+        n_mesh *= 2;
+    pppm->setParams(n_mesh, n_mesh, n_mesh, 5, Scalar(2.0)/lj_r_cut, lj_r_cut);
+
+    suite.run("charged_liquid", "PPPMForceCompute::computeForces", N, [&](unsigned int timestep)
+        {
+        pppm->compute(timestep);
+        });
+    }
+
+int main(int argc, char **argv)
+    {
+    BenchmarkSuite suite(argc, argv, "md");
+
+    unsigned int N = suite.scaled(64000);
+    benchmark_nlist<NeighborListBinned>(suite, "NeighborListBinned::buildNlist", N);
+    benchmark_nlist<NeighborListStencil>(suite, "NeighborListStencil::buildNlist", N);
+    benchmark_nlist<NeighborListTree>(suite, "NeighborListTree::buildNlist", N);
+    benchmark_pair_lj(suite, N);
+    benchmark_bond_harmonic(suite, N);
+    benchmark_pair_polymer(suite, N);
+    benchmark_pppm(suite, suite.scaled(32000));
+
+    return suite.finish();
+    }
@@ -374,11 +374,12 @@ class pair(force._force):
         self.nlist.subscribe(lambda:self.get_rcut())
         self.nlist.update_rcut()
 
-    def set_params(self, mode=None):
+    def set_params(self, mode=None, vectorize=None):
         R""" Set parameters controlling the way forces are computed.
 
         Args:
             mode (str): (if set) Set the mode with which potentials are handled at the cutoff.
+            vectorize (bool): (if set) Set to False to disable the vectorized CPU kernel.
 
         Valid values for *mode* are: "none" (the default), "shift", and "xplor":
 
@@ -389,15 +390,23 @@ class pair(force._force):
 
         See :py:class:`pair` for the equations.
 
+        When HOOMD is compiled for a CPU with AVX or AVX-512, lj, force_shifted_lj, gauss, yukawa and morse evaluate
+        several neighbors at once (except with *mode* "xplor"). *vectorize* (default True) switches back to the
+        scalar kernel, for example to compare the two. It has no effect on the GPU.
+
         Examples::
 
             mypair.set_params(mode="shift")
             mypair.set_params(mode="no_shift")
             mypair.set_params(mode="xplor")
+            mypair.set_params(vectorize=False)
 
         """
         hoomd.util.print_status_line();
 
+        if vectorize is not None:
+            self.cpp_force.setVectorization(bool(vectorize))
+
         if mode is not None:
             if mode == "no_shift":
                 self.cpp_force.setShiftMode(self.cpp_class.energyShiftMode.no_shift)
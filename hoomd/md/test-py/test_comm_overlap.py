@@ -0,0 +1,170 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: jglaser
+
+from hoomd import *
+from hoomd import md
+context.initialize()
+import unittest
+import os
+
+# tests for comm.overlap_ghosts
+class comm_overlap_tests(unittest.TestCase):
+    def setUp(self):
+        self.s = init.read_gsd(os.path.join(os.path.dirname(__file__),'test_data_polymer_system.gsd'));
+        self.harmonic = md.bond.harmonic();
+        self.harmonic.bond_coeff.set('polymer', k=1.0, r0=1.0)
+        nl = md.nlist.cell()
+        self.pair = md.pair.lj(r_cut=2.5, nlist=nl)
+        self.pair.pair_coeff.set('A','A',epsilon=1.0, sigma=1.0)
+        self.pair.pair_coeff.set('A','B',epsilon=1.0, sigma=1.0)
+        self.pair.pair_coeff.set('B','B',epsilon=1.0, sigma=1.0)
+        md.integrate.mode_standard(dt=0.001);
+        md.integrate.nve(group.all());
+
+    # test that forces with overlap agree with those computed without it
+    def test_forces(self):
+        if context.current.on_gpu():
+            return
+
+        run(50)
+        snap = self.s.take_snapshot()
+
+        comm.overlap_ghosts()
+        run(50)
+        forces_overlap = [p.net_force for p in self.s.particles]
+        energy_overlap = [p.net_energy for p in self.s.particles]
+
+        self.s.restore_snapshot(snap)
+        comm.overlap_ghosts(enable=False)
+        run(50)
+        forces = [p.net_force for p in self.s.particles]
+        energy = [p.net_energy for p in self.s.particles]
+
+        for f, f_overlap in zip(forces, forces_overlap):
+            for i in range(3):
+                self.assertAlmostEqual(f[i], f_overlap[i], places=3)
+        for e, e_overlap in zip(energy, energy_overlap):
+            self.assertAlmostEqual(e, e_overlap, places=3)
+
+    # test that persistent requests, also combined with overlap, reproduce the trajectory
+    def test_persistent_requests(self):
+        if context.current.on_gpu():
+            return
+
+        snap = self.s.take_snapshot()
+        run(100)
+        pos = [p.position for p in self.s.particles]
+
+        self.s.restore_snapshot(snap)
+        comm.persistent_requests()
+        comm.overlap_ghosts()
+        run(100)
+        pos_persistent = [p.position for p in self.s.particles]
+        comm.persistent_requests(enable=False)
+        comm.overlap_ghosts(enable=False)
+
+        for r, r_persistent in zip(pos, pos_persistent):
+            for i in range(3):
+                self.assertAlmostEqual(r[i], r_persistent[i], places=4)
+
+    # test that shared memory ghost updates, also combined with the other options, reproduce the trajectory
+    def test_shared_memory(self):
+        if context.current.on_gpu():
+            return
+
+        snap = self.s.take_snapshot()
+        run(100)
+        pos = [p.position for p in self.s.particles]
+
+        self.s.restore_snapshot(snap)
+        comm.shared_memory_ghosts()
+        comm.persistent_requests()
+        comm.overlap_ghosts()
+        run(100)
+        pos_shm = [p.position for p in self.s.particles]
+        comm.shared_memory_ghosts(enable=False)
+        comm.persistent_requests(enable=False)
+        comm.overlap_ghosts(enable=False)
+
+        for r, r_shm in zip(pos, pos_shm):
+            for i in range(3):
+                self.assertAlmostEqual(r[i], r_shm[i], places=4)
+
+    # test that compressed ghost updates reproduce the trajectory within their precision
+    def test_compression(self):
+        if context.current.on_gpu():
+            return
+
+        snap = self.s.take_snapshot()
+        run(100)
+        pos = [p.position for p in self.s.particles]
+
+        self.s.restore_snapshot(snap)
+        comm.compress_ghosts()
+        comm.persistent_requests()
+        run(100)
+        pos_compressed = [p.position for p in self.s.particles]
+        comm.compress_ghosts(enable=False)
+        comm.persistent_requests(enable=False)
+
+        for r, r_compressed in zip(pos, pos_compressed):
+            for i in range(3):
+                self.assertAlmostEqual(r[i], r_compressed[i], places=3)
+
+    # test that a tolerance below the precision of the fixed point positions is rejected
+    def test_compression_tolerance(self):
+        if context.current.on_gpu() or comm.get_num_ranks() == 1:
+            return
+
+        with self.assertRaises(RuntimeError):
+            comm.compress_ghosts(tolerance=1e-12)
+
+    # test that keeping the ghosts within the skin reproduces the trajectory
+    def test_ghost_skin(self):
+        if context.current.on_gpu():
+            return
+
+        snap = self.s.take_snapshot()
+        run(100)
+        pos = [p.position for p in self.s.particles]
+
+        self.s.restore_snapshot(snap)
+        comm.ghost_skin(0.5)
+        run(100)
+        pos_skin = [p.position for p in self.s.particles]
+
+        cpp_comm = context.current.system.getCommunicator()
+        if cpp_comm is not None:
+            self.assertAlmostEqual(cpp_comm.getGhostSkin(), 0.5)
+        comm.ghost_skin(0)
+
+        for r, r_skin in zip(pos, pos_skin):
+            for i in range(3):
+                self.assertAlmostEqual(r[i], r_skin[i], places=4)
+
+    # test that the ghost traffic is counted
+    def test_ghost_traffic(self):
+        run(10)
+        traffic = comm.get_ghost_traffic(reset=True)
+        self.assertEqual(sorted(traffic.keys()), ['network', 'node', 'numa', 'socket'])
+        if comm.get_num_ranks() > 1 and not context.current.on_gpu():
+            self.assertGreater(sum(traffic.values()), 0)
+
+        traffic = comm.get_ghost_traffic()
+        self.assertEqual(sum(traffic.values()), 0)
+
+    # test that overlap can only be enabled after initialization
+    def test_not_initialized(self):
+        self.tearDown()
+        with self.assertRaises(RuntimeError):
+            comm.overlap_ghosts()
+        self.setUp()
+
+    def tearDown(self):
+        del self.harmonic
+        del self.pair
+        del self.s
+        context.initialize();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
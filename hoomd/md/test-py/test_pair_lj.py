@@ -39,6 +39,8 @@ class pair_lj_tests (unittest.TestCase):
         lj.set_params(mode="shift");
         lj.set_params(mode="xplor");
         self.assertRaises(RuntimeError, lj.set_params, mode="blah");
+        lj.set_params(vectorize=False);
+        lj.set_params(vectorize=True);
 
     # test default coefficients
     def test_default_coeff(self):
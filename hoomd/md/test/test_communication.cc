@@ -1677,9 +1677,29 @@ void test_communicator_ghosts(communicator_creator comm_creator,
             }
         }
 
-    // update ghosts
+    // update ghosts, and make progress on the update while holding the particle data, like a force compute that
+    // overlaps it with computation (in debug builds, a nested access to the arrays fails an assertion)
     comm->beginUpdateGhosts(0);
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+
+        // all directions, including the forwarded ghosts, must complete without finishUpdateGhosts()
+        bool done = false;
+        double start = MPI_Wtime();
+        while (! done && MPI_Wtime() - start < 10.0)
+            done = comm->progressUpdateGhosts();
+        UP_ASSERT(done);
+
+        // on the CPU, the ghosts are only copied into the particle data by finishUpdateGhosts()
+        if (! exec_conf->isCUDAEnabled())
+            UP_ASSERT(comm->isGhostUpdatePending());
+        }
     comm->finishUpdateGhosts(0);
+    UP_ASSERT(! comm->isGhostUpdatePending());
+    UP_ASSERT(comm->progressUpdateGhosts());
 
     // check ghost positions, taking into account that the particles should have been wrapped across the boundaries
         {
@@ -2742,6 +2762,139 @@ void test_communicator_bonded_ghosts(communicator_creator comm_creator,
         }
     }
 
+//! Check that a rank owns exactly the groups with a local member
+template<class group_data>
+void check_group_ownership(std::shared_ptr<group_data> gdata,
+                           std::shared_ptr<ParticleData> pdata,
+                           const std::vector<typename group_data::members_t>& groups)
+    {
+    ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_group_rtag(gdata->getRTags(), access_location::host, access_mode::read);
+
+    unsigned int n_local = 0;
+    for (unsigned int group_tag = 0; group_tag < groups.size(); ++group_tag)
+        {
+        bool has_local_member = false;
+        for (unsigned int i = 0; i < group_data::size; ++i)
+            if (h_rtag.data[groups[group_tag].tag[i]] < pdata->getN())
+                has_local_member = true;
+
+        UP_ASSERT_EQUAL(h_group_rtag.data[group_tag] < gdata->getN(), has_local_member);
+        if (has_local_member)
+            n_local++;
+        }
+
+    UP_ASSERT_EQUAL(gdata->getN(), n_local);
+    }
+
+//! Test that bonds and angles migrate together with their member particles
+void test_communicator_mixed_group_exchange(communicator_creator comm_creator,
+                                            std::shared_ptr<ExecutionConfiguration> exec_conf,
+                                            const BoxDim& box,
+                                            std::shared_ptr<DomainDecomposition> decomposition)
+    {
+    // this test needs to be run on eight processors
+    int size;
+    MPI_Comm_size(exec_conf->getHOOMDWorldMPICommunicator(), &size);
+    UP_ASSERT_EQUAL(size,8);
+
+    // create a system with eight particles
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(8,           // number of particles
+                                                             box,         // box dimensions
+                                                             1,           // number of particle types
+                                                             1,           // number of bond types
+                                                             1,           // number of angle types
+                                                             0,           // number of dihedral types
+                                                             0,           // number of dihedral types
+                                                             exec_conf));
+
+    std::shared_ptr<ParticleData> pdata(sysdef->getParticleData());
+
+    // place one particle in every box
+    pdata->setPosition(0, make_scalar3(-0.4,-0.4,-0.4),false);
+    pdata->setPosition(1, make_scalar3( 0.4,-0.4,-0.4),false);
+    pdata->setPosition(2, make_scalar3(-0.4, 0.4,-0.4),false);
+    pdata->setPosition(3, make_scalar3( 0.4, 0.4,-0.4),false);
+    pdata->setPosition(4, make_scalar3(-0.4,-0.4, 0.4),false);
+    pdata->setPosition(5, make_scalar3( 0.4,-0.4, 0.4),false);
+    pdata->setPosition(6, make_scalar3(-0.4, 0.4, 0.4),false);
+    pdata->setPosition(7, make_scalar3( 0.4, 0.4, 0.4),false);
+
+    // bond the particles along the edges of a cube, and add angles at four corners
+    std::shared_ptr<BondData> bdata(sysdef->getBondData());
+    std::shared_ptr<AngleData> adata(sysdef->getAngleData());
+
+    unsigned int bond_members[12][2] = {{0,1},{0,2},{0,4},{1,3},{1,5},{2,3},{2,6},{3,7},{4,5},{4,6},{5,7},{6,7}};
+    std::vector<BondData::members_t> bonds(12);
+    for (unsigned int i = 0; i < 12; ++i)
+        {
+        bdata->addBondedGroup(Bond(0, bond_members[i][0], bond_members[i][1]));
+        bonds[i].tag[0] = bond_members[i][0];
+        bonds[i].tag[1] = bond_members[i][1];
+        }
+
+    unsigned int angle_members[4][3] = {{1,0,2},{0,1,5},{2,3,7},{4,6,7}};
+    std::vector<AngleData::members_t> angles(4);
+    for (unsigned int i = 0; i < 4; ++i)
+        {
+        adata->addBondedGroup(Angle(0, angle_members[i][0], angle_members[i][1], angle_members[i][2]));
+        for (unsigned int j = 0; j < 3; ++j)
+            angles[i].tag[j] = angle_members[i][j];
+        }
+
+    SnapshotParticleData<Scalar> snap(8);
+    pdata->takeSnapshot(snap);
+
+    BondData::Snapshot bdata_snap(12);
+    bdata->takeSnapshot(bdata_snap);
+
+    AngleData::Snapshot adata_snap(4);
+    adata->takeSnapshot(adata_snap);
+
+    std::shared_ptr<Communicator> comm = comm_creator(sysdef, decomposition);
+
+    // width of ghost layer
+    ghost_layer_width g(0.1);
+    comm->getGhostLayerWidthRequestSignal().connect<ghost_layer_width, &ghost_layer_width::get>(g);
+
+    pdata->setDomainDecomposition(decomposition);
+
+    // distribute particles and groups on processors
+    pdata->initializeFromSnapshot(snap);
+    bdata->initializeFromSnapshot(bdata_snap);
+    adata->initializeFromSnapshot(adata_snap);
+
+    comm->migrateParticles();
+
+    UP_ASSERT_EQUAL(pdata->getN(), 1);
+    check_group_ownership(bdata, pdata, bonds);
+    check_group_ownership(adata, pdata, angles);
+
+    // move particle 0 to box 1
+    pdata->setPosition(0, make_scalar3(.3, -0.4, -0.4),false);
+    comm->migrateParticles();
+
+    check_group_ownership(bdata, pdata, bonds);
+    check_group_ownership(adata, pdata, angles);
+
+    // move it back, and move particle 7 to box 6 at the same time
+    pdata->setPosition(0, make_scalar3(-.3, -0.4, -0.4),false);
+    pdata->setPosition(7, make_scalar3(-.3, 0.4, 0.4),false);
+    comm->migrateParticles();
+
+    check_group_ownership(bdata, pdata, bonds);
+    check_group_ownership(adata, pdata, angles);
+
+    // migrating without any moving particle changes nothing
+    comm->migrateParticles();
+
+    check_group_ownership(bdata, pdata, bonds);
+    check_group_ownership(adata, pdata, angles);
+
+    UP_ASSERT_EQUAL(bdata->getNGlobal(), 12);
+    UP_ASSERT_EQUAL(adata->getNGlobal(), 4);
+    }
+
 bool migrate_request(unsigned int timestep)
     {
     return true;
@@ -3256,6 +3409,20 @@ void test_communicator_ghost_layer_width(communicator_creator comm_creator, std:
         CHECK_CLOSE(h_r_ghost.data[0], 0.3, tol);
         CHECK_CLOSE(h_r_ghost.data[1], 0.2, tol);
         }
+
+    // the ghost skin widens the layer of every type
+    if (! exec_conf->isCUDAEnabled())
+        {
+        comm->setGhostSkin(Scalar(0.1));
+        pdata->removeAllGhostParticles();
+        comm->exchangeGhosts();
+            {
+            ArrayHandle<Scalar> h_r_ghost(comm->getGhostLayerWidth(), access_location::host, access_mode::read);
+            CHECK_CLOSE(h_r_ghost.data[0], 0.4, tol);
+            CHECK_CLOSE(h_r_ghost.data[1], 0.3, tol);
+            }
+        CHECK_CLOSE(comm->getGhostLayerMaxWidth(), 0.4, tol);
+        }
     }
 
 //! Test per-type ghost layer
@@ -3639,6 +3806,17 @@ UP_TEST( communicator_bond_exchange_test)
         }
     }
 
+UP_TEST( communicator_mixed_group_exchange_test)
+    {
+    if (!exec_conf_cpu)
+        exec_conf_cpu = std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    communicator_creator communicator_creator_base = bind(base_class_communicator_creator, _1, _2);
+    BoxDim box(2.0);
+    std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf_cpu, box.getL()));
+    test_communicator_mixed_group_exchange(communicator_creator_base, exec_conf_cpu, box, decomposition);
+    }
+
 UP_TEST( communicator_ghost_fields_test)
     {
     if (!exec_conf_cpu)
@@ -9,6 +9,7 @@
 #include <fstream>
 
 #include <functional>
+#include <algorithm>
 #include <memory>
 
 #include "hoomd/md/AllPairPotentials.h"
@@ -531,6 +532,192 @@ void lj_force_shift_test(ljforce_creator lj_creator, std::shared_ptr<ExecutionCo
     }
     }
 
+#ifdef ENABLE_TBB
+//! Test that the multithreaded CPU path gives the same forces as the serial one
+void lj_force_threaded_test(NeighborList::storageMode mode, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    const unsigned int N = 2000;
+
+    // create a random particle system to sum forces on
+    RandomInitializer rand_init(N, Scalar(0.2), Scalar(0.9), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = rand_init.getSnapshot();
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setFlags(~PDataFlags(0));
+
+    std::shared_ptr<NeighborListTree> nlist(new NeighborListTree(sysdef, Scalar(3.0), Scalar(0.8)));
+    nlist->setStorageMode(mode);
+
+    std::shared_ptr<PotentialPairLJ> fc_serial(new PotentialPairLJ(sysdef, nlist));
+    std::shared_ptr<PotentialPairLJ> fc_threaded(new PotentialPairLJ(sysdef, nlist));
+
+    Scalar lj1 = Scalar(4.0) * pow(Scalar(1.2),Scalar(12.0));
+    Scalar lj2 = Scalar(0.45) * Scalar(4.0) * pow(Scalar(1.2),Scalar(6.0));
+    fc_serial->setRcut(0, 0, Scalar(3.0));
+    fc_threaded->setRcut(0, 0, Scalar(3.0));
+    fc_serial->setParams(0,0,make_scalar2(lj1,lj2));
+    fc_threaded->setParams(0,0,make_scalar2(lj1,lj2));
+
+    unsigned int old_num_threads = exec_conf->getNumThreads();
+    exec_conf->setNumThreads(1);
+    fc_serial->compute(0);
+    exec_conf->setNumThreads(4);
+    fc_threaded->compute(0);
+    exec_conf->setNumThreads(old_num_threads);
+
+    {
+    ArrayHandle<Scalar4> h_force_1(fc_serial->getForceArray(),access_location::host,access_mode::read);
+    ArrayHandle<Scalar> h_virial_1(fc_serial->getVirialArray(),access_location::host,access_mode::read);
+    ArrayHandle<Scalar4> h_force_2(fc_threaded->getForceArray(),access_location::host,access_mode::read);
+    ArrayHandle<Scalar> h_virial_2(fc_threaded->getVirialArray(),access_location::host,access_mode::read);
+    unsigned int pitch = fc_serial->getVirialArray().getPitch();
+
+    for (unsigned int i = 0; i < N; i++)
+        {
+        // the summation order differs between the two paths, compare relative to the magnitude
+        UP_ASSERT(std::abs(h_force_1.data[i].x - h_force_2.data[i].x) <= tol_small*(Scalar(1.0)+std::abs(h_force_1.data[i].x)));
+        UP_ASSERT(std::abs(h_force_1.data[i].y - h_force_2.data[i].y) <= tol_small*(Scalar(1.0)+std::abs(h_force_1.data[i].y)));
+        UP_ASSERT(std::abs(h_force_1.data[i].z - h_force_2.data[i].z) <= tol_small*(Scalar(1.0)+std::abs(h_force_1.data[i].z)));
+        UP_ASSERT(std::abs(h_force_1.data[i].w - h_force_2.data[i].w) <= tol_small*(Scalar(1.0)+std::abs(h_force_1.data[i].w)));
+        for (unsigned int j = 0; j < 6; j++)
+            UP_ASSERT(std::abs(h_virial_1.data[j*pitch+i] - h_virial_2.data[j*pitch+i])
+                <= tol_small*(Scalar(1.0)+std::abs(h_virial_1.data[j*pitch+i])));
+        }
+    }
+    }
+#endif
+
+#ifdef ENABLE_PAIR_SIMD
+//! Test that the vectorized CPU path gives the same forces as the scalar evaluator
+void lj_force_vectorized_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    const unsigned int N = 2000;
+
+    // create a random particle system to sum forces on
+    RandomInitializer rand_init(N, Scalar(0.2), Scalar(0.9), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = rand_init.getSnapshot();
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setFlags(~PDataFlags(0));
+
+    std::shared_ptr<NeighborListTree> nlist(new NeighborListTree(sysdef, Scalar(3.0), Scalar(0.8)));
+    nlist->setStorageMode(NeighborList::full);
+
+    Scalar lj1 = Scalar(4.0) * pow(Scalar(1.2),Scalar(12.0));
+    Scalar lj2 = Scalar(0.45) * Scalar(4.0) * pow(Scalar(1.2),Scalar(6.0));
+    Scalar rcutsq = Scalar(3.0)*Scalar(3.0);
+
+    // evaluate the pairs of the neighbor list pair_simd::width at a time, and compare every lane to the scalar
+    // evaluator
+    nlist->compute(0);
+
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_n_neigh(nlist->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist(nlist->getNListArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_head_list(nlist->getHeadList(), access_location::host, access_mode::read);
+    const BoxDim& box = pdata->getBox();
+
+    EvaluatorPairLJ::param_type params = make_scalar2(lj1,lj2);
+    int typpair[pair_simd::width];
+    Scalar rsq[pair_simd::width];
+    Scalar simd_force_divr[pair_simd::width];
+    Scalar simd_pair_eng[pair_simd::width];
+    Scalar simd_evaluated[pair_simd::width];
+    for (unsigned int l = 0; l < pair_simd::width; ++l)
+        typpair[l] = 0;
+
+    unsigned int n_pairs = 0;
+    for (unsigned int i = 0; i < N; i++)
+        {
+        Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+        for (unsigned int k = 0; k < h_n_neigh.data[i]; k += pair_simd::width)
+            {
+            unsigned int n_lanes = std::min(h_n_neigh.data[i] - k, pair_simd::width);
+            for (unsigned int l = 0; l < pair_simd::width; ++l)
+                {
+                // pad the last batch with a pair beyond the cutoff
+                rsq[l] = Scalar(2.0)*rcutsq;
+                if (l < n_lanes)
+                    {
+                    unsigned int j = h_nlist.data[h_head_list.data[i] + k + l];
+                    Scalar3 dx = box.minImage(pi - make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z));
+                    rsq[l] = dot(dx, dx);
+                    }
+                }
+
+            for (unsigned int m = 0; m < 2; ++m)
+                {
+                bool energy_shift = (m == 1);
+                pair_simd::vreal force_divr, pair_eng;
+                pair_simd::vmask mask = EvaluatorPairLJ::evalForceAndEnergySIMD(pair_simd::load(rsq),
+                    pair_simd::set1(rcutsq), &params, typpair, energy_shift, force_divr, pair_eng);
+                pair_simd::store(simd_force_divr, force_divr);
+                pair_simd::store(simd_pair_eng, pair_eng);
+                pair_simd::store(simd_evaluated, pair_simd::select(mask, pair_simd::set1(Scalar(1.0)),
+                    pair_simd::set1(Scalar(0.0))));
+
+                for (unsigned int l = 0; l < pair_simd::width; ++l)
+                    {
+                    EvaluatorPairLJ eval(rsq[l], rcutsq, params);
+                    Scalar force_divr_ref = Scalar(0.0), pair_eng_ref = Scalar(0.0);
+                    bool evaluated = eval.evalForceAndEnergy(force_divr_ref, pair_eng_ref, energy_shift);
+
+                    UP_ASSERT_EQUAL(simd_evaluated[l] != Scalar(0.0), evaluated);
+                    if (evaluated)
+                        {
+                        UP_ASSERT(std::abs(simd_force_divr[l] - force_divr_ref)
+                            <= tol_small*(Scalar(1.0)+std::abs(force_divr_ref)));
+                        UP_ASSERT(std::abs(simd_pair_eng[l] - pair_eng_ref)
+                            <= tol_small*(Scalar(1.0)+std::abs(pair_eng_ref)));
+                        n_pairs++;
+                        }
+                    }
+                }
+            }
+        }
+
+    // the configuration must exercise the kernel
+    UP_ASSERT(n_pairs > 0);
+    }
+
+    // the whole compute must agree with the scalar path on the same configuration
+    std::shared_ptr<PotentialPairLJ> fc_scalar(new PotentialPairLJ(sysdef, nlist));
+    std::shared_ptr<PotentialPairLJ> fc_vector(new PotentialPairLJ(sysdef, nlist));
+    fc_scalar->setVectorization(false);
+    fc_scalar->setShiftMode(PotentialPairLJ::shift);
+    fc_vector->setShiftMode(PotentialPairLJ::shift);
+
+    fc_scalar->setRcut(0, 0, Scalar(3.0));
+    fc_vector->setRcut(0, 0, Scalar(3.0));
+    fc_scalar->setParams(0,0,make_scalar2(lj1,lj2));
+    fc_vector->setParams(0,0,make_scalar2(lj1,lj2));
+
+    fc_scalar->compute(0);
+    fc_vector->compute(0);
+
+    {
+    ArrayHandle<Scalar4> h_force_1(fc_scalar->getForceArray(),access_location::host,access_mode::read);
+    ArrayHandle<Scalar> h_virial_1(fc_scalar->getVirialArray(),access_location::host,access_mode::read);
+    ArrayHandle<Scalar4> h_force_2(fc_vector->getForceArray(),access_location::host,access_mode::read);
+    ArrayHandle<Scalar> h_virial_2(fc_vector->getVirialArray(),access_location::host,access_mode::read);
+    unsigned int pitch = fc_scalar->getVirialArray().getPitch();
+
+    for (unsigned int i = 0; i < N; i++)
+        {
+        // the summation order differs between the two paths, compare relative to the magnitude
+        UP_ASSERT(std::abs(h_force_1.data[i].x - h_force_2.data[i].x) <= tol_small*(Scalar(1.0)+std::abs(h_force_1.data[i].x)));
+        UP_ASSERT(std::abs(h_force_1.data[i].y - h_force_2.data[i].y) <= tol_small*(Scalar(1.0)+std::abs(h_force_1.data[i].y)));
+        UP_ASSERT(std::abs(h_force_1.data[i].z - h_force_2.data[i].z) <= tol_small*(Scalar(1.0)+std::abs(h_force_1.data[i].z)));
+        UP_ASSERT(std::abs(h_force_1.data[i].w - h_force_2.data[i].w) <= tol_small*(Scalar(1.0)+std::abs(h_force_1.data[i].w)));
+        for (unsigned int j = 0; j < 6; j++)
+            UP_ASSERT(std::abs(h_virial_1.data[j*pitch+i] - h_virial_2.data[j*pitch+i])
+                <= tol_small*(Scalar(1.0)+std::abs(h_virial_1.data[j*pitch+i])));
+        }
+    }
+    }
+#endif
+
 //! LJForceCompute creator for unit tests
 std::shared_ptr<PotentialPairLJ> base_class_lj_creator(std::shared_ptr<SystemDefinition> sysdef,
                                                   std::shared_ptr<NeighborList> nlist)
@@ -570,6 +757,28 @@ UP_TEST( PotentialPairLJ_shift )
     lj_force_shift_test(lj_creator_base, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+#ifdef ENABLE_PAIR_SIMD
+//! test case comparing the vectorized CPU path with the scalar evaluator
+UP_TEST( PotentialPairLJ_vectorized )
+    {
+    lj_force_vectorized_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+#endif
+
+# ifdef ENABLE_TBB
+//! test case for the multithreaded CPU path with a half neighbor list
+UP_TEST( PotentialPairLJ_threaded_half )
+    {
+    lj_force_threaded_test(NeighborList::half, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! test case for the multithreaded CPU path with a full neighbor list
+UP_TEST( PotentialPairLJ_threaded_full )
+    {
+    lj_force_threaded_test(NeighborList::full, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+#endif
+
 # ifdef ENABLE_CUDA
 //! test case for particle test on GPU
 UP_TEST( LJForceGPU_particle )
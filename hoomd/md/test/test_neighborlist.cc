@@ -989,6 +989,67 @@ void neighborlist_comparison_test(std::shared_ptr<ExecutionConfiguration> exec_c
         }
     }
 
+#ifdef ENABLE_TBB
+//! Test that the multithreaded build of a NeighborList gives the same output as the serial one
+template <class NL>
+void neighborlist_threaded_tests(NeighborList::storageMode mode, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // construct the particle system
+    RandomInitializer init(1000, Scalar(0.2), Scalar(0.9), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = init.getSnapshot();
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::shared_ptr<NeighborList> nlist_serial(new NL(sysdef, Scalar(3.0), Scalar(0.4)));
+    nlist_serial->setRCutPair(0,0,3.0);
+    nlist_serial->setStorageMode(mode);
+
+    std::shared_ptr<NeighborList> nlist_threaded(new NL(sysdef, Scalar(3.0), Scalar(0.4)));
+    nlist_threaded->setRCutPair(0,0,3.0);
+    nlist_threaded->setStorageMode(mode);
+
+    for (unsigned int i=0; i < pdata->getN()-1; i++)
+        {
+        nlist_serial->addExclusion(i,i+1);
+        nlist_threaded->addExclusion(i,i+1);
+        }
+
+    // both lists start with room for 4 neighbors per particle, so both builds overflow and are redone
+    unsigned int old_num_threads = exec_conf->getNumThreads();
+    exec_conf->setNumThreads(1);
+    nlist_serial->compute(0);
+    exec_conf->setNumThreads(4);
+    nlist_threaded->compute(0);
+    exec_conf->setNumThreads(old_num_threads);
+
+    ArrayHandle<unsigned int> h_n_neigh1(nlist_serial->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist1(nlist_serial->getNListArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_head_list1(nlist_serial->getHeadList(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_n_neigh2(nlist_threaded->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist2(nlist_threaded->getNListArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_head_list2(nlist_threaded->getHeadList(), access_location::host, access_mode::read);
+
+    // the overflow was resolved with the same size
+    UP_ASSERT(nlist_serial->getNListArray().getNumElements() > 4*pdata->getN());
+    CHECK_EQUAL_UINT(nlist_threaded->getNListArray().getNumElements(), nlist_serial->getNListArray().getNumElements());
+
+    for (unsigned int i = 0; i < pdata->getN(); i++)
+        {
+        CHECK_EQUAL_UINT(h_head_list2.data[i], h_head_list1.data[i]);
+        CHECK_EQUAL_UINT(h_n_neigh2.data[i], h_n_neigh1.data[i]);
+
+        // the order within a row may differ, compare the sorted rows
+        std::vector<unsigned int> row1(h_nlist1.data + h_head_list1.data[i],
+                                       h_nlist1.data + h_head_list1.data[i] + h_n_neigh1.data[i]);
+        std::vector<unsigned int> row2(h_nlist2.data + h_head_list2.data[i],
+                                       h_nlist2.data + h_head_list2.data[i] + h_n_neigh2.data[i]);
+        std::sort(row1.begin(), row1.end());
+        std::sort(row2.begin(), row2.end());
+        UP_ASSERT(row1 == row2);
+        }
+    }
+#endif
+
 //! Test that a NeighborList can successfully exclude a ridiculously large number of particles
 template <class NL>
 void neighborlist_large_ex_tests(std::shared_ptr<ExecutionConfiguration> exec_conf)
@@ -1304,6 +1365,19 @@ UP_TEST( NeighborListBinned_2d )
     neighborlist_2d_tests<NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+#ifdef ENABLE_TBB
+//! threaded build test case for binned class with a full list
+UP_TEST( NeighborListBinned_threaded_full )
+    {
+    neighborlist_threaded_tests<NeighborListBinned>(NeighborList::full, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+//! threaded build test case for binned class with a half list
+UP_TEST( NeighborListBinned_threaded_half )
+    {
+    neighborlist_threaded_tests<NeighborListBinned>(NeighborList::half, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+#endif
+
 ////////////////////
 // STENCIL CPU
 ////////////////////
@@ -1364,6 +1438,19 @@ UP_TEST( NeighborListStencil_comparison )
     neighborlist_comparison_test<NeighborListBinned, NeighborListStencil>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+#ifdef ENABLE_TBB
+//! threaded build test case for stencil class with a full list
+UP_TEST( NeighborListStencil_threaded_full )
+    {
+    neighborlist_threaded_tests<NeighborListStencil>(NeighborList::full, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+//! threaded build test case for stencil class with a half list
+UP_TEST( NeighborListStencil_threaded_half )
+    {
+    neighborlist_threaded_tests<NeighborListStencil>(NeighborList::half, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+#endif
+
 ///////////////
 // TREE CPU
 ///////////////
@@ -1423,6 +1510,19 @@ UP_TEST( NeighborListTree_comparison )
     neighborlist_comparison_test<NeighborListBinned, NeighborListTree>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+#ifdef ENABLE_TBB
+//! threaded build test case for tree class with a full list
+UP_TEST( NeighborListTree_threaded_full )
+    {
+    neighborlist_threaded_tests<NeighborListTree>(NeighborList::full, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+//! threaded build test case for tree class with a half list
+UP_TEST( NeighborListTree_threaded_half )
+    {
+    neighborlist_threaded_tests<NeighborListTree>(NeighborList::half, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+#endif
+
 #ifdef ENABLE_CUDA
 ///////////////
 // BINNED GPU
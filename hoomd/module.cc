@@ -216,7 +216,13 @@ int initialize_mpi()
     MPI_Initialized(&external_init);
     if (!external_init)
         {
+        #ifdef ENABLE_TBB
+        // only the main thread makes MPI calls, the TBB worker threads never do
+        int provided;
+        MPI_Init_thread(0, (char ***) NULL, MPI_THREAD_FUNNELED, &provided);
+        #else
         MPI_Init(0, (char ***) NULL);
+        #endif
         }
 
     if (hoomd_launch_timing)
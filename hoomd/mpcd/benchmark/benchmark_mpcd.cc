@@ -0,0 +1,71 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file benchmark_mpcd.cc
+    \brief Benchmarks of the MPCD collision step
+    \ingroup benchmarks
+*/
+
+#include "hoomd/benchmark/BenchmarkSuite.h"
+
+#include "hoomd/mpcd/CellThermoCompute.h"
+#include "hoomd/mpcd/SRDCollisionMethod.h"
+#include "hoomd/mpcd/SystemData.h"
+#include "hoomd/mpcd/SystemDataSnapshot.h"
+#include "hoomd/RandomNumbers.h"
+#include "hoomd/SnapshotSystemData.h"
+
+using namespace std;
+
+//! Benchmark an SRD collision of an ideal MPCD fluid
+/*! The solvent has the usual density of 5 particles per cell of unit size. A collision is done at every step, so
+    each call sorts the particles into cells, computes the cell velocities, and rotates the relative velocities.
+*/
+void benchmark_srd(BenchmarkSuite& suite)
+    {
+    if (!suite.isSelected("srd_fluid", "SRDCollisionMethod::collide"))
+        return;
+
+    unsigned int N = suite.scaled(200000);
+    Scalar L = Scalar(ceil(cbrt(double(N) / 5.0)));
+
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap(new SnapshotSystemData<Scalar>());
+    snap->global_box = BoxDim(L);
+    snap->particle_data.type_mapping.push_back("A");
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, suite.getExecConf()));
+
+    auto mpcd_sys_snap = std::make_shared<mpcd::SystemDataSnapshot>(sysdef);
+        {
+        auto mpcd_snap = mpcd_sys_snap->particles;
+        mpcd_snap->resize(N);
+
+        hoomd::RandomGenerator rng(5, 0);
+        hoomd::UniformDistribution<Scalar> pos(-L/Scalar(2.0), L/Scalar(2.0));
+        hoomd::NormalDistribution<Scalar> vel(Scalar(1.0));
+        for (unsigned int i = 0; i < N; i++)
+            {
+            mpcd_snap->position[i] = vec3<Scalar>(pos(rng), pos(rng), pos(rng));
+            mpcd_snap->velocity[i] = vec3<Scalar>(vel(rng), vel(rng), vel(rng));
+            }
+        }
+
+    auto mpcd_sys = std::make_shared<mpcd::SystemData>(mpcd_sys_snap);
+    auto thermo = std::make_shared<mpcd::CellThermoCompute>(mpcd_sys);
+    auto collide = std::make_shared<mpcd::SRDCollisionMethod>(mpcd_sys, 0, 1, 0, 42, thermo);
+    collide->setRotationAngle(2.2689280275926285);
+
+    suite.run("srd_fluid", "SRDCollisionMethod::collide", N, [&](unsigned int timestep)
+        {
+        collide->collide(timestep);
+        });
+    }
+
+int main(int argc, char **argv)
+    {
+    BenchmarkSuite suite(argc, argv, "mpcd");
+
+    benchmark_srd(suite);
+
+    return suite.finish();
+    }
@@ -87,7 +87,7 @@ def _parse_command_line(arg_string=None):
     parser.add_option("--onelevel", dest="onelevel", action="store_true", default=False, help="(MPI only) Disable two-level (node-local) decomposition");
     parser.add_option("--single-mpi", dest="single_mpi", action="store_true", help="Allow single-threaded HOOMD builds in MPI jobs");
     parser.add_option("--user", dest="user", help="User options");
-    parser.add_option("--nthreads", dest="nthreads", help="Number of TBB threads");
+    parser.add_option("--nthreads", dest="nthreads", help="Number of TBB threads per rank, or auto to share the cores of each node among its ranks");
 
     input_args = None;
     if arg_string is not None:
@@ -157,10 +157,11 @@ def _parse_command_line(arg_string=None):
        if not _hoomd.is_TBB_available():
             parser.error("The --nthreads option is only available in TBB-enabled builds.\n");
             raise RuntimeError('Error setting option');
-       try:
-            cmd_options.nthreads = int(cmd_options.nthreads);
-       except ValueError:
-            parser.error('--nthreads must be an integer')
+       if cmd_options.nthreads != 'auto':
+            try:
+                cmd_options.nthreads = int(cmd_options.nthreads);
+            except ValueError:
+                parser.error('--nthreads must be an integer or auto')
 
 
     # copy command line options over to global options
@@ -271,7 +272,13 @@ def set_num_threads(num_threads):
     R""" Set the number of CPU (TBB) threads HOOMD uses
 
     Args:
-        num_threads (int): The number of threads
+        num_threads (int): The number of threads per MPI rank, or ``'auto'``
+
+    All CPU computes that support threads share this pool. With ``'auto'``, a rank that is bound to a subset of the
+    cores (for example, one NUMA domain) uses all of them, otherwise the cores of the node are divided evenly among the
+    ranks on it. For MPI runs on nodes with many cores, run one rank per NUMA domain with ``'auto'`` threads, and bind
+    the ranks to their domains with the MPI launcher (e.g. ``mpirun --bind-to numa``). This needs far fewer ghost
+    particles and messages than one rank per core.
 
     Note:
         Overrides ``--nthreads`` on the command line.
@@ -281,6 +288,8 @@ def set_num_threads(num_threads):
     if not _hoomd.is_TBB_available():
         msg.warning("HOOMD was compiled without thread support, ignoring request to set number of threads.\n");
     else:
+        if num_threads == 'auto':
+            num_threads = hoomd.context.exec_conf.getNumThreadsPerRank();
         hoomd.context.exec_conf.setNumThreads(int(num_threads));
 
 
@@ -147,6 +147,106 @@ class gsd_write_tests (unittest.TestCase):
         if comm.get_rank() == 0:
             self.assertRaises(RuntimeError, data.gsd_snapshot, self.tmp_file, frame=1);
 
+    # tests asynchronous writes
+    def test_async(self):
+        dump.gsd(filename=self.tmp_file, group=group.all(), period=1, overwrite=True, async_write=True);
+        run(5);
+        # all frames must be in the file at the end of the run
+        data.gsd_snapshot(self.tmp_file, frame=4);
+        if comm.get_rank() == 0:
+            self.assertRaises(RuntimeError, data.gsd_snapshot, self.tmp_file, frame=5);
+
+    # tests asynchronous writes with truncate
+    def test_async_truncate(self):
+        dump.gsd(filename=self.tmp_file, group=group.all(), period=1, truncate=True, overwrite=True, async_write=True);
+        run(5);
+        data.gsd_snapshot(self.tmp_file, frame=0);
+        if comm.get_rank() == 0:
+            self.assertRaises(RuntimeError, data.gsd_snapshot, self.tmp_file, frame=1);
+
+    # tests asynchronous writes that may drop frames
+    def test_async_drop(self):
+        dump.gsd(filename=self.tmp_file, group=group.all(), period=1, overwrite=True, async_write=True, drop_frames=True);
+        run(5);
+        # the first frame is never dropped
+        data.gsd_snapshot(self.tmp_file, frame=0);
+        if comm.get_rank() == 0:
+            self.assertRaises(RuntimeError, data.gsd_snapshot, self.tmp_file, frame=5);
+
+    # tests writes of the particle data from all ranks
+    def test_distributed(self):
+        dump.gsd(filename=self.tmp_file, group=group.all(), period=1, overwrite=True, distributed=True,
+                 dynamic=['attribute', 'momentum']);
+        run(3);
+
+        snap = data.gsd_snapshot(self.tmp_file, frame=2);
+        if comm.get_rank() == 0:
+            self.assertRaises(RuntimeError, data.gsd_snapshot, self.tmp_file, frame=3);
+            numpy.testing.assert_array_equal(snap.particles.position, self.snapshot.particles.position);
+            numpy.testing.assert_array_equal(snap.particles.velocity, self.snapshot.particles.velocity);
+            numpy.testing.assert_array_equal(snap.particles.image, self.snapshot.particles.image);
+            numpy.testing.assert_array_equal(snap.particles.typeid, self.snapshot.particles.typeid);
+            numpy.testing.assert_array_equal(snap.particles.mass, self.snapshot.particles.mass);
+            numpy.testing.assert_array_equal(snap.particles.diameter, self.snapshot.particles.diameter);
+            self.assertEqual(snap.particles.types, self.snapshot.particles.types);
+            self.assertEqual(snap.bonds.N, 2);
+
+    # tests writes of a subset of the particles from all ranks
+    def test_distributed_group(self):
+        dump.gsd(filename=self.tmp_file, group=group.tags(1, 2), period=None, time_step=0, overwrite=True,
+                 distributed=True);
+
+        snap = data.gsd_snapshot(self.tmp_file, frame=0);
+        if comm.get_rank() == 0:
+            self.assertEqual(snap.particles.N, 2);
+            numpy.testing.assert_array_equal(snap.particles.position, self.snapshot.particles.position[1:3]);
+
+    def test_distributed_async(self):
+        self.assertRaises(ValueError, dump.gsd, filename=self.tmp_file, group=group.all(), period=1,
+                          async_write=True, distributed=True);
+
+    # tests lossless compression of positions and velocities
+    def test_compression_lossless(self):
+        try:
+            dump.gsd(filename=self.tmp_file, group=group.all(), period=1, overwrite=True, compression='lossless',
+                     dynamic=['momentum']);
+        except RuntimeError:
+            self.skipTest("HOOMD is built without zlib");
+        run(3);
+
+        snap = data.gsd_snapshot(self.tmp_file, frame=2);
+        if comm.get_rank() == 0:
+            numpy.testing.assert_array_equal(snap.particles.position, self.snapshot.particles.position);
+            numpy.testing.assert_array_equal(snap.particles.velocity, self.snapshot.particles.velocity);
+            numpy.testing.assert_array_equal(snap.particles.image, self.snapshot.particles.image);
+
+    # tests lossy compression, frames after the first are stored as differences
+    def test_compression_lossy(self):
+        tol = 0.03;
+        dump.gsd(filename=self.tmp_file, group=group.all(), period=1, overwrite=True, compression='lossy',
+                 tolerance=tol, dynamic=['momentum']);
+        run(1);
+        for p in self.s.particles:
+            p.position = (p.position[0] + 0.0123, p.position[1] - 0.0456, p.position[2]);
+        run(2);
+
+        snap0 = data.gsd_snapshot(self.tmp_file, frame=0);
+        snap2 = data.gsd_snapshot(self.tmp_file, frame=2);
+        if comm.get_rank() == 0:
+            numpy.testing.assert_allclose(snap0.particles.position, self.snapshot.particles.position,
+                                          rtol=0, atol=tol/2);
+            numpy.testing.assert_allclose(snap2.particles.position,
+                                          self.snapshot.particles.position + [0.0123, -0.0456, 0],
+                                          rtol=0, atol=tol/2 + 1e-6);
+            numpy.testing.assert_allclose(snap2.particles.velocity, self.snapshot.particles.velocity,
+                                          rtol=0, atol=tol/2);
+
+    def test_compression_invalid(self):
+        self.assertRaises(ValueError, dump.gsd, filename=self.tmp_file, group=group.all(), period=1,
+                          compression='zip');
+        self.assertRaises(ValueError, dump.gsd, filename=self.tmp_file, group=group.all(), period=1,
+                          compression='lossy', distributed=True);
+
     # test write file
     def test_write_immediate(self):
         dump.gsd(filename=self.tmp_file, group=group.all(), period=None, time_step=1000, overwrite=True);
@@ -445,6 +545,29 @@ class gsd_read_tests (unittest.TestCase):
 
         init.read_gsd(filename=self.tmp_file, frame=-1);
 
+    # tests init.read_gsd with every rank reading its own particles
+    def test_read_gsd_distributed(self):
+        dump.gsd(filename=self.tmp_file, group=group.all(), period=None, overwrite=True);
+        context.initialize();
+
+        s = init.read_gsd(filename=self.tmp_file, distributed=True);
+        snap = s.take_snapshot(all=True);
+        if comm.get_rank() == 0:
+            self.assertEqual(snap.particles.N, self.snapshot.particles.N);
+            self.assertEqual(snap.particles.types, self.snapshot.particles.types);
+            numpy.testing.assert_array_equal(snap.particles.typeid, self.snapshot.particles.typeid);
+            numpy.testing.assert_array_equal(snap.particles.mass, self.snapshot.particles.mass);
+            numpy.testing.assert_array_equal(snap.particles.moment_inertia, self.snapshot.particles.moment_inertia);
+            numpy.testing.assert_array_equal(snap.particles.position, self.snapshot.particles.position);
+            numpy.testing.assert_array_equal(snap.particles.orientation, self.snapshot.particles.orientation);
+            numpy.testing.assert_array_equal(snap.particles.velocity, self.snapshot.particles.velocity);
+            numpy.testing.assert_array_equal(snap.particles.image, self.snapshot.particles.image);
+
+            self.assertEqual(snap.bonds.N, self.snapshot.bonds.N);
+            self.assertEqual(snap.bonds.types, self.snapshot.bonds.types);
+            numpy.testing.assert_array_equal(snap.bonds.group, self.snapshot.bonds.group);
+            self.assertEqual(snap.pairs.N, self.snapshot.pairs.N);
+
     def tearDown(self):
         if comm.get_rank() == 0:
             os.remove(self.tmp_file);
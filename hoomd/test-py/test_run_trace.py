@@ -0,0 +1,83 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+import signal
+# hoomd chains its SIGINT handler to this one, so that the test can interrupt a run without a KeyboardInterrupt
+signal.signal(signal.SIGINT, lambda signum, frame: None);
+
+import hoomd
+hoomd.context.initialize()
+import unittest
+import json
+import os
+import tempfile
+
+class run_trace_tests(unittest.TestCase):
+
+    def setUp(self):
+        sysdef = hoomd.init.create_lattice(unitcell=hoomd.lattice.sq(a=2.0),
+                                           n=[4,4]);
+        if hoomd.comm.get_rank() == 0:
+            tmp = tempfile.mkstemp(suffix='.test.json');
+            self.tmp_file = tmp[1];
+            tmp = tempfile.mkstemp(suffix='.test.gsd');
+            self.gsd_file = tmp[1];
+        else:
+            self.tmp_file = "invalid";
+            self.gsd_file = "invalid";
+
+    # check that the trace is valid and every region is closed
+    def test_trace(self):
+        hoomd.dump.gsd(filename=self.gsd_file, group=hoomd.group.all(), period=1, overwrite=True);
+        hoomd.run(10, trace=self.tmp_file);
+
+        if hoomd.comm.get_rank() == 0:
+            with open(self.tmp_file) as f:
+                trace = json.load(f);
+
+            events = trace['traceEvents'];
+            names = [e['name'] for e in events if e['ph'] == 'B'];
+            self.assertGreater(names.count('Dump GSD'), 0);
+
+            depth = {};
+            for e in events:
+                key = (e['pid'], e.get('tid'));
+                if e['ph'] == 'B':
+                    depth[key] = depth.get(key, 0) + 1;
+                elif e['ph'] == 'E':
+                    depth[key] = depth.get(key, 0) - 1;
+                    self.assertGreaterEqual(depth[key], 0);
+            self.assertTrue(all(d == 0 for d in depth.values()));
+
+    # check that the trace is written when the run is interrupted with Ctrl-C
+    def test_interrupted(self):
+        hoomd.dump.gsd(filename=self.gsd_file, group=hoomd.group.all(), period=1, overwrite=True);
+
+        def interrupt(step):
+            if step == 5:
+                os.kill(os.getpid(), signal.SIGINT);
+
+        hoomd.run(10, trace=self.tmp_file, callback_period=1, callback=interrupt);
+        self.assertLess(hoomd.get_step(), 10);
+
+        if hoomd.comm.get_rank() == 0:
+            with open(self.tmp_file) as f:
+                trace = json.load(f);
+
+            names = [e['name'] for e in trace['traceEvents'] if e['ph'] == 'B'];
+            self.assertGreater(names.count('Dump GSD'), 0);
+
+    # check that errors are raised, and that the next run without a trace does not write one
+    def test_invalid_file(self):
+        if hoomd.comm.get_num_ranks() == 1:
+            self.assertRaises(RuntimeError, hoomd.run, 10, trace='/invalid/path/trace.json');
+        hoomd.run(10);
+
+    def tearDown(self):
+        hoomd.context.initialize();
+        if hoomd.comm.get_rank() == 0:
+            os.remove(self.tmp_file);
+            os.remove(self.gsd_file);
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
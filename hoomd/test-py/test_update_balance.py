@@ -22,6 +22,26 @@ class load_balance_tests (unittest.TestCase):
         if hoomd.context.current.decomposition is not None:
             lb.set_params(x=True, y=True, z=True, tolerance=0.95, maxiter=1)
 
+    ## Test that balancing by bisection runs
+    def test_bisection(self):
+        lb = hoomd.update.balance(tolerance=0.95, period=1, bisection=True)
+        if hoomd.context.current.decomposition is not None:
+            lb.set_params(bisection=False)
+            lb.set_params(bisection=True)
+        hoomd.run(2)
+
+    ## Test that balancing weighted by the compute time runs
+    def test_time_weighting(self):
+        if hoomd.context.exec_conf.isCUDAEnabled():
+            return
+        lb = hoomd.update.balance(tolerance=0.95, period=1, weight='time', damping=0.8)
+        if hoomd.context.current.decomposition is not None:
+            with self.assertRaises(ValueError):
+                lb.set_params(weight='neighbors')
+            with self.assertRaises(RuntimeError):
+                lb.set_params(damping=1.0)
+        hoomd.run(2)
+
     def tearDown(self):
         hoomd.context.initialize()
 
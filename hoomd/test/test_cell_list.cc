@@ -582,3 +582,65 @@ UP_TEST( CellListGPU_large )
     celllist_large_test<CellListGPU>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
 #endif
+
+#ifdef ENABLE_TBB
+//! Validate that the multithreaded cell list build gives the same cells as the serial one
+template <class CL>
+void celllist_threaded_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    unsigned int N = 10000;
+    RandomInitializer rand_init(N, Scalar(0.2), Scalar(0.9), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap;
+    snap = rand_init.getSnapshot();
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+
+    std::shared_ptr<CellList> cl_serial(new CL(sysdef));
+    cl_serial->setNominalWidth(Scalar(3.0));
+    cl_serial->setRadius(1);
+    cl_serial->setFlagIndex();
+
+    std::shared_ptr<CellList> cl_threaded(new CL(sysdef));
+    cl_threaded->setNominalWidth(Scalar(3.0));
+    cl_threaded->setRadius(1);
+    cl_threaded->setFlagIndex();
+
+    // Nmax starts at the average cell occupancy, so both builds overflow and are redone
+    unsigned int old_num_threads = exec_conf->getNumThreads();
+    exec_conf->setNumThreads(1);
+    cl_serial->compute(0);
+    exec_conf->setNumThreads(4);
+    cl_threaded->compute(0);
+    exec_conf->setNumThreads(old_num_threads);
+
+    uint3 dim1 = cl_serial->getDim();
+    uint3 dim2 = cl_threaded->getDim();
+    UP_ASSERT(dim1.x == dim2.x && dim1.y == dim2.y && dim1.z == dim2.z);
+    CHECK_EQUAL_UINT(cl_threaded->getNmax(), cl_serial->getNmax());
+
+    ArrayHandle<unsigned int> h_cell_size1(cl_serial->getCellSizeArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_xyzf1(cl_serial->getXYZFArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_cell_size2(cl_threaded->getCellSizeArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_xyzf2(cl_threaded->getXYZFArray(), access_location::host, access_mode::read);
+
+    // the particles are in the same cells and in the same order within each cell
+    Index2D cli = cl_serial->getCellListIndexer();
+    unsigned int ncell = cl_serial->getCellIndexer().getNumElements();
+    for (unsigned int cell = 0; cell < ncell; cell++)
+        {
+        CHECK_EQUAL_UINT(h_cell_size2.data[cell], h_cell_size1.data[cell]);
+        for (unsigned int offset = 0; offset < h_cell_size1.data[cell]; offset++)
+            {
+            Scalar4 a = h_xyzf1.data[cli(offset, cell)];
+            Scalar4 b = h_xyzf2.data[cli(offset, cell)];
+            UP_ASSERT(a.x == b.x && a.y == b.y && a.z == b.z);
+            CHECK_EQUAL_UINT(__scalar_as_int(b.w), __scalar_as_int(a.w));
+            }
+        }
+    }
+
+//! test case for celllist_threaded_test
+UP_TEST( CellList_threaded )
+    {
+    celllist_threaded_test<CellList>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+#endif
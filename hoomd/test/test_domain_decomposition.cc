@@ -0,0 +1,175 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+#ifdef ENABLE_MPI
+
+// this has to be included after naming the test module
+#include "upp11_config.h"
+HOOMD_UP_MAIN();
+
+#include "hoomd/DomainDecomposition.h"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+using namespace std;
+
+//! Check that every rank owns exactly one position of the grid
+void check_bijection(const std::vector<unsigned int>& cart_ranks)
+    {
+    std::vector<unsigned int> sorted(cart_ranks);
+    std::sort(sorted.begin(), sorted.end());
+    for (unsigned int i = 0; i < sorted.size(); ++i)
+        UP_ASSERT_EQUAL(sorted[i], i);
+    }
+
+//! Check that the ranks of every group own a contiguous sub-block of the grid
+/*! \param cart_ranks Rank of every linear grid index
+    \param index Indexer of the grid
+    \param group Group of every rank
+*/
+void check_sub_blocks(const std::vector<unsigned int>& cart_ranks, const Index3D& index,
+    const std::vector<unsigned int>& group)
+    {
+    std::map<unsigned int, uint3> lo, hi;
+    std::map<unsigned int, unsigned int> count;
+    for (unsigned int iglob = 0; iglob < cart_ranks.size(); ++iglob)
+        {
+        unsigned int g = group[cart_ranks[iglob]];
+        uint3 c = index.getTriple(iglob);
+        if (count[g] == 0)
+            {
+            lo[g] = c;
+            hi[g] = c;
+            }
+        lo[g] = make_uint3(std::min(lo[g].x, c.x), std::min(lo[g].y, c.y), std::min(lo[g].z, c.z));
+        hi[g] = make_uint3(std::max(hi[g].x, c.x), std::max(hi[g].y, c.y), std::max(hi[g].z, c.z));
+        count[g]++;
+        }
+
+    // the bounding box of every group contains only positions of that group
+    for (std::map<unsigned int, unsigned int>::iterator it = count.begin(); it != count.end(); ++it)
+        {
+        unsigned int g = it->first;
+        unsigned int volume = (hi[g].x - lo[g].x + 1)*(hi[g].y - lo[g].y + 1)*(hi[g].z - lo[g].z + 1);
+        UP_ASSERT_EQUAL(volume, it->second);
+        }
+    }
+
+//! Test the mapping onto two nodes with two sockets of two NUMA domains each
+UP_TEST( DomainDecomposition_map_three_levels )
+    {
+    const unsigned int nranks = 16;
+
+    // interleave the ranks, as with a round-robin placement on the nodes
+    std::vector<unsigned int> rank_node(nranks);
+    std::vector<int> rank_socket(nranks), rank_numa(nranks);
+    std::vector<unsigned int> node_group(nranks), socket_group(nranks), numa_group(nranks);
+    for (unsigned int r = 0; r < nranks; ++r)
+        {
+        rank_node[r] = r % 2;
+        rank_socket[r] = (r/2) % 2;
+        rank_numa[r] = 2*rank_socket[r] + (r/4) % 2;
+
+        node_group[r] = rank_node[r];
+        socket_group[r] = 2*rank_node[r] + rank_socket[r];
+        numa_group[r] = 4*rank_node[r] + rank_numa[r];
+        }
+
+    unsigned int grids[3][3] = {{4,2,2}, {2,2,4}, {16,1,1}};
+    for (unsigned int i = 0; i < 3; ++i)
+        {
+        unsigned int nx = grids[i][0], ny = grids[i][1], nz = grids[i][2];
+        std::vector<unsigned int> cart_ranks, blocks;
+        unsigned int n_levels = DomainDecomposition::mapDomainsToTopology(rank_node, rank_socket, rank_numa,
+            make_scalar3(nx, ny, nz), nx, ny, nz, cart_ranks, blocks);
+
+        UP_ASSERT_EQUAL(n_levels, 3);
+        UP_ASSERT_EQUAL(blocks.size(), 12);
+        UP_ASSERT_EQUAL(blocks[3]*blocks[4]*blocks[5], 8);
+        UP_ASSERT_EQUAL(blocks[6]*blocks[7]*blocks[8], 4);
+        UP_ASSERT_EQUAL(blocks[9]*blocks[10]*blocks[11], 2);
+
+        Index3D index(nx, ny, nz);
+        check_bijection(cart_ranks);
+        check_sub_blocks(cart_ranks, index, node_group);
+        check_sub_blocks(cart_ranks, index, socket_group);
+        check_sub_blocks(cart_ranks, index, numa_group);
+        }
+    }
+
+//! Test that sockets with different numbers of ranks fall back to the node level
+UP_TEST( DomainDecomposition_map_uneven_sockets )
+    {
+    const unsigned int nranks = 12;
+
+    // two nodes with six ranks, four on the first socket and two on the second
+    std::vector<unsigned int> rank_node(nranks), node_group(nranks);
+    std::vector<int> rank_socket(nranks), rank_numa(nranks);
+    for (unsigned int r = 0; r < nranks; ++r)
+        {
+        rank_node[r] = r / 6;
+        rank_socket[r] = (r % 6) < 4 ? 0 : 1;
+        rank_numa[r] = rank_socket[r];
+        node_group[r] = rank_node[r];
+        }
+
+    std::vector<unsigned int> cart_ranks, blocks;
+    unsigned int n_levels = DomainDecomposition::mapDomainsToTopology(rank_node, rank_socket, rank_numa,
+        make_scalar3(3, 2, 2), 3, 2, 2, cart_ranks, blocks);
+
+    UP_ASSERT_EQUAL(n_levels, 1);
+    UP_ASSERT_EQUAL(blocks.size(), 6);
+
+    Index3D index(3, 2, 2);
+    check_bijection(cart_ranks);
+    check_sub_blocks(cart_ranks, index, node_group);
+    }
+
+//! Test that ranks which are not bound to a socket are only grouped by node
+UP_TEST( DomainDecomposition_map_unbound )
+    {
+    const unsigned int nranks = 8;
+
+    std::vector<unsigned int> rank_node(nranks), node_group(nranks);
+    std::vector<int> rank_socket(nranks, -1), rank_numa(nranks, -1);
+    for (unsigned int r = 0; r < nranks; ++r)
+        {
+        rank_node[r] = r % 2;
+        node_group[r] = rank_node[r];
+        }
+
+    std::vector<unsigned int> cart_ranks, blocks;
+    unsigned int n_levels = DomainDecomposition::mapDomainsToTopology(rank_node, rank_socket, rank_numa,
+        make_scalar3(2, 2, 2), 2, 2, 2, cart_ranks, blocks);
+
+    UP_ASSERT_EQUAL(n_levels, 1);
+
+    Index3D index(2, 2, 2);
+    check_bijection(cart_ranks);
+    check_sub_blocks(cart_ranks, index, node_group);
+    }
+
+//! Test that nodes with different numbers of ranks use the linear mapping
+UP_TEST( DomainDecomposition_map_uneven_nodes )
+    {
+    const unsigned int nranks = 8;
+
+    // three ranks on the first node and five on the second
+    std::vector<unsigned int> rank_node(nranks);
+    std::vector<int> rank_socket(nranks, 0), rank_numa(nranks, 0);
+    for (unsigned int r = 0; r < nranks; ++r)
+        rank_node[r] = r < 3 ? 0 : 1;
+
+    std::vector<unsigned int> cart_ranks, blocks;
+    unsigned int n_levels = DomainDecomposition::mapDomainsToTopology(rank_node, rank_socket, rank_numa,
+        make_scalar3(2, 2, 2), 2, 2, 2, cart_ranks, blocks);
+
+    UP_ASSERT_EQUAL(n_levels, 0);
+    for (unsigned int i = 0; i < nranks; ++i)
+        UP_ASSERT_EQUAL(cart_ranks[i], i);
+    }
+
+#endif // ENABLE_MPI
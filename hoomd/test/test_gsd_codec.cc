@@ -0,0 +1,118 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+#include <vector>
+#include <math.h>
+#include <string.h>
+
+#include "upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+
+#include "hoomd/GSDChunkCodec.h"
+#include "hoomd/RandomNumbers.h"
+
+using namespace std;
+
+/*! \file test_gsd_codec.cc
+    \brief Implements unit tests for GSDChunkCodec
+    \ingroup unit_tests
+*/
+
+//! Fill a vector with random values in [-range, range)
+static void fill_random(std::vector<float>& data, float range, unsigned int seed)
+    {
+    hoomd::RandomGenerator rng(seed, 0);
+    hoomd::UniformDistribution<float> uniform(-range, range);
+    for (unsigned int i = 0; i < data.size(); i++)
+        data[i] = uniform(rng);
+    }
+
+//! Test that lossless chunks decode to the exact input
+UP_TEST( gsd_codec_lossless )
+    {
+    if (!GSDChunkCodec::isDeflateAvailable())
+        return;
+
+    std::vector<float> data(1000*3);
+    fill_random(data, 50.0f, 1);
+
+    std::vector<char> encoded;
+    GSDChunkCodec::encodeLossless(encoded, GSD_TYPE_FLOAT, 1000, 3, &data[0]);
+
+    GSDChunkCodec::Header header = GSDChunkCodec::readHeader(&encoded[0], encoded.size());
+    UP_ASSERT_EQUAL(header.N, (uint64_t)1000);
+    UP_ASSERT_EQUAL(header.M, (uint32_t)3);
+    UP_ASSERT_EQUAL(header.type, (uint8_t)GSD_TYPE_FLOAT);
+
+    std::vector<float> decoded(data.size());
+    GSDChunkCodec::decodeLossless(&decoded[0], &encoded[0], encoded.size());
+    UP_ASSERT(memcmp(&data[0], &decoded[0], data.size()*sizeof(float)) == 0);
+    }
+
+//! Test that quantized chunks are within half the tolerance, also along a chain of differences
+UP_TEST( gsd_codec_lossy )
+    {
+    const double tolerance = 1e-3;
+    std::vector<float> data(1000*3);
+    fill_random(data, 50.0f, 2);
+
+    std::vector<int64_t> q_ref;
+    std::vector<int64_t> q_decoded;
+    for (unsigned int frame = 0; frame < 5; frame++)
+        {
+        // small displacements as in a trajectory
+        std::vector<float> step(data.size());
+        fill_random(step, 0.05f, 3 + frame);
+        for (unsigned int i = 0; i < data.size(); i++)
+            data[i] += step[i];
+
+        std::vector<int64_t> q;
+        GSDChunkCodec::quantize(q, &data[0], data.size(), tolerance);
+
+        std::vector<char> encoded;
+        if (frame == 0)
+            GSDChunkCodec::encodeQuantized(encoded, 1000, 3, q, NULL, 0, tolerance);
+        else
+            GSDChunkCodec::encodeQuantized(encoded, 1000, 3, q, &q_ref, frame-1, tolerance);
+
+        GSDChunkCodec::Header header = GSDChunkCodec::readHeader(&encoded[0], encoded.size());
+        if (frame == 0)
+            UP_ASSERT_EQUAL(header.ref_frame, GSDChunkCodec::no_reference);
+        else
+            UP_ASSERT_EQUAL(header.ref_frame, (uint64_t)(frame-1));
+
+        GSDChunkCodec::decodeQuantized(q_decoded, &encoded[0], encoded.size());
+        std::vector<float> decoded(data.size());
+        GSDChunkCodec::dequantize(&decoded[0], q_decoded, tolerance);
+
+        for (unsigned int i = 0; i < data.size(); i++)
+            UP_ASSERT(fabs(decoded[i] - data[i]) <= tolerance/2 + 1e-5);
+
+        q_ref.swap(q);
+        }
+    }
+
+//! Test that corrupt chunks are rejected
+UP_TEST( gsd_codec_invalid )
+    {
+    std::vector<float> data(10, 1.0f);
+    std::vector<int64_t> q;
+    GSDChunkCodec::quantize(q, &data[0], data.size(), 0.1);
+
+    std::vector<char> encoded;
+    GSDChunkCodec::encodeQuantized(encoded, 10, 1, q, NULL, 0, 0.1);
+
+    std::vector<int64_t> q_decoded;
+    UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ GSDChunkCodec::readHeader(&encoded[0], 4); });
+    UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ GSDChunkCodec::decodeQuantized(q_decoded, &encoded[0], encoded.size()-1); });
+
+    std::vector<float> decoded(data.size());
+    UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ GSDChunkCodec::decodeLossless(&decoded[0], &encoded[0], encoded.size()); });
+    }
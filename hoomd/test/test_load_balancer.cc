@@ -359,6 +359,200 @@ void test_load_balancer_ghost(std::shared_ptr<ExecutionConfiguration> exec_conf,
     UP_ASSERT_EQUAL(pdata->getOwnerRank(7), di(1,0,1));
     }
 
+template<class LB>
+void test_load_balancer_bisection(std::shared_ptr<ExecutionConfiguration> exec_conf, const BoxDim& dest_box)
+{
+    // this test needs to be run on eight processors
+    int size;
+    MPI_Comm_size(exec_conf->getHOOMDWorldMPICommunicator(), &size);
+    UP_ASSERT_EQUAL(size,8);
+
+    // create a system with eight particles
+    BoxDim ref_box = BoxDim(2.0);
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(8,           // number of particles
+                                                             dest_box,        // box dimensions
+                                                             1,           // number of particle types
+                                                             0,           // number of bond types
+                                                             0,           // number of angle types
+                                                             0,           // number of dihedral types
+                                                             0,           // number of dihedral types
+                                                             exec_conf));
+
+    std::shared_ptr<ParticleData> pdata(sysdef->getParticleData());
+
+    pdata->setPosition(0, TO_TRICLINIC(make_scalar3(0.25,-0.25,0.25)),false);
+    pdata->setPosition(1, TO_TRICLINIC(make_scalar3(0.25,-0.25,0.75)),false);
+    pdata->setPosition(2, TO_TRICLINIC(make_scalar3(0.25,-0.75,0.25)),false);
+    pdata->setPosition(3, TO_TRICLINIC(make_scalar3(0.25,-0.75,0.75)),false);
+    pdata->setPosition(4, TO_TRICLINIC(make_scalar3(0.75,-0.25,0.25)),false);
+    pdata->setPosition(5, TO_TRICLINIC(make_scalar3(0.75,-0.25,0.75)),false);
+    pdata->setPosition(6, TO_TRICLINIC(make_scalar3(0.75,-0.75,0.25)),false);
+    pdata->setPosition(7, TO_TRICLINIC(make_scalar3(0.75,-0.75,0.75)),false);
+
+    SnapshotParticleData<Scalar> snap(8);
+    pdata->takeSnapshot(snap);
+
+    // initialize a 2x2x2 domain decomposition on processor with rank 0
+    std::vector<Scalar> fxs(1), fys(1), fzs(1);
+    fxs[0] = Scalar(0.5);
+    fys[0] = Scalar(0.5);
+    fzs[0] = Scalar(0.5);
+    std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, pdata->getBox().getL(), fxs, fys, fzs));
+    std::shared_ptr<Communicator> comm(new Communicator(sysdef, decomposition));
+    pdata->setDomainDecomposition(decomposition);
+
+    pdata->initializeFromSnapshot(snap);
+
+    std::shared_ptr<LoadBalancer> lb(new LB(sysdef,decomposition));
+    lb->setCommunicator(comm);
+    lb->setBisection(true);
+    UP_ASSERT(lb->getBisection());
+
+    // migrate atoms, all of them are in one domain
+    comm->migrateParticles();
+    const Index3D& di = decomposition->getDomainIndexer();
+    UP_ASSERT_EQUAL(pdata->getOwnerRank(0), di(1,0,1));
+    UP_ASSERT_EQUAL(pdata->getOwnerRank(7), di(1,0,1));
+
+    // a single update places every boundary at the median, within half of the neighboring domains
+    lb->update(0);
+
+    // each rank should own one particle
+    UP_ASSERT_EQUAL(pdata->getN(), 1);
+    UP_ASSERT_EQUAL(pdata->getOwnerRank(0), di(0,1,0));
+    UP_ASSERT_EQUAL(pdata->getOwnerRank(1), di(0,1,1));
+    UP_ASSERT_EQUAL(pdata->getOwnerRank(2), di(0,0,0));
+    UP_ASSERT_EQUAL(pdata->getOwnerRank(3), di(0,0,1));
+    UP_ASSERT_EQUAL(pdata->getOwnerRank(4), di(1,1,0));
+    UP_ASSERT_EQUAL(pdata->getOwnerRank(5), di(1,1,1));
+    UP_ASSERT_EQUAL(pdata->getOwnerRank(6), di(1,0,0));
+    UP_ASSERT_EQUAL(pdata->getOwnerRank(7), di(1,0,1));
+
+    // the boundaries are clamped to half of the neighboring domains
+    MY_CHECK_CLOSE(decomposition->getCumulativeFraction(0,1), 0.75, tol);
+    MY_CHECK_CLOSE(decomposition->getCumulativeFraction(2,1), 0.75, tol);
+    UP_ASSERT(decomposition->getCumulativeFraction(1,1) > Scalar(0.125));
+    UP_ASSERT(decomposition->getCumulativeFraction(1,1) < Scalar(0.375));
+    }
+
+//! Exposes the particle cost and the weighted load of a LoadBalancer
+class LoadBalancerCostTest : public LoadBalancer
+    {
+    public:
+        LoadBalancerCostTest(std::shared_ptr<SystemDefinition> sysdef,
+                             std::shared_ptr<DomainDecomposition> decomposition)
+            : LoadBalancer(sysdef, decomposition)
+            { }
+
+        //! Get the relative cost of a particle on this rank
+        Scalar getParticleCost() const
+            {
+            return m_particle_cost;
+            }
+
+        //! Count the load again after the domain boundaries have been moved
+        Scalar recountLoad()
+            {
+            signalResize();
+            return getLoad();
+            }
+    };
+
+void test_load_balancer_time_weighting(std::shared_ptr<ExecutionConfiguration> exec_conf, const BoxDim& dest_box)
+{
+    // this test needs to be run on eight processors
+    int size;
+    MPI_Comm_size(exec_conf->getHOOMDWorldMPICommunicator(), &size);
+    UP_ASSERT_EQUAL(size,8);
+
+    // create a system with a 4x4x4 lattice of particles
+    BoxDim ref_box = BoxDim(2.0);
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(64,          // number of particles
+                                                             dest_box,        // box dimensions
+                                                             1,           // number of particle types
+                                                             0,           // number of bond types
+                                                             0,           // number of angle types
+                                                             0,           // number of dihedral types
+                                                             0,           // number of dihedral types
+                                                             exec_conf));
+
+    std::shared_ptr<ParticleData> pdata(sysdef->getParticleData());
+
+    const Scalar x[4] = {-0.75, -0.25, 0.25, 0.75};
+    unsigned int tag = 0;
+    for (unsigned int i=0; i < 4; ++i)
+        for (unsigned int j=0; j < 4; ++j)
+            for (unsigned int k=0; k < 4; ++k)
+                pdata->setPosition(tag++, TO_TRICLINIC(make_scalar3(x[i],x[j],x[k])),false);
+
+    SnapshotParticleData<Scalar> snap(64);
+    pdata->takeSnapshot(snap);
+
+    // initialize a 2x2x2 domain decomposition on processor with rank 0
+    std::vector<Scalar> fxs(1), fys(1), fzs(1);
+    fxs[0] = Scalar(0.5);
+    fys[0] = Scalar(0.5);
+    fzs[0] = Scalar(0.5);
+    std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, pdata->getBox().getL(), fxs, fys, fzs));
+    std::shared_ptr<Communicator> comm(new Communicator(sysdef, decomposition));
+    pdata->setDomainDecomposition(decomposition);
+
+    pdata->initializeFromSnapshot(snap);
+
+    std::shared_ptr<LoadBalancerCostTest> lb(new LoadBalancerCostTest(sysdef,decomposition));
+    lb->setCommunicator(comm);
+    lb->setTimeWeighting(true);
+    lb->setDamping(Scalar(0.5));
+    UP_ASSERT(lb->getTimeWeighting());
+
+    comm->migrateParticles();
+    UP_ASSERT_EQUAL(pdata->getN(), 8);
+
+    // the rank of domain (0,0,0) takes three times as long as the others for the same number of particles
+    const uint3 grid_pos = decomposition->getGridPos();
+    const bool expensive = (grid_pos.x == 0 && grid_pos.y == 0 && grid_pos.z == 0);
+    sysdef->getIntegratorData()->addComputeTime(expensive ? 3.0 : 1.0);
+    lb->update(0);
+
+    // the cost is the time per particle relative to the average of 10 s / 64 particles
+    MY_CHECK_CLOSE(lb->getParticleCost(), expensive ? Scalar(2.4) : Scalar(0.8), tol);
+
+    // the boundaries move toward the expensive domain, limited to 5% of the domain width, so no particle migrates
+    for (unsigned int dim=0; dim < 3; ++dim)
+        {
+        UP_ASSERT(decomposition->getCumulativeFraction(dim,1) < Scalar(0.5));
+        UP_ASSERT(decomposition->getCumulativeFraction(dim,1) > Scalar(0.375));
+        }
+    UP_ASSERT_EQUAL(pdata->getN(), 8);
+
+    // move the x boundary past the second plane of particles, which is then counted on the ranks with x index 1
+    const BoxDim global_box = pdata->getGlobalBox();
+    std::vector<Scalar> old_cum_frac = decomposition->getCumulativeFractions(0);
+    std::vector<Scalar> cum_frac(3);
+    cum_frac[0] = Scalar(0.0);
+    cum_frac[1] = Scalar(0.25);
+    cum_frac[2] = Scalar(1.0);
+    decomposition->setCumulativeFractions(0, cum_frac, 0);
+    pdata->setGlobalBox(global_box);
+
+    // the received particles keep the cost of the rank that sends them
+    Scalar load = lb->recountLoad();
+    if (grid_pos.x == 0)
+        MY_CHECK_CLOSE(load, expensive ? Scalar(4*2.4) : Scalar(4*0.8), tol);
+    else if (grid_pos.y == 0 && grid_pos.z == 0)
+        MY_CHECK_CLOSE(load, Scalar(8*0.8 + 4*2.4), tol);
+    else
+        MY_CHECK_CLOSE(load, Scalar(8*0.8 + 4*0.8), tol);
+
+    decomposition->setCumulativeFractions(0, old_cum_frac, 0);
+    pdata->setGlobalBox(global_box);
+
+    // with a uniform time per particle, the new estimate of 1 is averaged with the previous one
+    sysdef->getIntegratorData()->addComputeTime(1.0);
+    lb->update(1);
+    MY_CHECK_CLOSE(lb->getParticleCost(), expensive ? Scalar(0.5*1.0 + 0.5*2.4) : Scalar(0.5*1.0 + 0.5*0.8), tol);
+    }
+
 //! Tests basic particle redistribution
 UP_TEST( LoadBalancer_test_basic)
     {
@@ -395,6 +589,26 @@ UP_TEST( LoadBalancer_test_ghost)
     test_load_balancer_ghost<LoadBalancer>(exec_conf, BoxDim(1.0,-.6,.7,.5));
     }
 
+//! Tests placing the boundaries at the particle-count medians
+UP_TEST( LoadBalancer_test_bisection)
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    // cubic box
+    test_load_balancer_bisection<LoadBalancer>(exec_conf, BoxDim(2.0));
+    // triclinic box 1
+    test_load_balancer_bisection<LoadBalancer>(exec_conf, BoxDim(1.0,.1,.2,.3));
+    }
+
+//! Tests weighting the particles by the measured compute time
+UP_TEST( LoadBalancer_test_time_weighting)
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    // cubic box
+    test_load_balancer_time_weighting(exec_conf, BoxDim(2.0));
+    // triclinic box 1
+    test_load_balancer_time_weighting(exec_conf, BoxDim(1.0,.1,.2,.3));
+    }
+
 #ifdef ENABLE_CUDA
 //! Tests basic particle redistribution on the GPU
 UP_TEST( LoadBalancerGPU_test_basic)
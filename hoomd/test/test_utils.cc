@@ -147,6 +147,36 @@ UP_TEST(Profiler_test)
 
     }
 
+//! check that trace buffers keep the most recent events in order
+UP_TEST(ProfileTraceBuffer_test)
+    {
+    ProfileTraceBuffer buffer(0, 4);
+    std::vector<ProfileTraceEvent> events;
+
+    buffer.getEvents(events);
+    UP_ASSERT_EQUAL(events.size(), (size_t)0);
+
+    buffer.record(1, "A", true, 0, 0);
+    buffer.record(2, NULL, false, 10, 20);
+    buffer.getEvents(events);
+    UP_ASSERT_EQUAL(events.size(), (size_t)2);
+    UP_ASSERT(events[0].m_begin);
+    UP_ASSERT_EQUAL(events[0].m_time, 1);
+    UP_ASSERT(!events[1].m_begin);
+    UP_ASSERT_EQUAL(events[1].m_flop_count, (uint64_t)10);
+    UP_ASSERT_EQUAL(events[1].m_mem_byte_count, (uint64_t)20);
+    UP_ASSERT_EQUAL(buffer.getNumDropped(), (uint64_t)0);
+
+    // overwrite the oldest events
+    for (int64_t t = 3; t <= 7; t++)
+        buffer.record(t, "B", true, 0, 0);
+    buffer.getEvents(events);
+    UP_ASSERT_EQUAL(events.size(), (size_t)4);
+    for (unsigned int i = 0; i < 4; i++)
+        UP_ASSERT_EQUAL(events[i].m_time, int64_t(4+i));
+    UP_ASSERT_EQUAL(buffer.getNumDropped(), (uint64_t)3);
+    }
+
 //! perform some simple checks on the variant types
 UP_TEST(Variant_test)
     {
@@ -399,6 +399,9 @@ class balance(_updater):
         z (bool): If True, balance in z dimension.
         tolerance (float): Load imbalance tolerance (if <= 1.0, balance every step).
         maxiter (int): Maximum number of iterations to attempt in a single step.
+        bisection (bool): If True, place the domain boundaries at the particle-count medians.
+        weight (str): Load of a particle, either 'particles' (every particle counts one) or 'time' (measured compute time).
+        damping (float): Weight of the previous particle cost estimate when *weight* is 'time' (0 <= damping < 1).
         period (int): Balancing will be attempted every \a period time steps
         phase (int): When -1, start on the current time step. When >= 0, execute on steps where *(step + phase) % period == 0*.
 
@@ -441,9 +444,27 @@ class balance(_updater):
     either balance infrequently or to balance once in a short test run and then set the decomposition statically in a
     separate initialization.
 
+    With *bisection* set to True, the boundaries are not rescaled by 5% per step. Instead, the particle positions are
+    binned along each dimension, and every boundary is placed at the position that divides the particles evenly
+    between the domains on either side (the particle-count median of the slabs it separates). The constraint that a
+    boundary cannot move more than half the width of its neighboring domains still applies, so strongly inhomogeneous
+    systems such as a droplet in its vapor are balanced within a few *period* instead of tens. Because the domains form
+    a regular grid, the boundaries along one dimension are shared by all domains in that plane, and the best achievable
+    balance is that of the particle distribution projected onto each axis.
+
+    By default, the load of a rank is the number of particles it owns. When the cost per particle varies strongly
+    (rigid bodies in a solvent, dense and dilute regions, complex HPMC shapes), set *weight* to 'time'. Every rank then
+    measures the wall time its integrator spent computing forces (MD) or trial moves (HPMC) since the last balancing
+    step, excluding the time spent waiting for other ranks. Each particle is weighted by the time per particle of its
+    rank, relative to the average over all ranks, and the load imbalance is computed from the weighted loads. The
+    estimate is an exponential moving average, where *damping* is the weight of the previous estimate. Larger values
+    of *damping* reduce oscillations caused by noisy timings, smaller values adapt faster. Time weighting is only
+    available on the CPU.
+
     Balancing is ignored if there is no domain decomposition available (MPI is not built or is running on a single rank).
     """
-    def __init__(self, x=True, y=True, z=True, tolerance=1.02, maxiter=1, period=1000, phase=0):
+    def __init__(self, x=True, y=True, z=True, tolerance=1.02, maxiter=1, period=1000, phase=0, bisection=False,
+                 weight='particles', damping=0.5):
         hoomd.util.print_status_line();
 
         # initialize base class
@@ -463,16 +484,17 @@ class balance(_updater):
         self.setupUpdater(period,phase)
 
         # stash arguments to metadata
-        self.metadata_fields = ['tolerance','maxiter','period','phase']
+        self.metadata_fields = ['tolerance','maxiter','period','phase','bisection','weight','damping']
         self.period = period
         self.phase = phase
 
         # configure the parameters
         hoomd.util.quiet_status()
-        self.set_params(x,y,z,tolerance, maxiter)
+        self.set_params(x,y,z,tolerance, maxiter, bisection, weight, damping)
         hoomd.util.unquiet_status()
 
-    def set_params(self, x=None, y=None, z=None, tolerance=None, maxiter=None):
+    def set_params(self, x=None, y=None, z=None, tolerance=None, maxiter=None, bisection=None, weight=None,
+                   damping=None):
         R""" Change load balancing parameters.
 
         Args:
@@ -481,12 +503,17 @@ class balance(_updater):
             z (bool): If True, balance in z dimension.
             tolerance (float): Load imbalance tolerance (if <= 1.0, balance every step).
             maxiter (int): Maximum number of iterations to attempt in a single step.
+            bisection (bool): If True, place the domain boundaries at the particle-count medians.
+            weight (str): Load of a particle, either 'particles' or 'time'.
+            damping (float): Weight of the previous particle cost estimate when *weight* is 'time'.
 
 
         Examples::
 
             balance.set_params(x=True, y=False)
             balance.set_params(tolerance=0.02, maxiter=5)
+            balance.set_params(bisection=True)
+            balance.set_params(weight='time', damping=0.8)
         """
         hoomd.util.print_status_line()
         self.check_initialization()
@@ -503,6 +530,18 @@ class balance(_updater):
         if maxiter is not None:
             self.maxiter = maxiter
             self.cpp_updater.setMaxIterations(self.maxiter)
+        if bisection is not None:
+            self.bisection = bisection
+            self.cpp_updater.setBisection(self.bisection)
+        if weight is not None:
+            if weight not in ['particles', 'time']:
+                hoomd.context.msg.error("update.balance: weight must be 'particles' or 'time'\n")
+                raise ValueError('Invalid load balancing weight')
+            self.weight = weight
+            self.cpp_updater.setTimeWeighting(self.weight == 'time')
+        if damping is not None:
+            self.damping = damping
+            self.cpp_updater.setDamping(self.damping)
 
 # Global current id counter to assign updaters unique names
 _updater.cur_id = 0;